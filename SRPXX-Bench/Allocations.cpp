@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Allocations.hpp"
+#include <SRPXX.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic< uint64_t > allocations( 0 );
+    
+    class CountingAllocator: public SRP::Allocator
+    {
+        public:
+            
+            void * allocate( size_t size ) override
+            {
+                allocations.fetch_add( 1, std::memory_order_relaxed );
+                
+                return SRP::Allocator::defaultAllocator().allocate( size );
+            }
+            
+            void * reallocate( void * p, size_t size ) override
+            {
+                allocations.fetch_add( 1, std::memory_order_relaxed );
+                
+                return SRP::Allocator::defaultAllocator().reallocate( p, size );
+            }
+            
+            void deallocate( void * p ) override
+            {
+                SRP::Allocator::defaultAllocator().deallocate( p );
+            }
+    };
+    
+    void * allocate( size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        
+        void * p = malloc( ( size == 0 ) ? 1 : size );
+        
+        if( p == nullptr )
+        {
+            throw std::bad_alloc();
+        }
+        
+        return p;
+    }
+}
+
+namespace Allocations
+{
+    void install()
+    {
+        /* Never destroyed, as memory is released through the allocator that provided it */
+        static CountingAllocator * allocator = new CountingAllocator();
+        
+        SRP::Allocator::setCurrent( *( allocator ) );
+    }
+    
+    uint64_t count()
+    {
+        return allocations.load( std::memory_order_relaxed );
+    }
+}
+
+void * operator new( size_t size )
+{
+    return allocate( size );
+}
+
+void * operator new[]( size_t size )
+{
+    return allocate( size );
+}
+
+void operator delete( void * p ) noexcept
+{
+    free( p );
+}
+
+void operator delete[]( void * p ) noexcept
+{
+    free( p );
+}
+
+void operator delete( void * p, size_t size ) noexcept
+{
+    ( void )size;
+    
+    free( p );
+}
+
+void operator delete[]( void * p, size_t size ) noexcept
+{
+    ( void )size;
+    
+    free( p );
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Arguments.hpp"
+#include <stdexcept>
+
+class Arguments::IMPL
+{
+    public:
+        
+        IMPL( int argc, const char * argv[] );
+        IMPL( const IMPL & o );
+        ~IMPL();
+        
+        static size_t numberFromString( const std::string & number, size_t max );
+        
+        std::string               _filter;
+        std::string               _json;
+        std::chrono::milliseconds _time;
+        size_t                    _samples;
+};
+
+Arguments::Arguments( int argc, const char * argv[] ):
+    impl( std::make_unique< IMPL >( argc, argv ) )
+{}
+
+Arguments::Arguments( const Arguments & o ):
+    impl( std::make_unique< IMPL >( *( o.impl ) ) )
+{}
+
+Arguments::~Arguments()
+{}
+
+Arguments & Arguments::operator =( Arguments o )
+{
+    swap( *( this ), o );
+    
+    return *( this );
+}
+
+void swap( Arguments & o1, Arguments & o2 )
+{
+    using std::swap;
+    
+    swap( o1.impl, o2.impl );
+}
+
+std::string Arguments::filter() const
+{
+    return this->impl->_filter;
+}
+
+std::string Arguments::json() const
+{
+    return this->impl->_json;
+}
+
+std::chrono::milliseconds Arguments::time() const
+{
+    return this->impl->_time;
+}
+
+size_t Arguments::samples() const
+{
+    return this->impl->_samples;
+}
+
+Arguments::IMPL::IMPL( int argc, const char * argv[] ):
+    _time( 200 ),
+    _samples( 10 )
+{
+    bool filter = false;
+    
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg  = argv[ i ];
+        bool        last = i + 1 == argc;
+        
+        if( arg == "--json" && last == false )
+        {
+            this->_json = argv[ ++i ];
+        }
+        else if( arg == "--time" && last == false )
+        {
+            this->_time = std::chrono::milliseconds( IMPL::numberFromString( argv[ ++i ], 3600000 ) );
+        }
+        else if( arg == "--samples" && last == false )
+        {
+            this->_samples = std::max< size_t >( 1, IMPL::numberFromString( argv[ ++i ], 1000000 ) );
+        }
+        else if( filter == false && arg.empty() == false && arg[ 0 ] != '-' )
+        {
+            this->_filter = arg;
+            filter        = true;
+        }
+        else
+        {
+            throw std::runtime_error
+            (
+                "Usage: srp-bench [--json <path>] [--time <ms>] [--samples <count>] [filter]\n"
+                "\n"
+                "    Runs every benchmark whose name contains the filter, for example `Handshake/SHA256` or `/2048`.\n"
+                "    Each one is warmed up, then sampled for at least the given time and number of samples (200 ms and 10 by default).\n"
+                "    Results are printed as a table, and written as JSON to the given path, or `-` for stdout."
+            );
+        }
+    }
+}
+
+Arguments::IMPL::IMPL( const IMPL & o ):
+    _filter(  o._filter ),
+    _json(    o._json ),
+    _time(    o._time ),
+    _samples( o._samples )
+{}
+
+Arguments::IMPL::~IMPL()
+{}
+
+size_t Arguments::IMPL::numberFromString( const std::string & number, size_t max )
+{
+    size_t length = 0;
+    
+    try
+    {
+        unsigned long long value = std::stoull( number, &length );
+        
+        if( length == number.size() && value <= max )
+        {
+            return static_cast< size_t >( value );
+        }
+    }
+    catch( const std::exception & )
+    {}
+    
+    throw std::runtime_error( "Invalid number: " + number );
+}
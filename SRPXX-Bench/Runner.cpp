@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Runner.hpp"
+#include "Allocations.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+class Runner::IMPL
+{
+    public:
+        
+        using Clock = std::chrono::steady_clock;
+        
+        IMPL( const std::string & filter, std::chrono::milliseconds time, size_t samples, std::ostream & output );
+        
+        void               print( const Result & result );
+        static std::string stringFromTime( double ns );
+        static std::string escape( const std::string & str );
+        
+        std::string               _filter;
+        std::chrono::milliseconds _time;
+        size_t                    _samples;
+        std::ostream            & _output;
+        std::vector< Result >     _results;
+};
+
+Runner::Runner( const std::string & filter, std::chrono::milliseconds time, size_t samples, std::ostream & output ):
+    impl( std::make_unique< IMPL >( filter, time, samples, output ) )
+{}
+
+Runner::~Runner()
+{}
+
+bool Runner::matches( const std::string & name ) const
+{
+    return this->impl->_filter.empty() || name.find( this->impl->_filter ) != std::string::npos;
+}
+
+void Runner::run( const std::string & name, const std::function< void() > & body, uint64_t bytes )
+{
+    if( this->matches( name ) == false )
+    {
+        return;
+    }
+    
+    using Clock = IMPL::Clock;
+    
+    /* Warm-up, for a tenth of the sampling time or at least three calls */
+    Clock::duration warmup = this->impl->_time / 10;
+    Clock::time_point start  = Clock::now();
+    uint64_t          calls  = 0;
+    
+    while( calls < 3 || Clock::now() - start < warmup )
+    {
+        body();
+        
+        calls++;
+    }
+    
+    double   average = static_cast< double >( std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - start ).count() ) / static_cast< double >( calls );
+    uint64_t batch   = std::max< uint64_t >( 1, static_cast< uint64_t >( 10000.0 / std::max( average, 1.0 ) ) );
+    
+    std::vector< double > samples;
+    uint64_t              allocations = Allocations::count();
+    Clock::time_point     end         = Clock::now() + this->impl->_time;
+    
+    while( samples.size() < this->impl->_samples || Clock::now() < end )
+    {
+        Clock::time_point t = Clock::now();
+        
+        for( uint64_t i = 0; i < batch; i++ )
+        {
+            body();
+        }
+        
+        samples.push_back( static_cast< double >( std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - t ).count() ) / static_cast< double >( batch ) );
+    }
+    
+    /* Includes the samples vector growing, which is negligible next to a batch */
+    allocations = Allocations::count() - allocations;
+    
+    std::sort( samples.begin(), samples.end() );
+    
+    auto percentile = [ & ]( double p )
+    {
+        return samples[ std::min( samples.size() - 1, static_cast< size_t >( p * static_cast< double >( samples.size() ) ) ) ];
+    };
+    
+    double total = 0;
+    
+    for( double sample: samples )
+    {
+        total += sample;
+    }
+    
+    Result result;
+    
+    result.name        = name;
+    result.iterations  = samples.size() * batch;
+    result.bytes       = bytes;
+    result.allocations = static_cast< double >( allocations ) / static_cast< double >( result.iterations );
+    result.mean        = total / static_cast< double >( samples.size() );
+    result.min         = samples.front();
+    result.p50         = percentile( 0.50 );
+    result.p90         = percentile( 0.90 );
+    result.p99         = percentile( 0.99 );
+    result.max         = samples.back();
+    
+    this->impl->print( result );
+    this->impl->_results.push_back( result );
+}
+
+std::vector< Runner::Result > Runner::results() const
+{
+    return this->impl->_results;
+}
+
+std::string Runner::json() const
+{
+    std::stringstream ss;
+    
+    ss << std::fixed << std::setprecision( 1 ) << "{\n    \"benchmarks\":\n    [\n";
+    
+    for( size_t i = 0; i < this->impl->_results.size(); i++ )
+    {
+        const Result & r = this->impl->_results[ i ];
+        
+        ss << "        { "
+           << "\"name\": \""        << IMPL::escape( r.name ) << "\", "
+           << "\"iterations\": "    << r.iterations           << ", "
+           << "\"bytes\": "         << r.bytes                << ", "
+           << "\"allocations\": "   << std::setprecision( 2 ) << r.allocations << std::setprecision( 1 ) << ", "
+           << "\"mean_ns\": "       << r.mean                 << ", "
+           << "\"min_ns\": "        << r.min                  << ", "
+           << "\"p50_ns\": "        << r.p50                  << ", "
+           << "\"p90_ns\": "        << r.p90                  << ", "
+           << "\"p99_ns\": "        << r.p99                  << ", "
+           << "\"max_ns\": "        << r.max
+           << " }" << ( ( i + 1 < this->impl->_results.size() ) ? "," : "" ) << "\n";
+    }
+    
+    ss << "    ]\n}\n";
+    
+    return ss.str();
+}
+
+Runner::IMPL::IMPL( const std::string & filter, std::chrono::milliseconds time, size_t samples, std::ostream & output ):
+    _filter( filter ),
+    _time( time ),
+    _samples( samples ),
+    _output( output )
+{}
+
+void Runner::IMPL::print( const Result & result )
+{
+    if( this->_results.empty() )
+    {
+        this->_output << std::left  << std::setw( 32 ) << "Benchmark"
+                      << std::right << std::setw( 12 ) << "Iterations"
+                      << std::setw( 14 ) << "p50"
+                      << std::setw( 14 ) << "p90"
+                      << std::setw( 14 ) << "p99"
+                      << std::setw( 14 ) << "Max"
+                      << std::setw( 10 ) << "Allocs"
+                      << std::setw( 17 ) << "Throughput"
+                      << std::endl;
+    }
+    
+    this->_output << std::left  << std::setw( 32 ) << result.name
+                  << std::right << std::setw( 12 ) << result.iterations
+                  << std::setw( 14 ) << IMPL::stringFromTime( result.p50 )
+                  << std::setw( 14 ) << IMPL::stringFromTime( result.p90 )
+                  << std::setw( 14 ) << IMPL::stringFromTime( result.p99 )
+                  << std::setw( 14 ) << IMPL::stringFromTime( result.max )
+                  << std::setw( 10 ) << std::fixed << std::setprecision( 1 ) << result.allocations;
+    
+    if( result.bytes > 0 && result.p50 > 0 )
+    {
+        this->_output << std::setw( 12 ) << std::setprecision( 1 ) << ( static_cast< double >( result.bytes ) * 1000.0 ) / result.p50 << " MB/s";
+    }
+    
+    this->_output << std::endl;
+}
+
+std::string Runner::IMPL::stringFromTime( double ns )
+{
+    std::stringstream ss;
+    
+    ss << std::fixed << std::setprecision( 3 );
+    
+         if( ns < 1000.0 )       { ss << ns                << " ns"; }
+    else if( ns < 1000000.0 )    { ss << ns / 1000.0       << " us"; }
+    else if( ns < 1000000000.0 ) { ss << ns / 1000000.0    << " ms"; }
+    else                         { ss << ns / 1000000000.0 << " s";  }
+    
+    return ss.str();
+}
+
+std::string Runner::IMPL::escape( const std::string & str )
+{
+    std::string escaped;
+    
+    for( char c: str )
+    {
+        if( c == '"' || c == '\\' )
+        {
+            escaped += '\\';
+        }
+        
+        escaped += c;
+    }
+    
+    return escaped;
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_BENCH_RUNNER_HPP
+#define SRPXX_BENCH_RUNNER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Times benchmarks one after the other on the calling thread.
+ * Each one is warmed up first, which also calibrates how many calls make up
+ * a sample, so timer overhead stays negligible for fast operations.
+ * Sampling then lasts for at least the minimum time and number of samples.
+ */
+class Runner
+{
+    public:
+        
+        struct Result
+        {
+            std::string name;
+            uint64_t    iterations;
+            uint64_t    bytes;
+            double      allocations;
+            double      mean;
+            double      min;
+            double      p50;
+            double      p90;
+            double      p99;
+            double      max;
+        };
+        
+        /* Rows are printed to output as each benchmark completes */
+        Runner( const std::string & filter, std::chrono::milliseconds time, size_t samples, std::ostream & output );
+        ~Runner();
+        
+        Runner( const Runner & o )              = delete;
+        Runner & operator =( const Runner & o ) = delete;
+        
+        bool matches( const std::string & name ) const;
+        
+        /* Skipped if the name does not match the filter - Bytes processed per call, for throughput */
+        void run( const std::string & name, const std::function< void() > & body, uint64_t bytes = 0 );
+        
+        /* Times in nanoseconds per call */
+        std::vector< Result > results() const;
+        std::string           json()    const;
+        
+    private:
+        
+        class IMPL;
+        
+        std::unique_ptr< IMPL > impl;
+};
+
+#endif /* SRPXX_BENCH_RUNNER_HPP */
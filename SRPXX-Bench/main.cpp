@@ -0,0 +1,292 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <SRPXX.hpp>
+#include "Allocations.hpp"
+#include "Arguments.hpp"
+#include "Runner.hpp"
+
+static std::vector< uint8_t > deterministicBytes( const std::string & label, size_t length );
+static std::string            stringFromHashAlgorithm( SRP::HashAlgorithm algorithm );
+static std::string            stringFromSize( size_t size );
+static void                   benchBigNum( Runner & runner, SRP::Base::GroupType groupType, const std::string & bits );
+static void                   benchSession( Runner & runner, SRP::HashAlgorithm algorithm, SRP::Base::GroupType groupType, const std::string & bits );
+static void                   benchHashing( Runner & runner );
+static void                   benchEncoding( Runner & runner );
+
+template< typename T >
+static void benchSHA( Runner & runner, const std::string & name );
+
+int main( int argc, const char * argv[] )
+{
+    /* Before anything allocates through SRP::Allocator */
+    Allocations::install();
+    
+    try
+    {
+        Arguments args( argc, argv );
+        Runner    runner( args.filter(), args.time(), args.samples(), ( args.json() == "-" ) ? std::cerr : std::cout );
+        
+        std::vector< std::pair< SRP::Base::GroupType, std::string > > groups =
+        {
+            { SRP::Base::GroupType::NG1024, "1024" },
+            { SRP::Base::GroupType::NG1536, "1536" },
+            { SRP::Base::GroupType::NG2048, "2048" },
+            { SRP::Base::GroupType::NG3072, "3072" },
+            { SRP::Base::GroupType::NG4096, "4096" },
+            { SRP::Base::GroupType::NG6144, "6144" },
+            { SRP::Base::GroupType::NG8192, "8192" },
+        };
+        
+        std::vector< SRP::HashAlgorithm > algorithms =
+        {
+            SRP::HashAlgorithm::SHA1,
+            SRP::HashAlgorithm::SHA224,
+            SRP::HashAlgorithm::SHA256,
+            SRP::HashAlgorithm::SHA384,
+            SRP::HashAlgorithm::SHA512
+        };
+        
+        for( const auto & group: groups )
+        {
+            benchBigNum( runner, group.first, group.second );
+        }
+        
+        for( SRP::HashAlgorithm algorithm: algorithms )
+        {
+            for( const auto & group: groups )
+            {
+                benchSession( runner, algorithm, group.first, group.second );
+            }
+        }
+        
+        for( SRP::HashAlgorithm algorithm: algorithms )
+        {
+            std::string name = "PBKDF2/" + stringFromHashAlgorithm( algorithm );
+            
+            if( runner.matches( name ) )
+            {
+                std::vector< uint8_t > salt = deterministicBytes( "salt", 16 );
+                
+                runner.run( name, [ & ] { SRP::PBKDF2::HMAC( algorithm, "password", salt, 1000, 32 ); } );
+            }
+        }
+        
+        benchHashing( runner );
+        benchEncoding( runner );
+        
+        if( args.json() == "-" )
+        {
+            std::cout << runner.json();
+        }
+        else if( args.json().empty() == false )
+        {
+            std::ofstream stream( args.json() );
+            
+            stream << runner.json();
+            
+            if( stream.good() == false )
+            {
+                throw std::runtime_error( "Cannot write to " + args.json() );
+            }
+        }
+    }
+    catch( const std::exception & e )
+    {
+        std::cout << e.what() << std::endl;
+        
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+/* Inputs are derived from a label rather than random, so runs compare against each other */
+static std::vector< uint8_t > deterministicBytes( const std::string & label, size_t length )
+{
+    std::vector< uint8_t > bytes;
+    
+    for( uint32_t counter = 0; bytes.size() < length; counter++ )
+    {
+        std::vector< uint8_t > block = SRP::SHA256::bytes( label + ":" + std::to_string( counter ) );
+        
+        bytes.insert( bytes.end(), block.begin(), block.end() );
+    }
+    
+    bytes.resize( length );
+    
+    return bytes;
+}
+
+static std::string stringFromHashAlgorithm( SRP::HashAlgorithm algorithm )
+{
+    switch( algorithm )
+    {
+        case SRP::HashAlgorithm::SHA1:   return "SHA1";
+        case SRP::HashAlgorithm::SHA224: return "SHA224";
+        case SRP::HashAlgorithm::SHA256: return "SHA256";
+        case SRP::HashAlgorithm::SHA384: return "SHA384";
+        case SRP::HashAlgorithm::SHA512: return "SHA512";
+    }
+    
+    return "Unknown";
+}
+
+static std::string stringFromSize( size_t size )
+{
+    if( size >= 1024 * 1024 ) { return std::to_string( size / ( 1024 * 1024 ) ) + "MB"; }
+    if( size >= 1024 )        { return std::to_string( size / 1024 )            + "KB"; }
+    
+    return std::to_string( size ) + "B";
+}
+
+static void benchBigNum( Runner & runner, SRP::Base::GroupType groupType, const std::string & bits )
+{
+    if( runner.matches( "BigNum/modExp/" + bits ) == false && runner.matches( "BigNum/modMul/" + bits ) == false )
+    {
+        return;
+    }
+    
+    SRP::BigNum N = SRP::Client( "bench", SRP::HashAlgorithm::SHA256, groupType ).N();
+    size_t      n = N.bytes( SRP::BigNum::Endianness::BigEndian ).size();
+    
+    /* One byte shorter than N, so both are already reduced */
+    SRP::BigNum x( deterministicBytes( "x:" + bits, n - 1 ), SRP::BigNum::Endianness::BigEndian );
+    SRP::BigNum y( deterministicBytes( "y:" + bits, n - 1 ), SRP::BigNum::Endianness::BigEndian );
+    SRP::BigNum e( deterministicBytes( "e:" + bits, 32 ),    SRP::BigNum::Endianness::BigEndian );
+    
+    runner.run( "BigNum/modExp/" + bits, [ & ] { x.modExp( e, N ); } );
+    runner.run( "BigNum/modMul/" + bits, [ & ] { x.modMul( y, N ); } );
+}
+
+static void benchSession( Runner & runner, SRP::HashAlgorithm algorithm, SRP::Base::GroupType groupType, const std::string & bits )
+{
+    std::string suffix = "/" + stringFromHashAlgorithm( algorithm ) + "/" + bits;
+    bool        any    = false;
+    
+    for( const char * name: { "Client/A", "Client/x", "Client/v", "Client/S", "Server/B", "Server/S", "Handshake" } )
+    {
+        any = any || runner.matches( std::string( name ) + suffix );
+    }
+    
+    if( any == false )
+    {
+        return;
+    }
+    
+    std::string            identity = "alice";
+    std::string            password = "password123";
+    std::vector< uint8_t > salt     = deterministicBytes( "salt", 16 );
+    SRP::BigNum            a( deterministicBytes( "a", 32 ), SRP::BigNum::Endianness::BigEndian );
+    SRP::BigNum            b( deterministicBytes( "b", 32 ), SRP::BigNum::Endianness::BigEndian );
+    SRP::Client            client( identity, algorithm, groupType, a );
+    SRP::Server            server( identity, algorithm, groupType, b );
+    
+    client.setSalt( salt );
+    client.setPassword( password );
+    
+    SRP::BigNum v = client.v();
+    
+    server.setSalt( salt );
+    server.setV( v );
+    server.setA( client.A() );
+    client.setB( server.B() );
+    
+    runner.run( "Client/A" + suffix, [ & ] { client.A(); } );
+    runner.run( "Client/x" + suffix, [ & ] { client.x(); } );
+    runner.run( "Client/v" + suffix, [ & ] { client.v(); } );
+    runner.run( "Client/S" + suffix, [ & ] { client.S(); } );
+    runner.run( "Server/B" + suffix, [ & ] { server.B(); } );
+    runner.run( "Server/S" + suffix, [ & ] { server.S(); } );
+    
+    /* Both sides of a full exchange, each computing S once */
+    runner.run
+    (
+        "Handshake" + suffix,
+        [ & ]
+        {
+            SRP::Client c( identity, algorithm, groupType, a );
+            SRP::Server s( identity, algorithm, groupType, b );
+            
+            s.setSalt( salt );
+            s.setV( v );
+            s.setA( c.A() );
+            c.setSalt( salt );
+            c.setPassword( password );
+            c.setB( s.B() );
+            
+            std::vector< uint8_t > K  = c.K( c.S() );
+            std::vector< uint8_t > M1 = c.M1( K );
+            
+            if( s.verifyM1( M1 ) != c.M2( M1, K ) )
+            {
+                throw std::runtime_error( "Handshake failed" );
+            }
+        }
+    );
+}
+
+template< typename T >
+static void benchSHA( Runner & runner, const std::string & name )
+{
+    for( size_t size: { 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576 } )
+    {
+        std::string label = name + "/" + stringFromSize( size );
+        
+        if( runner.matches( label ) )
+        {
+            std::vector< uint8_t > data = deterministicBytes( label, size );
+            
+            runner.run( label, [ & ] { T::bytes( data.data(), data.size() ); }, size );
+        }
+    }
+}
+
+static void benchHashing( Runner & runner )
+{
+    benchSHA< SRP::SHA1   >( runner, "SHA1" );
+    benchSHA< SRP::SHA224 >( runner, "SHA224" );
+    benchSHA< SRP::SHA256 >( runner, "SHA256" );
+    benchSHA< SRP::SHA384 >( runner, "SHA384" );
+    benchSHA< SRP::SHA512 >( runner, "SHA512" );
+}
+
+static void benchEncoding( Runner & runner )
+{
+    for( size_t size: { 32, 4096 } )
+    {
+        std::vector< uint8_t > data    = deterministicBytes( "encoding", size );
+        std::string            encoded = SRP::Base64::encode( data );
+        
+        runner.run( "Base64/encode/" + stringFromSize( size ), [ & ] { SRP::Base64::encode( data ); },                                 size );
+        runner.run( "Base64/decode/" + stringFromSize( size ), [ & ] { SRP::Base64::decode( encoded ); },                              size );
+        runner.run( "String/toHex/"  + stringFromSize( size ), [ & ] { SRP::String::toHex( data, SRP::String::HexFormat::Lowercase ); }, size );
+    }
+}
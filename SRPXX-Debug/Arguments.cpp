@@ -33,10 +33,17 @@ class Arguments::IMPL
         IMPL( const IMPL & o );
         ~IMPL();
         
+        static SRP::HashAlgorithm   hashAlgorithmFromString( const std::string & hash );
+        static SRP::Base::GroupType groupTypeFromString( const std::string & group );
+        
+        Command              _command;
         std::string          _identity;
         std::string          _password;
         SRP::HashAlgorithm   _hashAlgorithm;
         SRP::Base::GroupType _groupType;
+        Format               _format;
+        std::string          _input;
+        std::string          _output;
 };
 
 Arguments::Arguments( int argc, const char * argv[] ):
@@ -64,6 +71,11 @@ void swap( Arguments & o1, Arguments & o2 )
     swap( o1.impl, o2.impl );
 }
 
+Arguments::Command Arguments::command() const
+{
+    return this->impl->_command;
+}
+
 std::string Arguments::identity() const
 {
     return this->impl->_identity;
@@ -84,54 +96,102 @@ SRP::Base::GroupType Arguments::groupType() const
     return this->impl->_groupType;
 }
 
-Arguments::IMPL::IMPL( int argc, const char * argv[] )
+Arguments::Format Arguments::format() const
+{
+    return this->impl->_format;
+}
+
+std::string Arguments::input() const
+{
+    return this->impl->_input;
+}
+
+std::string Arguments::output() const
 {
+    return this->impl->_output;
+}
+
+Arguments::IMPL::IMPL( int argc, const char * argv[] ):
+    _command( Command::Debug ),
+    _format( Format::Binary )
+{
+    if( argc >= 2 && std::string( argv[ 1 ] ) == "register" && argc >= 5 && argc <= 7 )
+    {
+        std::string format = argv[ 4 ];
+        
+        this->_command       = Command::Register;
+        this->_hashAlgorithm = IMPL::hashAlgorithmFromString( argv[ 2 ] );
+        this->_groupType     = IMPL::groupTypeFromString( argv[ 3 ] );
+        this->_input         = ( argc > 5 ) ? argv[ 5 ] : "-";
+        this->_output        = ( argc > 6 ) ? argv[ 6 ] : "-";
+        
+             if( format == "binary" ) { this->_format = Format::Binary; }
+        else if( format == "csv" )    { this->_format = Format::CSV; }
+        else
+        {
+            throw std::runtime_error( "Unsupported output format: " + format );
+        }
+        
+        return;
+    }
+    
     if( argc != 5 )
     {
         throw std::runtime_error
         (
             "Usage: srp <identity> <password> <hash algorithm> <group parameter>\n"
+            "       srp register <hash algorithm> <group parameter> <binary|csv> [input] [output]\n"
             "\n"
             "    - Supported hash algorithms:  sha1 sha224 sha256 sha384 sha512\n"
-            "    - Supported group parameters: 1024 1536 2048 3072 4096 6144 8192"
+            "    - Supported group parameters: 1024 1536 2048 3072 4096 6144 8192\n"
+            "\n"
+            "    register reads `identity,password` lines and writes one salt and verifier per identity.\n"
+            "    Input and output default to stdin and stdout, or `-`.\n"
+            "    - binary: for each identity, then salt, then big-endian verifier, a 16-bit little-endian length followed by the bytes\n"
+            "    - csv:    identity,base64 salt,base64 verifier"
         );
     }
     
-    this->_identity = argv[ 1 ];
-    this->_password = argv[ 2 ];
-    
-    std::string hash  = argv[ 3 ];
-    std::string group = argv[ 4 ];
-    
-         if( hash == "sha1"   ) { this->_hashAlgorithm = SRP::HashAlgorithm::SHA1; }
-    else if( hash == "sha224" ) { this->_hashAlgorithm = SRP::HashAlgorithm::SHA224; }
-    else if( hash == "sha256" ) { this->_hashAlgorithm = SRP::HashAlgorithm::SHA256; }
-    else if( hash == "sha384" ) { this->_hashAlgorithm = SRP::HashAlgorithm::SHA384; }
-    else if( hash == "sha512" ) { this->_hashAlgorithm = SRP::HashAlgorithm::SHA512; }
-    else
-    {
-        throw std::runtime_error( "Unsupported hash algorithm: " + hash );
-    }
-    
-         if( group == "1024" ) { this->_groupType = SRP::Base::GroupType::NG1024; }
-    else if( group == "1536" ) { this->_groupType = SRP::Base::GroupType::NG1536; }
-    else if( group == "2048" ) { this->_groupType = SRP::Base::GroupType::NG2048; }
-    else if( group == "3072" ) { this->_groupType = SRP::Base::GroupType::NG3072; }
-    else if( group == "4096" ) { this->_groupType = SRP::Base::GroupType::NG4096; }
-    else if( group == "6144" ) { this->_groupType = SRP::Base::GroupType::NG6144; }
-    else if( group == "8192" ) { this->_groupType = SRP::Base::GroupType::NG8192; }
-    else
-    {
-        throw std::runtime_error( "Unsupported group parameter: " + group );
-    }
+    this->_identity      = argv[ 1 ];
+    this->_password      = argv[ 2 ];
+    this->_hashAlgorithm = IMPL::hashAlgorithmFromString( argv[ 3 ] );
+    this->_groupType     = IMPL::groupTypeFromString( argv[ 4 ] );
 }
 
 Arguments::IMPL::IMPL( const IMPL & o ):
+    _command(       o._command ),
     _identity(      o._identity ),
     _password(      o._password ),
     _hashAlgorithm( o._hashAlgorithm ),
-    _groupType(     o._groupType )
+    _groupType(     o._groupType ),
+    _format(        o._format ),
+    _input(         o._input ),
+    _output(        o._output )
 {}
 
 Arguments::IMPL::~IMPL()
 {}
+
+SRP::HashAlgorithm Arguments::IMPL::hashAlgorithmFromString( const std::string & hash )
+{
+         if( hash == "sha1"   ) { return SRP::HashAlgorithm::SHA1; }
+    else if( hash == "sha224" ) { return SRP::HashAlgorithm::SHA224; }
+    else if( hash == "sha256" ) { return SRP::HashAlgorithm::SHA256; }
+    else if( hash == "sha384" ) { return SRP::HashAlgorithm::SHA384; }
+    else if( hash == "sha512" ) { return SRP::HashAlgorithm::SHA512; }
+    
+    throw std::runtime_error( "Unsupported hash algorithm: " + hash );
+}
+
+SRP::Base::GroupType Arguments::IMPL::groupTypeFromString( const std::string & group )
+{
+         if( group == "1024" ) { return SRP::Base::GroupType::NG1024; }
+    else if( group == "1536" ) { return SRP::Base::GroupType::NG1536; }
+    else if( group == "2048" ) { return SRP::Base::GroupType::NG2048; }
+    else if( group == "3072" ) { return SRP::Base::GroupType::NG3072; }
+    else if( group == "4096" ) { return SRP::Base::GroupType::NG4096; }
+    else if( group == "6144" ) { return SRP::Base::GroupType::NG6144; }
+    else if( group == "8192" ) { return SRP::Base::GroupType::NG8192; }
+    
+    throw std::runtime_error( "Unsupported group parameter: " + group );
+}
@@ -30,6 +30,18 @@ class Arguments
 {
     public:
         
+        enum class Command
+        {
+            Debug,
+            Register
+        };
+        
+        enum class Format
+        {
+            Binary,
+            CSV
+        };
+        
         Arguments( int argc, const char * argv[] );
         Arguments( const Arguments & o );
         ~Arguments();
@@ -38,10 +50,14 @@ class Arguments
         
         friend void swap( Arguments & o1, Arguments & o2 );
         
+        Command              command()       const;
         std::string          identity()      const;
         std::string          password()      const;
         SRP::HashAlgorithm   hashAlgorithm() const;
         SRP::Base::GroupType groupType()     const;
+        Format               format()        const;
+        std::string          input()         const;
+        std::string          output()        const;
         
     private:
         
@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -36,6 +37,8 @@ static std::string stringFromGroupType( SRP::Base::GroupType groupType );
 static std::string stringFromString( const std::string & string );
 static std::string stringFromBigNum( const std::string & name, const SRP::BigNum & number );
 static std::string stringFromData( const std::string & name, const std::vector< uint8_t > & data );
+static void        registerVerifiers( const Arguments & args );
+static void        writeRegistration( std::ostream & output, Arguments::Format format, const SRP::BulkRegistrar::Registration & registration );
 
 int main( int argc, const char * argv[] )
 {
@@ -45,6 +48,13 @@ int main( int argc, const char * argv[] )
         std::vector< uint8_t > salt;
         std::vector< uint8_t > verifier;
         
+        if( args.command() == Arguments::Command::Register )
+        {
+            registerVerifiers( args );
+            
+            return EXIT_SUCCESS;
+        }
+        
         {
             SRP::Client client( args.identity(), args.hashAlgorithm(), args.groupType() );
             
@@ -177,3 +187,109 @@ static std::string stringFromData( const std::string & name, const std::vector<
     
     return ss.str();
 }
+
+static void registerVerifiers( const Arguments & args )
+{
+    std::ifstream                                  inputFile;
+    std::ofstream                                  outputFile;
+    std::istream                                 * input  = &( std::cin );
+    std::ostream                                 * output = &( std::cout );
+    SRP::Engine                                    engine;
+    SRP::BulkRegistrar                             registrar( args.hashAlgorithm(), args.groupType() );
+    std::vector< SRP::BulkRegistrar::Credentials > batch;
+    std::string                                    line;
+    
+    if( args.input() != "-" )
+    {
+        inputFile.open( args.input() );
+        
+        if( inputFile.good() == false )
+        {
+            throw std::runtime_error( "Cannot open input file: " + args.input() );
+        }
+        
+        input = &( inputFile );
+    }
+    
+    if( args.output() != "-" )
+    {
+        outputFile.open( args.output(), std::ios::binary | std::ios::trunc );
+        
+        if( outputFile.good() == false )
+        {
+            throw std::runtime_error( "Cannot open output file: " + args.output() );
+        }
+        
+        output = &( outputFile );
+    }
+    
+    /* Streamed in batches, so memory stays bounded regardless of the number of identities */
+    do
+    {
+        batch.clear();
+        
+        while( batch.size() < 65536 && std::getline( *( input ), line ) )
+        {
+            if( line.empty() == false && line.back() == '\r' )
+            {
+                line.pop_back();
+            }
+            
+            if( line.empty() )
+            {
+                continue;
+            }
+            
+            size_t separator = line.find( ',' );
+            
+            if( separator == std::string::npos )
+            {
+                throw std::runtime_error( "Invalid input line, expected identity,password: " + line );
+            }
+            
+            batch.push_back( { line.substr( 0, separator ), line.substr( separator + 1 ) } );
+        }
+        
+        for( const auto & registration: registrar.generate( batch, engine ) )
+        {
+            writeRegistration( *( output ), args.format(), registration );
+        }
+    }
+    while( batch.empty() == false );
+    
+    output->flush();
+    
+    if( output->good() == false )
+    {
+        throw std::runtime_error( "Cannot write output" );
+    }
+}
+
+static void writeRegistration( std::ostream & output, Arguments::Format format, const SRP::BulkRegistrar::Registration & registration )
+{
+    if( format == Arguments::Format::CSV )
+    {
+        output << registration.identity                        << ","
+               << SRP::Base64::encode( registration.salt )     << ","
+               << SRP::Base64::encode( registration.verifier ) << "\n";
+        
+        return;
+    }
+    
+    auto write = [ & ]( const uint8_t * data, size_t size )
+    {
+        if( size > 0xFFFF )
+        {
+            throw std::runtime_error( "Value is too long for the binary format" );
+        }
+        
+        char length[ 2 ] = { static_cast< char >( size & 0xFF ), static_cast< char >( size >> 8 ) };
+        
+        output.write( length, 2 );
+        output.write( reinterpret_cast< const char * >( data ), static_cast< std::streamsize >( size ) );
+    };
+    
+    write( reinterpret_cast< const uint8_t * >( registration.identity.data() ), registration.identity.size() );
+    write( registration.salt.data(),     registration.salt.size() );
+    write( registration.verifier.data(), registration.verifier.size() );
+}
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Arguments.hpp"
+#include "Protocol.hpp"
+#include <stdexcept>
+#include <string>
+
+class Arguments::IMPL
+{
+    public:
+        
+        IMPL( int argc, const char * argv[] );
+        IMPL( const IMPL & o );
+        ~IMPL();
+        
+        static SRP::HashAlgorithm   hashAlgorithmFromString( const std::string & hash );
+        static SRP::Base::GroupType groupTypeFromString( const std::string & group );
+        static size_t               numberFromString( const std::string & number, size_t max );
+        
+        Command              _command;
+        SRP::HashAlgorithm   _hashAlgorithm;
+        SRP::Base::GroupType _groupType;
+        uint16_t             _port;
+        size_t               _connections;
+        size_t               _handshakes;
+        size_t               _threads;
+};
+
+Arguments::Arguments( int argc, const char * argv[] ):
+    impl( std::make_unique< IMPL >( argc, argv ) )
+{}
+
+Arguments::Arguments( const Arguments & o ):
+    impl( std::make_unique< IMPL >( *( o.impl ) ) )
+{}
+
+Arguments::~Arguments()
+{}
+
+Arguments & Arguments::operator =( Arguments o )
+{
+    swap( *( this ), o );
+    
+    return *( this );
+}
+
+void swap( Arguments & o1, Arguments & o2 )
+{
+    using std::swap;
+    
+    swap( o1.impl, o2.impl );
+}
+
+Arguments::Command Arguments::command() const
+{
+    return this->impl->_command;
+}
+
+SRP::HashAlgorithm Arguments::hashAlgorithm() const
+{
+    return this->impl->_hashAlgorithm;
+}
+
+SRP::Base::GroupType Arguments::groupType() const
+{
+    return this->impl->_groupType;
+}
+
+uint16_t Arguments::port() const
+{
+    return this->impl->_port;
+}
+
+size_t Arguments::connections() const
+{
+    return this->impl->_connections;
+}
+
+size_t Arguments::handshakes() const
+{
+    return this->impl->_handshakes;
+}
+
+size_t Arguments::threads() const
+{
+    return this->impl->_threads;
+}
+
+Arguments::IMPL::IMPL( int argc, const char * argv[] ):
+    _command( Command::Loopback ),
+    _port( Protocol::defaultPort ),
+    _connections( 64 ),
+    _handshakes( 100 ),
+    _threads( 0 )
+{
+    std::string command = ( argc >= 2 ) ? argv[ 1 ] : "";
+    
+    if( command == "server" && argc >= 4 && argc <= 6 )
+    {
+        this->_command = Command::Server;
+        this->_port    = ( argc > 4 ) ? static_cast< uint16_t >( IMPL::numberFromString( argv[ 4 ], 0xFFFF ) ) : this->_port;
+        this->_threads = ( argc > 5 ) ? IMPL::numberFromString( argv[ 5 ], 1024 )                                 : this->_threads;
+    }
+    else if( command == "client" && argc >= 4 && argc <= 8 )
+    {
+        this->_command     = Command::Client;
+        this->_port        = ( argc > 4 ) ? static_cast< uint16_t >( IMPL::numberFromString( argv[ 4 ], 0xFFFF ) ) : this->_port;
+        this->_connections = ( argc > 5 ) ? IMPL::numberFromString( argv[ 5 ], 65536 )                                : this->_connections;
+        this->_handshakes  = ( argc > 6 ) ? IMPL::numberFromString( argv[ 6 ], 1000000000 )                           : this->_handshakes;
+        this->_threads     = ( argc > 7 ) ? IMPL::numberFromString( argv[ 7 ], 1024 )                                 : this->_threads;
+    }
+    else if( command == "loopback" && argc >= 4 && argc <= 6 )
+    {
+        this->_command     = Command::Loopback;
+        this->_connections = ( argc > 4 ) ? IMPL::numberFromString( argv[ 4 ], 65536 )      : this->_connections;
+        this->_handshakes  = ( argc > 5 ) ? IMPL::numberFromString( argv[ 5 ], 1000000000 ) : this->_handshakes;
+    }
+    else
+    {
+        throw std::runtime_error
+        (
+            "Usage: srp-server server   <hash algorithm> <group parameter> [port] [threads]\n"
+            "       srp-server client   <hash algorithm> <group parameter> [port] [connections] [handshakes] [threads]\n"
+            "       srp-server loopback <hash algorithm> <group parameter> [connections] [handshakes]\n"
+            "\n"
+            "    - Supported hash algorithms:  sha1 sha224 sha256 sha384 sha512\n"
+            "    - Supported group parameters: 1024 1536 2048 3072 4096 6144 8192\n"
+            "\n"
+            "    server runs an SRP server on 127.0.0.1 until interrupted.\n"
+            "    client opens connections to it and runs handshakes back to back on each, then prints throughput and latency.\n"
+            "    loopback runs both in one process.\n"
+            "    Handshakes are per connection - Zero threads uses one per core - The port defaults to "
+            + std::to_string( Protocol::defaultPort ) + "."
+        );
+    }
+    
+    this->_hashAlgorithm = IMPL::hashAlgorithmFromString( argv[ 2 ] );
+    this->_groupType     = IMPL::groupTypeFromString( argv[ 3 ] );
+}
+
+Arguments::IMPL::IMPL( const IMPL & o ):
+    _command(       o._command ),
+    _hashAlgorithm( o._hashAlgorithm ),
+    _groupType(     o._groupType ),
+    _port(          o._port ),
+    _connections(   o._connections ),
+    _handshakes(    o._handshakes ),
+    _threads(       o._threads )
+{}
+
+Arguments::IMPL::~IMPL()
+{}
+
+SRP::HashAlgorithm Arguments::IMPL::hashAlgorithmFromString( const std::string & hash )
+{
+         if( hash == "sha1"   ) { return SRP::HashAlgorithm::SHA1; }
+    else if( hash == "sha224" ) { return SRP::HashAlgorithm::SHA224; }
+    else if( hash == "sha256" ) { return SRP::HashAlgorithm::SHA256; }
+    else if( hash == "sha384" ) { return SRP::HashAlgorithm::SHA384; }
+    else if( hash == "sha512" ) { return SRP::HashAlgorithm::SHA512; }
+    
+    throw std::runtime_error( "Unsupported hash algorithm: " + hash );
+}
+
+SRP::Base::GroupType Arguments::IMPL::groupTypeFromString( const std::string & group )
+{
+         if( group == "1024" ) { return SRP::Base::GroupType::NG1024; }
+    else if( group == "1536" ) { return SRP::Base::GroupType::NG1536; }
+    else if( group == "2048" ) { return SRP::Base::GroupType::NG2048; }
+    else if( group == "3072" ) { return SRP::Base::GroupType::NG3072; }
+    else if( group == "4096" ) { return SRP::Base::GroupType::NG4096; }
+    else if( group == "6144" ) { return SRP::Base::GroupType::NG6144; }
+    else if( group == "8192" ) { return SRP::Base::GroupType::NG8192; }
+    
+    throw std::runtime_error( "Unsupported group parameter: " + group );
+}
+
+size_t Arguments::IMPL::numberFromString( const std::string & number, size_t max )
+{
+    size_t length = 0;
+    
+    try
+    {
+        unsigned long long value = std::stoull( number, &length );
+        
+        if( length == number.size() && value <= max )
+        {
+            return static_cast< size_t >( value );
+        }
+    }
+    catch( const std::exception & )
+    {}
+    
+    throw std::runtime_error( "Invalid number: " + number );
+}
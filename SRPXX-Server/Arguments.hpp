@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SERVER_ARGUMENTS_HPP
+#define SRPXX_SERVER_ARGUMENTS_HPP
+
+#include <SRPXX.hpp>
+#include <memory>
+#include <algorithm>
+
+class Arguments
+{
+    public:
+        
+        enum class Command
+        {
+            Server,
+            Client,
+            Loopback
+        };
+        
+        Arguments( int argc, const char * argv[] );
+        Arguments( const Arguments & o );
+        ~Arguments();
+        
+        Arguments & operator =( Arguments o );
+        
+        friend void swap( Arguments & o1, Arguments & o2 );
+        
+        Command              command()       const;
+        SRP::HashAlgorithm   hashAlgorithm() const;
+        SRP::Base::GroupType groupType()     const;
+        uint16_t             port()          const;
+        size_t               connections()   const;
+        size_t               handshakes()    const;
+        size_t               threads()       const;
+        
+    private:
+        
+        class IMPL;
+        
+        std::unique_ptr< IMPL > impl;
+};
+
+#endif /* SRPXX_SERVER_ARGUMENTS_HPP */
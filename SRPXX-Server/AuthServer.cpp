@@ -0,0 +1,518 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "AuthServer.hpp"
+#include "Poller.hpp"
+#include "Protocol.hpp"
+#include "Socket.hpp"
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#ifdef MSG_NOSIGNAL
+static constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+static constexpr int sendFlags = 0;
+#endif
+
+class AuthServer::IMPL
+{
+    public:
+        
+        struct User
+        {
+            std::vector< uint8_t > salt;
+            SRP::BigNum            verifier;
+        };
+        
+        struct Connection
+        {
+            uint64_t                       id;
+            int                            fd;
+            std::vector< uint8_t >         input;
+            std::vector< uint8_t >         output;
+            size_t                         written;
+            bool                           writing;
+            bool                           busy;
+            std::shared_ptr< SRP::Server > session;
+        };
+        
+        struct Completion
+        {
+            int                    fd;
+            uint64_t               id;
+            std::vector< uint8_t > message;
+            bool                   verified;
+            bool                   final;
+        };
+        
+        IMPL( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t threads );
+        ~IMPL();
+        
+        void accept();
+        bool read( Connection & connection );
+        bool handle( Connection & connection, const SRP::Wire::Message & message );
+        bool flush( Connection & connection );
+        void close( int fd );
+        
+        /* From the engine's threads */
+        void complete( Completion completion );
+        void drain();
+        
+        SRP::HashAlgorithm                      _hashAlgorithm;
+        SRP::Base::GroupType                    _groupType;
+        Poller                                  _poller;
+        int                                     _listener;
+        int                                     _wake[ 2 ];
+        std::unordered_map< std::string, User > _users;
+        std::unordered_map< int, Connection >   _connections;
+        uint64_t                                _nextID;
+        std::mutex                              _mutex;
+        std::vector< Completion >               _completions;
+        std::vector< Completion >               _ready;
+        std::atomic< bool >                     _stopped;
+        std::atomic< uint64_t >                 _accepted;
+        std::atomic< uint64_t >                 _handshakes;
+        std::atomic< uint64_t >                 _rejected;
+        std::unique_ptr< SRP::Engine >          _engine;
+};
+
+AuthServer::AuthServer( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t threads ):
+    impl( std::make_unique< IMPL >( hashAlgorithm, groupType, port, threads ) )
+{}
+
+AuthServer::~AuthServer()
+{}
+
+void AuthServer::run()
+{
+    std::vector< Poller::Event > events;
+    
+    while( this->impl->_stopped == false )
+    {
+        this->impl->_poller.wait( events, -1 );
+        
+        for( const auto & event: events )
+        {
+            if( event.fd == this->impl->_listener )
+            {
+                this->impl->accept();
+                
+                continue;
+            }
+            
+            if( event.fd == this->impl->_wake[ 0 ] )
+            {
+                this->impl->drain();
+                
+                continue;
+            }
+            
+            auto it = this->impl->_connections.find( event.fd );
+            
+            if( it == this->impl->_connections.end() )
+            {
+                continue;
+            }
+            
+            bool open = true;
+            
+            if( event.readable || event.closed )
+            {
+                open = this->impl->read( it->second );
+            }
+            
+            if( open && event.writable )
+            {
+                open = this->impl->flush( it->second );
+            }
+            
+            if( open == false )
+            {
+                this->impl->close( event.fd );
+            }
+        }
+    }
+}
+
+void AuthServer::stop()
+{
+    this->impl->_stopped = true;
+    
+    ( void )write( this->impl->_wake[ 1 ], "", 1 );
+}
+
+AuthServer::Stats AuthServer::stats() const
+{
+    return { this->impl->_accepted, this->impl->_handshakes, this->impl->_rejected };
+}
+
+AuthServer::IMPL::IMPL( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t threads ):
+    _hashAlgorithm( hashAlgorithm ),
+    _groupType( groupType ),
+    _listener( -1 ),
+    _wake{ -1, -1 },
+    _nextID( 0 ),
+    _stopped( false ),
+    _accepted( 0 ),
+    _handshakes( 0 ),
+    _rejected( 0 ),
+    _engine( std::make_unique< SRP::Engine >( threads ) )
+{
+    std::vector< SRP::BulkRegistrar::Credentials > credentials;
+    
+    for( size_t i = 0; i < Protocol::users; i++ )
+    {
+        credentials.push_back( { Protocol::identity( i ), Protocol::password() } );
+    }
+    
+    for( const auto & registration: SRP::BulkRegistrar( hashAlgorithm, groupType ).generate( credentials, *( this->_engine ) ) )
+    {
+        this->_users[ registration.identity ] = { registration.salt, SRP::BigNum( registration.verifier, SRP::BigNum::Endianness::BigEndian ) };
+    }
+    
+    if( pipe( this->_wake ) < 0 )
+    {
+        throw std::system_error( errno, std::generic_category(), "pipe" );
+    }
+    
+    fcntl( this->_wake[ 0 ], F_SETFL, fcntl( this->_wake[ 0 ], F_GETFL ) | O_NONBLOCK );
+    fcntl( this->_wake[ 1 ], F_SETFL, fcntl( this->_wake[ 1 ], F_GETFL ) | O_NONBLOCK );
+    
+    this->_listener = Socket::listenLoopback( port );
+    
+    this->_poller.add( this->_listener );
+    this->_poller.add( this->_wake[ 0 ] );
+}
+
+AuthServer::IMPL::~IMPL()
+{
+    /* Workers may still be completing steps */
+    this->_engine.reset();
+    
+    for( const auto & connection: this->_connections )
+    {
+        ::close( connection.first );
+    }
+    
+    ::close( this->_listener );
+    ::close( this->_wake[ 0 ] );
+    ::close( this->_wake[ 1 ] );
+}
+
+void AuthServer::IMPL::accept()
+{
+    int fd = -1;
+    
+    while( ( fd = Socket::accept( this->_listener ) ) >= 0 )
+    {
+        this->_connections[ fd ] = { ++( this->_nextID ), fd, {}, {}, 0, false, false, nullptr };
+        
+        this->_poller.add( fd );
+        this->_accepted++;
+    }
+}
+
+bool AuthServer::IMPL::read( Connection & connection )
+{
+    uint8_t buffer[ 4096 ];
+    
+    while( true )
+    {
+        ssize_t n = recv( connection.fd, buffer, sizeof( buffer ), 0 );
+        
+        if( n == 0 )
+        {
+            return false;
+        }
+        
+        if( n < 0 )
+        {
+            if( errno == EAGAIN || errno == EWOULDBLOCK )
+            {
+                break;
+            }
+            
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            
+            return false;
+        }
+        
+        connection.input.insert( connection.input.end(), buffer, buffer + n );
+    }
+    
+    try
+    {
+        SRP::Wire::Message message;
+        size_t             offset = 0;
+        size_t             length = 0;
+        
+        while( ( length = SRP::Wire::parse( connection.input.data() + offset, connection.input.size() - offset, message ) ) > 0 )
+        {
+            offset += length;
+            
+            /* Fields point into the input, which is kept until the loop ends */
+            if( this->handle( connection, message ) == false )
+            {
+                return false;
+            }
+        }
+        
+        connection.input.erase( connection.input.begin(), connection.input.begin() + static_cast< ptrdiff_t >( offset ) );
+    }
+    catch( const std::exception & )
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+bool AuthServer::IMPL::handle( Connection & connection, const SRP::Wire::Message & message )
+{
+    /* One step at a time - Clients wait for each answer */
+    if( connection.busy )
+    {
+        return false;
+    }
+    
+    if( message.hashAlgorithm != this->_hashAlgorithm || message.groupType != this->_groupType )
+    {
+        this->_rejected++;
+        
+        return false;
+    }
+    
+    int      fd = connection.fd;
+    uint64_t id = connection.id;
+    
+    if( message.type == SRP::Wire::Type::Hello )
+    {
+        auto user = this->_users.find( std::string( message.identity ) );
+        
+        if( user == this->_users.end() )
+        {
+            this->_rejected++;
+            
+            return false;
+        }
+        
+        auto session = std::make_shared< SRP::Server >( user->first, this->_hashAlgorithm, this->_groupType );
+        
+        if( session->isValidPublicValue( message.A ) == false )
+        {
+            this->_rejected++;
+            
+            return false;
+        }
+        
+        session->setSalt( user->second.salt );
+        session->setV( user->second.verifier );
+        session->setA( message.A );
+        
+        connection.session = session;
+        connection.busy    = true;
+        
+        this->_engine->post
+        (
+            [ this, fd, id, session ]
+            {
+                Completion completion { fd, id, std::vector< uint8_t >( SRP::Wire::maxLength ), false, false };
+                
+                completion.message.resize( SRP::Wire::encodeChallenge( *( session ), completion.message.data(), completion.message.size() ) );
+                this->complete( std::move( completion ) );
+            }
+        );
+        
+        return true;
+    }
+    
+    if( message.type == SRP::Wire::Type::ClientProof && connection.session != nullptr )
+    {
+        auto                   session = connection.session;
+        std::vector< uint8_t > M1( message.M1.data, message.M1.data + message.M1.length );
+        
+        connection.busy = true;
+        
+        this->_engine->post
+        (
+            [ this, fd, id, session, M1 ]
+            {
+                Completion             completion { fd, id, {}, false, true };
+                std::vector< uint8_t > M2 = session->verifyM1( M1 );
+                
+                /* A rejected proof gets no answer - The connection is closed */
+                if( M2.empty() == false )
+                {
+                    completion.verified = true;
+                    
+                    completion.message.resize( SRP::Wire::maxLength );
+                    completion.message.resize( SRP::Wire::encodeServerProof( *( session ), M2, completion.message.data(), completion.message.size() ) );
+                }
+                
+                this->complete( std::move( completion ) );
+            }
+        );
+        
+        return true;
+    }
+    
+    return false;
+}
+
+bool AuthServer::IMPL::flush( Connection & connection )
+{
+    while( connection.written < connection.output.size() )
+    {
+        ssize_t n = send( connection.fd, connection.output.data() + connection.written, connection.output.size() - connection.written, sendFlags );
+        
+        if( n < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            
+            if( errno != EAGAIN && errno != EWOULDBLOCK )
+            {
+                return false;
+            }
+            
+            if( connection.writing == false )
+            {
+                connection.writing = true;
+                
+                this->_poller.modify( connection.fd, true );
+            }
+            
+            return true;
+        }
+        
+        connection.written += static_cast< size_t >( n );
+    }
+    
+    connection.output.clear();
+    
+    connection.written = 0;
+    
+    if( connection.writing )
+    {
+        connection.writing = false;
+        
+        this->_poller.modify( connection.fd, false );
+    }
+    
+    return true;
+}
+
+void AuthServer::IMPL::close( int fd )
+{
+    this->_poller.remove( fd );
+    ::close( fd );
+    this->_connections.erase( fd );
+}
+
+void AuthServer::IMPL::complete( Completion completion )
+{
+    bool wake = false;
+    
+    {
+        std::lock_guard< std::mutex > lock( this->_mutex );
+        
+        wake = this->_completions.empty();
+        
+        this->_completions.push_back( std::move( completion ) );
+    }
+    
+    /* The reactor takes every pending completion when woken up */
+    if( wake )
+    {
+        ( void )write( this->_wake[ 1 ], "", 1 );
+    }
+}
+
+void AuthServer::IMPL::drain()
+{
+    uint8_t buffer[ 64 ];
+    
+    while( ::read( this->_wake[ 0 ], buffer, sizeof( buffer ) ) > 0 )
+    {}
+    
+    {
+        std::lock_guard< std::mutex > lock( this->_mutex );
+        
+        std::swap( this->_ready, this->_completions );
+    }
+    
+    for( auto & completion: this->_ready )
+    {
+        auto it = this->_connections.find( completion.fd );
+        
+        /* Closed while the step was running */
+        if( it == this->_connections.end() || it->second.id != completion.id )
+        {
+            continue;
+        }
+        
+        Connection & connection = it->second;
+        
+        connection.busy = false;
+        
+        if( completion.final )
+        {
+            connection.session.reset();
+            
+            if( completion.verified == false )
+            {
+                this->_rejected++;
+                
+                this->close( completion.fd );
+                
+                continue;
+            }
+            
+            this->_handshakes++;
+        }
+        
+        connection.output.insert( connection.output.end(), completion.message.begin(), completion.message.end() );
+        
+        if( this->flush( connection ) == false )
+        {
+            this->close( completion.fd );
+        }
+    }
+    
+    this->_ready.clear();
+}
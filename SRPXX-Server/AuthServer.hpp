@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SERVER_AUTH_SERVER_HPP
+#define SRPXX_SERVER_AUTH_SERVER_HPP
+
+#include <SRPXX.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Single-threaded reactor accepting SRP handshakes on 127.0.0.1.
+ * B and the M1 check run on an Engine, and results come back to the
+ * reactor through a wake-up pipe, so the event loop never blocks on math.
+ */
+class AuthServer
+{
+    public:
+        
+        struct Stats
+        {
+            uint64_t connections;
+            uint64_t handshakes;
+            uint64_t rejected;
+        };
+        
+        /* Zero threads uses one per core */
+        AuthServer( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t threads = 0 );
+        ~AuthServer();
+        
+        AuthServer( const AuthServer & o )              = delete;
+        AuthServer & operator =( const AuthServer & o ) = delete;
+        
+        /* Runs the event loop until stop() is called */
+        void run();
+        
+        /* Thread-safe */
+        void  stop();
+        Stats stats() const;
+        
+    private:
+        
+        class IMPL;
+        
+        std::unique_ptr< IMPL > impl;
+};
+
+#endif /* SRPXX_SERVER_AUTH_SERVER_HPP */
@@ -0,0 +1,396 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "LoadClient.hpp"
+#include "Poller.hpp"
+#include "Protocol.hpp"
+#include "Socket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#ifdef MSG_NOSIGNAL
+static constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+static constexpr int sendFlags = 0;
+#endif
+
+class LoadClient::IMPL
+{
+    public:
+        
+        using Clock = std::chrono::steady_clock;
+        
+        struct Connection
+        {
+            int                            fd;
+            size_t                         user;
+            size_t                         remaining;
+            std::vector< uint8_t >         input;
+            std::vector< uint8_t >         output;
+            size_t                         written;
+            bool                           writing;
+            Clock::time_point              start;
+            std::unique_ptr< SRP::Client > session;
+        };
+        
+        struct Results
+        {
+            std::vector< std::chrono::nanoseconds > latencies;
+            uint64_t                                failures;
+        };
+        
+        IMPL( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t connections, size_t handshakes, size_t threads );
+        
+        /* Runs on each load thread, for connections first, first + step, ... */
+        void run( size_t first, size_t step, Results & results ) const;
+        
+        void begin(  Connection & connection ) const;
+        bool handle( Connection & connection, const SRP::Wire::Message & message, Results & results ) const;
+        bool read(   Connection & connection, Results & results ) const;
+        bool flush(  Poller & poller, Connection & connection ) const;
+        
+        SRP::HashAlgorithm   _hashAlgorithm;
+        SRP::Base::GroupType _groupType;
+        uint16_t             _port;
+        size_t               _connections;
+        size_t               _handshakes;
+        size_t               _threads;
+};
+
+LoadClient::LoadClient( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t connections, size_t handshakes, size_t threads ):
+    impl( std::make_unique< IMPL >( hashAlgorithm, groupType, port, connections, handshakes, threads ) )
+{}
+
+LoadClient::~LoadClient()
+{}
+
+LoadClient::Report LoadClient::run()
+{
+    std::vector< IMPL::Results > results( this->impl->_threads );
+    std::vector< std::thread >   threads;
+    auto                         start = IMPL::Clock::now();
+    
+    for( size_t i = 0; i < this->impl->_threads; i++ )
+    {
+        threads.emplace_back( [ this, i, &results ] { this->impl->run( i, this->impl->_threads, results[ i ] ); } );
+    }
+    
+    for( auto & thread: threads )
+    {
+        thread.join();
+    }
+    
+    Report                                  report    = {};
+    std::vector< std::chrono::nanoseconds > latencies;
+    
+    report.elapsed = std::chrono::duration_cast< std::chrono::nanoseconds >( IMPL::Clock::now() - start );
+    
+    for( const auto & result: results )
+    {
+        latencies.insert( latencies.end(), result.latencies.begin(), result.latencies.end() );
+        
+        report.failures += result.failures;
+    }
+    
+    report.handshakes = latencies.size();
+    
+    if( latencies.empty() )
+    {
+        return report;
+    }
+    
+    std::sort( latencies.begin(), latencies.end() );
+    
+    auto percentile = [ & ]( size_t permille )
+    {
+        return latencies[ std::min( latencies.size() - 1, ( latencies.size() * permille ) / 1000 ) ];
+    };
+    
+    report.p50  = percentile( 500 );
+    report.p90  = percentile( 900 );
+    report.p99  = percentile( 990 );
+    report.p999 = percentile( 999 );
+    report.max  = latencies.back();
+    
+    return report;
+}
+
+LoadClient::IMPL::IMPL( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t connections, size_t handshakes, size_t threads ):
+    _hashAlgorithm( hashAlgorithm ),
+    _groupType( groupType ),
+    _port( port ),
+    _connections( connections ),
+    _handshakes( handshakes ),
+    _threads( threads )
+{
+    if( this->_threads == 0 )
+    {
+        this->_threads = std::max< size_t >( 1, std::thread::hardware_concurrency() );
+    }
+    
+    this->_threads = std::max< size_t >( 1, std::min( this->_threads, this->_connections ) );
+}
+
+void LoadClient::IMPL::run( size_t first, size_t step, Results & results ) const
+{
+    Poller                                poller;
+    std::unordered_map< int, Connection > connections;
+    std::vector< Poller::Event >          events;
+    
+    results.failures = 0;
+    
+    for( size_t i = first; i < this->_connections; i += step )
+    {
+        int fd = Socket::connectLoopback( this->_port );
+        
+        connections[ fd ] = { fd, i, this->_handshakes, {}, {}, 0, false, {}, nullptr };
+        
+        poller.add( fd );
+    }
+    
+    results.latencies.reserve( connections.size() * this->_handshakes );
+    
+    for( auto it = connections.begin(); it != connections.end(); )
+    {
+        if( it->second.remaining > 0 )
+        {
+            this->begin( it->second );
+        }
+        
+        if( it->second.remaining == 0 || this->flush( poller, it->second ) == false )
+        {
+            results.failures += it->second.remaining;
+            
+            poller.remove( it->first );
+            close( it->first );
+            
+            it = connections.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    
+    while( connections.empty() == false )
+    {
+        poller.wait( events, -1 );
+        
+        for( const auto & event: events )
+        {
+            auto it = connections.find( event.fd );
+            
+            if( it == connections.end() )
+            {
+                continue;
+            }
+            
+            bool open = true;
+            
+            if( event.readable || event.closed )
+            {
+                open = this->read( it->second, results );
+            }
+            
+            if( open )
+            {
+                open = this->flush( poller, it->second );
+            }
+            
+            /* Done, or dropped by the server */
+            if( open == false || it->second.remaining == 0 )
+            {
+                results.failures += it->second.remaining;
+                
+                poller.remove( event.fd );
+                close( event.fd );
+                connections.erase( it );
+            }
+        }
+    }
+}
+
+void LoadClient::IMPL::begin( Connection & connection ) const
+{
+    size_t offset = connection.output.size();
+    
+    connection.start   = Clock::now();
+    connection.session = std::make_unique< SRP::Client >( Protocol::identity( connection.user ), this->_hashAlgorithm, this->_groupType );
+    
+    connection.output.resize( offset + SRP::Wire::maxLength );
+    connection.output.resize( offset + SRP::Wire::encodeHello( *( connection.session ), connection.output.data() + offset, SRP::Wire::maxLength ) );
+}
+
+bool LoadClient::IMPL::handle( Connection & connection, const SRP::Wire::Message & message, Results & results ) const
+{
+    if( connection.session == nullptr )
+    {
+        return false;
+    }
+    
+    if( message.type == SRP::Wire::Type::Challenge )
+    {
+        size_t offset = connection.output.size();
+        
+        connection.session->setSalt( message.salt.data, message.salt.length );
+        connection.session->setPassword( Protocol::password() );
+        connection.session->setB( message.B );
+        
+        connection.output.resize( offset + SRP::Wire::maxLength );
+        connection.output.resize( offset + SRP::Wire::encodeClientProof( *( connection.session ), connection.output.data() + offset, SRP::Wire::maxLength ) );
+        
+        return true;
+    }
+    
+    if( message.type == SRP::Wire::Type::ServerProof )
+    {
+        std::vector< uint8_t > M2 = connection.session->M2();
+        
+        if( M2.size() != message.M2.length || std::equal( M2.begin(), M2.end(), message.M2.data ) == false )
+        {
+            return false;
+        }
+        
+        connection.session.reset();
+        connection.remaining--;
+        
+        results.latencies.push_back( std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - connection.start ) );
+        
+        if( connection.remaining > 0 )
+        {
+            this->begin( connection );
+        }
+        
+        return true;
+    }
+    
+    return false;
+}
+
+bool LoadClient::IMPL::read( Connection & connection, Results & results ) const
+{
+    uint8_t buffer[ 4096 ];
+    
+    while( true )
+    {
+        ssize_t n = recv( connection.fd, buffer, sizeof( buffer ), 0 );
+        
+        if( n == 0 )
+        {
+            return false;
+        }
+        
+        if( n < 0 )
+        {
+            if( errno == EAGAIN || errno == EWOULDBLOCK )
+            {
+                break;
+            }
+            
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            
+            return false;
+        }
+        
+        connection.input.insert( connection.input.end(), buffer, buffer + n );
+    }
+    
+    try
+    {
+        SRP::Wire::Message message;
+        size_t             offset = 0;
+        size_t             length = 0;
+        
+        while( ( length = SRP::Wire::parse( connection.input.data() + offset, connection.input.size() - offset, message ) ) > 0 )
+        {
+            offset += length;
+            
+            if( this->handle( connection, message, results ) == false )
+            {
+                return false;
+            }
+        }
+        
+        connection.input.erase( connection.input.begin(), connection.input.begin() + static_cast< ptrdiff_t >( offset ) );
+    }
+    catch( const std::exception & )
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+bool LoadClient::IMPL::flush( Poller & poller, Connection & connection ) const
+{
+    while( connection.written < connection.output.size() )
+    {
+        ssize_t n = send( connection.fd, connection.output.data() + connection.written, connection.output.size() - connection.written, sendFlags );
+        
+        if( n < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            
+            if( errno != EAGAIN && errno != EWOULDBLOCK )
+            {
+                return false;
+            }
+            
+            if( connection.writing == false )
+            {
+                connection.writing = true;
+                
+                poller.modify( connection.fd, true );
+            }
+            
+            return true;
+        }
+        
+        connection.written += static_cast< size_t >( n );
+    }
+    
+    connection.output.clear();
+    
+    connection.written = 0;
+    
+    if( connection.writing )
+    {
+        connection.writing = false;
+        
+        poller.modify( connection.fd, false );
+    }
+    
+    return true;
+}
@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SERVER_LOAD_CLIENT_HPP
+#define SRPXX_SERVER_LOAD_CLIENT_HPP
+
+#include <SRPXX.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*
+ * Opens many connections to an AuthServer on 127.0.0.1 and runs handshakes
+ * back to back on each of them.
+ * Latency is measured from sending Hello to receiving the server proof, so it includes
+ * the client's own steps, framing and syscalls.
+ */
+class LoadClient
+{
+    public:
+        
+        struct Report
+        {
+            uint64_t                  handshakes;
+            uint64_t                  failures;
+            std::chrono::nanoseconds  elapsed;
+            std::chrono::nanoseconds  p50;
+            std::chrono::nanoseconds  p90;
+            std::chrono::nanoseconds  p99;
+            std::chrono::nanoseconds  p999;
+            std::chrono::nanoseconds  max;
+        };
+        
+        /* Zero threads uses one per core, up to the number of connections */
+        LoadClient( SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, uint16_t port, size_t connections, size_t handshakes, size_t threads = 0 );
+        ~LoadClient();
+        
+        LoadClient( const LoadClient & o )              = delete;
+        LoadClient & operator =( const LoadClient & o ) = delete;
+        
+        /* Handshakes are per connection */
+        Report run();
+        
+    private:
+        
+        class IMPL;
+        
+        std::unique_ptr< IMPL > impl;
+};
+
+#endif /* SRPXX_SERVER_LOAD_CLIENT_HPP */
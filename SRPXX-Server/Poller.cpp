@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Poller.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <sys/event.h>
+#else
+#include <sys/epoll.h>
+#endif
+
+namespace
+{
+    constexpr size_t maxEvents = 256;
+    
+    void check( int result, const char * what )
+    {
+        if( result < 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), what );
+        }
+    }
+}
+
+#ifdef __APPLE__
+
+Poller::Poller():
+    _fd( kqueue() )
+{
+    check( this->_fd, "kqueue" );
+}
+
+void Poller::add( int fd, bool write )
+{
+    struct kevent changes[ 2 ];
+    
+    EV_SET( &( changes[ 0 ] ), fd, EVFILT_READ,  EV_ADD,                               0, 0, nullptr );
+    EV_SET( &( changes[ 1 ] ), fd, EVFILT_WRITE, EV_ADD | ( write ? 0 : EV_DISABLE ),  0, 0, nullptr );
+    
+    check( kevent( this->_fd, changes, 2, nullptr, 0, nullptr ), "kevent" );
+}
+
+void Poller::modify( int fd, bool write )
+{
+    struct kevent change;
+    
+    EV_SET( &change, fd, EVFILT_WRITE, write ? EV_ENABLE : EV_DISABLE, 0, 0, nullptr );
+    
+    check( kevent( this->_fd, &change, 1, nullptr, 0, nullptr ), "kevent" );
+}
+
+void Poller::remove( int fd )
+{
+    struct kevent changes[ 2 ];
+    
+    EV_SET( &( changes[ 0 ] ), fd, EVFILT_READ,  EV_DELETE, 0, 0, nullptr );
+    EV_SET( &( changes[ 1 ] ), fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr );
+    
+    /* Closed descriptors are already removed */
+    kevent( this->_fd, changes, 2, nullptr, 0, nullptr );
+}
+
+size_t Poller::wait( std::vector< Event > & events, int timeout )
+{
+    struct kevent   received[ maxEvents ];
+    struct timespec ts { timeout / 1000, ( timeout % 1000 ) * 1000000 };
+    int             n = kevent( this->_fd, nullptr, 0, received, static_cast< int >( maxEvents ), ( timeout < 0 ) ? nullptr : &ts );
+    
+    events.clear();
+    
+    if( n < 0 && errno == EINTR )
+    {
+        return 0;
+    }
+    
+    check( n, "kevent" );
+    
+    for( int i = 0; i < n; i++ )
+    {
+        int fd = static_cast< int >( received[ i ].ident );
+        
+        events.push_back( { fd, received[ i ].filter == EVFILT_READ, received[ i ].filter == EVFILT_WRITE, ( received[ i ].flags & ( EV_EOF | EV_ERROR ) ) != 0 } );
+    }
+    
+    return events.size();
+}
+
+#else
+
+Poller::Poller():
+    _fd( epoll_create1( EPOLL_CLOEXEC ) )
+{
+    check( this->_fd, "epoll_create1" );
+}
+
+void Poller::add( int fd, bool write )
+{
+    struct epoll_event event {};
+    
+    event.events  = EPOLLIN | ( write ? EPOLLOUT : 0u );
+    event.data.fd = fd;
+    
+    check( epoll_ctl( this->_fd, EPOLL_CTL_ADD, fd, &event ), "epoll_ctl" );
+}
+
+void Poller::modify( int fd, bool write )
+{
+    struct epoll_event event {};
+    
+    event.events  = EPOLLIN | ( write ? EPOLLOUT : 0u );
+    event.data.fd = fd;
+    
+    check( epoll_ctl( this->_fd, EPOLL_CTL_MOD, fd, &event ), "epoll_ctl" );
+}
+
+void Poller::remove( int fd )
+{
+    epoll_ctl( this->_fd, EPOLL_CTL_DEL, fd, nullptr );
+}
+
+size_t Poller::wait( std::vector< Event > & events, int timeout )
+{
+    struct epoll_event received[ maxEvents ];
+    int                n = epoll_wait( this->_fd, received, static_cast< int >( maxEvents ), timeout );
+    
+    events.clear();
+    
+    if( n < 0 && errno == EINTR )
+    {
+        return 0;
+    }
+    
+    check( n, "epoll_wait" );
+    
+    for( int i = 0; i < n; i++ )
+    {
+        uint32_t flags = received[ i ].events;
+        
+        events.push_back( { received[ i ].data.fd, ( flags & EPOLLIN ) != 0, ( flags & EPOLLOUT ) != 0, ( flags & ( EPOLLERR | EPOLLHUP ) ) != 0 } );
+    }
+    
+    return events.size();
+}
+
+#endif
+
+Poller::~Poller()
+{
+    close( this->_fd );
+}
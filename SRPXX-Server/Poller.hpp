@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SERVER_POLLER_HPP
+#define SRPXX_SERVER_POLLER_HPP
+
+#include <cstddef>
+#include <vector>
+
+/* Readiness notifications for non-blocking descriptors - epoll on Linux, kqueue on Apple platforms */
+class Poller
+{
+    public:
+        
+        struct Event
+        {
+            int  fd;
+            bool readable;
+            bool writable;
+            bool closed;
+        };
+        
+        Poller();
+        ~Poller();
+        
+        Poller( const Poller & o )              = delete;
+        Poller & operator =( const Poller & o ) = delete;
+        
+        /* Descriptors are always watched for reading */
+        void add(    int fd, bool write = false );
+        void modify( int fd, bool write );
+        void remove( int fd );
+        
+        /* Negative timeout waits forever - Returns the number of events */
+        size_t wait( std::vector< Event > & events, int timeout );
+        
+    private:
+        
+        int _fd;
+};
+
+#endif /* SRPXX_SERVER_POLLER_HPP */
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "Socket.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace
+{
+    int check( int result, const char * what )
+    {
+        if( result < 0 )
+        {
+            throw std::system_error( errno, std::generic_category(), what );
+        }
+        
+        return result;
+    }
+    
+    int configure( int fd )
+    {
+        int one = 1;
+        
+        if( fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK ) < 0
+        ||  setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) ) < 0 )
+        {
+            int error = errno;
+            
+            close( fd );
+            
+            throw std::system_error( error, std::generic_category(), "fcntl" );
+        }
+        
+        #ifdef __APPLE__
+        setsockopt( fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof( one ) );
+        #endif
+        
+        return fd;
+    }
+    
+    struct sockaddr_in loopback( uint16_t port )
+    {
+        struct sockaddr_in address {};
+        
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons( port );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        
+        return address;
+    }
+}
+
+namespace Socket
+{
+    int listenLoopback( uint16_t port )
+    {
+        int                fd      = check( socket( AF_INET, SOCK_STREAM, 0 ), "socket" );
+        int                one     = 1;
+        struct sockaddr_in address = loopback( port );
+        
+        setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+        
+        if( bind( fd, reinterpret_cast< struct sockaddr * >( &address ), sizeof( address ) ) < 0 || listen( fd, SOMAXCONN ) < 0 )
+        {
+            int error = errno;
+            
+            close( fd );
+            
+            throw std::system_error( error, std::generic_category(), "bind" );
+        }
+        
+        return configure( fd );
+    }
+    
+    int accept( int fd )
+    {
+        int client = ::accept( fd, nullptr, nullptr );
+        
+        if( client < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED || errno == EINTR ) )
+        {
+            return -1;
+        }
+        
+        return configure( check( client, "accept" ) );
+    }
+    
+    /* Blocking connect - Only the exchange is non-blocking */
+    int connectLoopback( uint16_t port )
+    {
+        int                fd      = check( socket( AF_INET, SOCK_STREAM, 0 ), "socket" );
+        struct sockaddr_in address = loopback( port );
+        
+        if( connect( fd, reinterpret_cast< struct sockaddr * >( &address ), sizeof( address ) ) < 0 )
+        {
+            int error = errno;
+            
+            close( fd );
+            
+            throw std::system_error( error, std::generic_category(), "connect" );
+        }
+        
+        return configure( fd );
+    }
+}
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <csignal>
+#include <cstdlib>
+#include <SRPXX.hpp>
+#include "Arguments.hpp"
+#include "AuthServer.hpp"
+#include "LoadClient.hpp"
+
+static AuthServer * runningServer = nullptr;
+
+static void        handleSignal( int signal );
+static std::string stringFromDuration( std::chrono::nanoseconds duration );
+static void        printReport( const LoadClient::Report & report );
+
+int main( int argc, const char * argv[] )
+{
+    /* Peers closing early must not kill the process */
+    signal( SIGPIPE, SIG_IGN );
+    
+    try
+    {
+        Arguments args( argc, argv );
+        
+        if( args.command() == Arguments::Command::Server )
+        {
+            AuthServer server( args.hashAlgorithm(), args.groupType(), args.port(), args.threads() );
+            
+            runningServer = &server;
+            
+            signal( SIGINT,  handleSignal );
+            signal( SIGTERM, handleSignal );
+            
+            std::cout << "Listening on 127.0.0.1:" << args.port() << std::endl;
+            
+            server.run();
+            
+            runningServer = nullptr;
+            
+            AuthServer::Stats stats = server.stats();
+            
+            std::cout << "Connections: " << stats.connections << std::endl;
+            std::cout << "Handshakes:  " << stats.handshakes  << std::endl;
+            std::cout << "Rejected:    " << stats.rejected    << std::endl;
+        }
+        else if( args.command() == Arguments::Command::Client )
+        {
+            LoadClient client( args.hashAlgorithm(), args.groupType(), args.port(), args.connections(), args.handshakes(), args.threads() );
+            
+            printReport( client.run() );
+        }
+        else
+        {
+            /* Server and client share the cores - Each gets half */
+            size_t      threads = std::max< size_t >( 1, std::thread::hardware_concurrency() / 2 );
+            AuthServer  server( args.hashAlgorithm(), args.groupType(), args.port(), threads );
+            std::thread reactor( [ & ] { server.run(); } );
+            
+            LoadClient::Report report;
+            
+            try
+            {
+                LoadClient client( args.hashAlgorithm(), args.groupType(), args.port(), args.connections(), args.handshakes(), threads );
+                
+                report = client.run();
+            }
+            catch( ... )
+            {
+                server.stop();
+                reactor.join();
+                
+                throw;
+            }
+            
+            server.stop();
+            reactor.join();
+            printReport( report );
+        }
+    }
+    catch( const std::exception & e )
+    {
+        std::cout << e.what() << std::endl;
+        
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+static void handleSignal( int signal )
+{
+    ( void )signal;
+    
+    if( runningServer != nullptr )
+    {
+        runningServer->stop();
+    }
+}
+
+static std::string stringFromDuration( std::chrono::nanoseconds duration )
+{
+    std::stringstream ss;
+    
+    ss << std::fixed << std::setprecision( 3 ) << static_cast< double >( duration.count() ) / 1000000.0 << " ms";
+    
+    return ss.str();
+}
+
+static void printReport( const LoadClient::Report & report )
+{
+    double seconds = static_cast< double >( report.elapsed.count() ) / 1000000000.0;
+    
+    std::cout << "Handshakes: " << report.handshakes                      << std::endl;
+    std::cout << "Failures:   " << report.failures                        << std::endl;
+    std::cout << "Elapsed:    " << stringFromDuration( report.elapsed )   << std::endl;
+    
+    if( report.handshakes == 0 || seconds <= 0 )
+    {
+        return;
+    }
+    
+    std::cout << "Throughput: " << std::fixed << std::setprecision( 1 ) << static_cast< double >( report.handshakes ) / seconds << " handshakes/s" << std::endl;
+    std::cout << "p50:        " << stringFromDuration( report.p50 )  << std::endl;
+    std::cout << "p90:        " << stringFromDuration( report.p90 )  << std::endl;
+    std::cout << "p99:        " << stringFromDuration( report.p99 )  << std::endl;
+    std::cout << "p99.9:      " << stringFromDuration( report.p999 ) << std::endl;
+    std::cout << "max:        " << stringFromDuration( report.max )  << std::endl;
+}
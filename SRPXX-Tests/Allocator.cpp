@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+
+namespace
+{
+    class CountingAllocator: public SRP::Allocator
+    {
+        public:
+            
+            void * allocate( size_t size ) override
+            {
+                this->allocations++;
+                
+                return SRP::Allocator::defaultAllocator().allocate( size );
+            }
+            
+            void * reallocate( void * p, size_t size ) override
+            {
+                return SRP::Allocator::defaultAllocator().reallocate( p, size );
+            }
+            
+            void deallocate( void * p ) override
+            {
+                this->deallocations++;
+                
+                SRP::Allocator::defaultAllocator().deallocate( p );
+            }
+            
+            size_t allocations   = 0;
+            size_t deallocations = 0;
+    };
+}
+
+XSTest( Allocator, DefaultAllocator )
+{
+    SRP::Allocator & allocator = SRP::Allocator::defaultAllocator();
+    void           * p         = allocator.allocate( 42 );
+    
+    XSTestAssertTrue( p != nullptr );
+    
+    p = allocator.reallocate( p, 4242 );
+    
+    XSTestAssertTrue( p != nullptr );
+    
+    allocator.deallocate( p );
+    
+    XSTestAssertTrue( &( SRP::Allocator::current() ) == &allocator );
+}
+
+XSTest( Allocator, SetCurrent )
+{
+    CountingAllocator allocator;
+    
+    SRP::Allocator::setCurrent( allocator );
+    XSTestAssertTrue( &( SRP::Allocator::current() ) == &allocator );
+    SRP::Allocator::setCurrent( SRP::Allocator::defaultAllocator() );
+    XSTestAssertTrue( &( SRP::Allocator::current() ) == &( SRP::Allocator::defaultAllocator() ) );
+}
+
+XSTest( Allocator, BigNum )
+{
+    CountingAllocator allocator;
+    
+    SRP::Allocator::setCurrent( allocator );
+    
+    {
+        SRP::BigNum n1( 42 );
+        SRP::BigNum n2( n1 );
+        
+        XSTestAssertEqual( allocator.allocations, static_cast< size_t >( 2 ) );
+        
+        /* Released through the allocator that provided the memory */
+        SRP::Allocator::setCurrent( SRP::Allocator::defaultAllocator() );
+    }
+    
+    XSTestAssertEqual( allocator.deallocations, static_cast< size_t >( 2 ) );
+}
+
+XSTest( Allocator, STLAllocator )
+{
+    CountingAllocator allocator;
+    
+    {
+        SRP::Vector< uint8_t > v( allocator );
+        
+        v.resize( 42 );
+        
+        XSTestAssertTrue( allocator.allocations > 0 );
+        XSTestAssertTrue( v.size() == 42 );
+    }
+    
+    XSTestAssertEqual( allocator.allocations, allocator.deallocations );
+    
+    XSTestAssertTrue(  SRP::STLAllocator< uint8_t >( allocator ) == SRP::STLAllocator< uint32_t >( allocator ) );
+    XSTestAssertFalse( SRP::STLAllocator< uint8_t >( allocator ) == SRP::STLAllocator< uint8_t >( SRP::Allocator::defaultAllocator() ) );
+}
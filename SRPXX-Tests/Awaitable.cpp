@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached           get_return_object()            { return {}; }
+            std::suspend_never initial_suspend()     noexcept { return {}; }
+            std::suspend_never final_suspend()       noexcept { return {}; }
+            void               return_void()                  {}
+            void               unhandled_exception()          { std::terminate(); }
+        };
+    };
+    
+    /* Stands for an event loop */
+    class Loop: public SRP::Executor
+    {
+        public:
+            
+            void post( Task task ) override
+            {
+                std::lock_guard< std::mutex > l( this->_mutex );
+                
+                this->_tasks.push_back( std::move( task ) );
+                this->_condition.notify_one();
+            }
+            
+            void runOne()
+            {
+                Task task;
+                
+                {
+                    std::unique_lock< std::mutex > l( this->_mutex );
+                    
+                    this->_condition.wait( l, [ this ] { return this->_tasks.empty() == false; } );
+                    
+                    task = std::move( this->_tasks.front() );
+                    
+                    this->_tasks.pop_front();
+                }
+                
+                task();
+            }
+            
+        private:
+            
+            std::mutex              _mutex;
+            std::condition_variable _condition;
+            std::deque< Task >      _tasks;
+    };
+    
+    Detached computeB( SRP::Server & server, SRP::Executor & executor, std::promise< SRP::BigNum > & result )
+    {
+        result.set_value( co_await server.computeB( executor ) );
+    }
+    
+    Detached verify( SRP::Server & server, std::vector< uint8_t > M1, std::promise< std::vector< uint8_t > > & result )
+    {
+        result.set_value( co_await server.verify( M1 ) );
+    }
+    
+    Detached computeM1( SRP::Client & client, SRP::Executor & executor, Loop & loop, std::thread::id & thread, std::vector< uint8_t > & result )
+    {
+        result = co_await client.computeM1( executor ).resumeOn( loop );
+        thread = std::this_thread::get_id();
+    }
+    
+    Detached fail( SRP::Executor & executor, std::promise< bool > & result )
+    {
+        try
+        {
+            co_await SRP::Awaitable< int >( [] () -> int { throw std::runtime_error( "error" ); }, executor );
+            
+            result.set_value( false );
+        }
+        catch( const std::runtime_error & )
+        {
+            result.set_value( true );
+        }
+    }
+}
+
+XSTest( Awaitable, ComputeB )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                        server = test.makeServer();
+        std::promise< SRP::BigNum > result;
+        
+        server->setV( test.v() );
+        computeB( *( server ), e, result );
+        
+        XSTestAssertTrue( result.get_future().get() == test.B() );
+    }
+}
+
+XSTest( Awaitable, Verify )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                                   server = test.makeServer();
+        std::promise< std::vector< uint8_t > > valid;
+        std::promise< std::vector< uint8_t > > invalid;
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        verify( *( server ), test.M1(), valid );
+        XSTestAssertTrue( valid.get_future().get() == test.M2() );
+        
+        verify( *( server ), {}, invalid );
+        XSTestAssertTrue( invalid.get_future().get().empty() );
+    }
+}
+
+XSTest( Awaitable, ResumeOn )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   client = test.makeClient();
+        Loop                   loop;
+        std::thread::id        thread;
+        std::vector< uint8_t > M1;
+        
+        client->setPassword( test.password() );
+        client->setSalt( test.salt() );
+        client->setB( test.B() );
+        
+        computeM1( *( client ), e, loop, thread, M1 );
+        loop.runOne();
+        
+        XSTestAssertTrue( M1 == test.M1() );
+        XSTestAssertTrue( thread == std::this_thread::get_id() );
+    }
+}
+
+XSTest( Awaitable, Exception )
+{
+    SRP::Engine          e( 1 );
+    std::promise< bool > result;
+    
+    fail( e, result );
+    
+    XSTestAssertTrue( result.get_future().get() );
+}
@@ -25,6 +25,10 @@
 #include <SRPXX.hpp>
 #include <XSTest/XSTest.hpp>
 #include "TestVectors.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 static std::string removeSpaces( std::string s );
 static std::string removeSpaces( std::string s )
@@ -60,12 +64,20 @@ class ConcreteBase: public SRP::Base
         
         SRP::BigNum S() const override
         {
+            this->_computations++;
+            
             return this->_test.S();
         }
         
+        size_t computations() const
+        {
+            return this->_computations;
+        }
+        
     private:
         
-        TestVectors _test;
+        TestVectors    _test;
+        mutable size_t _computations = 0;
 };
 
 XSTest( Base, u )
@@ -101,6 +113,81 @@ XSTest( Base, K )
     }
 }
 
+XSTest( Base, DeriveKeys )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        ConcreteBase           base( test );
+        std::vector< uint8_t > k1( 42 );
+        std::vector< uint8_t > k2( 20 );
+        std::vector< uint8_t > k3( 20 );
+        std::vector< uint8_t > k4( 20 );
+        
+        base.setSalt( test.salt() );
+        base.deriveKeys( { { "encryption", k1.data(), k1.size() }, { "mac", k2.data(), k2.size() } } );
+        base.deriveKeys( { { "encryption", k3.data(), k3.size() }, { "resumption", k4.data(), k4.size() } } );
+        
+        XSTestAssertTrue( base.computations() == 1 );
+        XSTestAssertTrue( std::equal( k3.begin(), k3.end(), k1.begin() ) );
+        XSTestAssertTrue( k2 != k3 );
+        XSTestAssertTrue( k2 != k4 );
+        
+        /* The cached PRK is dropped when the session changes */
+        base.setSalt( test.salt() );
+        base.deriveKeys( { { "mac", k3.data(), k3.size() } } );
+        
+        XSTestAssertTrue( base.computations() == 2 );
+        XSTestAssertTrue( k2 == k3 );
+        
+        XSTestAssertThrow( ( base.deriveKeys( { { "mac", k1.data(), 255 * test.K().size() + 1 } } ) ), std::runtime_error );
+    }
+    
+    /* RFC 5869 HKDF, with an empty salt and the label as info */
+    auto                   test = TestVectors::all().front();
+    ConcreteBase           base( test );
+    std::vector< uint8_t > k1( 42 );
+    std::vector< uint8_t > k2( 20 );
+    
+    base.deriveKeys( std::vector< SRP::Base::DerivedKey >{ { "encryption", k1.data(), k1.size() }, { "mac", k2.data(), k2.size() } } );
+    
+    XSTestAssertEqual( SRP::String::toHex( k1, SRP::String::HexFormat::Lowercase ), "febd994f85f84be8c6c3461f7c544d10abc1a68b4afea061c35d6592b9756abf57cbec752eeb8b347304" );
+    XSTestAssertEqual( SRP::String::toHex( k2, SRP::String::HexFormat::Lowercase ), "07edc6573b464a20c34b08ebab626058936baf59" );
+}
+
+XSTest( Base, DeriveKeysThreads )
+{
+    auto                   test = TestVectors::all().front();
+    ConcreteBase           base( test );
+    std::vector< uint8_t > expected( 32 );
+    
+    {
+        ConcreteBase reference( test );
+        
+        reference.deriveKeys( { { "encryption", expected.data(), expected.size() } } );
+    }
+    
+    /* The first calls race to extract the PRK, which is only computed once */
+    std::vector< std::vector< uint8_t > > keys( 8, std::vector< uint8_t >( 32 ) );
+    std::vector< std::thread >            threads;
+    
+    for( auto & key: keys )
+    {
+        threads.emplace_back( [ & ] { base.deriveKeys( { { "encryption", key.data(), key.size() } } ); } );
+    }
+    
+    for( auto & thread: threads )
+    {
+        thread.join();
+    }
+    
+    XSTestAssertTrue( base.computations() == 1 );
+    
+    for( const auto & key: keys )
+    {
+        XSTestAssertTrue( key == expected );
+    }
+}
+
 XSTest( Base, M1 )
 {
     for( const auto & test: TestVectors::all() )
@@ -429,6 +429,17 @@ XSTest( BigNum, OperatorLess )
     XSTestAssertTrue( SRP::BigNum( -42 ) < SRP::BigNum( 41 ) );
 }
 
+XSTest( BigNum, Compare )
+{
+    XSTestAssertEqual( SRP::BigNum( 42 ).compare( SRP::BigNum( 42 ) ),  0 );
+    XSTestAssertEqual( SRP::BigNum( 41 ).compare( SRP::BigNum( 42 ) ), -1 );
+    XSTestAssertEqual( SRP::BigNum( 42 ).compare( SRP::BigNum( 41 ) ),  1 );
+    
+    XSTestAssertEqual( SRP::BigNum( -42 ).compare( SRP::BigNum( 42 ) ), -1 );
+    XSTestAssertEqual( SRP::BigNum( 42 ).compare( SRP::BigNum( -42 ) ),  1 );
+    XSTestAssertEqual( SRP::BigNum( -42 ).compare( SRP::BigNum( -41 ) ), -1 );
+}
+
 XSTest( BigNum, OperatorPrefixIncrement )
 {
     for( int64_t i = INT8_MIN; i <= INT8_MAX; i++ )
@@ -713,17 +724,138 @@ XSTest( BigNum, OperatorExp )
 
 XSTest( BigNum, ModExp )
 {
-    // TODO: Implement test...
+    SRP::BigNum n( 4 );
+    
+    XSTestAssertTrue( n.modExp( 13, 497 ) == 445 );
+    XSTestAssertTrue( n == 4 );
+    XSTestAssertTrue( SRP::BigNum( 4 ).modExp( 13, 497 ) == 445 );
+    XSTestAssertTrue( SRP::BigNum( 3 ).modExp( 200, 50 ) == 1 );
 }
 
 XSTest( BigNum, ModAdd )
 {
-    // TODO: Implement test...
+    SRP::BigNum n( 40 );
+    
+    XSTestAssertTrue( n.modAdd( 5, 42 ) == 3 );
+    XSTestAssertTrue( n == 40 );
+    XSTestAssertTrue( SRP::BigNum( 40 ).modAdd( 1, 42 ) == 41 );
+}
+
+XSTest( BigNum, ModSub )
+{
+    SRP::BigNum n( 3 );
+    
+    XSTestAssertTrue( n.modSub( 5, 42 ) == 40 );
+    XSTestAssertTrue( n == 3 );
+    XSTestAssertTrue( SRP::BigNum( 10 ).modSub( 3, 42 ) == 7 );
 }
 
 XSTest( BigNum, ModMul )
 {
-    // TODO: Implement test...
+    SRP::BigNum n( 12 );
+    
+    XSTestAssertTrue( n.modMul( 5, 42 ) == 18 );
+    XSTestAssertTrue( n == 12 );
+    XSTestAssertTrue( SRP::BigNum( 6 ).modMul( 7, 42 ) == 0 );
+}
+
+XSTest( BigNum, ModExpInPlace )
+{
+    SRP::BigNum n( 4 );
+    
+    XSTestAssertTrue( &( n.modExpInPlace( 13, 497 ) ) == &n );
+    XSTestAssertTrue( n == 445 );
+}
+
+XSTest( BigNum, ModAddInPlace )
+{
+    SRP::BigNum n( 40 );
+    
+    XSTestAssertTrue( &( n.modAddInPlace( 5, 42 ) ) == &n );
+    XSTestAssertTrue( n == 3 );
+}
+
+XSTest( BigNum, ModSubInPlace )
+{
+    SRP::BigNum n( 3 );
+    
+    XSTestAssertTrue( &( n.modSubInPlace( 5, 42 ) ) == &n );
+    XSTestAssertTrue( n == 40 );
+}
+
+XSTest( BigNum, ModMulInPlace )
+{
+    SRP::BigNum n( 12 );
+    
+    XSTestAssertTrue( &( n.modMulInPlace( 5, 42 ) ) == &n );
+    XSTestAssertTrue( n == 18 );
+}
+
+XSTest( BigNum, ModInvalidModulus )
+{
+    SRP::BigNum n( 12 );
+    
+    XSTestAssertThrow( n.modExpInPlace( 5, 0 ), std::runtime_error );
+    XSTestAssertThrow( n.modAddInPlace( 5, 0 ), std::runtime_error );
+    XSTestAssertThrow( n.modSubInPlace( 5, 0 ), std::runtime_error );
+    XSTestAssertThrow( n.modMulInPlace( 5, 0 ), std::runtime_error );
+    XSTestAssertThrow( n.modExp( 5, 0 ),        std::runtime_error );
+    XSTestAssertThrow( n.modMul( 5, 0 ),        std::runtime_error );
+}
+
+XSTest( BigNum, ModSubMulExp )
+{
+    SRP::BigNum a( 5 );
+    SRP::BigNum k( 3 );
+    SRP::BigNum g( 2 );
+    SRP::BigNum x( 10 );
+    SRP::BigNum N( 1019 );
+    SRP::BigNum r( ( a - ( k * g.modExp( x, N ) ) ) % N );
+    
+    if( r.isNegative() )
+    {
+        r += N;
+    }
+    
+    XSTestAssertTrue( SRP::BigNum::modSubMulExp( a, k, g, x, N ) == r );
+    XSTestAssertTrue( SRP::BigNum::modSubMulExp( 1000, 1, 2, 3, N ) == 992 );
+}
+
+XSTest( BigNum, ModMulAddExp )
+{
+    SRP::BigNum k( 3 );
+    SRP::BigNum v( 500 );
+    SRP::BigNum g( 2 );
+    SRP::BigNum b( 10 );
+    SRP::BigNum N( 1019 );
+    
+    XSTestAssertTrue( SRP::BigNum::modMulAddExp( k, v, g, b, N ) == k.modMul( v, N ).modAdd( g.modExp( b, N ), N ) );
+    XSTestAssertTrue( SRP::BigNum::modMulAddExp( 1, 1018, 2, 1, N ) == 1 );
+}
+
+XSTest( BigNum, RValueOperators )
+{
+    SRP::BigNum n1( 40 );
+    SRP::BigNum n2( 2 );
+    
+    XSTestAssertTrue( ( std::move( n1 ) + n2 ) == 42 );
+    XSTestAssertTrue( ( SRP::BigNum( 44 ) - n2 ) == 42 );
+    XSTestAssertTrue( ( SRP::BigNum( 21 ) * n2 ) == 42 );
+    XSTestAssertTrue( ( SRP::BigNum( 84 ) / n2 ) == 42 );
+    XSTestAssertTrue( ( SRP::BigNum( 85 ) % n2 ) == 1 );
+    XSTestAssertTrue( ( SRP::BigNum( 9 ) ^ n2 ) == 81 );
+    XSTestAssertTrue( n2 == 2 );
+}
+
+XSTest( BigNum, MakeSecret )
+{
+    SRP::BigNum n( 42 );
+    
+    XSTestAssertFalse( n.isSecret() );
+    XSTestAssertTrue( &( n.makeSecret() ) == &n );
+    XSTestAssertTrue( n.isSecret() );
+    XSTestAssertTrue( n == 42 );
+    XSTestAssertTrue( SRP::BigNum( n ).isSecret() );
 }
 
 XSTest( BigNum, ToString )
@@ -769,6 +901,18 @@ XSTest( BigNum, GetBytes_LittleEndian )
     XSTestAssertTrue( n1.bytes( SRP::BigNum::Endianness::LittleEndian ) == std::vector< uint8_t >( { 0xFF, 0x42 } ) );
 }
 
+XSTest( BigNum, GetBytes_Padded )
+{
+    SRP::BigNum n1( { 0x42, 0xFF }, SRP::BigNum::Endianness::BigEndian );
+    uint8_t     bytes[ 4 ] = { 1, 1, 1, 1 };
+    
+    XSTestAssertTrue( n1.bytes( bytes, 4 ) );
+    XSTestAssertTrue( std::vector< uint8_t >( bytes, bytes + 4 ) == std::vector< uint8_t >( { 0x00, 0x00, 0x42, 0xFF } ) );
+    XSTestAssertTrue( n1.bytes( bytes, 2 ) );
+    XSTestAssertTrue( std::vector< uint8_t >( bytes, bytes + 2 ) == std::vector< uint8_t >( { 0x42, 0xFF } ) );
+    XSTestAssertFalse( n1.bytes( bytes, 1 ) );
+}
+
 XSTest( BigNum, Negative )
 {
     SRP::BigNum n1( 42 );
@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+
+XSTest( BigNumView, Data )
+{
+    std::vector< uint8_t > bytes = { 0x00, 0x00, 0x01, 0x02 };
+    SRP::BigNumView        view( bytes );
+    
+    XSTestAssertTrue( view.size() == 2 );
+    XSTestAssertTrue( view.data() == bytes.data() + 2 );
+    XSTestAssertTrue( view.bytes() == std::vector< uint8_t >( { 0x01, 0x02 } ) );
+    XSTestAssertTrue( SRP::BigNum( view ) == 0x0102 );
+}
+
+XSTest( BigNumView, IsZero )
+{
+    std::vector< uint8_t > zero    = { 0x00, 0x00 };
+    std::vector< uint8_t > nonZero = { 0x00, 0x01 };
+    
+    XSTestAssertTrue(  SRP::BigNumView().isZero() );
+    XSTestAssertTrue(  SRP::BigNumView( zero ).isZero() );
+    XSTestAssertFalse( SRP::BigNumView( nonZero ).isZero() );
+}
+
+XSTest( BigNumView, Compare )
+{
+    std::vector< uint8_t > bytes = { 0x00, 0x01, 0x00 };
+    SRP::BigNumView        view( bytes );
+    
+    XSTestAssertTrue( view.compare( SRP::BigNum( 0xFF ) )    ==  1 );
+    XSTestAssertTrue( view.compare( SRP::BigNum( 0x100 ) )   ==  0 );
+    XSTestAssertTrue( view.compare( SRP::BigNum( 0x101 ) )   == -1 );
+    XSTestAssertTrue( view.compare( SRP::BigNum( 0x10000 ) ) == -1 );
+    XSTestAssertTrue( view.compare( SRP::BigNum( -1 ) )      ==  1 );
+    XSTestAssertTrue( SRP::BigNumView().compare( SRP::BigNum() ) == 0 );
+}
+
+XSTest( BigNumView, IsValidModulo )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   server = test.makeServer();
+        SRP::BigNum            N      = server->N();
+        std::vector< uint8_t > A      = test.A().bytes( SRP::BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > n      = N.bytes( SRP::BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > n2     = ( N * 2 ).bytes( SRP::BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > n1     = ( N + 1 ).bytes( SRP::BigNum::Endianness::BigEndian );
+        
+        XSTestAssertTrue(  SRP::BigNumView( A ).isValidModulo( N ) );
+        XSTestAssertFalse( SRP::BigNumView().isValidModulo( N ) );
+        XSTestAssertFalse( SRP::BigNumView( n ).isValidModulo( N ) );
+        XSTestAssertFalse( SRP::BigNumView( n2 ).isValidModulo( N ) );
+        XSTestAssertTrue(  SRP::BigNumView( n1 ).isValidModulo( N ) );
+        XSTestAssertTrue(  server->isValidPublicValue( SRP::BigNumView( A ) ) );
+        XSTestAssertFalse( server->isValidPublicValue( SRP::BigNumView( n ) ) );
+    }
+}
+
+XSTest( BigNumView, ModExp )
+{
+    std::vector< uint8_t > bytes = { 0x03 };
+    SRP::BigNumView        view( bytes );
+    
+    XSTestAssertTrue( view.modExp( 4, 7 )  == SRP::BigNum( 3 ).modExp( 4, 7 ) );
+    XSTestAssertTrue( view.modExp( 4, 10 ) == SRP::BigNum( 3 ).modExp( 4, 10 ) );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   client = test.makeClient();
+        std::vector< uint8_t > g      = client->g().bytes( SRP::BigNum::Endianness::BigEndian );
+        
+        XSTestAssertTrue( SRP::BigNumView( g ).modExp( test.a(), client->N() ) == test.A() );
+    }
+}
+
+XSTest( BigNumView, Assign )
+{
+    std::vector< uint8_t > bytes = { 0x01, 0x00 };
+    SRP::BigNum            n( 42 );
+    
+    n.assign( SRP::BigNumView( bytes ) );
+    XSTestAssertTrue( n == 0x100 );
+    
+    n.assign( SRP::BigNumView() );
+    XSTestAssertTrue( n == 0 );
+}
+
+XSTest( BigNumView, ServerSetA )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   server = test.makeServer();
+        std::vector< uint8_t > A      = test.A().bytes( SRP::BigNum::Endianness::BigEndian );
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( SRP::BigNumView( A ) );
+        
+        XSTestAssertTrue( server->A() == test.A() );
+        XSTestAssertTrue( server->S() == test.S() );
+    }
+}
+
+XSTest( BigNumView, ClientSetB )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   client = test.makeClient();
+        std::vector< uint8_t > B      = test.B().bytes( SRP::BigNum::Endianness::BigEndian );
+        
+        client->setSalt( test.salt() );
+        client->setPassword( test.password() );
+        client->setB( SRP::BigNumView( B ) );
+        
+        XSTestAssertTrue( client->B() == test.B() );
+        XSTestAssertTrue( client->S() == test.S() );
+    }
+}
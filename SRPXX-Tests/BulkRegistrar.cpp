@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <string>
+#include <vector>
+
+XSTest( BulkRegistrar, Generate )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        SRP::BulkRegistrar registrar( test.hashAlgorithm(), test.groupType() );
+        auto               registration = registrar.generate( { test.identity(), test.password() } );
+        SRP::Client        client( test.identity(), test.hashAlgorithm(), test.groupType() );
+        
+        client.setPassword( test.password() );
+        client.setSalt( registration.salt );
+        
+        XSTestAssertTrue( registration.identity == test.identity() );
+        XSTestAssertEqual( registration.salt.size(), registrar.saltLength() );
+        XSTestAssertTrue( registration.verifier == client.v().bytes( SRP::BigNum::Endianness::BigEndian ) );
+    }
+}
+
+XSTest( BulkRegistrar, Options )
+{
+    SRP::BulkRegistrar registrar( SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, 32, static_cast< uint64_t >( SRP::Client::Options::NoUsernameInX ) );
+    auto               registration = registrar.generate( { "alice", "password123" } );
+    SRP::Client        client( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    client.addOption( SRP::Client::Options::NoUsernameInX );
+    client.setPassword( "password123" );
+    client.setSalt( registration.salt );
+    
+    XSTestAssertEqual( registration.salt.size(), static_cast< size_t >( 32 ) );
+    XSTestAssertTrue( registration.verifier == client.v().bytes( SRP::BigNum::Endianness::BigEndian ) );
+}
+
+XSTest( BulkRegistrar, Batch )
+{
+    SRP::Engine                                    engine( 4 );
+    SRP::BulkRegistrar                             registrar( SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG3072 );
+    std::vector< SRP::BulkRegistrar::Credentials > credentials;
+    
+    for( size_t i = 0; i < 100; i++ )
+    {
+        credentials.push_back( { "user" + std::to_string( i ), "password" + std::to_string( i ) } );
+    }
+    
+    auto registrations = registrar.generate( credentials, engine );
+    
+    XSTestAssertEqual( registrations.size(), credentials.size() );
+    XSTestAssertTrue( registrar.generate( {}, engine ).empty() );
+    
+    for( size_t i = 0; i < credentials.size(); i++ )
+    {
+        SRP::Client client( credentials[ i ].identity, SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG3072 );
+        SRP::Server server( credentials[ i ].identity, SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG3072 );
+        
+        XSTestAssertTrue( registrations[ i ].identity == credentials[ i ].identity );
+        XSTestAssertTrue( i == 0 || registrations[ i ].salt != registrations[ i - 1 ].salt );
+        
+        server.setSalt( registrations[ i ].salt );
+        server.setV( SRP::BigNum( registrations[ i ].verifier, SRP::BigNum::Endianness::BigEndian ) );
+        server.setA( client.A() );
+        client.setB( server.B() );
+        client.setSalt( server.salt() );
+        client.setPassword( credentials[ i ].password );
+        
+        XSTestAssertTrue( client.M1() == server.M1() );
+    }
+}
@@ -218,3 +218,51 @@ XSTest( Client, HasOption )
         XSTestAssertFalse( client->hasOption( SRP::Client::Options::NoUsernameInX ) );
     }
 }
+
+XSTest( Client, Move )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto client = test.makeClient();
+        
+        client->setPassword( test.password() );
+        client->setSalt( test.salt() );
+        client->setB( test.B() );
+        
+        SRP::Client moved( test.identity(), test.hashAlgorithm(), test.groupType() );
+        
+        moved = std::move( *( client ) );
+        
+        XSTestAssertTrue( moved.S() == test.S() );
+        XSTestAssertTrue( moved.identity() == test.identity() );
+    }
+}
+
+XSTest( Client, Reset )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        SRP::Client client( "foo", test.hashAlgorithm(), test.groupType() );
+        
+        client.setPassword( "bar" );
+        client.setSalt( { 1, 2, 3 } );
+        client.setB( SRP::BigNum( 42 ) );
+        client.reset( test.identity(), test.a() );
+        
+        XSTestAssertTrue( client.identity() == test.identity() );
+        XSTestAssertTrue( client.salt().empty() );
+        XSTestAssertTrue( client.a() == test.a() );
+        XSTestAssertTrue( client.a().isSecret() );
+        XSTestAssertTrue( client.B() == SRP::BigNum() );
+        
+        client.setPassword( test.password() );
+        client.setSalt( test.salt() );
+        client.setB( test.B() );
+        XSTestAssertTrue( client.A() == test.A() );
+        XSTestAssertTrue( client.S() == test.S() );
+        XSTestAssertTrue( client.M1() == test.M1() );
+        
+        client.reset( test.identity() );
+        XSTestAssertTrue( client.a() != test.a() );
+    }
+}
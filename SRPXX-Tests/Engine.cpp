@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+XSTest( Engine, Threads )
+{
+    SRP::Engine e1( 3 );
+    SRP::Engine e2;
+    
+    XSTestAssertEqual( e1.threads(), static_cast< size_t >( 3 ) );
+    XSTestAssertTrue( e2.threads() > 0 );
+}
+
+XSTest( Engine, Submit )
+{
+    SRP::Engine e( 2 );
+    
+    auto f1 = e.submit( [] { return 42; } );
+    auto f2 = e.submit( [] () -> int { throw std::runtime_error( "error" ); } );
+    
+    XSTestAssertEqual( f1.get(), 42 );
+    XSTestAssertThrow( f2.get(), std::runtime_error );
+}
+
+XSTest( Engine, Post )
+{
+    std::atomic< size_t > count( 0 );
+    
+    {
+        SRP::Engine e( 4 );
+        
+        for( size_t i = 0; i < 10000; i++ )
+        {
+            e.post( [ & ] { count++; } );
+        }
+    }
+    
+    XSTestAssertEqual( count.load(), static_cast< size_t >( 10000 ) );
+}
+
+XSTest( Engine, PostFromWorker )
+{
+    std::atomic< size_t > count( 0 );
+    
+    {
+        SRP::Engine e( 4 );
+        
+        for( size_t i = 0; i < 100; i++ )
+        {
+            e.post
+            (
+                [ & ]
+                {
+                    for( size_t j = 0; j < 100; j++ )
+                    {
+                        e.post( [ & ] { count++; } );
+                    }
+                }
+            );
+        }
+    }
+    
+    XSTestAssertEqual( count.load(), static_cast< size_t >( 10000 ) );
+}
+
+XSTest( Engine, B )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setV( test.v() );
+        XSTestAssertTrue( e.B( *( server ) ).get() == test.B() );
+    }
+}
+
+XSTest( Engine, Keys )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto client = test.makeClient();
+        
+        client->setPassword( test.password() );
+        client->setSalt( test.salt() );
+        client->setB( test.B() );
+        
+        SRP::Engine::Keys keys = e.keys( *( client ) ).get();
+        
+        XSTestAssertTrue( keys.S  == test.S() );
+        XSTestAssertTrue( keys.K  == test.K() );
+        XSTestAssertTrue( keys.M1 == test.M1() );
+    }
+}
+
+XSTest( Engine, Verify )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        auto M1     = test.M1();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        XSTestAssertTrue( e.verify( *( server ), M1 ).get() == test.M2() );
+        
+        M1[ 0 ] ^= 1;
+        
+        XSTestAssertTrue( e.verify( *( server ), M1 ).get().empty() );
+        XSTestAssertTrue( e.verify( *( server ), {} ).get().empty() );
+    }
+}
+
+XSTest( Engine, Completion )
+{
+    SRP::Engine e( 2 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                 server = test.makeServer();
+        std::promise< bool > promise;
+        auto                 future = promise.get_future();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        e.verify
+        (
+            *( server ),
+            test.M1(),
+            [ & ]( std::vector< uint8_t > M2, std::exception_ptr error )
+            {
+                promise.set_value( error == nullptr && M2 == test.M2() );
+            }
+        );
+        
+        XSTestAssertTrue( future.get() );
+    }
+}
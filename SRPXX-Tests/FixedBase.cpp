@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <stdexcept>
+#include <vector>
+
+XSTest( FixedBase, ModExp )
+{
+    SRP::BigNum modulus = SRP::BigNum::random( 2048 );
+    SRP::BigNum base    = SRP::BigNum::random( 2000 );
+    
+    if( modulus.isEven() )
+    {
+        ++modulus;
+    }
+    
+    for( unsigned int window: { 1, 3, 4, 6 } )
+    {
+        SRP::FixedBase table( base, modulus, 256, window );
+        
+        XSTestAssertEqual( table.exponentBits(), 256U );
+        XSTestAssertTrue( table.memory() > 0 );
+        XSTestAssertTrue( table.modExp( SRP::BigNum( 0 ) ) == SRP::BigNum( 1 ) );
+        XSTestAssertTrue( table.modExp( SRP::BigNum( 1 ) ) == base );
+        
+        for( unsigned int bits: { 1, 7, 64, 255, 256 } )
+        {
+            SRP::BigNum exponent = SRP::BigNum::random( bits );
+            
+            XSTestAssertTrue( table.modExp( exponent ) == base.modExp( exponent, modulus ) );
+        }
+    }
+}
+
+XSTest( FixedBase, Groups )
+{
+    for( auto group: { SRP::Base::GroupType::NG1024, SRP::Base::GroupType::NG3072, SRP::Base::GroupType::NG8192 } )
+    {
+        SRP::Client    client( "alice", SRP::HashAlgorithm::SHA256, group );
+        SRP::FixedBase table( client.g(), client.N(), 256 );
+        SRP::BigNum    x = SRP::BigNum::random( 256 );
+        
+        XSTestAssertTrue( table.modExp( x ) == client.g().modExp( x, client.N() ) );
+    }
+}
+
+XSTest( FixedBase, Invalid )
+{
+    SRP::FixedBase table( SRP::BigNum( 2 ), SRP::BigNum( 1000003 ), 16 );
+    
+    XSTestAssertThrow( table.modExp( SRP::BigNum::random( 17 ) ),   std::runtime_error );
+    XSTestAssertThrow( table.modExp( SRP::BigNum( 1 ).negative() ), std::runtime_error );
+    XSTestAssertThrow( SRP::FixedBase( SRP::BigNum( 2 ), SRP::BigNum( 1000004 ), 16 ),    std::runtime_error );
+    XSTestAssertThrow( SRP::FixedBase( SRP::BigNum( 2 ), SRP::BigNum( 1000003 ), 16, 0 ), std::runtime_error );
+}
+
+XSTest( FixedBase, Table )
+{
+    SRP::Client            client( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    SRP::FixedBase         table( client.g(), client.N(), 256 );
+    std::vector< uint8_t > data = table.table();
+    SRP::FixedBase         mapped( client.g(), client.N(), 256, 4, data.data(), data.size() );
+    
+    XSTestAssertEqual( data.size(), table.memory() );
+    XSTestAssertTrue( mapped.table() == data );
+    XSTestAssertTrue( mapped.modExp( SRP::BigNum( 0 ) ) == SRP::BigNum( 1 ) );
+    XSTestAssertTrue( mapped.covers( SRP::BigNum::random( 256 ) ) );
+    XSTestAssertFalse( mapped.covers( SRP::BigNum::random( 257 ) ) );
+    
+    for( unsigned int bits: { 1, 64, 255, 256 } )
+    {
+        SRP::BigNum exponent = SRP::BigNum::random( bits );
+        
+        XSTestAssertTrue( mapped.modExp( exponent ) == table.modExp( exponent ) );
+    }
+    
+    XSTestAssertThrow( SRP::FixedBase( client.g(), client.N(), 256, 4, data.data(), data.size() - 1 ), std::runtime_error );
+    XSTestAssertThrow( SRP::FixedBase( client.g(), client.N(), 252, 4, data.data(), data.size() ),     std::runtime_error );
+    XSTestAssertThrow( SRP::FixedBase( SRP::BigNum( 5 ), client.N(), 256, 4, data.data(), data.size() ), std::runtime_error );
+}
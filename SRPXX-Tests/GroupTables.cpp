@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string tempPath( const std::string & name )
+    {
+        return ( std::filesystem::temp_directory_path() / ( "SRPXX-Tests-" + name ) ).string();
+    }
+    
+    std::vector< uint8_t > readFile( const std::string & path )
+    {
+        std::ifstream stream( path, std::ios::binary );
+        
+        return { std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() };
+    }
+    
+    void writeFile( const std::string & path, const std::vector< uint8_t > & data )
+    {
+        std::ofstream stream( path, std::ios::binary | std::ios::trunc );
+        
+        stream.write( reinterpret_cast< const char * >( data.data() ), static_cast< std::streamsize >( data.size() ) );
+    }
+    
+    /* Keeps the checksum valid, so only the content is wrong */
+    void updateChecksum( std::vector< uint8_t > & data )
+    {
+        std::vector< uint8_t > checksum = SRP::SHA256::bytes( data.data() + 64, data.size() - 64 );
+        
+        memcpy( data.data() + 32, checksum.data(), checksum.size() );
+    }
+}
+
+XSTest( GroupTables, Values )
+{
+    std::string path = tempPath( "GroupTables-Values" );
+    
+    SRP::GroupTables::write( path, { SRP::Base::GroupType::NG2048, SRP::Base::GroupType::NG1024, SRP::Base::GroupType::NG2048 } );
+    
+    {
+        SRP::GroupTables tables( path );
+        
+        XSTestAssertTrue(  tables.contains( SRP::Base::GroupType::NG1024 ) );
+        XSTestAssertTrue(  tables.contains( SRP::Base::GroupType::NG2048 ) );
+        XSTestAssertFalse( tables.contains( SRP::Base::GroupType::NG3072 ) );
+        XSTestAssertTrue(  tables.g( SRP::Base::GroupType::NG3072 )                                == nullptr );
+        XSTestAssertTrue(  tables.k( SRP::Base::GroupType::NG3072, SRP::HashAlgorithm::SHA256 ).data() == nullptr );
+        
+        for( auto group: { SRP::Base::GroupType::NG1024, SRP::Base::GroupType::NG2048 } )
+        {
+            for( auto hash: { SRP::HashAlgorithm::SHA1, SRP::HashAlgorithm::SHA224, SRP::HashAlgorithm::SHA256, SRP::HashAlgorithm::SHA384, SRP::HashAlgorithm::SHA512 } )
+            {
+                SRP::Client            client( "alice", hash, group );
+                std::vector< uint8_t > hn = client.hash( client.N().bytes( SRP::BigNum::Endianness::BigEndian ) );
+                std::vector< uint8_t > hg = client.hash( client.pad( client.g().bytes( SRP::BigNum::Endianness::BigEndian ) ) );
+                
+                for( size_t i = 0; i < hn.size(); i++ )
+                {
+                    hn[ i ] ^= hg[ i ];
+                }
+                
+                XSTestAssertTrue( tables.k( group, hash ).compare( client.k() ) == 0 );
+                XSTestAssertTrue( tables.hashNG( group, hash ) == hn );
+            }
+            
+            SRP::Client client( "alice", SRP::HashAlgorithm::SHA256, group );
+            SRP::BigNum x = SRP::BigNum::random( 256 );
+            
+            XSTestAssertTrue( tables.g( group )->modExp( x ) == client.g().modExp( x, client.N() ) );
+        }
+    }
+    
+    std::remove( path.c_str() );
+}
+
+XSTest( GroupTables, Install )
+{
+    std::string path = tempPath( "GroupTables-Install" );
+    
+    SRP::GroupTables::write( path, { SRP::Base::GroupType::NG1024, SRP::Base::GroupType::NG2048, SRP::Base::GroupType::NG4096 } );
+    SRP::GroupTables::install( std::make_shared< SRP::GroupTables >( path ) );
+    
+    /* Sessions keep the tables alive */
+    std::remove( path.c_str() );
+    
+    XSTestAssertTrue( SRP::GroupTables::installed() != nullptr );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto client = test.makeClient();
+        auto server = test.makeServer();
+        
+        client->setPassword( test.password() );
+        client->setSalt( test.salt() );
+        client->setB( test.B() );
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        server->setA( test.A() );
+        
+        XSTestAssertTrue( client->A()  == test.A() );
+        XSTestAssertTrue( client->v()  == test.v() );
+        XSTestAssertTrue( client->k()  == test.k() );
+        XSTestAssertTrue( client->M1() == test.M1() );
+        XSTestAssertTrue( server->B()  == test.B() );
+        XSTestAssertTrue( server->M2() == test.M2() );
+    }
+    
+    SRP::GroupTables::install( nullptr );
+    
+    XSTestAssertTrue( SRP::GroupTables::installed() == nullptr );
+}
+
+XSTest( GroupTables, Invalid )
+{
+    std::string path = tempPath( "GroupTables-Invalid" );
+    
+    SRP::GroupTables::write( path, { SRP::Base::GroupType::NG1024 } );
+    
+    std::vector< uint8_t > data = readFile( path );
+    
+    XSTestAssertThrow( SRP::GroupTables{ tempPath( "not-found" ) }, std::runtime_error );
+    
+    /* Corrupted table */
+    {
+        std::vector< uint8_t > copy = data;
+        
+        copy[ copy.size() - 100 ] ^= 1;
+        
+        writeFile( path, copy );
+        XSTestAssertThrow( SRP::GroupTables{ path }, std::runtime_error );
+    }
+    
+    /* Other version */
+    {
+        std::vector< uint8_t > copy = data;
+        
+        copy[ 8 ]++;
+        
+        writeFile( path, copy );
+        XSTestAssertThrow( SRP::GroupTables{ path }, std::runtime_error );
+    }
+    
+    /* Truncated */
+    {
+        std::vector< uint8_t > copy( data.begin(), data.end() - 64 );
+        
+        writeFile( path, copy );
+        XSTestAssertThrow( SRP::GroupTables{ path }, std::runtime_error );
+    }
+    
+    /* Valid checksum, but not the built-in N */
+    {
+        std::vector< uint8_t > copy = data;
+        
+        copy[ 128 + 10 ] ^= 1;
+        
+        updateChecksum( copy );
+        writeFile( path, copy );
+        XSTestAssertThrow( SRP::GroupTables{ path }, std::runtime_error );
+    }
+    
+    writeFile( path, data );
+    XSTestAssertTrue( SRP::GroupTables( path ).contains( SRP::Base::GroupType::NG1024 ) );
+    
+    std::remove( path.c_str() );
+}
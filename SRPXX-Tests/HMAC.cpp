@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <string>
+#include <vector>
+
+template< typename Hash >
+static std::string mac( const std::vector< uint8_t > & key, const std::string & message )
+{
+    SRP::HMAC< Hash > hmac( key );
+    
+    return SRP::String::toHex( hmac.mac( SRP::String::toBytes( message ) ), SRP::String::HexFormat::Lowercase );
+}
+
+/* RFC 2202 and RFC 4231, test cases 1 and 6 */
+XSTest( HMAC, Vectors )
+{
+    std::vector< uint8_t > k1( 20,  0x0B );
+    std::vector< uint8_t > k2( 131, 0xAA );
+    std::string            m1 = "Hi There";
+    std::string            m2 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    
+    XSTestAssertEqual( mac< SRP::SHA1   >( k1, m1 ), "b617318655057264e28bc0b6fb378c8ef146be00" );
+    XSTestAssertEqual( mac< SRP::SHA224 >( k1, m1 ), "896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22" );
+    XSTestAssertEqual( mac< SRP::SHA256 >( k1, m1 ), "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7" );
+    XSTestAssertEqual( mac< SRP::SHA384 >( k1, m1 ), "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6" );
+    XSTestAssertEqual( mac< SRP::SHA512 >( k1, m1 ), "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cdedaa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854" );
+    
+    XSTestAssertEqual( mac< SRP::SHA1   >( k2, m2 ), "90d0dace1c1bdc957339307803160335bde6df2b" );
+    XSTestAssertEqual( mac< SRP::SHA224 >( k2, m2 ), "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e" );
+    XSTestAssertEqual( mac< SRP::SHA256 >( k2, m2 ), "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54" );
+    XSTestAssertEqual( mac< SRP::SHA384 >( k2, m2 ), "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952" );
+    XSTestAssertEqual( mac< SRP::SHA512 >( k2, m2 ), "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598" );
+}
+
+XSTest( HMAC, Reuse )
+{
+    SRP::HMAC< SRP::SHA256 >              hmac( std::vector< uint8_t >( 32, 0x42 ) );
+    std::vector< std::vector< uint8_t > > messages = { { 1, 2, 3 }, {}, std::vector< uint8_t >( 1000, 0x07 ) };
+    std::vector< uint8_t >                batch( messages.size() * SRP::HMAC< SRP::SHA256 >::macSize );
+    
+    hmac.mac( messages, batch.data() );
+    
+    for( size_t i = 0; i < messages.size(); i++ )
+    {
+        std::vector< uint8_t > single = hmac.mac( messages[ i ] );
+        std::vector< uint8_t > parts( SRP::HMAC< SRP::SHA256 >::macSize );
+        
+        XSTestAssertTrue( std::equal( single.begin(), single.end(), batch.begin() + static_cast< ptrdiff_t >( i * single.size() ) ) );
+        
+        hmac.begin();
+        hmac.update( messages[ i ].data(), messages[ i ].size() / 2 );
+        hmac.update( messages[ i ].data() + messages[ i ].size() / 2, messages[ i ].size() - messages[ i ].size() / 2 );
+        hmac.finalize( parts.data() );
+        
+        XSTestAssertTrue( parts == single );
+        
+        SRP::HMAC< SRP::SHA256 > copy( hmac );
+        
+        XSTestAssertTrue( copy.mac( messages[ i ] ) == single );
+    }
+    
+    XSTestAssertTrue( hmac.mac( messages[ 0 ] ) != SRP::HMAC< SRP::SHA256 >( std::vector< uint8_t >( 32, 0x43 ) ).mac( messages[ 0 ] ) );
+}
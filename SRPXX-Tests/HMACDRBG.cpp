@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <string>
+#include <vector>
+
+static std::vector< uint8_t > bytes( const std::string & hex )
+{
+    std::vector< uint8_t > data;
+    
+    for( size_t i = 0; i < hex.size(); i += 2 )
+    {
+        data.push_back( static_cast< uint8_t >( std::stoul( hex.substr( i, 2 ), nullptr, 16 ) ) );
+    }
+    
+    return data;
+}
+
+/* NIST CAVP HMAC_DRBG, SHA-256, no prediction resistance, no reseed, COUNT = 0 */
+XSTest( HMACDRBG, SHA256 )
+{
+    SRP::HMACDRBG drbg
+    (
+        SRP::HashAlgorithm::SHA256,
+        bytes( "ca851911349384bffe89de1cbdc46e6831e44d34a4fb935ee285dd14b71a7488" ),
+        bytes( "659ba96c601dc69fc902940805ec0ca8" )
+    );
+    
+    drbg.generate( 128 );
+    
+    XSTestAssertEqual
+    (
+        SRP::String::toHex( drbg.generate( 128 ), SRP::String::HexFormat::Lowercase ),
+        "e528e9abf2dece54d47c7e75e5fe302149f817ea9fb4bee6f4199697d04d5b89"
+        "d54fbb978a15b5c443c9ec21036d2460b6f73ebad0dc2aba6e624abf07745bc1"
+        "07694bb7547bb0995f70de25d6b29e2d3011bb19d27676c07162c8b5ccde0668"
+        "961df86803482cb37ed6d5c0bb8d50cf1f50d476aa0458bdaba806f48be9dcb8"
+    );
+}
+
+XSTest( HMACDRBG, Deterministic )
+{
+    std::vector< uint8_t > entropy( 32, 0x42 );
+    std::vector< uint8_t > nonce( 16, 0x24 );
+    
+    SRP::HMACDRBG d1( SRP::HashAlgorithm::SHA512, entropy, nonce, { 1, 2, 3 } );
+    SRP::HMACDRBG d2( SRP::HashAlgorithm::SHA512, entropy, nonce, { 1, 2, 3 } );
+    SRP::HMACDRBG d3( SRP::HashAlgorithm::SHA512, entropy, nonce, { 1, 2, 4 } );
+    
+    std::vector< uint8_t > r1 = d1.generate( 100 );
+    std::vector< uint8_t > r2 = d2.generate( 100 );
+    
+    XSTestAssertTrue( r1 == r2 );
+    XSTestAssertTrue( r1 != d3.generate( 100 ) );
+    XSTestAssertTrue( r1 != d1.generate( 100 ) );
+    
+    d1.reseed( entropy );
+    d2.reseed( entropy, { 5 } );
+    
+    XSTestAssertTrue( d1.generate( 32 ) != d2.generate( 32 ) );
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+XSTest( KeyRing, Rotate )
+{
+    SRP::KeyRing ring( 2 );
+    uint8_t      k1[ SRP::KeyRing::keyLength ];
+    uint8_t      k2[ SRP::KeyRing::keyLength ];
+    
+    XSTestAssertTrue( ring.empty() );
+    XSTestAssertThrow( ring.current(), std::runtime_error );
+    
+    uint32_t id1 = ring.rotate();
+    uint32_t id2 = ring.rotate();
+    
+    XSTestAssertTrue( id1 != id2 );
+    XSTestAssertEqual( ring.current(), id2 );
+    XSTestAssertTrue( ring.key( id1, k1 ) );
+    XSTestAssertTrue( ring.key( id2, k2 ) );
+    XSTestAssertTrue( memcmp( k1, k2, sizeof( k1 ) ) != 0 );
+    
+    uint32_t id3 = ring.rotate();
+    
+    XSTestAssertEqual( ring.size(), static_cast< size_t >( 2 ) );
+    XSTestAssertFalse( ring.key( id1, k1 ) );
+    XSTestAssertTrue( ring.key( id3, k1 ) );
+    
+    ring.remove( id3 );
+    
+    XSTestAssertEqual( ring.current(), id2 );
+}
+
+XSTest( KeyRing, Add )
+{
+    SRP::KeyRing           ring;
+    std::vector< uint8_t > key( SRP::KeyRing::keyLength, 42 );
+    uint8_t                buffer[ SRP::KeyRing::keyLength ];
+    
+    ring.add( 7, key );
+    
+    XSTestAssertThrow( ring.add( 7, key ),                          std::runtime_error );
+    XSTestAssertThrow( ring.add( 8, std::vector< uint8_t >( 16 ) ), std::runtime_error );
+    XSTestAssertEqual( ring.current(), static_cast< uint32_t >( 7 ) );
+    XSTestAssertTrue( ring.key( 7, buffer ) );
+    XSTestAssertTrue( std::vector< uint8_t >( buffer, buffer + sizeof( buffer ) ) == key );
+    XSTestAssertEqual( ring.rotate(), static_cast< uint32_t >( 8 ) );
+}
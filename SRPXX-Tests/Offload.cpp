@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include "../SRPXX/source/OffloadSegment.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string segmentName()
+{
+    return "SRPXX-Tests-" + std::to_string( std::chrono::steady_clock::now().time_since_epoch().count() );
+}
+
+XSTest( Offload, Handshake )
+{
+    std::string                  name = segmentName();
+    SRP::OffloadService::Options options;
+    
+    options.slots   = 16;
+    options.threads = 2;
+    
+    SRP::OffloadService service( name, options );
+    std::thread         thread( [ & ] { service.run(); } );
+    SRP::OffloadClient  client( name );
+    size_t              count = 0;
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        server->setA( test.A() );
+        
+        auto verification = client.verify( *( server ), test.M1() );
+        
+        XSTestAssertTrue( client.B( *( server ) ) == test.B() );
+        XSTestAssertTrue( verification.M2 == test.M2() );
+        XSTestAssertTrue( verification.K  == test.K() );
+        
+        count += 2;
+    }
+    
+    service.stop();
+    thread.join();
+    
+    XSTestAssertEqual( service.stats().requests, static_cast< uint64_t >( count ) );
+}
+
+XSTest( Offload, Rejected )
+{
+    std::string         name = segmentName();
+    SRP::OffloadService service( name );
+    std::thread         thread( [ & ] { service.run(); } );
+    SRP::OffloadClient  client( name );
+    auto                test   = TestVectors::all().front();
+    auto                server = test.makeServer();
+    auto                M1     = test.M1();
+    
+    M1[ 0 ] ^= 1;
+    
+    server->setSalt( test.salt() );
+    server->setV( test.v() );
+    server->setA( test.A() );
+    
+    auto verification = client.verify( *( server ), M1 );
+    
+    XSTestAssertTrue( verification.M2.empty() );
+    XSTestAssertTrue( verification.K.empty() );
+    
+    /* Not a complete proof */
+    M1.pop_back();
+    
+    XSTestAssertTrue( client.verify( *( server ), M1 ).M2.empty() );
+    
+    service.stop();
+    thread.join();
+}
+
+XSTest( Offload, Concurrent )
+{
+    std::string                  name = segmentName();
+    SRP::OffloadService::Options options;
+    
+    /* Fewer slots than requests in flight, so clients have to wait for them */
+    options.slots = 4;
+    
+    SRP::OffloadService        service( name, options );
+    std::thread                thread( [ & ] { service.run(); } );
+    SRP::OffloadClient         client( name );
+    auto                       test = TestVectors::all().front();
+    std::vector< std::thread > threads;
+    std::atomic< size_t >      matches( 0 );
+    
+    for( size_t i = 0; i < 8; i++ )
+    {
+        threads.emplace_back
+        (
+            [ & ]
+            {
+                auto server = test.makeServer();
+                
+                server->setSalt( test.salt() );
+                server->setV( test.v() );
+                server->setA( test.A() );
+                
+                for( size_t j = 0; j < 10; j++ )
+                {
+                    if( client.verify( *( server ), test.M1() ).M2 == test.M2() )
+                    {
+                        matches++;
+                    }
+                }
+            }
+        );
+    }
+    
+    for( auto & t: threads )
+    {
+        t.join();
+    }
+    
+    service.stop();
+    thread.join();
+    
+    XSTestAssertEqual( matches.load(), static_cast< size_t >( 80 ) );
+}
+
+XSTest( Offload, Stopped )
+{
+    std::string name   = segmentName();
+    auto        test   = TestVectors::all().front();
+    auto        server = test.makeServer();
+    
+    XSTestAssertThrow( SRP::OffloadClient{ name }, std::runtime_error );
+    
+    auto service = std::make_unique< SRP::OffloadService >( name );
+    auto client  = std::make_unique< SRP::OffloadClient >( name, std::chrono::milliseconds( 200 ) );
+    
+    server->setSalt( test.salt() );
+    server->setV( test.v() );
+    
+    /* Not running - The request times out */
+    XSTestAssertThrow( client->B( *( server ) ), std::runtime_error );
+    
+    service.reset();
+    
+    XSTestAssertThrow( client->B( *( server ) ), std::runtime_error );
+    XSTestAssertThrow( SRP::OffloadClient{ name }, std::runtime_error );
+}
+
+XSTest( Offload, DeadClient )
+{
+    std::string                  name = segmentName();
+    auto                         test = TestVectors::all().front();
+    SRP::OffloadService::Options options;
+    
+    options.slots = 1;
+    
+    SRP::OffloadService service( name, options );
+    pid_t               child = fork();
+    
+    XSTestAssertTrue( child >= 0 );
+    
+    if( child == 0 )
+    {
+        auto server = test.makeServer();
+        
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        
+        try
+        {
+            SRP::OffloadClient( name, std::chrono::seconds( 60 ) ).B( *( server ) );
+        }
+        catch( ... )
+        {}
+        
+        _exit( 0 );
+    }
+    
+    /* The only slot is submitted by a client that dies before collecting its result */
+    std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+    kill( child, SIGKILL );
+    waitpid( child, nullptr, 0 );
+    
+    std::thread        thread( [ & ] { service.run(); } );
+    SRP::OffloadClient client( name, std::chrono::seconds( 5 ) );
+    auto               server = test.makeServer();
+    
+    server->setSalt( test.salt() );
+    server->setV( test.v() );
+    
+    XSTestAssertTrue( client.B( *( server ) ) == test.B() );
+    
+    service.stop();
+    thread.join();
+    
+    XSTestAssertEqual( service.stats().reclaimed, static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( Offload, ReclaimedThenClaimed )
+{
+    std::string                  name = segmentName();
+    auto                         test = TestVectors::all().front();
+    SRP::OffloadService::Options options;
+    
+    options.slots = 1;
+    
+    SRP::OffloadService           service( name, options );
+    SRP::OffloadSegment::Mapping  mapping( name, false );
+    SRP::OffloadSegment::Header & header  = mapping.header();
+    SRP::OffloadSegment::Slot   & slot    = mapping.slot( 0 );
+    uint32_t                      free    = slot.state.load();
+    uint32_t                      stalled = SRP::OffloadSegment::withState( free, SRP::OffloadSegment::State::Claimed );
+    
+    /* A client claims the only slot and stalls past the reclaim timeout */
+    XSTestAssertTrue( slot.state.compare_exchange_strong( free, stalled ) );
+    SRP::OffloadSegment::own( slot );
+    XSTestAssertTrue( SRP::OffloadSegment::reclaim( header, slot, std::chrono::milliseconds( 0 ) ) );
+    
+    /* Another one claims it again */
+    free = slot.state.load();
+    
+    uint32_t claimed = SRP::OffloadSegment::withState( free, SRP::OffloadSegment::State::Claimed );
+    
+    XSTestAssertTrue( SRP::OffloadSegment::stateOf( free ) == SRP::OffloadSegment::State::Free );
+    XSTestAssertTrue( slot.state.compare_exchange_strong( free, claimed ) );
+    XSTestAssertTrue( claimed != stalled );
+    
+    /* The stalled client can neither submit nor release it */
+    uint32_t expected = stalled;
+    
+    XSTestAssertFalse( slot.state.compare_exchange_strong( expected, SRP::OffloadSegment::withState( stalled, SRP::OffloadSegment::State::Submitted ) ) );
+    XSTestAssertFalse( SRP::OffloadSegment::release( header, slot, stalled ) );
+    XSTestAssertTrue( slot.state.load() == claimed );
+    XSTestAssertTrue( SRP::OffloadSegment::release( header, slot, claimed ) );
+    
+    std::thread        thread( [ & ] { service.run(); } );
+    SRP::OffloadClient client( name, std::chrono::seconds( 5 ) );
+    auto               server = test.makeServer();
+    
+    server->setSalt( test.salt() );
+    server->setV( test.v() );
+    
+    XSTestAssertTrue( client.B( *( server ) ) == test.B() );
+    
+    service.stop();
+    thread.join();
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <cstring>
+#include <future>
+#include <thread>
+
+XSTest( PoolAllocator, Allocate )
+{
+    SRP::PoolAllocator allocator;
+    
+    for( size_t size: { 0, 1, 16, 31, 32, 33, 1000, 4096, 16384, 16385, 100000 } )
+    {
+        void * p = allocator.allocate( size );
+        
+        XSTestAssertTrue( p != nullptr );
+        XSTestAssertTrue( reinterpret_cast< uintptr_t >( p ) % alignof( std::max_align_t ) == 0 );
+        
+        memset( p, 0x42, size );
+        allocator.deallocate( p );
+    }
+    
+    allocator.deallocate( nullptr );
+}
+
+XSTest( PoolAllocator, Reuse )
+{
+    SRP::PoolAllocator allocator;
+    void             * p1 = allocator.allocate( 100 );
+    
+    allocator.deallocate( p1 );
+    
+    void * p2 = allocator.allocate( 120 );
+    
+    XSTestAssertTrue( p1 == p2 );
+    allocator.deallocate( p2 );
+}
+
+XSTest( PoolAllocator, Reallocate )
+{
+    SRP::PoolAllocator allocator;
+    uint8_t          * p = static_cast< uint8_t * >( allocator.reallocate( nullptr, 10 ) );
+    
+    for( uint8_t i = 0; i < 10; i++ )
+    {
+        p[ i ] = i;
+    }
+    
+    XSTestAssertTrue( allocator.reallocate( p, 20 ) == p );
+    
+    for( size_t size: { 1000, 20000, 40000, 100 } )
+    {
+        p = static_cast< uint8_t * >( allocator.reallocate( p, size ) );
+        
+        XSTestAssertTrue( p != nullptr );
+        
+        for( uint8_t i = 0; i < 10; i++ )
+        {
+            XSTestAssertEqual( p[ i ], i );
+        }
+    }
+    
+    allocator.deallocate( p );
+}
+
+XSTest( PoolAllocator, Stats )
+{
+    SRP::PoolAllocator allocator;
+    
+    for( int i = 0; i < 10; i++ )
+    {
+        allocator.deallocate( allocator.allocate( 64 ) );
+    }
+    
+    allocator.deallocate( allocator.allocate( 100000 ) );
+    
+    SRP::PoolAllocator::Stats stats = allocator.stats();
+    
+    XSTestAssertEqual( stats.allocations,      static_cast< uint64_t >( 11 ) );
+    XSTestAssertEqual( stats.deallocations,    static_cast< uint64_t >( 11 ) );
+    XSTestAssertEqual( stats.cacheMisses,      static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( stats.cacheHits,        static_cast< uint64_t >( 9 ) );
+    XSTestAssertEqual( stats.largeAllocations, static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( stats.threads,          static_cast< uint64_t >( 1 ) );
+    XSTestAssertTrue(  stats.bytesReserved > 0 );
+}
+
+XSTest( PoolAllocator, Threads )
+{
+    SRP::PoolAllocator         allocator;
+    std::vector< std::thread > threads;
+    std::vector< void * >      shared( 4 );
+    
+    for( size_t i = 0; i < 4; i++ )
+    {
+        threads.emplace_back
+        (
+            [ &, i ]
+            {
+                for( int j = 0; j < 1000; j++ )
+                {
+                    void * p = allocator.allocate( 32 + static_cast< size_t >( j ) );
+                    
+                    memset( p, static_cast< int >( i ), 32 );
+                    allocator.deallocate( p );
+                }
+                
+                shared[ i ] = allocator.allocate( 256 );
+            }
+        );
+    }
+    
+    for( auto & thread: threads )
+    {
+        thread.join();
+    }
+    
+    /* Blocks can be released from another thread */
+    for( void * p: shared )
+    {
+        allocator.deallocate( p );
+    }
+    
+    SRP::PoolAllocator::Stats stats = allocator.stats();
+    
+    XSTestAssertEqual( stats.allocations,   static_cast< uint64_t >( 4004 ) );
+    XSTestAssertEqual( stats.deallocations, static_cast< uint64_t >( 4004 ) );
+    XSTestAssertEqual( stats.threads,       static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( PoolAllocator, DestroyedWhileThreadRuns )
+{
+    auto                 allocator = std::make_unique< SRP::PoolAllocator >();
+    std::promise< void > cached;
+    std::promise< void > destroyed;
+    std::future< void >  wait = destroyed.get_future();
+    bool                 allocated = false;
+    
+    std::thread thread
+    (
+        [ & ]
+        {
+            allocator->deallocate( allocator->allocate( 64 ) );
+            cached.set_value();
+            wait.wait();
+            
+            /* The stale cache is dropped on the next lookup */
+            SRP::PoolAllocator other;
+            void             * p = other.allocate( 64 );
+            
+            allocated = p != nullptr;
+            
+            other.deallocate( p );
+        }
+    );
+    
+    cached.get_future().wait();
+    allocator.reset();
+    destroyed.set_value();
+    thread.join();
+    
+    XSTestAssertTrue( allocated );
+}
+
+XSTest( PoolAllocator, BigNum )
+{
+    SRP::PoolAllocator allocator;
+    
+    SRP::Allocator::setCurrent( allocator );
+    
+    {
+        SRP::BigNum n( SRP::BigNum( 42 ).modExp( 13, 497 ) );
+        
+        XSTestAssertTrue( n == SRP::BigNum( 42 ).modExp( 13, 497 ) );
+    }
+    
+    SRP::Allocator::setCurrent( SRP::Allocator::defaultAllocator() );
+    
+    XSTestAssertTrue( allocator.stats().allocations > 0 );
+    XSTestAssertEqual( allocator.stats().allocations, allocator.stats().deallocations );
+}
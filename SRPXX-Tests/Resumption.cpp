@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <stdexcept>
+#include <vector>
+
+XSTest( Resumption, Secret )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto client = test.makeClient();
+        auto server = test.makeServer();
+        
+        client->setPassword( test.password() );
+        client->setSalt( test.salt() );
+        client->setB( test.B() );
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        server->setA( test.A() );
+        
+        std::vector< uint8_t > secret = SRP::Resumption::secret( test.hashAlgorithm(), test.K() );
+        
+        XSTestAssertTrue( secret.size() == test.K().size() );
+        XSTestAssertTrue( secret        != test.K() );
+        XSTestAssertTrue( secret        == SRP::Resumption::secret( *( client ) ) );
+        XSTestAssertTrue( secret        == SRP::Resumption::secret( *( server ) ) );
+    }
+}
+
+XSTest( Resumption, Proofs )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        std::vector< uint8_t > secret = SRP::Resumption::secret( test.hashAlgorithm(), test.K() );
+        std::vector< uint8_t > nc     = SRP::Resumption::nonce();
+        std::vector< uint8_t > ns     = SRP::Resumption::nonce();
+        
+        SRP::Resumption client( test.hashAlgorithm(), secret, nc, ns );
+        SRP::Resumption server( test.hashAlgorithm(), secret, nc, ns );
+        SRP::Resumption other(  test.hashAlgorithm(), secret, nc, SRP::Resumption::nonce() );
+        SRP::Resumption wrong(  test.hashAlgorithm(), test.K(), nc, ns );
+        
+        XSTestAssertTrue(  server.verifyClientProof( client.clientProof() ) );
+        XSTestAssertTrue(  client.verifyServerProof( server.serverProof() ) );
+        XSTestAssertFalse( server.verifyClientProof( client.serverProof() ) );
+        XSTestAssertFalse( server.verifyClientProof( wrong.clientProof() ) );
+        XSTestAssertFalse( server.verifyClientProof( other.clientProof() ) );
+        XSTestAssertFalse( client.verifyServerProof( wrong.serverProof() ) );
+        XSTestAssertFalse( server.verifyClientProof( {} ) );
+        
+        XSTestAssertTrue( client.K() == server.K() );
+        XSTestAssertTrue( client.K() != other.K() );
+        XSTestAssertTrue( client.K() != test.K() );
+    }
+    
+    std::vector< uint8_t > shortNonce( SRP::Resumption::nonceLength - 1 );
+    
+    XSTestAssertThrow( { SRP::Resumption r( SRP::HashAlgorithm::SHA256, SRP::Resumption::nonce(), shortNonce, SRP::Resumption::nonce() ); }, std::runtime_error );
+}
+
+XSTest( ResumptionStore, Redeem )
+{
+    auto                   test   = TestVectors::all().front();
+    SRP::ResumptionStore   store( std::chrono::minutes( 5 ), 2 );
+    uint64_t               id     = store.issue( test.hashAlgorithm(), test.K() );
+    std::vector< uint8_t > secret = SRP::Resumption::secret( test.hashAlgorithm(), test.K() );
+    std::vector< uint8_t > nc     = SRP::Resumption::nonce();
+    std::vector< uint8_t > ns     = SRP::Resumption::nonce();
+    std::vector< uint8_t > proof  = SRP::Resumption( test.hashAlgorithm(), secret, nc, ns ).clientProof();
+    
+    XSTestAssertTrue( store.size() == 1 );
+    XSTestAssertFalse( store.redeem( id + 1, nc, ns, proof ).has_value() );
+    
+    auto r1 = store.redeem( id, nc, ns, proof );
+    
+    XSTestAssertTrue( r1.has_value() );
+    XSTestAssertTrue( r1->serverProof() == SRP::Resumption( test.hashAlgorithm(), secret, nc, ns ).serverProof() );
+    XSTestAssertTrue( store.size() == 1 );
+    
+    /* Last use */
+    XSTestAssertTrue( store.redeem( id, nc, ns, proof ).has_value() );
+    XSTestAssertTrue( store.size() == 0 );
+    XSTestAssertFalse( store.redeem( id, nc, ns, proof ).has_value() );
+    
+    id = store.issue( test.hashAlgorithm(), test.K() );
+    
+    XSTestAssertTrue( store.revoke( id ) );
+    XSTestAssertFalse( store.revoke( id ) );
+    XSTestAssertFalse( store.redeem( id, nc, ns, proof ).has_value() );
+}
+
+XSTest( ResumptionStore, WrongProof )
+{
+    auto                   test   = TestVectors::all().front();
+    SRP::ResumptionStore   store( std::chrono::minutes( 5 ), 1 );
+    uint64_t               id     = store.issue( test.hashAlgorithm(), test.K() );
+    std::vector< uint8_t > secret = SRP::Resumption::secret( test.hashAlgorithm(), test.K() );
+    std::vector< uint8_t > nc     = SRP::Resumption::nonce();
+    std::vector< uint8_t > ns     = SRP::Resumption::nonce();
+    std::vector< uint8_t > proof  = SRP::Resumption( test.hashAlgorithm(), secret, nc, ns ).clientProof();
+    std::vector< uint8_t > wrong  = proof;
+    
+    wrong[ 0 ] ^= 1;
+    
+    /* Anyone who sees the ticket ID can try, without using up the ticket */
+    for( int i = 0; i < 4; i++ )
+    {
+        XSTestAssertFalse( store.redeem( id, nc, ns, wrong ).has_value() );
+        XSTestAssertFalse( store.redeem( id, nc, ns, {} ).has_value() );
+    }
+    
+    XSTestAssertTrue( store.size() == 1 );
+    XSTestAssertTrue( store.redeem( id, nc, ns, proof ).has_value() );
+    XSTestAssertTrue( store.size() == 0 );
+}
+
+XSTest( ResumptionStore, Identity )
+{
+    SRP::ResumptionStore   store;
+    std::vector< uint8_t > nc = SRP::Resumption::nonce();
+    std::vector< uint8_t > ns = SRP::Resumption::nonce();
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        server->setA( test.A() );
+        
+        auto proof      = SRP::Resumption( test.hashAlgorithm(), SRP::Resumption::secret( test.hashAlgorithm(), test.K() ), nc, ns ).clientProof();
+        auto resumption = store.redeem( store.issue( *( server ) ), nc, ns, proof );
+        
+        XSTestAssertTrue( resumption.has_value() );
+        XSTestAssertTrue( resumption->identity() == test.identity() );
+    }
+    
+    auto test       = TestVectors::all().front();
+    auto proof      = SRP::Resumption( test.hashAlgorithm(), SRP::Resumption::secret( test.hashAlgorithm(), test.K() ), nc, ns ).clientProof();
+    auto resumption = store.redeem( store.issue( test.hashAlgorithm(), test.K() ), nc, ns, proof );
+    
+    XSTestAssertTrue( resumption.has_value() );
+    XSTestAssertTrue( resumption->identity().empty() );
+}
+
+XSTest( ResumptionStore, Expire )
+{
+    auto                 test = TestVectors::all().front();
+    SRP::ResumptionStore store( std::chrono::minutes( 5 ) );
+    auto                 now  = SRP::ResumptionStore::Clock::now();
+    uint64_t             id1  = store.issue( test.hashAlgorithm(), test.K() );
+    uint64_t             id2  = store.issue( test.hashAlgorithm(), test.K() );
+    auto                 nc   = SRP::Resumption::nonce();
+    auto                 ns   = SRP::Resumption::nonce();
+    auto                 pr   = SRP::Resumption( test.hashAlgorithm(), SRP::Resumption::secret( test.hashAlgorithm(), test.K() ), nc, ns ).clientProof();
+    
+    XSTestAssertTrue( id1 != id2 );
+    XSTestAssertTrue( store.redeem( id1, nc, ns, pr, now + std::chrono::minutes( 4 ) ).has_value() );
+    XSTestAssertFalse( store.redeem( id1, nc, ns, pr, now + std::chrono::minutes( 6 ) ).has_value() );
+    XSTestAssertTrue( store.size() == 1 );
+    XSTestAssertTrue( store.expire( now + std::chrono::minutes( 4 ) ) == 0 );
+    XSTestAssertTrue( store.expire( now + std::chrono::minutes( 6 ) ) == 1 );
+    XSTestAssertTrue( store.size() == 0 );
+    
+    XSTestAssertThrow( { SRP::ResumptionStore s( std::chrono::minutes( 5 ), 0 ); }, std::runtime_error );
+}
@@ -184,6 +184,42 @@ XSTestFixture( SHA1, GetString )
     }
 }
 
+XSTestFixture( SHA1, Copy )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA1 prefix;
+        
+        XSTestAssertTrue( prefix.update( r.bytes.data(), r.bytes.size() / 2 ) );
+        
+        SRP::SHA1 hasher( prefix );
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+        
+        hasher = prefix;
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+    }
+}
+
+XSTestFixture( SHA1, Finalize_Buffer )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA1               hasher;
+        std::vector< uint8_t > hash( SRP::SHA1::digestSize );
+        
+        XSTestAssertTrue(  hasher.update( r.bytes ) );
+        XSTestAssertTrue(  hasher.finalize( hash.data() ) );
+        XSTestAssertFalse( hasher.finalize( hash.data() ) );
+        XSTestAssertTrue(  hash == r.hashBytes );
+    }
+}
+
 void SHA1::SetUp()
 {
     this->result =
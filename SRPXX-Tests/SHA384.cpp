@@ -184,6 +184,42 @@ XSTestFixture( SHA384, GetString )
     }
 }
 
+XSTestFixture( SHA384, Copy )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA384 prefix;
+        
+        XSTestAssertTrue( prefix.update( r.bytes.data(), r.bytes.size() / 2 ) );
+        
+        SRP::SHA384 hasher( prefix );
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+        
+        hasher = prefix;
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+    }
+}
+
+XSTestFixture( SHA384, Finalize_Buffer )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA384               hasher;
+        std::vector< uint8_t > hash( SRP::SHA384::digestSize );
+        
+        XSTestAssertTrue(  hasher.update( r.bytes ) );
+        XSTestAssertTrue(  hasher.finalize( hash.data() ) );
+        XSTestAssertFalse( hasher.finalize( hash.data() ) );
+        XSTestAssertTrue(  hash == r.hashBytes );
+    }
+}
+
 void SHA384::SetUp()
 {
     this->result =
@@ -184,6 +184,42 @@ XSTestFixture( SHA512, GetString )
     }
 }
 
+XSTestFixture( SHA512, Copy )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA512 prefix;
+        
+        XSTestAssertTrue( prefix.update( r.bytes.data(), r.bytes.size() / 2 ) );
+        
+        SRP::SHA512 hasher( prefix );
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+        
+        hasher = prefix;
+        
+        XSTestAssertTrue( hasher.update( r.bytes.data() + r.bytes.size() / 2, r.bytes.size() - r.bytes.size() / 2 ) );
+        XSTestAssertTrue( hasher.finalize() );
+        XSTestAssertTrue( hasher.bytes() == r.hashBytes );
+    }
+}
+
+XSTestFixture( SHA512, Finalize_Buffer )
+{
+    for( const auto & r: this->result )
+    {
+        SRP::SHA512               hasher;
+        std::vector< uint8_t > hash( SRP::SHA512::digestSize );
+        
+        XSTestAssertTrue(  hasher.update( r.bytes ) );
+        XSTestAssertTrue(  hasher.finalize( hash.data() ) );
+        XSTestAssertFalse( hasher.finalize( hash.data() ) );
+        XSTestAssertTrue(  hash == r.hashBytes );
+    }
+}
+
 void SHA512::SetUp()
 {
     this->result =
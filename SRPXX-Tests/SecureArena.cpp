@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <cstring>
+
+XSTest( SecureArena, Allocate )
+{
+    SRP::SecureArena arena;
+    
+    for( size_t size: { 0, 1, 16, 17, 100, 4096, 4097, 100000 } )
+    {
+        void * p = arena.allocate( size );
+        
+        XSTestAssertTrue( p != nullptr );
+        XSTestAssertTrue( arena.owns( p ) );
+        XSTestAssertTrue( reinterpret_cast< uintptr_t >( p ) % alignof( std::max_align_t ) == 0 );
+        
+        memset( p, 0x42, size );
+        arena.deallocate( p );
+    }
+    
+    int i = 0;
+    
+    XSTestAssertFalse( arena.owns( &i ) );
+    arena.deallocate( nullptr );
+}
+
+XSTest( SecureArena, Wipe )
+{
+    SRP::SecureArena arena;
+    uint8_t        * p = static_cast< uint8_t * >( arena.allocate( 64 ) );
+    
+    memset( p, 0x42, 64 );
+    arena.deallocate( p );
+    
+    /* Still mapped, as the block is only returned to the arena */
+    for( size_t i = 0; i < 64; i++ )
+    {
+        XSTestAssertEqual( p[ i ], 0 );
+    }
+}
+
+XSTest( SecureArena, Reuse )
+{
+    SRP::SecureArena arena;
+    void           * p1 = arena.allocate( 100 );
+    
+    arena.deallocate( p1 );
+    
+    void * p2 = arena.allocate( 120 );
+    
+    XSTestAssertTrue( p1 == p2 );
+    arena.deallocate( p2 );
+}
+
+XSTest( SecureArena, Reallocate )
+{
+    SRP::SecureArena arena;
+    uint8_t        * p = static_cast< uint8_t * >( arena.reallocate( nullptr, 10 ) );
+    
+    for( uint8_t i = 0; i < 10; i++ )
+    {
+        p[ i ] = i;
+    }
+    
+    XSTestAssertTrue( arena.reallocate( p, 16 ) == p );
+    
+    for( size_t size: { 1000, 10000, 100 } )
+    {
+        p = static_cast< uint8_t * >( arena.reallocate( p, size ) );
+        
+        XSTestAssertTrue( p != nullptr );
+        
+        for( uint8_t i = 0; i < 10; i++ )
+        {
+            XSTestAssertEqual( p[ i ], i );
+        }
+    }
+    
+    arena.deallocate( p );
+}
+
+XSTest( SecureArena, Stats )
+{
+    SRP::SecureArena arena;
+    void           * p1 = arena.allocate( 32 );
+    void           * p2 = arena.allocate( 100000 );
+    
+    SRP::SecureArena::Stats stats = arena.stats();
+    
+    XSTestAssertEqual( stats.allocations, static_cast< uint64_t >( 2 ) );
+    XSTestAssertEqual( stats.bytesInUse,  static_cast< uint64_t >( 100032 ) );
+    XSTestAssertEqual( stats.regions,     static_cast< uint64_t >( 2 ) );
+    XSTestAssertTrue(  stats.bytesReserved >= 100032 );
+    XSTestAssertTrue(  stats.bytesLocked   <= stats.bytesReserved );
+    
+    arena.deallocate( p1 );
+    arena.deallocate( p2 );
+    
+    stats = arena.stats();
+    
+    XSTestAssertEqual( stats.deallocations, static_cast< uint64_t >( 2 ) );
+    XSTestAssertEqual( stats.bytesInUse,    static_cast< uint64_t >( 0 ) );
+    XSTestAssertEqual( stats.regions,       static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( SecureArena, SecureBytes )
+{
+    SRP::SecureArena arena;
+    
+    {
+        SRP::SecureBytes bytes( arena );
+        
+        bytes.resize( 42, 0x42 );
+        
+        XSTestAssertTrue( arena.owns( bytes.data() ) );
+    }
+    
+    XSTestAssertEqual( arena.stats().bytesInUse, static_cast< uint64_t >( 0 ) );
+}
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <cstring>
+#include <vector>
+
+static std::pair< std::unique_ptr< SRP::Client >, std::unique_ptr< SRP::Server > > makeSessions( const TestVectors & test )
+{
+    auto client = test.makeClient();
+    auto server = test.makeServer();
+    
+    client->setPassword( test.password() );
+    client->setSalt( test.salt() );
+    client->setB( test.B() );
+    server->setSalt( test.salt() );
+    server->setV( test.v() );
+    server->setA( test.A() );
+    
+    return { std::move( client ), std::move( server ) };
+}
+
+XSTest( SecureChannel, Records )
+{
+    for( auto cipher: { SRP::SecureChannel::Cipher::AES256GCM, SRP::SecureChannel::Cipher::ChaCha20Poly1305 } )
+    {
+        for( const auto & test: { TestVectors::all().front(), TestVectors::all().back() } )
+        {
+            auto                   sessions = makeSessions( test );
+            SRP::SecureChannel     client( *( sessions.first ),  cipher );
+            SRP::SecureChannel     server( *( sessions.second ), cipher );
+            std::vector< uint8_t > message  = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+            std::vector< uint8_t > data     = message;
+            uint8_t                tag[ SRP::SecureChannel::tagLength ];
+            
+            for( int i = 0; i < 3; i++ )
+            {
+                client.seal( data.data(), data.size(), tag );
+                
+                XSTestAssertTrue( data != message );
+                XSTestAssertTrue( server.open( data.data(), data.size(), tag ) );
+                XSTestAssertTrue( data == message );
+                
+                server.seal( data.data(), data.size(), tag );
+                
+                XSTestAssertTrue( client.open( data.data(), data.size(), tag ) );
+                XSTestAssertTrue( data == message );
+            }
+            
+            XSTestAssertTrue( client.sent()     == 3 );
+            XSTestAssertTrue( client.received() == 3 );
+            
+            /* Replay */
+            client.seal( data.data(), data.size(), tag );
+            
+            std::vector< uint8_t > copy = data;
+            
+            XSTestAssertTrue( server.open( data.data(), data.size(), tag ) );
+            XSTestAssertFalse( server.open( copy.data(), copy.size(), tag ) );
+            
+            /* Same plaintext, different record number */
+            std::vector< uint8_t > first  = message;
+            std::vector< uint8_t > second = message;
+            uint8_t                firstTag[ SRP::SecureChannel::tagLength ];
+            
+            client.seal( first.data(),  first.size(),  firstTag );
+            client.seal( second.data(), second.size(), tag );
+            
+            XSTestAssertTrue( first != second );
+            
+            /* Out of order, then in order */
+            std::vector< uint8_t > early = second;
+            
+            XSTestAssertFalse( server.open( early.data(), early.size(), tag ) );
+            XSTestAssertTrue( server.open( first.data(), first.size(), firstTag ) );
+            
+            second[ 0 ] ^= 1;
+            
+            XSTestAssertFalse( server.open( second.data(), second.size(), tag ) );
+        }
+    }
+}
+
+XSTest( SecureChannel, Channels )
+{
+    auto                   sessions = makeSessions( TestVectors::all().front() );
+    SRP::SecureChannel     client0( *( sessions.first ) );
+    SRP::SecureChannel     client1( *( sessions.first ),  1 );
+    SRP::SecureChannel     server1( *( sessions.second ), 1 );
+    SRP::SecureChannel     server2( *( sessions.second ), 2 );
+    std::vector< uint8_t > message = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    std::vector< uint8_t > a       = message;
+    std::vector< uint8_t > b       = message;
+    std::vector< uint8_t > c       = message;
+    uint8_t                tagA[ SRP::SecureChannel::tagLength ];
+    uint8_t                tagB[ SRP::SecureChannel::tagLength ];
+    uint8_t                tagC[ SRP::SecureChannel::tagLength ];
+    
+    /* Same session and record number, but not the same key and nonce */
+    client0.seal( a.data(), a.size(), tagA );
+    client1.seal( b.data(), b.size(), tagB );
+    server1.seal( c.data(), c.size(), tagC );
+    
+    XSTestAssertTrue( a != b );
+    XSTestAssertTrue( memcmp( tagA, tagB, sizeof( tagA ) ) != 0 );
+    
+    /* Each direction has its own key and nonce */
+    XSTestAssertTrue( b != c );
+    
+    std::vector< uint8_t > copy = b;
+    
+    XSTestAssertFalse( server2.open( copy.data(), copy.size(), tagB ) );
+    XSTestAssertTrue( server1.open( b.data(), b.size(), tagB ) );
+    XSTestAssertTrue( b == message );
+    XSTestAssertTrue( client1.open( c.data(), c.size(), tagC ) );
+    XSTestAssertTrue( c == message );
+}
+
+XSTest( SecureChannel, Batch )
+{
+    auto                   sessions = makeSessions( TestVectors::all().front() );
+    SRP::SecureChannel     client( *( sessions.first ) );
+    SRP::SecureChannel     server( *( sessions.second ) );
+    std::vector< uint8_t > m1       = { 1, 2, 3 };
+    std::vector< uint8_t > m2       = {};
+    std::vector< uint8_t > m3( 1000, 0x42 );
+    std::vector< uint8_t > record( 2048 );
+    
+    std::vector< SRP::SecureChannel::Message > messages = { { m1.data(), m1.size() }, { m2.data(), m2.size() }, { m3.data(), m3.size() } };
+    std::vector< SRP::SecureChannel::Message > opened;
+    
+    XSTestAssertTrue( SRP::SecureChannel::batchLength( messages ) == 3 * SRP::SecureChannel::frameLength + 1003 + SRP::SecureChannel::tagLength );
+    XSTestAssertTrue( client.seal( messages, record.data(), 100 ) == 0 );
+    XSTestAssertTrue( client.sent() == 0 );
+    
+    size_t length = client.seal( messages, record.data(), record.size() );
+    
+    XSTestAssertTrue( length == SRP::SecureChannel::batchLength( messages ) );
+    XSTestAssertTrue( client.sent() == 1 );
+    XSTestAssertTrue( server.open( record.data(), length, opened ) );
+    XSTestAssertTrue( opened.size() == 3 );
+    XSTestAssertTrue( opened[ 0 ].length == 3    && memcmp( opened[ 0 ].data, m1.data(), 3 ) == 0 );
+    XSTestAssertTrue( opened[ 1 ].length == 0 );
+    XSTestAssertTrue( opened[ 2 ].length == 1000 && memcmp( opened[ 2 ].data, m3.data(), 1000 ) == 0 );
+    
+    length = client.seal( messages, record.data(), record.size() );
+    
+    XSTestAssertFalse( server.open( record.data(), length - 1, opened ) );
+    XSTestAssertFalse( server.open( record.data(), SRP::SecureChannel::tagLength - 1, opened ) );
+    XSTestAssertTrue( opened.empty() );
+}
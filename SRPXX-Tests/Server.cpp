@@ -25,6 +25,7 @@
 #include <SRPXX.hpp>
 #include <XSTest/XSTest.hpp>
 #include "TestVectors.hpp"
+#include <stdexcept>
 
 XSTest( Server, SetV )
 {
@@ -153,3 +154,262 @@ XSTest( Server, M2 )
         XSTestAssertTrue( server->M2() == test.M2() );
     }
 }
+
+XSTest( Server, VerifyM1 )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        auto M1     = test.M1();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        XSTestAssertTrue( server->verifyM1( M1 ) == test.M2() );
+        XSTestAssertTrue( server->verifyM1( M1.data(), M1.size() ) == test.M2() );
+        XSTestAssertTrue( server->verifyM1( M1.data(), M1.size() - 1 ).empty() );
+        
+        M1.back() ^= 1;
+        
+        XSTestAssertTrue( server->verifyM1( M1 ).empty() );
+    }
+}
+
+XSTest( Server, VerifyM1_InvalidA )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        
+        for( const SRP::BigNum & A: { SRP::BigNum( 0 ), server->N(), server->N() * 2 } )
+        {
+            server->setA( A );
+            
+            /* S is 0, so K and M1 are known without the password */
+            XSTestAssertTrue( server->verifyM1( server->M1( server->K( SRP::BigNum( 0 ) ) ) ).empty() );
+        }
+    }
+}
+
+XSTest( Server, Move )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        SRP::Server moved( std::move( *( server ) ) );
+        
+        XSTestAssertTrue( moved.S() == test.S() );
+        XSTestAssertTrue( moved.salt() == test.salt() );
+    }
+}
+
+XSTest( Server, Reset )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        SRP::Server server( "foo", test.hashAlgorithm(), test.groupType() );
+        
+        server.setV( SRP::BigNum( 42 ) );
+        server.setSalt( { 1, 2, 3 } );
+        server.setA( SRP::BigNum( 42 ) );
+        server.reset( test.identity(), test.salt(), test.v(), test.b() );
+        
+        XSTestAssertTrue( server.identity() == test.identity() );
+        XSTestAssertTrue( server.salt() == test.salt() );
+        XSTestAssertTrue( server.v() == test.v() );
+        XSTestAssertTrue( server.b() == test.b() );
+        XSTestAssertTrue( server.b().isSecret() );
+        XSTestAssertTrue( server.A() == SRP::BigNum() );
+        
+        server.setA( test.A() );
+        XSTestAssertTrue( server.B() == test.B() );
+        XSTestAssertTrue( server.S() == test.S() );
+        XSTestAssertTrue( server.M2() == test.M2() );
+        
+        SRP::BigNum b = server.b();
+        
+        server.reset( test.identity(), test.salt(), test.v() );
+        XSTestAssertTrue( server.b() != b );
+    }
+}
+
+XSTest( Server, Clear )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        server->clear();
+        
+        XSTestAssertTrue( server->identity().empty() );
+        XSTestAssertTrue( server->salt().empty() );
+        XSTestAssertTrue( server->v() == SRP::BigNum() );
+        XSTestAssertTrue( server->b() == SRP::BigNum() );
+        XSTestAssertTrue( server->A() == SRP::BigNum() );
+    }
+}
+
+XSTest( Server, Ticket )
+{
+    SRP::KeyRing keys;
+    
+    keys.rotate();
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        auto server = test.makeServer();
+        
+        server->setV( test.v() );
+        server->setSalt( test.salt() );
+        server->setA( test.A() );
+        
+        auto ticket   = server->exportTicket( keys );
+        auto restored = SRP::Server::fromTicket( ticket, keys );
+        
+        XSTestAssertTrue( restored.has_value() );
+        XSTestAssertTrue( restored->identity() == test.identity() );
+        XSTestAssertTrue( restored->salt()     == test.salt() );
+        XSTestAssertTrue( restored->v()        == test.v() );
+        XSTestAssertTrue( restored->b()        == test.b() );
+        XSTestAssertTrue( restored->A()        == test.A() );
+        XSTestAssertTrue( restored->B()        == test.B() );
+        XSTestAssertTrue( restored->verifyM1( test.M1() ) == test.M2() );
+    }
+}
+
+XSTest( Server, TicketInvalid )
+{
+    SRP::KeyRing keys( 2 );
+    SRP::Server  server( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    XSTestAssertThrow( server.exportTicket( keys ), std::runtime_error );
+    
+    keys.rotate();
+    server.setSalt( { 1, 2, 3 } );
+    server.setV( SRP::BigNum( 42 ) );
+    server.setA( SRP::BigNum( 43 ) );
+    
+    auto ticket = server.exportTicket( keys );
+    
+    XSTestAssertTrue( SRP::Server::fromTicket( ticket, keys ).has_value() );
+    XSTestAssertFalse( SRP::Server::fromTicket( server.exportTicket( keys, std::chrono::seconds( -1 ) ), keys ).has_value() );
+    XSTestAssertFalse( SRP::Server::fromTicket( std::vector< uint8_t >( ticket.begin(), ticket.end() - 1 ), keys ).has_value() );
+    XSTestAssertFalse( SRP::Server::fromTicket( {}, keys ).has_value() );
+    
+    for( size_t i = 0; i < ticket.size(); i++ )
+    {
+        auto tampered = ticket;
+        
+        tampered[ i ] ^= 1;
+        
+        XSTestAssertFalse( SRP::Server::fromTicket( tampered, keys ).has_value() );
+    }
+    
+    keys.rotate();
+    
+    XSTestAssertTrue( SRP::Server::fromTicket( ticket, keys ).has_value() );
+    
+    keys.rotate();
+    
+    XSTestAssertFalse( SRP::Server::fromTicket( ticket, keys ).has_value() );
+}
+
+XSTest( Server, TicketReplay )
+{
+    SRP::KeyRing keys;
+    SRP::Server  server( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    keys.rotate();
+    server.setSalt( { 1, 2, 3 } );
+    server.setV( SRP::BigNum( 42 ) );
+    server.setA( SRP::BigNum( 43 ) );
+    
+    auto                     ticket = server.exportTicket( keys );
+    SRP::Server::TicketCache redeemed;
+    
+    XSTestAssertTrue( SRP::Server::fromTicket( ticket, keys, redeemed ).has_value() );
+    XSTestAssertFalse( SRP::Server::fromTicket( ticket, keys, redeemed ).has_value() );
+    XSTestAssertTrue( SRP::Server::fromTicket( server.exportTicket( keys ), keys, redeemed ).has_value() );
+    XSTestAssertEqual( redeemed.size(), static_cast< size_t >( 2 ) );
+    
+    /* Invalid tickets do not use up an ID */
+    XSTestAssertFalse( SRP::Server::fromTicket( server.exportTicket( keys, std::chrono::seconds( -1 ) ), keys, redeemed ).has_value() );
+    XSTestAssertEqual( redeemed.size(), static_cast< size_t >( 2 ) );
+    
+    /* Without a cache, replays are not detected */
+    XSTestAssertTrue( SRP::Server::fromTicket( ticket, keys ).has_value() );
+    
+    SRP::Server::TicketCache full( 1 );
+    
+    XSTestAssertTrue( SRP::Server::fromTicket( ticket, keys, full ).has_value() );
+    XSTestAssertFalse( SRP::Server::fromTicket( server.exportTicket( keys ), keys, full ).has_value() );
+}
+
+XSTest( Server, TicketLeadingZeros )
+{
+    SRP::KeyRing keys;
+    SRP::Server  server( std::string( "\0alice", 6 ), SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    keys.rotate();
+    server.setSalt( { 0, 0, 1, 2, 3 } );
+    server.setV( SRP::BigNum( 42 ) );
+    server.setA( SRP::BigNum( 43 ) );
+    
+    auto restored = SRP::Server::fromTicket( server.exportTicket( keys ), keys );
+    
+    XSTestAssertTrue( restored.has_value() );
+    XSTestAssertTrue( restored->identity() == server.identity() );
+    XSTestAssertTrue( restored->salt()     == server.salt() );
+    XSTestAssertTrue( restored->v()        == server.v() );
+    XSTestAssertTrue( restored->b()        == server.b() );
+    XSTestAssertTrue( restored->A()        == server.A() );
+}
+
+XSTest( Server, DeriveB )
+{
+    SRP::KeyRing           keys;
+    std::vector< uint8_t > nonce( 16, 0x01 );
+    uint32_t               id = keys.rotate();
+    SRP::BigNum            b  = SRP::Server::deriveB( keys, id, nonce, "alice" );
+    
+    XSTestAssertTrue( b                                                       == SRP::Server::deriveB( keys, id, nonce, "alice" ) );
+    XSTestAssertTrue( b                                                       != SRP::Server::deriveB( keys, id, nonce, "bob" ) );
+    XSTestAssertTrue( b                                                       != SRP::Server::deriveB( keys, id, std::vector< uint8_t >( 16, 0x02 ), "alice" ) );
+    XSTestAssertThrow( SRP::Server::deriveB( keys, id + 1, nonce, "alice" ), std::runtime_error );
+    
+    /* Same concatenation, split differently */
+    XSTestAssertTrue( SRP::Server::deriveB( keys, id, { 'a', 'b' }, "c" ) != SRP::Server::deriveB( keys, id, { 'a' }, "bc" ) );
+    
+    /* Old keys keep deriving the same b after a rotation */
+    uint32_t next = keys.rotate();
+    
+    XSTestAssertTrue( b == SRP::Server::deriveB( keys, id, nonce, "alice" ) );
+    XSTestAssertTrue( b != SRP::Server::deriveB( keys, next, nonce, "alice" ) );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        SRP::BigNum derived = SRP::Server::deriveB( keys, next, nonce, test.identity() );
+        SRP::Server server( test.identity(), test.hashAlgorithm(), test.groupType(), derived );
+        
+        server.setSalt( test.salt() );
+        server.setV( test.v() );
+        
+        SRP::BigNum B = server.B();
+        
+        server.reset( test.identity(), test.salt(), test.v(), SRP::Server::deriveB( keys, next, nonce, test.identity() ) );
+        
+        XSTestAssertTrue( server.B() == B );
+    }
+}
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+
+namespace
+{
+    std::unique_ptr< SRP::Server > makeServer()
+    {
+        return std::make_unique< SRP::Server >( "", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    }
+}
+
+XSTest( SessionPool, Acquire )
+{
+    SRP::SessionPool< SRP::Server > pool( makeServer, 2 );
+    
+    {
+        auto s1 = pool.acquire();
+        auto s2 = pool.acquire();
+        
+        XSTestAssertTrue( s1 );
+        XSTestAssertTrue( s2 );
+        XSTestAssertTrue( s1.get() != s2.get() );
+        XSTestAssertEqual( pool.idle(), static_cast< size_t >( 0 ) );
+    }
+    
+    XSTestAssertEqual( pool.idle(),    static_cast< size_t >( 2 ) );
+    XSTestAssertEqual( pool.created(), static_cast< uint64_t >( 2 ) );
+    XSTestAssertEqual( pool.reused(),  static_cast< uint64_t >( 0 ) );
+}
+
+XSTest( SessionPool, Reuse )
+{
+    SRP::SessionPool< SRP::Server > pool( makeServer, 2 );
+    SRP::Server                   * p = nullptr;
+    
+    {
+        auto s = pool.acquire();
+        
+        p = s.get();
+    }
+    
+    auto s = pool.acquire();
+    
+    XSTestAssertTrue( s.get() == p );
+    XSTestAssertEqual( pool.created(), static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( pool.reused(),  static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( SessionPool, Capacity )
+{
+    SRP::SessionPool< SRP::Server > pool( makeServer, 1 );
+    
+    {
+        auto s1 = pool.acquire();
+        auto s2 = pool.acquire();
+    }
+    
+    XSTestAssertEqual( pool.capacity(), static_cast< size_t >( 1 ) );
+    XSTestAssertEqual( pool.idle(),     static_cast< size_t >( 1 ) );
+}
+
+XSTest( SessionPool, Clear )
+{
+    SRP::SessionPool< SRP::Server > pool( makeServer, 1 );
+    
+    {
+        auto s = pool.acquire();
+        
+        s->reset( "foo", { 1, 2, 3 }, SRP::BigNum( 42 ) );
+        XSTestAssertTrue( s->identity() == "foo" );
+    }
+    
+    auto s = pool.acquire();
+    
+    XSTestAssertTrue( s->identity().empty() );
+    XSTestAssertTrue( s->salt().empty() );
+    XSTestAssertTrue( s->v() == SRP::BigNum() );
+    XSTestAssertTrue( s->b() == SRP::BigNum() );
+}
+
+XSTest( SessionPool, Release )
+{
+    SRP::SessionPool< SRP::Server > pool( makeServer, 1 );
+    auto                            s1 = pool.acquire();
+    auto                            s2 = std::move( s1 );
+    
+    XSTestAssertFalse( s1 );
+    XSTestAssertTrue( s2 );
+    
+    s2.release();
+    
+    XSTestAssertFalse( s2 );
+    XSTestAssertEqual( pool.idle(), static_cast< size_t >( 1 ) );
+}
@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    SRP::Server makeServer( const TestVectors & test )
+    {
+        SRP::Server server( test.identity(), test.hashAlgorithm(), test.groupType(), test.b() );
+        
+        server.setSalt( test.salt() );
+        server.setV( test.v() );
+        
+        return server;
+    }
+}
+
+XSTest( SessionTable, InsertTake )
+{
+    SRP::SessionTable table( 100, std::chrono::minutes( 1 ) );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        XSTestAssertTrue( table.insert( 42, makeServer( test ) ) );
+        XSTestAssertTrue( table.contains( 42 ) );
+        XSTestAssertEqual( table.size(), static_cast< size_t >( 1 ) );
+        
+        auto server = table.take( 42 );
+        
+        XSTestAssertTrue( server.has_value() );
+        XSTestAssertFalse( table.contains( 42 ) );
+        XSTestAssertFalse( table.take( 42 ).has_value() );
+        
+        server->setA( test.A() );
+        
+        XSTestAssertTrue( server->B()  == test.B() );
+        XSTestAssertTrue( server->M2() == test.M2() );
+    }
+}
+
+XSTest( SessionTable, Duplicate )
+{
+    SRP::SessionTable table( 100, std::chrono::minutes( 1 ) );
+    auto              test = TestVectors::all()[ 0 ];
+    
+    XSTestAssertTrue( table.insert( 1, makeServer( test ) ) );
+    XSTestAssertFalse( table.insert( 1, makeServer( test ) ) );
+    XSTestAssertEqual( table.stats().rejected, static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( SessionTable, Capacity )
+{
+    SRP::SessionTable table( 8, std::chrono::minutes( 1 ), std::chrono::milliseconds( 10 ), 1 );
+    auto              test     = TestVectors::all()[ 0 ];
+    size_t            inserted = 0;
+    
+    for( uint64_t i = 0; i < 16; i++ )
+    {
+        inserted += table.insert( i, makeServer( test ) ) ? 1 : 0;
+    }
+    
+    XSTestAssertEqual( table.capacity(),       static_cast< size_t >( 8 ) );
+    XSTestAssertEqual( inserted,               static_cast< size_t >( 8 ) );
+    XSTestAssertEqual( table.size(),           static_cast< size_t >( 8 ) );
+    XSTestAssertEqual( table.stats().rejected, static_cast< uint64_t >( 8 ) );
+}
+
+XSTest( SessionTable, Remove )
+{
+    SRP::SessionTable table( 100, std::chrono::minutes( 1 ) );
+    auto              test = TestVectors::all()[ 0 ];
+    
+    XSTestAssertTrue( table.insert( 1, makeServer( test ) ) );
+    XSTestAssertTrue( table.remove( 1 ) );
+    XSTestAssertFalse( table.remove( 1 ) );
+    XSTestAssertFalse( table.contains( 1 ) );
+    XSTestAssertEqual( table.stats().removed, static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( SessionTable, Expire )
+{
+    SRP::SessionTable table( 1000, std::chrono::seconds( 30 ) );
+    auto              test = TestVectors::all()[ 0 ];
+    auto              now  = SRP::SessionTable::Clock::now();
+    
+    for( uint64_t i = 0; i < 100; i++ )
+    {
+        XSTestAssertTrue( table.insert( i, makeServer( test ) ) );
+    }
+    
+    XSTestAssertTrue( table.insert( 1000, makeServer( test ), std::chrono::hours( 2 ) ) );
+    
+    XSTestAssertEqual( table.expire( now + std::chrono::seconds( 10 ) ),  static_cast< size_t >( 0 ) );
+    XSTestAssertEqual( table.expire( now + std::chrono::seconds( 31 ) ),  static_cast< size_t >( 100 ) );
+    XSTestAssertEqual( table.size(),                                      static_cast< size_t >( 1 ) );
+    XSTestAssertEqual( table.expire( now + std::chrono::minutes( 119 ) ), static_cast< size_t >( 0 ) );
+    XSTestAssertEqual( table.expire( now + std::chrono::minutes( 121 ) ), static_cast< size_t >( 1 ) );
+    XSTestAssertEqual( table.size(),                                      static_cast< size_t >( 0 ) );
+    XSTestAssertEqual( table.stats().expired,                             static_cast< uint64_t >( 101 ) );
+}
+
+XSTest( SessionTable, ExpireSpread )
+{
+    SRP::SessionTable table( 1000, std::chrono::seconds( 30 ), std::chrono::milliseconds( 1 ), 4 );
+    auto              test = TestVectors::all()[ 0 ];
+    
+    /* Deadlines on every wheel level, so empty stretches are skipped and slots cascade - None is due while inserting */
+    for( uint64_t i = 0; i < 200; i++ )
+    {
+        XSTestAssertTrue( table.insert( i, makeServer( test ), std::chrono::milliseconds( 1000 + ( i * i * 97 ) ) ) );
+    }
+    
+    /* After all insertions, so each session is due by the matching step */
+    auto   now     = SRP::SessionTable::Clock::now();
+    size_t expired = 0;
+    
+    for( uint64_t i = 0; i < 200; i++ )
+    {
+        expired += table.expire( now + std::chrono::milliseconds( 1001 + ( i * i * 97 ) ) );
+        
+        XSTestAssertEqual( expired,      static_cast< size_t >( i + 1 ) );
+        XSTestAssertEqual( table.size(), static_cast< size_t >( 199 - i ) );
+    }
+}
+
+XSTest( SessionTable, Precomputed )
+{
+    SRP::SessionTable table( 100, std::chrono::minutes( 1 ) );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        SRP::Server server      = makeServer( test );
+        auto        precomputed = std::make_shared< SRP::PrecomputedVerifier >( server );
+        
+        server.setPrecomputed( precomputed );
+        server.setA( test.A() );
+        
+        XSTestAssertTrue( table.insert( 1, std::move( server ) ) );
+        
+        auto taken = table.take( 1 );
+        
+        XSTestAssertTrue( taken.has_value() );
+        XSTestAssertTrue( taken->precomputed() == precomputed );
+        XSTestAssertTrue( taken->identity()    == test.identity() );
+        XSTestAssertTrue( taken->A()           == test.A() );
+        XSTestAssertTrue( taken->S()           == test.S() );
+        XSTestAssertTrue( taken->M2()          == test.M2() );
+    }
+}
+
+XSTest( SessionTable, ExpireOnAccess )
+{
+    SRP::SessionTable table( 100, std::chrono::milliseconds( 5 ), std::chrono::milliseconds( 1 ) );
+    auto              test = TestVectors::all()[ 0 ];
+    
+    XSTestAssertTrue( table.insert( 1, makeServer( test ) ) );
+    
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    
+    XSTestAssertFalse( table.contains( 1 ) );
+    XSTestAssertFalse( table.take( 1 ).has_value() );
+    XSTestAssertEqual( table.stats().expired, static_cast< uint64_t >( 1 ) );
+}
+
+XSTest( SessionTable, Stats )
+{
+    SRP::SessionTable table( 100, std::chrono::minutes( 1 ) );
+    auto              test = TestVectors::all()[ 0 ];
+    
+    table.insert( 1, makeServer( test ) );
+    table.insert( 2, makeServer( test ) );
+    table.take( 1 );
+    
+    SRP::SessionTable::Stats stats = table.stats();
+    
+    XSTestAssertEqual( stats.sessions, static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( stats.inserted, static_cast< uint64_t >( 2 ) );
+    XSTestAssertEqual( stats.taken,    static_cast< uint64_t >( 1 ) );
+    XSTestAssertTrue( stats.capacity >= 100 );
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+XSTest( ShardRing, Route )
+{
+    SRP::ShardRing ring;
+    
+    XSTestAssertThrow( ring.route( "alice" ), std::runtime_error );
+    XSTestAssertTrue( ring.route( "alice", 2 ).empty() );
+    
+    ring.add( "node-1" );
+    ring.add( "node-2" );
+    ring.add( "node-3", 2 );
+    
+    XSTestAssertThrow( ring.add( "node-1" ),    std::runtime_error );
+    XSTestAssertThrow( ring.add( "node-4", 0 ), std::runtime_error );
+    XSTestAssertEqual( ring.size(), static_cast< size_t >( 3 ) );
+    XSTestAssertTrue( ring.contains( "node-3" ) );
+    XSTestAssertEqual( ring.route( "alice", 5 ).size(), static_cast< size_t >( 3 ) );
+    XSTestAssertTrue( ring.route( "alice", 1 )[ 0 ] == ring.route( "alice" ) );
+    
+    std::map< std::string, size_t > counts;
+    
+    for( size_t i = 0; i < 40000; i++ )
+    {
+        counts[ ring.route( "user" + std::to_string( i ) ) ]++;
+    }
+    
+    /* Proportional to the weights, within a few percent */
+    XSTestAssertTrue( counts[ "node-1" ] > 8000  && counts[ "node-1" ] < 12000 );
+    XSTestAssertTrue( counts[ "node-2" ] > 8000  && counts[ "node-2" ] < 12000 );
+    XSTestAssertTrue( counts[ "node-3" ] > 16000 && counts[ "node-3" ] < 24000 );
+}
+
+XSTest( ShardRing, Deterministic )
+{
+    SRP::ShardRing r1;
+    SRP::ShardRing r2;
+    
+    r1.add( "a" );
+    r1.add( "b" );
+    r1.add( "c" );
+    r2.add( "c" );
+    r2.add( "a" );
+    r2.add( "b" );
+    
+    SRP::ShardRing r3( r1 );
+    
+    r1.remove( "a" );
+    
+    for( size_t i = 0; i < 1000; i++ )
+    {
+        std::string identity = "user" + std::to_string( i );
+        
+        XSTestAssertTrue( r2.route( identity ) == r3.route( identity ) );
+        XSTestAssertTrue( r1.route( identity ) != "a" );
+    }
+}
+
+XSTest( ShardRing, Rebalance )
+{
+    SRP::ShardRing before;
+    
+    before.add( "node-1" );
+    before.add( "node-2" );
+    before.add( "node-3" );
+    
+    SRP::ShardRing after( before );
+    
+    after.add( "node-4" );
+    
+    auto   moves = before.rebalance( after );
+    size_t moved = 0;
+    
+    XSTestAssertFalse( moves.empty() );
+    XSTestAssertTrue( after.rebalance( after ).empty() );
+    
+    for( const auto & move: moves )
+    {
+        XSTestAssertTrue( move.to == "node-4" );
+        XSTestAssertTrue( move.first <= move.last );
+    }
+    
+    for( size_t i = 0; i < 20000; i++ )
+    {
+        std::string identity = "user" + std::to_string( i );
+        uint64_t    hash     = SRP::ShardRing::hash( identity );
+        bool        inMove   = false;
+        
+        for( const auto & move: moves )
+        {
+            if( hash >= move.first && hash <= move.last )
+            {
+                inMove = true;
+                
+                XSTestAssertTrue( move.from == before.route( identity ) );
+            }
+        }
+        
+        XSTestAssertTrue( inMove == ( before.route( identity ) != after.route( identity ) ) );
+        
+        moved += inMove ? 1 : 0;
+    }
+    
+    /* About a quarter of the identities move to the new shard, give or take the virtual node placement */
+    XSTestAssertTrue( moved > 3500 && moved < 6500 );
+}
+
+XSTest( ShardRing, Stores )
+{
+    SRP::ShardRing                                                 ring;
+    std::map< std::string, SRP::VerifierStore::Builder >           builders;
+    std::map< std::string, std::unique_ptr< SRP::VerifierStore > > stores;
+    std::vector< std::string >                                     paths;
+    
+    ring.add( "shard-1" );
+    ring.add( "shard-2" );
+    ring.add( "shard-3" );
+    
+    for( size_t i = 0; i < 300; i++ )
+    {
+        std::string identity = "user" + std::to_string( i );
+        
+        builders[ ring.route( identity ) ].add( identity, SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { 1, 2, 3 }, SRP::BigNum( static_cast< int64_t >( i ) ) );
+    }
+    
+    for( const auto & shard: ring.shards() )
+    {
+        std::string path = ( std::filesystem::temp_directory_path() / ( "SRPXX-Tests-ShardRing-" + shard.name ) ).string();
+        
+        builders[ shard.name ].write( path );
+        
+        paths.push_back( path );
+        
+        stores[ shard.name ] = std::make_unique< SRP::VerifierStore >( path );
+    }
+    
+    for( size_t i = 0; i < 300; i++ )
+    {
+        std::string identity = "user" + std::to_string( i );
+        auto        record   = stores[ ring.route( identity ) ]->find( identity );
+        
+        XSTestAssertTrue( record.has_value() );
+        XSTestAssertTrue( SRP::BigNum( record->verifier ) == SRP::BigNum( static_cast< int64_t >( i ) ) );
+    }
+    
+    stores.clear();
+    
+    for( const auto & path: paths )
+    {
+        std::remove( path.c_str() );
+    }
+}
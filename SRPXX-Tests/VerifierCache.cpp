@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+XSTest( VerifierCache, Server )
+{
+    SRP::VerifierCache cache( 64 * 1024 * 1024 );
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        /* Test vectors share identities, which would be admitted right away */
+        cache.clear();
+        
+        for( size_t i = 0; i < 3; i++ )
+        {
+            SRP::Server server( test.identity(), test.hashAlgorithm(), test.groupType(), test.b() );
+            
+            server.setSalt( test.salt() );
+            server.setV( test.v() );
+            server.setPrecomputed( cache.get( server ) );
+            server.setA( test.A() );
+            
+            XSTestAssertTrue( server.v()  == test.v() );
+            XSTestAssertTrue( server.B()  == test.B() );
+            XSTestAssertTrue( server.S()  == test.S() );
+            XSTestAssertTrue( server.M2() == test.M2() );
+        }
+    }
+    
+    auto stats = cache.stats();
+    
+    XSTestAssertEqual( stats.hits,   static_cast< uint64_t >( TestVectors::all().size() ) );
+    XSTestAssertEqual( stats.misses, static_cast< uint64_t >( TestVectors::all().size() * 2 ) );
+    XSTestAssertTrue( stats.memory > 0 && stats.memory <= stats.budget );
+}
+
+XSTest( VerifierCache, ChangedVerifier )
+{
+    SRP::VerifierCache cache( 64 * 1024 * 1024 );
+    SRP::Server        server( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    server.setV( SRP::BigNum( 42 ) );
+    
+    cache.get( server );
+    
+    auto e1 = cache.get( server );
+    auto e2 = cache.get( server );
+    
+    server.setV( SRP::BigNum( 43 ) );
+    
+    /* Already admitted */
+    auto e3 = cache.get( server );
+    
+    XSTestAssertTrue( e1 != nullptr );
+    XSTestAssertTrue( e1 == e2 );
+    XSTestAssertTrue( e1 != e3 );
+    XSTestAssertTrue( e3->v() == SRP::BigNum( 43 ) );
+    XSTestAssertEqual( cache.stats().entries, static_cast< size_t >( 1 ) );
+    XSTestAssertEqual( cache.stats().hits,    static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( cache.stats().misses,  static_cast< uint64_t >( 3 ) );
+    
+    cache.remove( "alice" );
+    
+    XSTestAssertEqual( cache.stats().entries, static_cast< size_t >( 0 ) );
+    XSTestAssertEqual( cache.stats().memory,  static_cast< size_t >( 0 ) );
+}
+
+XSTest( VerifierCache, Eviction )
+{
+    SRP::Server server( "", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    server.setV( SRP::BigNum( 2 ) );
+    
+    size_t             size = SRP::PrecomputedVerifier( server ).memory();
+    SRP::VerifierCache cache( size * 3 );
+    
+    auto get = [ & ]( const std::string & identity )
+    {
+        SRP::Server s( identity, SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+        
+        s.setV( SRP::BigNum( 2 ) );
+        
+        return cache.get( s );
+    };
+    
+    for( const char * identity: { "a", "b", "c" } )
+    {
+        get( identity );
+        get( identity );
+    }
+    
+    get( "a" );
+    get( "d" );
+    get( "d" );
+    
+    XSTestAssertEqual( cache.stats().entries,   static_cast< size_t >( 3 ) );
+    XSTestAssertEqual( cache.stats().evictions, static_cast< uint64_t >( 1 ) );
+    
+    /* a was referenced, so b was evicted */
+    get( "a" );
+    get( "c" );
+    get( "d" );
+    
+    XSTestAssertEqual( cache.stats().misses, static_cast< uint64_t >( 8 ) );
+    XSTestAssertEqual( cache.stats().hits,   static_cast< uint64_t >( 4 ) );
+    
+    SRP::VerifierCache small( size - 1 );
+    SRP::Server        s( "a", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    s.setV( SRP::BigNum( 2 ) );
+    small.get( s );
+    
+    XSTestAssertTrue( small.get( s ) != nullptr );
+    XSTestAssertEqual( small.stats().entries, static_cast< size_t >( 0 ) );
+    
+    cache.clear();
+    
+    XSTestAssertEqual( cache.stats().entries, static_cast< size_t >( 0 ) );
+}
+
+XSTest( VerifierCache, Admission )
+{
+    SRP::VerifierCache cache( 64 * 1024 * 1024 );
+    SRP::Server        server( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    
+    server.setV( SRP::BigNum( 42 ) );
+    
+    /* A single authentication does not compute an entry */
+    XSTestAssertTrue( cache.get( server ) == nullptr );
+    XSTestAssertEqual( cache.stats().entries, static_cast< size_t >( 0 ) );
+    XSTestAssertTrue( cache.get( server ) != nullptr );
+    XSTestAssertEqual( cache.stats().entries, static_cast< size_t >( 1 ) );
+}
+
+XSTest( VerifierCache, SetPrecomputedMismatch )
+{
+    SRP::Server server( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048 );
+    SRP::Server group(  "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG1024 );
+    SRP::Server hash(   "alice", SRP::HashAlgorithm::SHA1,   SRP::Base::GroupType::NG2048 );
+    
+    server.setV( SRP::BigNum( 42 ) );
+    
+    auto precomputed = std::make_shared< SRP::PrecomputedVerifier >( server );
+    
+    XSTestAssertThrow( group.setPrecomputed( precomputed ), std::runtime_error );
+    XSTestAssertThrow( hash.setPrecomputed( precomputed ),  std::runtime_error );
+    XSTestAssertTrue( group.precomputed() == nullptr );
+    
+    server.setPrecomputed( precomputed );
+    
+    XSTestAssertTrue( server.precomputed() == precomputed );
+}
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::string tempPath( const std::string & name )
+    {
+        return ( std::filesystem::temp_directory_path() / ( "SRPXX-Tests-" + name ) ).string();
+    }
+    
+    std::string writeStore( const std::string & name, uint64_t verifier )
+    {
+        std::string                 path = tempPath( name );
+        SRP::VerifierStore::Builder builder;
+        
+        builder.add( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { 1, 2, 3 }, SRP::BigNum( verifier ) );
+        builder.write( path );
+        
+        return path;
+    }
+}
+
+XSTest( VerifierDirectory, Publish )
+{
+    SRP::VerifierDirectory directory;
+    
+    {
+        auto reader = directory.read();
+        
+        XSTestAssertTrue( reader.store() == nullptr );
+        XSTestAssertFalse( reader.find( "alice" ).has_value() );
+    }
+    
+    std::string path = writeStore( "VerifierDirectory-Publish", 42 );
+    
+    directory.publish( path );
+    std::remove( path.c_str() );
+    
+    {
+        auto reader = directory.read();
+        auto record = reader.find( "alice" );
+        
+        XSTestAssertTrue( record.has_value() );
+        XSTestAssertTrue( SRP::BigNum( record->verifier ) == SRP::BigNum( 42 ) );
+        XSTestAssertFalse( reader.find( "bob" ).has_value() );
+    }
+    
+    XSTestAssertEqual( directory.version(), static_cast< uint64_t >( 1 ) );
+    XSTestAssertEqual( directory.retired(), static_cast< size_t >( 0 ) );
+}
+
+XSTest( VerifierDirectory, PinnedSnapshot )
+{
+    SRP::VerifierDirectory directory;
+    std::string            path1 = writeStore( "VerifierDirectory-Pinned-1", 1 );
+    std::string            path2 = writeStore( "VerifierDirectory-Pinned-2", 2 );
+    
+    directory.publish( path1 );
+    
+    {
+        auto reader = directory.read();
+        
+        directory.publish( path2 );
+        
+        XSTestAssertTrue( SRP::BigNum( reader.find( "alice" )->verifier ) == SRP::BigNum( 1 ) );
+        XSTestAssertTrue( SRP::BigNum( directory.read().find( "alice" )->verifier ) == SRP::BigNum( 2 ) );
+        XSTestAssertEqual( directory.retired(), static_cast< size_t >( 1 ) );
+        XSTestAssertEqual( directory.reclaim(), static_cast< size_t >( 1 ) );
+    }
+    
+    XSTestAssertEqual( directory.reclaim(), static_cast< size_t >( 0 ) );
+    XSTestAssertTrue( SRP::BigNum( directory.read().find( "alice" )->verifier ) == SRP::BigNum( 2 ) );
+    XSTestAssertEqual( directory.version(), static_cast< uint64_t >( 2 ) );
+    
+    std::remove( path1.c_str() );
+    std::remove( path2.c_str() );
+}
+
+XSTest( VerifierDirectory, ConcurrentReaders )
+{
+    SRP::VerifierDirectory     directory;
+    std::vector< std::string > paths;
+    std::atomic< bool >        done( false );
+    std::atomic< bool >        failed( false );
+    std::vector< std::thread > threads;
+    
+    for( uint64_t i = 1; i <= 8; i++ )
+    {
+        paths.push_back( writeStore( "VerifierDirectory-Concurrent-" + std::to_string( i ), i ) );
+    }
+    
+    directory.publish( paths[ 0 ] );
+    
+    for( size_t i = 0; i < 4; i++ )
+    {
+        threads.emplace_back
+        (
+            [ & ]
+            {
+                while( done == false )
+                {
+                    auto reader = directory.read();
+                    auto record = reader.find( "alice" );
+                    
+                    if( record.has_value() == false || SRP::BigNum( record->verifier ) < SRP::BigNum( 1 ) || SRP::BigNum( record->verifier ) > SRP::BigNum( 8 ) )
+                    {
+                        failed = true;
+                    }
+                }
+            }
+        );
+    }
+    
+    for( size_t i = 0; i < 64; i++ )
+    {
+        directory.publish( paths[ i % paths.size() ] );
+    }
+    
+    done = true;
+    
+    for( auto & thread: threads )
+    {
+        thread.join();
+    }
+    
+    XSTestAssertFalse( failed );
+    XSTestAssertEqual( directory.reclaim(), static_cast< size_t >( 0 ) );
+    XSTestAssertEqual( directory.version(), static_cast< uint64_t >( 65 ) );
+    
+    for( const auto & path: paths )
+    {
+        std::remove( path.c_str() );
+    }
+}
@@ -0,0 +1,350 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::string tempDirectory( const std::string & name )
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / ( "SRPXX-Tests-" + name );
+        
+        std::filesystem::remove_all( path );
+        
+        return path.string();
+    }
+    
+    void put( SRP::VerifierLog & log, const std::string & identity, int64_t verifier )
+    {
+        log.put( identity, SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { 1, 2, 3 }, SRP::BigNum( verifier ) ).get();
+    }
+    
+    bool hasVerifier( const SRP::VerifierLog & log, const std::string & identity, int64_t verifier )
+    {
+        auto record = log.find( identity );
+        
+        return record.has_value() && record->verifier == SRP::BigNum( verifier );
+    }
+}
+
+XSTest( VerifierLog, PutFind )
+{
+    std::string directory = tempDirectory( "VerifierLog-PutFind" );
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        for( const auto & test: TestVectors::all() )
+        {
+            log.put( test.identity(), test.hashAlgorithm(), test.groupType(), test.salt(), test.v() ).get();
+            
+            auto record = log.find( test.identity() );
+            
+            XSTestAssertTrue( record.has_value() );
+            XSTestAssertTrue( record->hashAlgorithm == test.hashAlgorithm() );
+            XSTestAssertTrue( record->groupType     == test.groupType() );
+            XSTestAssertTrue( record->salt          == test.salt() );
+            XSTestAssertTrue( record->verifier      == test.v() );
+        }
+        
+        XSTestAssertFalse( log.find( "unknown" ).has_value() );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, Reopen )
+{
+    std::string directory = tempDirectory( "VerifierLog-Reopen" );
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        put( log, "alice", 1 );
+        put( log, "bob",   2 );
+        put( log, "alice", 3 );
+        log.remove( "bob" ).get();
+    }
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        XSTestAssertEqual( log.size(), static_cast< size_t >( 1 ) );
+        XSTestAssertTrue( hasVerifier( log, "alice", 3 ) );
+        XSTestAssertFalse( log.find( "bob" ).has_value() );
+        
+        put( log, "bob", 4 );
+    }
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        XSTestAssertTrue( hasVerifier( log, "alice", 3 ) );
+        XSTestAssertTrue( hasVerifier( log, "bob",   4 ) );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, GroupCommit )
+{
+    std::string directory = tempDirectory( "VerifierLog-GroupCommit" );
+    
+    {
+        SRP::VerifierLog                   log( directory );
+        std::vector< std::future< void > > futures;
+        
+        for( int64_t i = 0; i < 1000; i++ )
+        {
+            futures.push_back( log.put( "user" + std::to_string( i ), SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { 1 }, SRP::BigNum( i ) ) );
+        }
+        
+        for( auto & future: futures )
+        {
+            future.get();
+        }
+        
+        SRP::VerifierLog::Stats stats = log.stats();
+        
+        XSTestAssertEqual( stats.records,    static_cast< uint64_t >( 1000 ) );
+        XSTestAssertEqual( stats.identities, static_cast< uint64_t >( 1000 ) );
+        XSTestAssertTrue( stats.commits > 0 );
+        XSTestAssertTrue( stats.commits <= stats.records );
+        XSTestAssertTrue( hasVerifier( log, "user999", 999 ) );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, Compact )
+{
+    std::string               directory = tempDirectory( "VerifierLog-Compact" );
+    SRP::VerifierLog::Options options;
+    
+    options.segmentSize         = 256;
+    options.compactionThreshold = 2;
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        for( int64_t i = 0; i < 100; i++ )
+        {
+            put( log, "alice", i );
+            put( log, "bob",   i + 1000 );
+        }
+        
+        log.remove( "bob" ).get();
+        put( log, "carol", 42 );
+        
+        SRP::VerifierLog::Stats before = log.stats();
+        
+        log.compact();
+        
+        SRP::VerifierLog::Stats after = log.stats();
+        
+        XSTestAssertTrue( after.segments   < before.segments );
+        XSTestAssertTrue( after.totalBytes < before.totalBytes );
+        XSTestAssertEqual( after.compactions, static_cast< uint64_t >( 1 ) );
+        XSTestAssertTrue( hasVerifier( log, "alice", 99 ) );
+        XSTestAssertTrue( hasVerifier( log, "carol", 42 ) );
+        XSTestAssertFalse( log.find( "bob" ).has_value() );
+        
+        put( log, "alice", 7 );
+    }
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        XSTestAssertEqual( log.size(), static_cast< size_t >( 2 ) );
+        XSTestAssertTrue( hasVerifier( log, "alice", 7 ) );
+        XSTestAssertTrue( hasVerifier( log, "carol", 42 ) );
+        XSTestAssertFalse( log.find( "bob" ).has_value() );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, CompactTombstones )
+{
+    std::string               directory = tempDirectory( "VerifierLog-CompactTombstones" );
+    SRP::VerifierLog::Options options;
+    
+    options.segmentSize         = 256;
+    options.compactionThreshold = 2;
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        for( int64_t i = 0; i < 20; i++ )
+        {
+            put( log, "user" + std::to_string( i ), i );
+        }
+        
+        for( int64_t i = 0; i < 20; i++ )
+        {
+            log.remove( "user" + std::to_string( i ) ).get();
+        }
+        
+        for( int64_t i = 0; i < 20; i++ )
+        {
+            put( log, "alice", i );
+        }
+        
+        log.compact();
+        
+        SRP::VerifierLog::Stats first = log.stats();
+        
+        /* The puts are gone, so the tombstones are too */
+        log.compact();
+        
+        SRP::VerifierLog::Stats second = log.stats();
+        
+        XSTestAssertTrue( second.totalBytes < first.totalBytes );
+        XSTestAssertEqual( log.size(), static_cast< size_t >( 1 ) );
+        
+        put( log, "carol", 7 );
+        
+        for( int64_t i = 20; i < 40; i++ )
+        {
+            put( log, "alice", i );
+        }
+        
+        log.compact();
+    }
+    
+    std::filesystem::path compacted;
+    
+    for( const auto & entry: std::filesystem::directory_iterator( directory ) )
+    {
+        if( entry.path().extension() == ".compact" )
+        {
+            compacted = entry.path();
+        }
+    }
+    
+    XSTestAssertFalse( compacted.empty() );
+    
+    uintmax_t size = std::filesystem::file_size( compacted );
+    
+    /* New writes go to the active segment, not to the compacted one */
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        put( log, "bob", 42 );
+    }
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        XSTestAssertEqual( log.size(), static_cast< size_t >( 3 ) );
+        XSTestAssertTrue( hasVerifier( log, "alice", 39 ) );
+        XSTestAssertTrue( hasVerifier( log, "carol", 7 ) );
+        XSTestAssertTrue( hasVerifier( log, "bob",   42 ) );
+        XSTestAssertFalse( log.find( "user0" ).has_value() );
+    }
+    
+    XSTestAssertEqual( std::filesystem::file_size( compacted ), size );
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, BackgroundCompaction )
+{
+    std::string               directory = tempDirectory( "VerifierLog-BackgroundCompaction" );
+    SRP::VerifierLog::Options options;
+    
+    options.segmentSize         = 256;
+    options.compactionThreshold = 0.5;
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        for( int64_t i = 0; i < 200; i++ )
+        {
+            put( log, "alice", i );
+        }
+        
+        for( int i = 0; i < 500 && log.stats().compactions == 0; i++ )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        }
+        
+        XSTestAssertTrue( log.stats().compactions > 0 );
+        XSTestAssertTrue( hasVerifier( log, "alice", 199 ) );
+    }
+    
+    {
+        SRP::VerifierLog log( directory, options );
+        
+        XSTestAssertTrue( hasVerifier( log, "alice", 199 ) );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
+
+XSTest( VerifierLog, TornWrite )
+{
+    std::string directory = tempDirectory( "VerifierLog-TornWrite" );
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        put( log, "alice", 1 );
+        put( log, "bob",   2 );
+    }
+    
+    for( const auto & entry: std::filesystem::directory_iterator( directory ) )
+    {
+        std::ofstream stream( entry.path(), std::ios::binary | std::ios::app );
+        
+        stream << std::string( 20, 'x' );
+    }
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        XSTestAssertTrue( hasVerifier( log, "alice", 1 ) );
+        XSTestAssertTrue( hasVerifier( log, "bob",   2 ) );
+        
+        put( log, "carol", 3 );
+    }
+    
+    {
+        SRP::VerifierLog log( directory );
+        
+        XSTestAssertEqual( log.size(), static_cast< size_t >( 3 ) );
+        XSTestAssertTrue( hasVerifier( log, "carol", 3 ) );
+    }
+    
+    std::filesystem::remove_all( directory );
+}
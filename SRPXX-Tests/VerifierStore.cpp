@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    std::string tempPath( const std::string & name )
+    {
+        return ( std::filesystem::temp_directory_path() / ( "SRPXX-Tests-" + name ) ).string();
+    }
+}
+
+XSTest( VerifierStore, Find )
+{
+    std::string                 path  = tempPath( "VerifierStore-Find" );
+    SRP::VerifierStore::Builder builder;
+    std::vector< TestVectors >  tests = TestVectors::all();
+    
+    for( size_t i = 0; i < tests.size(); i++ )
+    {
+        builder.add( tests[ i ].identity() + std::to_string( i ), tests[ i ].hashAlgorithm(), tests[ i ].groupType(), tests[ i ].salt(), tests[ i ].v() );
+    }
+    
+    builder.write( path );
+    
+    {
+        SRP::VerifierStore store( path );
+        
+        XSTestAssertEqual( store.size(), tests.size() );
+        XSTestAssertFalse( store.find( "unknown" ).has_value() );
+        
+        for( size_t i = 0; i < tests.size(); i++ )
+        {
+            auto record = store.find( tests[ i ].identity() + std::to_string( i ) );
+            
+            XSTestAssertTrue( record.has_value() );
+            XSTestAssertTrue( record->hashAlgorithm == tests[ i ].hashAlgorithm() );
+            XSTestAssertTrue( record->groupType     == tests[ i ].groupType() );
+            XSTestAssertTrue( std::vector< uint8_t >( record->salt, record->salt + record->saltLength ) == tests[ i ].salt() );
+            XSTestAssertTrue( SRP::BigNum( record->verifier ) == tests[ i ].v() );
+        }
+    }
+    
+    std::remove( path.c_str() );
+}
+
+XSTest( VerifierStore, Server )
+{
+    std::string                 path = tempPath( "VerifierStore-Server" );
+    SRP::VerifierStore::Builder builder;
+    
+    for( const auto & test: TestVectors::all() )
+    {
+        builder.add( test.identity(), test.hashAlgorithm(), test.groupType(), test.salt(), test.v() );
+        builder.write( path );
+        
+        SRP::VerifierStore store( path );
+        auto               record = store.find( test.identity() );
+        
+        XSTestAssertTrue( record.has_value() );
+        
+        SRP::Server server( std::string( record->identity ), record->hashAlgorithm, record->groupType, test.b() );
+        
+        server.setSalt( record->salt, record->saltLength );
+        server.setV( record->verifier );
+        server.setA( test.A() );
+        
+        XSTestAssertTrue( server.B()  == test.B() );
+        XSTestAssertTrue( server.M2() == test.M2() );
+    }
+    
+    std::remove( path.c_str() );
+}
+
+XSTest( VerifierStore, Replace )
+{
+    std::string                 path = tempPath( "VerifierStore-Replace" );
+    SRP::VerifierStore::Builder builder;
+    
+    builder.add( "alice", SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { 1, 2, 3 }, SRP::BigNum( 42 ) );
+    builder.add( "alice", SRP::HashAlgorithm::SHA512, SRP::Base::GroupType::NG4096, { 4, 5 },    SRP::BigNum( 43 ) );
+    builder.write( path );
+    
+    {
+        SRP::VerifierStore store( path );
+        auto               record = store.find( "alice" );
+        
+        XSTestAssertEqual( builder.size(), static_cast< size_t >( 1 ) );
+        XSTestAssertEqual( store.size(),   static_cast< size_t >( 1 ) );
+        XSTestAssertTrue( record.has_value() );
+        XSTestAssertTrue( record->hashAlgorithm == SRP::HashAlgorithm::SHA512 );
+        XSTestAssertTrue( record->groupType     == SRP::Base::GroupType::NG4096 );
+        XSTestAssertEqual( record->saltLength, static_cast< size_t >( 2 ) );
+        XSTestAssertTrue( SRP::BigNum( record->verifier ) == SRP::BigNum( 43 ) );
+    }
+    
+    std::remove( path.c_str() );
+}
+
+XSTest( VerifierStore, Many )
+{
+    std::string                 path = tempPath( "VerifierStore-Many" );
+    SRP::VerifierStore::Builder builder;
+    
+    for( int64_t i = 0; i < 10000; i++ )
+    {
+        builder.add( "user" + std::to_string( i ), SRP::HashAlgorithm::SHA256, SRP::Base::GroupType::NG2048, { static_cast< uint8_t >( i ) }, SRP::BigNum( i + 1 ) );
+    }
+    
+    builder.write( path );
+    
+    {
+        SRP::VerifierStore store( path );
+        bool               found = true;
+        
+        for( int64_t i = 0; i < 10000; i++ )
+        {
+            auto record = store.find( "user" + std::to_string( i ) );
+            
+            found = found && record.has_value() && SRP::BigNum( record->verifier ) == SRP::BigNum( i + 1 );
+        }
+        
+        XSTestAssertTrue( found );
+        XSTestAssertFalse( store.find( "user10000" ).has_value() );
+    }
+    
+    std::remove( path.c_str() );
+}
+
+XSTest( VerifierStore, Invalid )
+{
+    std::string path = tempPath( "VerifierStore-Invalid" );
+    
+    {
+        std::ofstream stream( path, std::ios::binary | std::ios::trunc );
+        
+        stream << std::string( 128, 'x' );
+    }
+    
+    XSTestAssertThrow( SRP::VerifierStore{ path },                     std::runtime_error );
+    XSTestAssertThrow( SRP::VerifierStore{ tempPath( "not-found" ) }, std::runtime_error );
+    
+    std::remove( path.c_str() );
+}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX.hpp>
+#include <XSTest/XSTest.hpp>
+#include "TestVectors.hpp"
+#include <vector>
+
+XSTest( Wire, Handshake )
+{
+    for( const auto & test: TestVectors::all() )
+    {
+        auto                   client = test.makeClient();
+        auto                   server = test.makeServer();
+        std::vector< uint8_t > buffer( SRP::Wire::maxLength );
+        SRP::Wire::Message     message;
+        size_t                 length;
+        
+        server->setSalt( test.salt() );
+        server->setV( test.v() );
+        
+        /* Hello */
+        length = SRP::Wire::encodeHello( *( client ), buffer.data(), buffer.size() );
+        
+        XSTestAssertTrue( length == SRP::Wire::headerLength + 1 + test.identity().size() + SRP::Wire::valueLength( test.groupType() ) );
+        XSTestAssertTrue( SRP::Wire::parse( buffer.data(), buffer.size(), message ) == length );
+        XSTestAssertTrue( message.type          == SRP::Wire::Type::Hello );
+        XSTestAssertTrue( message.hashAlgorithm == test.hashAlgorithm() );
+        XSTestAssertTrue( message.groupType     == test.groupType() );
+        XSTestAssertTrue( message.identity      == test.identity() );
+        XSTestAssertTrue( message.A.data()      == buffer.data() + length - message.A.size() );
+        XSTestAssertTrue( message.A.compare( test.A() ) == 0 );
+        
+        server->setA( message.A );
+        
+        /* Challenge */
+        length = SRP::Wire::encodeChallenge( *( server ), buffer.data(), buffer.size() );
+        
+        XSTestAssertTrue( SRP::Wire::parse( buffer.data(), length, message ) == length );
+        XSTestAssertTrue( message.type == SRP::Wire::Type::Challenge );
+        XSTestAssertTrue( std::vector< uint8_t >( message.salt.data, message.salt.data + message.salt.length ) == test.salt() );
+        XSTestAssertTrue( message.B.compare( test.B() ) == 0 );
+        
+        client->setPassword( test.password() );
+        client->setSalt( message.salt.data, message.salt.length );
+        client->setB( message.B );
+        
+        /* Client proof */
+        length = SRP::Wire::encodeClientProof( *( client ), buffer.data(), buffer.size() );
+        
+        XSTestAssertTrue( SRP::Wire::parse( buffer.data(), length, message ) == length );
+        XSTestAssertTrue( message.type == SRP::Wire::Type::ClientProof );
+        XSTestAssertTrue( std::vector< uint8_t >( message.M1.data, message.M1.data + message.M1.length ) == test.M1() );
+        
+        std::vector< uint8_t > M2 = server->verifyM1( message.M1.data, message.M1.length );
+        
+        /* Server proof */
+        length = SRP::Wire::encodeServerProof( *( server ), M2, buffer.data(), buffer.size() );
+        
+        XSTestAssertTrue( SRP::Wire::parse( buffer.data(), length, message ) == length );
+        XSTestAssertTrue( message.type == SRP::Wire::Type::ServerProof );
+        XSTestAssertTrue( std::vector< uint8_t >( message.M2.data, message.M2.data + message.M2.length ) == test.M2() );
+    }
+}
+
+XSTest( Wire, Partial )
+{
+    auto                   test   = TestVectors::all().front();
+    auto                   client = test.makeClient();
+    std::vector< uint8_t > buffer( SRP::Wire::maxLength );
+    SRP::Wire::Message     message;
+    size_t                 length = SRP::Wire::encodeHello( *( client ), buffer.data(), buffer.size() );
+    
+    for( size_t i = 0; i < length; i++ )
+    {
+        XSTestAssertTrue( SRP::Wire::parse( buffer.data(), i, message ) == 0 );
+    }
+    
+    XSTestAssertTrue( SRP::Wire::encodeHello( *( client ), buffer.data(), length - 1 ) == 0 );
+    XSTestAssertTrue( SRP::Wire::encodeHello( *( client ), buffer.data(), length )     == length );
+}
+
+XSTest( Wire, Malformed )
+{
+    auto                   test   = TestVectors::all().front();
+    auto                   client = test.makeClient();
+    std::vector< uint8_t > buffer( SRP::Wire::maxLength );
+    SRP::Wire::Message     message;
+    size_t                 length = SRP::Wire::encodeHello( *( client ), buffer.data(), buffer.size() );
+    
+    for( size_t i: { 0, 1, 2, 3 } )
+    {
+        std::vector< uint8_t > copy = buffer;
+        
+        copy[ i ] = 0xFF;
+        
+        XSTestAssertThrow( SRP::Wire::parse( copy.data(), length, message ), std::runtime_error );
+    }
+    
+    /* Body length not matching the fields */
+    {
+        std::vector< uint8_t > copy = buffer;
+        
+        copy[ 4 ]++;
+        
+        XSTestAssertThrow( SRP::Wire::parse( copy.data(), length + 1, message ), std::runtime_error );
+    }
+    
+    /* Identity longer than the body */
+    {
+        std::vector< uint8_t > copy = buffer;
+        
+        copy[ SRP::Wire::headerLength ] = 0xFF;
+        
+        XSTestAssertThrow( SRP::Wire::parse( copy.data(), length, message ), std::runtime_error );
+    }
+    
+    /* Rejected from the header alone */
+    {
+        std::vector< uint8_t > copy = buffer;
+        
+        copy[ 7 ] = 0x01;
+        
+        XSTestAssertThrow( SRP::Wire::parse( copy.data(), SRP::Wire::headerLength, message ), std::runtime_error );
+    }
+    
+    /* Proof of the wrong size */
+    buffer[ 1 ] = static_cast< uint8_t >( SRP::Wire::Type::ClientProof );
+    
+    XSTestAssertThrow( SRP::Wire::parse( buffer.data(), length, message ), std::runtime_error );
+}
@@ -26,11 +26,17 @@
 #define SRPXX_HPP
 
 #include <SRPXX/Platform.hpp>
+#include <SRPXX/Allocator.hpp>
+#include <SRPXX/PoolAllocator.hpp>
+#include <SRPXX/SecureArena.hpp>
 #include <SRPXX/Integer.hpp>
 #include <SRPXX/String.hpp>
 #include <SRPXX/Random.hpp>
 #include <SRPXX/Base64.hpp>
 #include <SRPXX/BigNum.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/FixedBase.hpp>
+#include <SRPXX/GroupTables.hpp>
 #include <SRPXX/HashAlgorithm.hpp>
 #include <SRPXX/Hasher.hpp>
 #include <SRPXX/SHA1.hpp>
@@ -38,8 +44,28 @@
 #include <SRPXX/SHA256.hpp>
 #include <SRPXX/SHA384.hpp>
 #include <SRPXX/SHA512.hpp>
+#include <SRPXX/HMAC.hpp>
 #include <SRPXX/PBKDF2.hpp>
+#include <SRPXX/HMACDRBG.hpp>
 #include <SRPXX/Client.hpp>
 #include <SRPXX/Server.hpp>
+#include <SRPXX/Wire.hpp>
+#include <SRPXX/SessionPool.hpp>
+#include <SRPXX/SessionTable.hpp>
+#include <SRPXX/VerifierStore.hpp>
+#include <SRPXX/VerifierLog.hpp>
+#include <SRPXX/VerifierDirectory.hpp>
+#include <SRPXX/VerifierCache.hpp>
+#include <SRPXX/KeyRing.hpp>
+#include <SRPXX/SecureChannel.hpp>
+#include <SRPXX/Resumption.hpp>
+#include <SRPXX/ResumptionStore.hpp>
+#include <SRPXX/ShardRing.hpp>
+#include <SRPXX/Executor.hpp>
+#include <SRPXX/Engine.hpp>
+#include <SRPXX/Awaitable.hpp>
+#include <SRPXX/BulkRegistrar.hpp>
+#include <SRPXX/OffloadService.hpp>
+#include <SRPXX/OffloadClient.hpp>
 
 #endif /* SRPXX_HPP */
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_ALLOCATOR_HPP
+#define SRPXX_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Allocation hook used for BigNum storage and internal buffers.
+     * Returned memory must be aligned for any fundamental type.
+     */
+    class Allocator
+    {
+        public:
+            
+            static Allocator & defaultAllocator();
+            static Allocator & current();
+            
+            /* Memory is released through the allocator that provided it, so this can change at any time */
+            static void setCurrent( Allocator & allocator );
+            
+            /*
+             * Routes OpenSSL's internal allocations to an allocator.
+             * Needs to be called before OpenSSL allocates anything, and the allocator must never be destroyed.
+             * Not supported by BoringSSL.
+             */
+            static bool useForOpenSSL( Allocator & allocator );
+            
+            virtual ~Allocator() = default;
+            
+            virtual void * allocate( size_t size )              = 0;
+            virtual void * reallocate( void * p, size_t size )  = 0;
+            virtual void   deallocate( void * p )               = 0;
+    };
+    
+    template< typename T >
+    class STLAllocator
+    {
+        public:
+            
+            using value_type = T;
+            
+            STLAllocator():
+                _allocator( &( Allocator::current() ) )
+            {}
+            
+            STLAllocator( Allocator & allocator ):
+                _allocator( &allocator )
+            {}
+            
+            template< typename U >
+            STLAllocator( const STLAllocator< U > & o ):
+                _allocator( o._allocator )
+            {}
+            
+            T * allocate( size_t n )
+            {
+                void * p = this->_allocator->allocate( n * sizeof( T ) );
+                
+                if( p == nullptr )
+                {
+                    throw std::bad_alloc();
+                }
+                
+                return static_cast< T * >( p );
+            }
+            
+            void deallocate( T * p, size_t n )
+            {
+                ( void )n;
+                
+                this->_allocator->deallocate( p );
+            }
+            
+            template< typename U >
+            bool operator ==( const STLAllocator< U > & o ) const
+            {
+                return this->_allocator == o._allocator;
+            }
+            
+            template< typename U >
+            bool operator !=( const STLAllocator< U > & o ) const
+            {
+                return this->_allocator != o._allocator;
+            }
+            
+        private:
+            
+            template< typename U >
+            friend class STLAllocator;
+            
+            Allocator * _allocator;
+    };
+    
+    template< typename T >
+    using Vector = std::vector< T, STLAllocator< T > >;
+}
+
+#endif /* SRPXX_ALLOCATOR_HPP */
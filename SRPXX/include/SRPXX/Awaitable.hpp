@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_AWAITABLE_HPP
+#define SRPXX_AWAITABLE_HPP
+
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+#define SRPXX_COROUTINES 1
+#endif
+
+#ifdef SRPXX_COROUTINES
+
+#include <SRPXX/Executor.hpp>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace SRP
+{
+    /*
+     * Result of an asynchronous handshake step, to be used with co_await.
+     * The work runs on an executor, and the awaiting coroutine is resumed on
+     * the thread that completed it, unless another executor is given with resumeOn().
+     * Work only starts once awaited.
+     */
+    template< typename T >
+    class Awaitable
+    {
+        public:
+            
+            Awaitable( std::function< T() > work, Executor & executor ):
+                _work( std::move( work ) ),
+                _executor( &executor ),
+                _resumeExecutor( nullptr )
+            {}
+            
+            Awaitable( const Awaitable & o )              = delete;
+            Awaitable & operator =( const Awaitable & o ) = delete;
+            
+            Awaitable( Awaitable && o ) noexcept              = default;
+            Awaitable & operator =( Awaitable && o ) noexcept = default;
+            
+            /* Typically the caller's event loop */
+            Awaitable && resumeOn( Executor & executor ) &&
+            {
+                this->_resumeExecutor = &executor;
+                
+                return std::move( *( this ) );
+            }
+            
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+            
+            void await_suspend( std::coroutine_handle<> handle )
+            {
+                this->_executor->post
+                (
+                    [ this, handle ]
+                    {
+                        try
+                        {
+                            this->_result.emplace( this->_work() );
+                        }
+                        catch( ... )
+                        {
+                            this->_error = std::current_exception();
+                        }
+                        
+                        if( this->_resumeExecutor == nullptr )
+                        {
+                            handle.resume();
+                        }
+                        else
+                        {
+                            this->_resumeExecutor->post( [ handle ] { handle.resume(); } );
+                        }
+                    }
+                );
+            }
+            
+            T await_resume()
+            {
+                if( this->_error )
+                {
+                    std::rethrow_exception( this->_error );
+                }
+                
+                return std::move( *( this->_result ) );
+            }
+            
+        private:
+            
+            std::function< T() > _work;
+            Executor            * _executor;
+            Executor            * _resumeExecutor;
+            std::optional< T >    _result;
+            std::exception_ptr    _error;
+    };
+}
+
+#endif /* SRPXX_COROUTINES */
+
+#endif /* SRPXX_AWAITABLE_HPP */
@@ -28,9 +28,12 @@
 #include <SRPXX/HashAlgorithm.hpp>
 #include <SRPXX/Hasher.hpp>
 #include <SRPXX/BigNum.hpp>
+#include <SRPXX/BigNumView.hpp>
 #include <memory>
 #include <vector>
 #include <cstdint>
+#include <initializer_list>
+#include <string>
 
 namespace SRP
 {
@@ -55,20 +58,52 @@ namespace SRP
             Base( const Base & o )              = delete;
             Base & operator =( const Base & o ) = delete;
             
-            std::string identity() const;
+            Base( Base && o ) noexcept;
+            Base & operator =( Base && o ) noexcept;
+            
+            /* Wipes the session state, keeping the group and hash algorithm */
+            virtual void clear();
+            
+            std::string   identity()      const;
+            HashAlgorithm hashAlgorithm() const;
+            GroupType     groupType()     const;
             
             std::vector< uint8_t > salt() const;
             void                   setSalt( const std::vector< uint8_t > & value );
+            void                   setSalt( const uint8_t * data, size_t length );
             
             BigNum N() const;
             BigNum g() const;
             BigNum k() const;
             BigNum u() const;
             
+            bool isValidPublicValue( const BigNumView & value ) const;
+            
             std::vector< uint8_t > K()  const;
             std::vector< uint8_t > M1() const;
             std::vector< uint8_t > M2() const;
             
+            struct DerivedKey
+            {
+                std::string label;
+                uint8_t   * key;
+                size_t      length;
+            };
+            
+            /*
+             * HKDF (RFC 5869) from K, with each label as info.
+             * The PRK is extracted once and kept until the session changes, so S is only computed for the first call.
+             * Can be called from several threads at once.
+             * Throws for a key longer than 255 hashes.
+             */
+            void deriveKeys( std::initializer_list< DerivedKey > keys ) const;
+            void deriveKeys( const std::vector< DerivedKey > & keys )   const;
+            
+            /* From already computed values, so S is only computed once */
+            std::vector< uint8_t > K(  const BigNum & S )                                                     const;
+            std::vector< uint8_t > M1( const std::vector< uint8_t > & K )                                     const;
+            std::vector< uint8_t > M2( const std::vector< uint8_t > & M1, const std::vector< uint8_t > & K ) const;
+            
             virtual BigNum A() const = 0;
             virtual BigNum B() const = 0;
             virtual BigNum S() const = 0;
@@ -78,6 +113,17 @@ namespace SRP
             std::vector< uint8_t >    hash( const std::vector< std::vector< uint8_t > > & data ) const;
             std::vector< uint8_t >    pad(  const std::vector< uint8_t > & data )                const;
             
+        protected:
+            
+            void reset( const std::string & identity );
+            
+            /* Drops the PRK cached by deriveKeys() - Needs to be called whenever a value K depends on changes */
+            void invalidateKeys();
+            
+            /* g ^ exponent % N - From the GroupTables installed when the session was created, if they cover the exponent */
+            BigNum gExp( const BigNum & exponent ) const;
+            bool   hasGroupTables()                const;
+            
         private:
             
             class IMPL;
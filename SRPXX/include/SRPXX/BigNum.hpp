@@ -25,6 +25,7 @@
 #ifndef SRPXX_BIG_NUM_HPP
 #define SRPXX_BIG_NUM_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -32,6 +33,8 @@
 
 namespace SRP
 {
+    class BigNumView;
+    
     class BigNum
     {
         public:
@@ -53,16 +56,30 @@ namespace SRP
             static std::unique_ptr< BigNum > fromString( const std::string & value, StringFormat format = StringFormat::Auto );
             
             static BigNum random( unsigned int bits );
+            
+            /* ( a - ( k * ( g ^ x ) ) ) % modulus */
+            static BigNum modSubMulExp( const BigNum & a, const BigNum & k, const BigNum & g, const BigNum & x, const BigNum & modulus );
+            
+            /* ( ( k * v ) + ( g ^ b ) ) % modulus */
+            static BigNum modMulAddExp( const BigNum & k, const BigNum & v, const BigNum & g, const BigNum & b, const BigNum & modulus );
         
             BigNum();
             BigNum( const std::vector< uint8_t > & bytes, Endianness endianness );
             BigNum( int64_t value );
+            explicit BigNum( const BigNumView & view );
             BigNum( const BigNum & o );
             BigNum( BigNum && o ) noexcept;
             ~BigNum();
             
             BigNum & operator =( BigNum o );
             
+            BigNum & assign( const BigNumView & view );
+            BigNum & assign( const BigNum & o );
+            
+            /* In place, re-using the existing storage */
+            BigNum & randomize( unsigned int bits );
+            BigNum & clear();
+            
             bool operator ==( const BigNum & o )          const;
             bool operator ==( int64_t value )             const;
             bool operator ==( const std::string & value ) const;
@@ -75,6 +92,8 @@ namespace SRP
             bool operator >( const BigNum & o ) const;
             bool operator <( const BigNum & o ) const;
             
+            int compare( const BigNum & o ) const;
+            
             BigNum & operator ++();
             BigNum & operator --();
             BigNum   operator ++( int );
@@ -87,23 +106,48 @@ namespace SRP
             BigNum & operator %=( const BigNum & value );
             BigNum & operator ^=( const BigNum & value );
             
-            BigNum operator +( const BigNum & value ) const;
-            BigNum operator -( const BigNum & value ) const;
-            BigNum operator *( const BigNum & value ) const;
-            BigNum operator /( const BigNum & value ) const;
-            BigNum operator %( const BigNum & value ) const;
-            BigNum operator ^( const BigNum & value ) const;
-            
-            BigNum modExp( const BigNum & exponent,   const BigNum & modulus ) const;
-            BigNum modAdd( const BigNum & add,        const BigNum & modulus ) const;
-            BigNum modMul( const BigNum & multiplier, const BigNum & modulus ) const;
+            BigNum operator +( const BigNum & value ) const &;
+            BigNum operator -( const BigNum & value ) const &;
+            BigNum operator *( const BigNum & value ) const &;
+            BigNum operator /( const BigNum & value ) const &;
+            BigNum operator %( const BigNum & value ) const &;
+            BigNum operator ^( const BigNum & value ) const &;
+            
+            BigNum operator +( const BigNum & value ) &&;
+            BigNum operator -( const BigNum & value ) &&;
+            BigNum operator *( const BigNum & value ) &&;
+            BigNum operator /( const BigNum & value ) &&;
+            BigNum operator %( const BigNum & value ) &&;
+            BigNum operator ^( const BigNum & value ) &&;
+            
+            BigNum modExp( const BigNum & exponent,   const BigNum & modulus ) const &;
+            BigNum modAdd( const BigNum & add,        const BigNum & modulus ) const &;
+            BigNum modSub( const BigNum & sub,        const BigNum & modulus ) const &;
+            BigNum modMul( const BigNum & multiplier, const BigNum & modulus ) const &;
+            
+            BigNum modExp( const BigNum & exponent,   const BigNum & modulus ) &&;
+            BigNum modAdd( const BigNum & add,        const BigNum & modulus ) &&;
+            BigNum modSub( const BigNum & sub,        const BigNum & modulus ) &&;
+            BigNum modMul( const BigNum & multiplier, const BigNum & modulus ) &&;
+            
+            BigNum & modExpInPlace( const BigNum & exponent,   const BigNum & modulus );
+            BigNum & modAddInPlace( const BigNum & add,        const BigNum & modulus );
+            BigNum & modSubInPlace( const BigNum & sub,        const BigNum & modulus );
+            BigNum & modMulInPlace( const BigNum & multiplier, const BigNum & modulus );
             
             std::string            string( StringFormat format )  const;
             std::vector< uint8_t > bytes( Endianness endianness ) const;
             
+            /* Big-endian, left-padded to length - False if the value needs more bytes */
+            bool bytes( uint8_t * output, size_t length ) const;
+            
             BigNum negative() const;
             BigNum positive() const;
             
+            /* Secret values are wiped when released */
+            BigNum & makeSecret();
+            bool     isSecret() const;
+            
             bool isNegative() const;
             bool isPositive() const;
             bool isOdd()      const;
@@ -113,6 +157,9 @@ namespace SRP
             
         private:
             
+            friend class BigNumView;
+            friend class FixedBase;
+            
             class IMPL;
             class Context;
             
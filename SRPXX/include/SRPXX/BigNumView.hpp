@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_BIG_NUM_VIEW_HPP
+#define SRPXX_BIG_NUM_VIEW_HPP
+
+#include <SRPXX/BigNum.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Read-only view over an external big-endian byte buffer.
+     * The buffer is not copied and must outlive the view.
+     */
+    class BigNumView
+    {
+        public:
+            
+            BigNumView();
+            BigNumView( const uint8_t * data, size_t length );
+            explicit BigNumView( const std::vector< uint8_t > & data );
+            
+            const uint8_t * data() const;
+            size_t          size() const;
+            
+            bool isZero() const;
+            int  compare( const BigNum & o ) const;
+            
+            /* 0 < value % modulus */
+            bool isValidModulo( const BigNum & modulus ) const;
+            
+            BigNum modExp( const BigNum & exponent, const BigNum & modulus ) const;
+            
+            std::vector< uint8_t > bytes() const;
+            
+        private:
+            
+            const uint8_t * _data;
+            size_t          _size;
+    };
+}
+
+#endif /* SRPXX_BIG_NUM_VIEW_HPP */
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_BULK_REGISTRAR_HPP
+#define SRPXX_BULK_REGISTRAR_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/Engine.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Generates salts and verifiers for many identities at once, with the
+     * same values Client::salt() and Client::v() would produce.
+     * Batches are split across the threads of an engine, salts are drawn
+     * in a single call, and g ^ x uses a fixed-base table shared by all
+     * threads.
+     */
+    class BulkRegistrar
+    {
+        public:
+            
+            struct Credentials
+            {
+                std::string identity;
+                std::string password;
+            };
+            
+            struct Registration
+            {
+                std::string            identity;
+                std::vector< uint8_t > salt;
+                std::vector< uint8_t > verifier;
+            };
+            
+            /* Options are Client::Options flags */
+            BulkRegistrar( HashAlgorithm hashAlgorithm, Base::GroupType groupType, size_t saltLength = 16, uint64_t options = 0 );
+            ~BulkRegistrar();
+            
+            BulkRegistrar( const BulkRegistrar & o )              = delete;
+            BulkRegistrar & operator =( const BulkRegistrar & o ) = delete;
+            
+            HashAlgorithm   hashAlgorithm() const;
+            Base::GroupType groupType()     const;
+            size_t          saltLength()    const;
+            
+            /* On the calling thread */
+            Registration generate( const Credentials & credentials ) const;
+            
+            /* In the same order as the credentials - Blocks, so not to be called from one of the engine's threads */
+            std::vector< Registration > generate( const std::vector< Credentials > & credentials, Engine & engine ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_BULK_REGISTRAR_HPP */
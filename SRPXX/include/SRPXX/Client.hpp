@@ -25,8 +25,11 @@
 #ifndef SRPXX_CLIENT_HPP
 #define SRPXX_CLIENT_HPP
 
+#include <SRPXX/Awaitable.hpp>
 #include <SRPXX/Base.hpp>
 #include <SRPXX/BigNum.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/Executor.hpp>
 #include <memory>
 #include <string>
 #include <cstdint>
@@ -50,9 +53,18 @@ namespace SRP
             Client( const Client & o )              = delete;
             Client & operator =( const Client & o ) = delete;
             
+            Client( Client && o ) noexcept;
+            Client & operator =( Client && o ) noexcept;
+            
+            /* Starts a new handshake, re-using the existing storage */
+            void reset( const std::string & identity );
+            void reset( const std::string & identity, const BigNum & a );
+            void clear() override;
+            
             void setPassword( const std::string & value );
             void setPassword( const std::vector< uint8_t > & value );
             void setB( const BigNum & value );
+            void setB( const BigNumView & value );
             
             void setOptions( uint64_t options );
             void addOption( Options option );
@@ -67,6 +79,14 @@ namespace SRP
             BigNum x() const;
             BigNum v() const;
             
+            #ifdef SRPXX_COROUTINES
+            
+            /* The session must outlive the awaited step */
+            Awaitable< BigNum >                 computeA( Executor & executor = Executor::current() ) const;
+            Awaitable< std::vector< uint8_t > > computeM1( Executor & executor = Executor::current() ) const;
+            
+            #endif
+            
         private:
             
             class IMPL;
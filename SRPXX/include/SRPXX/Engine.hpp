@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_ENGINE_HPP
+#define SRPXX_ENGINE_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNum.hpp>
+#include <SRPXX/Executor.hpp>
+#include <SRPXX/Server.hpp>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Runs handshake steps on a pool of worker threads.
+     * Each worker owns a deque of tasks and steals from the others when idle.
+     * External submissions go through a lock-free queue.
+     * A session must not be used by more than one step at a time.
+     */
+    class Engine: public Executor
+    {
+        public:
+            
+            template< typename T >
+            using Completion = std::function< void( T result, std::exception_ptr error ) >;
+            
+            struct Keys
+            {
+                BigNum                 S;
+                std::vector< uint8_t > K;
+                std::vector< uint8_t > M1;
+            };
+            
+            /* Zero threads uses one per core */
+            explicit Engine( size_t threads = 0, bool pinThreads = false );
+            ~Engine() override;
+            
+            Engine( const Engine & o )              = delete;
+            Engine & operator =( const Engine & o ) = delete;
+            
+            size_t threads() const;
+            
+            /* Exceptions escaping a posted task are discarded */
+            void post( Task task ) override;
+            
+            template< typename F >
+            std::future< std::invoke_result_t< F > > submit( F f )
+            {
+                auto task   = std::make_shared< std::packaged_task< std::invoke_result_t< F >() > >( std::move( f ) );
+                auto future = task->get_future();
+                
+                this->post( [ task ] { ( *( task ) )(); } );
+                
+                return future;
+            }
+            
+            /* B */
+            std::future< BigNum > B( Server & server );
+            void                  B( Server & server, Completion< BigNum > completion );
+            
+            /* S, K and M1 */
+            std::future< Keys > keys( Base & session );
+            void                keys( Base & session, Completion< Keys > completion );
+            
+            /* M2 for a valid client M1, or an empty vector */
+            std::future< std::vector< uint8_t > > verify( Server & server, const std::vector< uint8_t > & M1 );
+            void                                  verify( Server & server, const std::vector< uint8_t > & M1, Completion< std::vector< uint8_t > > completion );
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_ENGINE_HPP */
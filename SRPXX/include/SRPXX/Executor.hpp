@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_EXECUTOR_HPP
+#define SRPXX_EXECUTOR_HPP
+
+#include <functional>
+
+namespace SRP
+{
+    /*
+     * Runs tasks, typically on another thread.
+     * Used to move expensive handshake steps off the caller's thread.
+     */
+    class Executor
+    {
+        public:
+            
+            using Task = std::function< void() >;
+            
+            /* A shared Engine, with one thread per core */
+            static Executor & defaultExecutor();
+            static Executor & current();
+            
+            /* The executor must outlive any step started with it */
+            static void setCurrent( Executor & executor );
+            
+            virtual ~Executor() = default;
+            
+            virtual void post( Task task ) = 0;
+    };
+}
+
+#endif /* SRPXX_EXECUTOR_HPP */
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_FIXED_BASE_HPP
+#define SRPXX_FIXED_BASE_HPP
+
+#include <SRPXX/BigNum.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Precomputed powers of a base, for repeated exponentiations modulo the
+     * same odd modulus with exponents of bounded size.
+     * Each window of the exponent selects one table entry, so an
+     * exponentiation only takes one Montgomery multiplication per window
+     * and no squaring.
+     * Entries are selected in constant time, reading a whole row, as exponents may be secret.
+     * Immutable once built, so it can be shared between threads.
+     */
+    class FixedBase
+    {
+        public:
+            
+            FixedBase( const BigNum & base, const BigNum & modulus, unsigned int exponentBits, unsigned int window = 4 );
+            
+            /*
+             * Uses a table exported by table() in place, without copying it, so it
+             * must outlive this object - Meant for read-only mappings shared between
+             * processes.
+             * Throws if the table's size or first entries do not match the base and modulus.
+             */
+            FixedBase( const BigNum & base, const BigNum & modulus, unsigned int exponentBits, unsigned int window, const uint8_t * table, size_t length );
+            
+            ~FixedBase();
+            
+            FixedBase( const FixedBase & o )              = delete;
+            FixedBase & operator =( const FixedBase & o ) = delete;
+            
+            unsigned int exponentBits() const;
+            
+            /* Whether modExp() accepts the exponent */
+            bool covers( const BigNum & exponent ) const;
+            
+            /* Approximate size of the table, in bytes */
+            size_t memory() const;
+            
+            /* base ^ exponent % modulus - Throws if the exponent is negative or has more than exponentBits bits */
+            BigNum modExp( const BigNum & exponent ) const;
+            
+            /* Entries in Montgomery form, little-endian and padded to the size of the modulus, row after row */
+            std::vector< uint8_t > table() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_FIXED_BASE_HPP */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_GROUP_TABLES_HPP
+#define SRPXX_GROUP_TABLES_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/FixedBase.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Read-only, memory-mapped file of per-group precomputations: a fixed-base
+     * table for g, and k and H( N ) xor H( g ) for every hash algorithm.
+     * Tables are used in place, so processes mapping the same file share its
+     * pages - Typically loaded once before forking workers.
+     * Files are checksummed, and their groups are checked against the built-in
+     * RFC 5054 groups when loaded.
+     */
+    class GroupTables
+    {
+        public:
+            
+            static constexpr uint32_t version = 1;
+            
+            /*
+             * Tables cover exponents of up to exponentBits bits, like a and b.
+             * Written to a temporary file first, then renamed.
+             */
+            static void write( const std::string & path, const std::vector< Base::GroupType > & groups, unsigned int exponentBits = 256, unsigned int window = 4 );
+            
+            /* Throws if the file is corrupted, from another version, or for other groups */
+            explicit GroupTables( const std::string & path );
+            ~GroupTables();
+            
+            GroupTables( const GroupTables & o )              = delete;
+            GroupTables & operator =( const GroupTables & o ) = delete;
+            
+            bool contains( Base::GroupType groupType ) const;
+            
+            /* Null, or empty, if the group is not in the file - g and k point into the mapping */
+            const FixedBase      * g(      Base::GroupType groupType )                              const;
+            BigNumView             k(      Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const;
+            
+            /* Digest-sized, leading zeros included, as M1 hashes it */
+            std::vector< uint8_t > hashNG( Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const;
+            
+            /*
+             * Sessions created afterwards use the tables for the groups they contain,
+             * and keep them alive - nullptr to stop.
+             * Thread-safe.
+             */
+            static void                                 install( std::shared_ptr< const GroupTables > tables );
+            static std::shared_ptr< const GroupTables > installed();
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_GROUP_TABLES_HPP */
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_HMAC_HPP
+#define SRPXX_HMAC_HPP
+
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * HMAC (RFC 2104) over one of the library's hashers.
+     * The inner and outer padded keys are hashed once, when keying, so each
+     * MAC only costs the message plus two final compressions.
+     * Not thread-safe - MACs reuse a scratch hasher. Copy the instance to
+     * share a key between threads.
+     */
+    template< typename Hash >
+    class HMAC
+    {
+        public:
+            
+            static constexpr size_t blockSize = Hash::blockSize;
+            static constexpr size_t macSize   = Hash::digestSize;
+            
+            HMAC( const std::vector< uint8_t > & key ):
+                HMAC( key.data(), key.size() )
+            {}
+            
+            HMAC( const uint8_t * key, size_t length )
+            {
+                uint8_t pad[ blockSize ] = {};
+                
+                if( length > blockSize )
+                {
+                    Hash hash;
+                    
+                    hash.update( key, length );
+                    hash.finalize( pad );
+                }
+                else
+                {
+                    std::copy_n( key, length, pad );
+                }
+                
+                for( auto & c: pad )
+                {
+                    c = static_cast< uint8_t >( c ^ 0x36 );
+                }
+                
+                this->_inner.update( pad, blockSize );
+                
+                for( auto & c: pad )
+                {
+                    c = static_cast< uint8_t >( c ^ 0x36 ^ 0x5C );
+                }
+                
+                this->_outer.update( pad, blockSize );
+                
+                SecureArena::wipe( pad, sizeof( pad ) );
+            }
+            
+            /* Writes macSize bytes */
+            void mac( const uint8_t * data, size_t length, uint8_t * out )
+            {
+                this->begin();
+                this->update( data, length );
+                this->finalize( out );
+            }
+            
+            std::vector< uint8_t > mac( const std::vector< uint8_t > & data )
+            {
+                std::vector< uint8_t > out( macSize );
+                
+                this->mac( data.data(), data.size(), out.data() );
+                
+                return out;
+            }
+            
+            /* Writes macSize bytes per message, one after the other */
+            void mac( const std::vector< std::vector< uint8_t > > & messages, uint8_t * out )
+            {
+                for( const auto & message: messages )
+                {
+                    this->mac( message.data(), message.size(), out );
+                    
+                    out += macSize;
+                }
+            }
+            
+            /* Incremental MAC, for messages in several parts */
+            void begin()
+            {
+                this->_work = this->_inner;
+            }
+            
+            void update( const uint8_t * data, size_t length )
+            {
+                this->_work.update( data, length );
+            }
+            
+            void finalize( uint8_t * out )
+            {
+                uint8_t inner[ macSize ];
+                
+                this->_work.finalize( inner );
+                
+                this->_work = this->_outer;
+                
+                this->_work.update( inner, macSize );
+                this->_work.finalize( out );
+                
+                SecureArena::wipe( inner, sizeof( inner ) );
+            }
+            
+        private:
+            
+            Hash _inner;
+            Hash _outer;
+            Hash _work;
+    };
+}
+
+#endif /* SRPXX_HMAC_HPP */
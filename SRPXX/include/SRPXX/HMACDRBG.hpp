@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_HMAC_DRBG_HPP
+#define SRPXX_HMAC_DRBG_HPP
+
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * HMAC_DRBG from NIST SP 800-90A, without prediction resistance.
+     * The output only depends on the seed, so values derived from a secret
+     * key can be derived again on demand instead of being stored.
+     * The internal state lives in the secure arena.
+     */
+    class HMACDRBG
+    {
+        public:
+            
+            HMACDRBG( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & entropy, const std::vector< uint8_t > & nonce, const std::vector< uint8_t > & personalization = {} );
+            ~HMACDRBG();
+            
+            HMACDRBG( const HMACDRBG & o )              = delete;
+            HMACDRBG & operator =( const HMACDRBG & o ) = delete;
+            
+            void reseed( const std::vector< uint8_t > & entropy, const std::vector< uint8_t > & additional = {} );
+            
+            void                   generate( uint8_t * buffer, size_t length );
+            std::vector< uint8_t > generate( size_t length );
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_HMAC_DRBG_HPP */
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_KEY_RING_HPP
+#define SRPXX_KEY_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Server keys identified by a 32-bit id, so values sealed or derived
+     * under a key survive its rotation.
+     * New values use the current key. Older keys are kept, up to the ring's
+     * capacity, so existing values can still be opened. Keys live in the
+     * secure arena.
+     * Thread-safe.
+     */
+    class KeyRing
+    {
+        public:
+            
+            static constexpr size_t keyLength = 32;
+            
+            explicit KeyRing( size_t capacity = 4 );
+            ~KeyRing();
+            
+            KeyRing( const KeyRing & o )              = delete;
+            KeyRing & operator =( const KeyRing & o ) = delete;
+            
+            /* Adds a random key and makes it current, returning its id */
+            uint32_t rotate();
+            
+            /* Adds a key distributed to several nodes and makes it current - Throws on a duplicate id or a wrong length */
+            void add( uint32_t id, const std::vector< uint8_t > & key );
+            void remove( uint32_t id );
+            
+            bool     empty()   const;
+            size_t   size()    const;
+            uint32_t current() const;
+            
+            /* Copies keyLength bytes into the buffer, or returns false for an unknown id */
+            bool key( uint32_t id, uint8_t * buffer ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_KEY_RING_HPP */
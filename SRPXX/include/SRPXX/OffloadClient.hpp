@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_OFFLOAD_CLIENT_HPP
+#define SRPXX_OFFLOAD_CLIENT_HPP
+
+#include <SRPXX/BigNum.hpp>
+#include <SRPXX/Server.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Runs a server's expensive steps in an OffloadService on the same host.
+     * Requests and results are exchanged through the service's shared memory,
+     * so no socket or copy through the kernel is involved.
+     */
+    class OffloadClient
+    {
+        public:
+            
+            struct Verification
+            {
+                /* Empty if M1 was rejected */
+                std::vector< uint8_t > M2;
+                std::vector< uint8_t > K;
+            };
+            
+            /* Throws if no service is running under that name */
+            explicit OffloadClient( const std::string & name, std::chrono::milliseconds timeout = std::chrono::seconds( 10 ) );
+            ~OffloadClient();
+            
+            OffloadClient( const OffloadClient & o )              = delete;
+            OffloadClient & operator =( const OffloadClient & o ) = delete;
+            
+            /*
+             * Thread-safe, from the server's identity, salt, v, b and A.
+             * Throws if the service fails, stops or does not answer in time.
+             */
+            BigNum       B(      const Server & server );
+            Verification verify( const Server & server, const std::vector< uint8_t > & M1 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_OFFLOAD_CLIENT_HPP */
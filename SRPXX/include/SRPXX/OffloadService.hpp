@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_OFFLOAD_SERVICE_HPP
+#define SRPXX_OFFLOAD_SERVICE_HPP
+
+#include <SRPXX/VerifierCache.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace SRP
+{
+    /*
+     * Computes server handshake steps for other processes on the same host,
+     * through OffloadClient.
+     * Requests come through a named shared-memory segment: clients write them
+     * into slots and push the slots into a lock-free ring, which this process
+     * drains in batches onto an Engine.
+     * Verifier tables are kept in one VerifierCache for all clients, and results
+     * are written back into the request's slot.
+     * Waiting uses futexes on Linux, and short sleeps on other POSIX platforms.
+     * Not available on Windows.
+     */
+    class OffloadService
+    {
+        public:
+            
+            struct Options
+            {
+                Options();
+                
+                /* Concurrent requests - A power of two */
+                uint32_t slots;
+                
+                /* Zero uses one per core */
+                size_t threads;
+                
+                /* Memory for the precomputed verifiers, in bytes */
+                size_t cacheBudget;
+                
+                /*
+                 * Slots held by a client for longer than this are freed, as are the slots
+                 * of clients that exited - Needs to exceed the clients' timeouts.
+                 */
+                std::chrono::milliseconds reclaimTimeout;
+            };
+            
+            struct Stats
+            {
+                uint64_t             requests;
+                uint64_t             batches;
+                uint64_t             reclaimed;
+                VerifierCache::Stats cache;
+            };
+            
+            /* Creates the segment, replacing a stale one with the same name */
+            explicit OffloadService( const std::string & name );
+            OffloadService( const std::string & name, const Options & options );
+            ~OffloadService();
+            
+            OffloadService( const OffloadService & o )              = delete;
+            OffloadService & operator =( const OffloadService & o ) = delete;
+            
+            /* Serves requests until stop() is called */
+            void run();
+            
+            /* Thread-safe */
+            void  stop();
+            Stats stats() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_OFFLOAD_SERVICE_HPP */
@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_POOL_ALLOCATOR_HPP
+#define SRPXX_POOL_ALLOCATOR_HPP
+
+#include <SRPXX/Allocator.hpp>
+#include <memory>
+
+namespace SRP
+{
+    /*
+     * Size-class pool with a per-thread cache in front of a shared free list.
+     * Requests larger than the biggest size class go to malloc.
+     */
+    class PoolAllocator: public Allocator
+    {
+        public:
+            
+            struct Stats
+            {
+                uint64_t allocations;
+                uint64_t deallocations;
+                uint64_t cacheHits;
+                uint64_t cacheMisses;
+                uint64_t largeAllocations;
+                uint64_t bytesReserved;
+                uint64_t threads;
+            };
+            
+            static constexpr size_t maxPooledSize = 16384;
+            
+            PoolAllocator();
+            ~PoolAllocator() override;
+            
+            PoolAllocator( const PoolAllocator & o )              = delete;
+            PoolAllocator & operator =( const PoolAllocator & o ) = delete;
+            
+            void * allocate( size_t size )             override;
+            void * reallocate( void * p, size_t size ) override;
+            void   deallocate( void * p )              override;
+            
+            Stats stats() const;
+            
+        private:
+            
+            class IMPL;
+            
+            /* Shared with the thread caches, which may outlive the allocator - Slabs are released with the allocator */
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_POOL_ALLOCATOR_HPP */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_RESUMPTION_HPP
+#define SRPXX_RESUMPTION_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Re-authentication from the secret of a completed handshake, with no
+     * modular exponentiation.
+     * Both sides derive the resumption secret from K. On reconnect, the
+     * client and server exchange fresh nonces, prove knowledge of the secret
+     * with HMACs over both nonces, and derive a new session key.
+     * 
+     *   client -> server: ticket ID, client nonce
+     *   server -> client: server nonce
+     *   client -> server: client proof
+     *   server -> client: server proof
+     */
+    class Resumption
+    {
+        public:
+            
+            static constexpr size_t nonceLength = 32;
+            
+            /* HMAC( K, "SRPXX resumption" ) - Empty for a session whose K cannot be computed yet */
+            static std::vector< uint8_t > secret( const Base & session );
+            static std::vector< uint8_t > secret( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K );
+            
+            static std::vector< uint8_t > nonce();
+            
+            /* Throws if a nonce does not have nonceLength bytes */
+            Resumption( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce );
+            Resumption( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce );
+            ~Resumption();
+            
+            Resumption( const Resumption & o )              = delete;
+            Resumption & operator =( const Resumption & o ) = delete;
+            
+            Resumption( Resumption && o ) noexcept;
+            Resumption & operator =( Resumption && o ) noexcept;
+            
+            std::vector< uint8_t > clientProof() const;
+            std::vector< uint8_t > serverProof() const;
+            
+            /* Constant-time */
+            bool verifyClientProof( const std::vector< uint8_t > & proof ) const;
+            bool verifyServerProof( const std::vector< uint8_t > & proof ) const;
+            
+            /* Key of the resumed session */
+            std::vector< uint8_t > K() const;
+            
+            /* Identity of the resumed session - Empty unless given on construction */
+            std::string identity() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_RESUMPTION_HPP */
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_RESUMPTION_STORE_HPP
+#define SRPXX_RESUMPTION_STORE_HPP
+
+#include <SRPXX/Resumption.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Resumption secrets issued by a server, keyed by random ticket IDs.
+     * Each ticket expires after its TTL or once it was redeemed maxUses
+     * times. Secrets live in the secure arena and are wiped on removal.
+     * Thread-safe.
+     */
+    class ResumptionStore
+    {
+        public:
+            
+            using Clock = std::chrono::steady_clock;
+            
+            ResumptionStore( Clock::duration ttl = std::chrono::hours( 1 ), uint32_t maxUses = 8 );
+            ~ResumptionStore();
+            
+            ResumptionStore( const ResumptionStore & o )              = delete;
+            ResumptionStore & operator =( const ResumptionStore & o ) = delete;
+            
+            /*
+             * Returns the ticket ID sent to the client after M2 - Throws if the session's K cannot be computed.
+             * The session's identity is kept with the ticket.
+             */
+            uint64_t issue( const Base & session );
+            uint64_t issue( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K );
+            uint64_t issue( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K );
+            
+            /*
+             * Consumes one use of the ticket once the client's proof is verified - Ticket IDs are sent in the clear.
+             * Empty for an unknown, expired or used-up ticket, or a wrong proof - Otherwise, carries the identity the ticket was issued for.
+             */
+            std::optional< Resumption > redeem( uint64_t id, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce, const std::vector< uint8_t > & clientProof );
+            std::optional< Resumption > redeem( uint64_t id, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce, const std::vector< uint8_t > & clientProof, Clock::time_point now );
+            
+            bool   revoke( uint64_t id );
+            size_t size() const;
+            
+            /* Number of expired tickets */
+            size_t expire();
+            size_t expire( Clock::time_point now );
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_RESUMPTION_STORE_HPP */
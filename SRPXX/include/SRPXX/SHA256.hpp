@@ -34,6 +34,9 @@ namespace SRP
     {
         public:
         
+            static constexpr size_t blockSize  = 64;
+            static constexpr size_t digestSize = 32;
+            
             static std::vector< uint8_t > bytes( const std::vector< uint8_t > & data );
             static std::vector< uint8_t > bytes( const uint8_t * data, size_t length );
             static std::vector< uint8_t > bytes( const std::string & data );
@@ -45,14 +48,18 @@ namespace SRP
             SHA256();
             ~SHA256() override;
             
-            SHA256( const SHA256 & o )              = delete;
-            SHA256 & operator =( const SHA256 & o ) = delete;
+            /* Copies the hashing state, so a common prefix can be hashed once */
+            SHA256( const SHA256 & o );
+            SHA256 & operator =( const SHA256 & o );
             
             bool update( const std::vector< uint8_t > & data ) override;
             bool update( const uint8_t * data, size_t length ) override;
             bool update( const std::string & data            ) override;
             bool finalize()                                    override;
             
+            /* Finalizes into a buffer of digestSize bytes */
+            bool finalize( uint8_t * hash );
+            
             std::vector< uint8_t > bytes()                            const override;
             std::string            string( String::HexFormat format ) const override;
             
@@ -34,6 +34,9 @@ namespace SRP
     {
         public:
         
+            static constexpr size_t blockSize  = 128;
+            static constexpr size_t digestSize = 48;
+            
             static std::vector< uint8_t > bytes( const std::vector< uint8_t > & data );
             static std::vector< uint8_t > bytes( const uint8_t * data, size_t length );
             static std::vector< uint8_t > bytes( const std::string & data );
@@ -45,14 +48,18 @@ namespace SRP
             SHA384();
             ~SHA384() override;
             
-            SHA384( const SHA384 & o )              = delete;
-            SHA384 & operator =( const SHA384 & o ) = delete;
+            /* Copies the hashing state, so a common prefix can be hashed once */
+            SHA384( const SHA384 & o );
+            SHA384 & operator =( const SHA384 & o );
             
             bool update( const std::vector< uint8_t > & data ) override;
             bool update( const uint8_t * data, size_t length ) override;
             bool update( const std::string & data            ) override;
             bool finalize()                                    override;
             
+            /* Finalizes into a buffer of digestSize bytes */
+            bool finalize( uint8_t * hash );
+            
             std::vector< uint8_t > bytes()                            const override;
             std::string            string( String::HexFormat format ) const override;
             
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SECURE_ARENA_HPP
+#define SRPXX_SECURE_ARENA_HPP
+
+#include <SRPXX/Allocator.hpp>
+#include <memory>
+
+namespace SRP
+{
+    /*
+     * Allocator for secrets.
+     * Memory comes from locked pages surrounded by inaccessible guard pages,
+     * each block is wiped when released, and whole regions are wiped again
+     * when the arena is destroyed.
+     * Installing it with Allocator::useForOpenSSL also covers BIGNUM limbs.
+     */
+    class SecureArena: public Allocator
+    {
+        public:
+            
+            struct Stats
+            {
+                uint64_t allocations;
+                uint64_t deallocations;
+                uint64_t bytesInUse;
+                uint64_t bytesReserved;
+                uint64_t bytesLocked;
+                uint64_t regions;
+            };
+            
+            static SecureArena & shared();
+            static void          wipe( void * p, size_t size );
+            
+            SecureArena( size_t regionSize = 256 * 1024 );
+            ~SecureArena() override;
+            
+            SecureArena( const SecureArena & o )              = delete;
+            SecureArena & operator =( const SecureArena & o ) = delete;
+            
+            void * allocate( size_t size )             override;
+            void * reallocate( void * p, size_t size ) override;
+            void   deallocate( void * p )              override;
+            
+            bool  owns( const void * p ) const;
+            Stats stats()                const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+    
+    using SecureBytes = Vector< uint8_t >;
+}
+
+#endif /* SRPXX_SECURE_ARENA_HPP */
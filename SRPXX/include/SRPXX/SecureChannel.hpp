@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SECURE_CHANNEL_HPP
+#define SRPXX_SECURE_CHANNEL_HPP
+
+#include <SRPXX/Client.hpp>
+#include <SRPXX/Server.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Record protection for a completed handshake.
+     * Each direction gets its own key and nonce, derived from K and a
+     * channel ID with deriveKeys(). Records are numbered, and the nonce of
+     * a record is its number xored into the direction's nonce, so only
+     * counters need to be kept. Records must be opened in the order they
+     * were sealed.
+     * Records are encrypted in place, with the tag stored separately.
+     * Not thread-safe.
+     */
+    class SecureChannel
+    {
+        public:
+            
+            enum class Cipher
+            {
+                AES256GCM,
+                ChaCha20Poly1305
+            };
+            
+            struct Message
+            {
+                const uint8_t * data;
+                size_t          length;
+            };
+            
+            static constexpr size_t tagLength   = 16;
+            static constexpr size_t frameLength = 4;
+            
+            /*
+             * Both sides must use the same cipher and channel ID - Throws if the cipher is not available.
+             * Channels built from the same session with the same ID share keys and nonces,
+             * so each channel of a session needs its own ID - Without one, the ID is 0.
+             */
+            SecureChannel( const Client & session, Cipher cipher = Cipher::ChaCha20Poly1305 );
+            SecureChannel( const Server & session, Cipher cipher = Cipher::ChaCha20Poly1305 );
+            SecureChannel( const Client & session, uint64_t channel, Cipher cipher = Cipher::ChaCha20Poly1305 );
+            SecureChannel( const Server & session, uint64_t channel, Cipher cipher = Cipher::ChaCha20Poly1305 );
+            ~SecureChannel();
+            
+            SecureChannel( const SecureChannel & o )              = delete;
+            SecureChannel & operator =( const SecureChannel & o ) = delete;
+            
+            SecureChannel( SecureChannel && o ) noexcept;
+            SecureChannel & operator =( SecureChannel && o ) noexcept;
+            
+            /* Writes tagLength bytes to tag */
+            void seal( uint8_t * data, size_t length, uint8_t * tag );
+            
+            /* False for a forged, reordered or replayed record, after which data is garbled and the channel should be closed */
+            bool open( uint8_t * data, size_t length, const uint8_t * tag );
+            
+            /* Bytes needed to batch messages - Each one is framed by a 32-bit length, and the record ends with the tag */
+            static size_t batchLength( const std::vector< Message > & messages );
+            
+            /* Frames and seals several messages as a single record - Returns the record's length, or 0 if the buffer is too small */
+            size_t seal( const std::vector< Message > & messages, uint8_t * record, size_t capacity );
+            
+            /* Opens a batched record in place - Messages point into the record */
+            bool open( uint8_t * record, size_t length, std::vector< Message > & messages );
+            
+            uint64_t sent()     const;
+            uint64_t received() const;
+            
+        private:
+            
+            SecureChannel( const Base & session, bool client, uint64_t channel, Cipher cipher );
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_SECURE_CHANNEL_HPP */
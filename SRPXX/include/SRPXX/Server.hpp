@@ -25,17 +25,58 @@
 #ifndef SRPXX_SERVER_HPP
 #define SRPXX_SERVER_HPP
 
+#include <SRPXX/Awaitable.hpp>
 #include <SRPXX/Base.hpp>
 #include <SRPXX/BigNum.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/Executor.hpp>
+#include <SRPXX/KeyRing.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace SRP
 {
+    class PrecomputedVerifier;
+    
     class Server: public Base
     {
         public:
             
+            /*
+             * IDs of the tickets already restored, each kept until its ticket expires,
+             * so a ticket only restores a single handshake.
+             * Holds at most capacity unexpired IDs, and refuses tickets once full.
+             * Thread-safe.
+             */
+            class TicketCache
+            {
+                public:
+                    
+                    explicit TicketCache( size_t capacity = 65536 );
+                    ~TicketCache();
+                    
+                    TicketCache( const TicketCache & o )              = delete;
+                    TicketCache & operator =( const TicketCache & o ) = delete;
+                    
+                    size_t size() const;
+                    
+                private:
+                    
+                    friend class Server;
+                    
+                    /* False if the ID was already redeemed, or if the cache is full */
+                    bool redeem( const uint8_t * id, int64_t expiry );
+                    
+                    class IMPL;
+                    
+                    std::unique_ptr< IMPL > impl;
+            };
+            
             Server( const std::string & identity, HashAlgorithm hashAlgorithm, GroupType groupType );
             Server( const std::string & identity, HashAlgorithm hashAlgorithm, GroupType groupType, const BigNum & b );
             virtual ~Server() override;
@@ -43,8 +84,25 @@ namespace SRP
             Server( const Server & o )              = delete;
             Server & operator =( const Server & o ) = delete;
             
+            Server( Server && o ) noexcept;
+            Server & operator =( Server && o ) noexcept;
+            
+            /* Starts a new handshake, re-using the existing storage */
+            void reset( const std::string & identity, const std::vector< uint8_t > & salt, const BigNum & verifier );
+            void reset( const std::string & identity, const std::vector< uint8_t > & salt, const BigNum & verifier, const BigNum & b );
+            void clear() override;
+            
             void setV( const BigNum & value );
+            void setV( const BigNumView & value );
             void setA( const BigNum & value );
+            void setA( const BigNumView & value );
+            
+            /*
+             * Also sets v - Cleared by setV(), reset() and clear().
+             * Throws if computed for another group or hash algorithm.
+             */
+            void                                         setPrecomputed( std::shared_ptr< const PrecomputedVerifier > value );
+            std::shared_ptr< const PrecomputedVerifier > precomputed() const;
             
             BigNum A() const override;
             BigNum B() const override;
@@ -53,8 +111,48 @@ namespace SRP
             BigNum v() const;
             BigNum b() const;
             
+            /* M2 for a valid client M1, or an empty vector - Also empty when A % N is 0 */
+            std::vector< uint8_t > verifyM1( const std::vector< uint8_t > & M1 ) const;
+            std::vector< uint8_t > verifyM1( const uint8_t * M1, size_t length ) const;
+            
+            /*
+             * Seals identity, salt, v, b and A with AES-256-GCM under the ring's current key,
+             * so any node holding the key ring can finish the handshake.
+             * Each ticket has a random ID, for replay detection.
+             */
+            std::vector< uint8_t > exportTicket( const KeyRing & keys, std::chrono::seconds lifetime = std::chrono::seconds( 60 ) ) const;
+            
+            /*
+             * Empty if the ticket was tampered with, is sealed under an unknown key, or has expired.
+             * Does not detect replays, so a ticket can be restored any number of times until it expires.
+             */
+            static std::optional< Server > fromTicket( const std::vector< uint8_t > & ticket, const KeyRing & keys );
+            
+            /*
+             * Also empty if the ticket was already restored through the same cache.
+             * Nodes sharing a key ring need a single cache, or a ticket can be restored once per node.
+             */
+            static std::optional< Server > fromTicket( const std::vector< uint8_t > & ticket, const KeyRing & keys, TicketCache & redeemed );
+            
+            /*
+             * 256-bit b from HMAC-DRBG( key, nonce, identity ), both length-prefixed, for the explicit-b constructor and reset().
+             * Lets a server derive b again when M1 arrives instead of keeping it.
+             * The nonce must be unique per handshake - Throws for an unknown key id.
+             */
+            static BigNum deriveB( const KeyRing & keys, uint32_t keyID, const std::vector< uint8_t > & nonce, const std::string & identity );
+            
+            #ifdef SRPXX_COROUTINES
+            
+            /* The session must outlive the awaited step */
+            Awaitable< BigNum >                 computeB( Executor & executor = Executor::current() ) const;
+            Awaitable< std::vector< uint8_t > > verify( const std::vector< uint8_t > & M1, Executor & executor = Executor::current() ) const;
+            
+            #endif
+            
         private:
             
+            static std::optional< Server > restore( const std::vector< uint8_t > & ticket, const KeyRing & keys, TicketCache * redeemed );
+            
             class IMPL;
             
             std::unique_ptr< IMPL > impl;
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SESSION_POOL_HPP
+#define SRPXX_SESSION_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Recycles session objects (Client / Server) across handshakes.
+     * Released objects are cleared before being kept for re-use, and
+     * acquired ones need to be reset for the new handshake.
+     * The pool must outlive its handles.
+     */
+    template< typename T >
+    class SessionPool
+    {
+        public:
+            
+            class Handle
+            {
+                public:
+                    
+                    Handle():
+                        _pool( nullptr )
+                    {}
+                    
+                    Handle( SessionPool * pool, std::unique_ptr< T > object ):
+                        _pool( pool ),
+                        _object( std::move( object ) )
+                    {}
+                    
+                    ~Handle()
+                    {
+                        this->release();
+                    }
+                    
+                    Handle( const Handle & o )              = delete;
+                    Handle & operator =( const Handle & o ) = delete;
+                    
+                    Handle( Handle && o ) noexcept:
+                        _pool( o._pool ),
+                        _object( std::move( o._object ) )
+                    {}
+                    
+                    Handle & operator =( Handle && o ) noexcept
+                    {
+                        if( this != &o )
+                        {
+                            this->release();
+                            
+                            this->_pool   = o._pool;
+                            this->_object = std::move( o._object );
+                        }
+                        
+                        return *( this );
+                    }
+                    
+                    T * operator ->() const
+                    {
+                        return this->_object.get();
+                    }
+                    
+                    T & operator *() const
+                    {
+                        return *( this->_object );
+                    }
+                    
+                    T * get() const
+                    {
+                        return this->_object.get();
+                    }
+                    
+                    explicit operator bool() const
+                    {
+                        return this->_object != nullptr;
+                    }
+                    
+                    /* Returns the object to the pool */
+                    void release()
+                    {
+                        if( this->_pool != nullptr && this->_object != nullptr )
+                        {
+                            this->_pool->recycle( std::move( this->_object ) );
+                        }
+                        
+                        this->_object = nullptr;
+                    }
+                    
+                private:
+                    
+                    SessionPool        * _pool;
+                    std::unique_ptr< T > _object;
+            };
+            
+            SessionPool( std::function< std::unique_ptr< T >() > factory, size_t capacity ):
+                _factory( std::move( factory ) ),
+                _capacity( capacity ),
+                _created( 0 ),
+                _reused( 0 )
+            {
+                this->_idle.reserve( capacity );
+            }
+            
+            SessionPool( const SessionPool & o )              = delete;
+            SessionPool & operator =( const SessionPool & o ) = delete;
+            
+            Handle acquire()
+            {
+                {
+                    std::lock_guard< std::mutex > l( this->_mutex );
+                    
+                    if( this->_idle.empty() == false )
+                    {
+                        std::unique_ptr< T > object = std::move( this->_idle.back() );
+                        
+                        this->_idle.pop_back();
+                        
+                        this->_reused++;
+                        
+                        return { this, std::move( object ) };
+                    }
+                    
+                    this->_created++;
+                }
+                
+                return { this, this->_factory() };
+            }
+            
+            size_t idle() const
+            {
+                std::lock_guard< std::mutex > l( this->_mutex );
+                
+                return this->_idle.size();
+            }
+            
+            size_t capacity() const
+            {
+                return this->_capacity;
+            }
+            
+            uint64_t created() const
+            {
+                std::lock_guard< std::mutex > l( this->_mutex );
+                
+                return this->_created;
+            }
+            
+            uint64_t reused() const
+            {
+                std::lock_guard< std::mutex > l( this->_mutex );
+                
+                return this->_reused;
+            }
+            
+        private:
+            
+            void recycle( std::unique_ptr< T > object )
+            {
+                /* Outside of the lock, as this wipes the session secrets */
+                object->clear();
+                
+                std::lock_guard< std::mutex > l( this->_mutex );
+                
+                if( this->_idle.size() < this->_capacity )
+                {
+                    this->_idle.push_back( std::move( object ) );
+                }
+            }
+            
+            std::function< std::unique_ptr< T >() > _factory;
+            size_t                                  _capacity;
+            mutable std::mutex                      _mutex;
+            std::vector< std::unique_ptr< T > >     _idle;
+            uint64_t                                _created;
+            uint64_t                                _reused;
+    };
+}
+
+#endif /* SRPXX_SESSION_POOL_HPP */
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SESSION_TABLE_HPP
+#define SRPXX_SESSION_TABLE_HPP
+
+#include <SRPXX/Server.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace SRP
+{
+    /*
+     * Server sessions waiting for the client's M1, keyed by session ID.
+     * Sharded, with one lock per shard. Each shard expires its sessions on a
+     * hierarchical timer wheel, advanced on access and by expire().
+     * Sessions are kept as compact records rather than whole Server objects,
+     * and a Server is rebuilt when taken.
+     * Sessions that expire or are removed are wiped.
+     */
+    class SessionTable
+    {
+        public:
+            
+            using Clock = std::chrono::steady_clock;
+            
+            struct Stats
+            {
+                uint64_t sessions;
+                uint64_t capacity;
+                uint64_t inserted;
+                uint64_t taken;
+                uint64_t removed;
+                uint64_t expired;
+                uint64_t rejected;
+            };
+            
+            /* Capacity is split evenly between shards, whose count is rounded to a power of two */
+            SessionTable( size_t capacity, Clock::duration timeout, Clock::duration resolution = std::chrono::milliseconds( 10 ), size_t shards = 64 );
+            ~SessionTable();
+            
+            SessionTable( const SessionTable & o )              = delete;
+            SessionTable & operator =( const SessionTable & o ) = delete;
+            
+            /* Fails if the ID is already in use or if its shard is full */
+            bool insert( uint64_t id, Server && server );
+            bool insert( uint64_t id, Server && server, Clock::duration timeout );
+            
+            std::optional< Server > take( uint64_t id );
+            bool                    remove( uint64_t id );
+            bool                    contains( uint64_t id ) const;
+            
+            size_t size()     const;
+            size_t capacity() const;
+            
+            /* Number of expired sessions */
+            size_t expire();
+            size_t expire( Clock::time_point now );
+            
+            Stats stats() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_SESSION_TABLE_HPP */
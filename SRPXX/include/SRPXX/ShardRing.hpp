@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_SHARD_RING_HPP
+#define SRPXX_SHARD_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Consistent-hash ring assigning identities to verifier shards.
+     * Each shard is placed on the ring as a number of virtual nodes
+     * proportional to its weight, and an identity belongs to the first
+     * virtual node at or after its hash.
+     * Placement only depends on shard names and weights, so every process
+     * building the same ring routes identically. Adding a shard only moves
+     * identities to that shard.
+     */
+    class ShardRing
+    {
+        public:
+            
+            struct Shard
+            {
+                std::string name;
+                uint32_t    weight;
+            };
+            
+            /* Identities whose hash is in [ first, last ] change owner */
+            struct Move
+            {
+                uint64_t    first;
+                uint64_t    last;
+                std::string from;
+                std::string to;
+            };
+            
+            static uint64_t hash( std::string_view identity );
+            
+            explicit ShardRing( size_t virtualNodes = 128 );
+            ShardRing( const ShardRing & o );
+            ~ShardRing();
+            
+            ShardRing & operator =( ShardRing o );
+            
+            friend void swap( ShardRing & o1, ShardRing & o2 );
+            
+            /* Throws if the shard already exists or if the weight is zero */
+            void add( const std::string & name, uint32_t weight = 1 );
+            void remove( const std::string & name );
+            bool contains( const std::string & name ) const;
+            
+            size_t               size()   const;
+            std::vector< Shard > shards() const;
+            
+            /* Owning shard - Throws if the ring is empty */
+            const std::string & route( std::string_view identity ) const;
+            
+            /* Up to count distinct shards, in ring order, for replicas */
+            std::vector< std::string > route( std::string_view identity, size_t count ) const;
+            
+            /* Hash ranges to move between shards to go from this ring to another */
+            std::vector< Move > rebalance( const ShardRing & target ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_SHARD_RING_HPP */
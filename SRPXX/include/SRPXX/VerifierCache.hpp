@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_VERIFIER_CACHE_HPP
+#define SRPXX_VERIFIER_CACHE_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNum.hpp>
+#include <SRPXX/FixedBase.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace SRP
+{
+    class Server;
+    
+    /*
+     * Values derived from a verifier that do not change between logins:
+     * k * v % N, and a fixed-base table for v ^ u % N, holding v in
+     * Montgomery form.
+     * Immutable, so it can be shared between sessions and threads.
+     */
+    class PrecomputedVerifier
+    {
+        public:
+            
+            /* From the server's group, hash algorithm and verifier */
+            PrecomputedVerifier( const Server & server, unsigned int window = 4 );
+            ~PrecomputedVerifier();
+            
+            PrecomputedVerifier( const PrecomputedVerifier & o )              = delete;
+            PrecomputedVerifier & operator =( const PrecomputedVerifier & o ) = delete;
+            
+            HashAlgorithm     hashAlgorithm() const;
+            Base::GroupType   groupType()     const;
+            const BigNum    & v()             const;
+            const BigNum    & kv()            const;
+            const FixedBase & powers()        const;
+            
+            /* Approximate size, in bytes */
+            size_t memory() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+    
+    /*
+     * Keeps the precomputed verifiers of frequently authenticating
+     * identities, within a memory budget.
+     * An identity is only admitted on its second miss, so identities that
+     * authenticate once never pay for a table - The identities that missed
+     * once are remembered as hashes, up to a fixed count.
+     * Entries are evicted with the CLOCK algorithm: a hit marks an entry as
+     * referenced, and the clock hand skips referenced entries once before
+     * evicting them.
+     */
+    class VerifierCache
+    {
+        public:
+            
+            struct Stats
+            {
+                uint64_t hits;
+                uint64_t misses;
+                uint64_t evictions;
+                size_t   entries;
+                size_t   memory;
+                size_t   budget;
+            };
+            
+            /* With the default window, an entry takes about 16 * ( hash bits / 4 ) * ( group bits / 8 ) bytes */
+            explicit VerifierCache( size_t budget, unsigned int window = 4 );
+            ~VerifierCache();
+            
+            VerifierCache( const VerifierCache & o )              = delete;
+            VerifierCache & operator =( const VerifierCache & o ) = delete;
+            
+            /*
+             * Entry for the server's identity and verifier, computed on a miss
+             * once the identity is admitted, or nullptr.
+             * An entry larger than the whole budget is returned but not kept.
+             */
+            std::shared_ptr< const PrecomputedVerifier > get( const Server & server );
+            
+            /* After a password change, although a different verifier is detected anyway */
+            void remove( const std::string & identity );
+            void clear();
+            
+            Stats stats() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_VERIFIER_CACHE_HPP */
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_VERIFIER_DIRECTORY_HPP
+#define SRPXX_VERIFIER_DIRECTORY_HPP
+
+#include <SRPXX/VerifierStore.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace SRP
+{
+    /*
+     * Publishes immutable VerifierStore snapshots to concurrent readers.
+     * Readers never block: they announce the current epoch and load the
+     * snapshot pointer. Replaced snapshots are retired, and destroyed once
+     * no reader that could have seen them remains (epoch-based reclamation).
+     */
+    class VerifierDirectory
+    {
+        public:
+            
+            /* Pins the current snapshot, on the thread that created it */
+            class Reader
+            {
+                public:
+                    
+                    Reader( const VerifierDirectory & directory );
+                    ~Reader();
+                    
+                    Reader( const Reader & o )              = delete;
+                    Reader & operator =( const Reader & o ) = delete;
+                    
+                    /* Null if nothing was published */
+                    const VerifierStore * store() const;
+                    
+                    /* Records point into the snapshot, so they are only valid while the reader is alive */
+                    std::optional< VerifierStore::Record > find( std::string_view identity ) const;
+                    
+                private:
+                    
+                    const VerifierDirectory * _directory;
+                    const VerifierStore     * _store;
+            };
+            
+            VerifierDirectory();
+            ~VerifierDirectory();
+            
+            VerifierDirectory( const VerifierDirectory & o )              = delete;
+            VerifierDirectory & operator =( const VerifierDirectory & o ) = delete;
+            
+            void publish( std::unique_ptr< VerifierStore > store );
+            void publish( const std::string & path );
+            
+            Reader read() const;
+            
+            /* Number of publications so far */
+            uint64_t version() const;
+            
+            /* Replaced snapshots not destroyed yet */
+            size_t retired() const;
+            
+            /* Destroys the retired snapshots no reader can still see, returning how many are left */
+            size_t reclaim();
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_VERIFIER_DIRECTORY_HPP */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_VERIFIER_LOG_HPP
+#define SRPXX_VERIFIER_LOG_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNum.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Write-optimized verifier store, as a directory of append-only segments.
+     * Updates are queued and written in batches, with one sync per batch.
+     * Records are checksummed, and the index of identities is kept in memory,
+     * rebuilt on startup by scanning the segments in parallel.
+     * Sealed segments are compacted in the background once they hold too much garbage.
+     * Removals are kept as tombstones, until compaction leaves no older record to hide.
+     */
+    class VerifierLog
+    {
+        public:
+            
+            struct Options
+            {
+                Options();
+                
+                /* A new segment is started once the current one reaches this size */
+                uint64_t segmentSize;
+                
+                /* Sealed segments are compacted once this fraction of their data is stale */
+                double compactionThreshold;
+            };
+            
+            struct Record
+            {
+                HashAlgorithm          hashAlgorithm;
+                Base::GroupType        groupType;
+                std::vector< uint8_t > salt;
+                BigNum                 verifier;
+            };
+            
+            struct Stats
+            {
+                uint64_t identities;
+                uint64_t segments;
+                uint64_t records;
+                uint64_t commits;
+                uint64_t bytesWritten;
+                uint64_t compactions;
+                uint64_t liveBytes;
+                uint64_t totalBytes;
+            };
+            
+            /* The directory is created if needed */
+            explicit VerifierLog( const std::string & directory );
+            VerifierLog( const std::string & directory, const Options & options );
+            ~VerifierLog();
+            
+            VerifierLog( const VerifierLog & o )              = delete;
+            VerifierLog & operator =( const VerifierLog & o ) = delete;
+            
+            /* Ready once the update is durable, and visible to find() */
+            std::future< void > put( const std::string & identity, HashAlgorithm hashAlgorithm, Base::GroupType groupType, const std::vector< uint8_t > & salt, const BigNum & verifier );
+            std::future< void > remove( const std::string & identity );
+            
+            std::optional< Record > find( const std::string & identity ) const;
+            size_t                  size() const;
+            
+            /* Merges the sealed segments, keeping live records only */
+            void compact();
+            
+            Stats stats() const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_VERIFIER_LOG_HPP */
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_VERIFIER_STORE_HPP
+#define SRPXX_VERIFIER_STORE_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNum.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Read-only, memory-mapped file of verifiers, indexed by identity.
+     * Lookups hash the identity into an open-addressed table and return views
+     * into the mapping, which can be passed to Server::setSalt() / setV() directly.
+     * Files are created with VerifierStore::Builder.
+     */
+    class VerifierStore
+    {
+        public:
+            
+            static constexpr uint32_t version = 1;
+            
+            /* Points into the mapping, so only valid while the store is alive */
+            struct Record
+            {
+                std::string_view identity;
+                HashAlgorithm    hashAlgorithm;
+                Base::GroupType  groupType;
+                const uint8_t  * salt;
+                size_t           saltLength;
+                BigNumView       verifier;
+            };
+            
+            class Builder
+            {
+                public:
+                    
+                    Builder();
+                    ~Builder();
+                    
+                    Builder( const Builder & o )              = delete;
+                    Builder & operator =( const Builder & o ) = delete;
+                    
+                    /* Replaces any previous record for the same identity */
+                    void add( const std::string & identity, HashAlgorithm hashAlgorithm, Base::GroupType groupType, const std::vector< uint8_t > & salt, const BigNum & verifier );
+                    
+                    size_t size() const;
+                    
+                    /* Written to a temporary file first, then renamed */
+                    void write( const std::string & path ) const;
+                    
+                private:
+                    
+                    class IMPL;
+                    
+                    std::unique_ptr< IMPL > impl;
+            };
+            
+            explicit VerifierStore( const std::string & path );
+            ~VerifierStore();
+            
+            VerifierStore( const VerifierStore & o )              = delete;
+            VerifierStore & operator =( const VerifierStore & o ) = delete;
+            
+            VerifierStore( VerifierStore && o ) noexcept;
+            VerifierStore & operator =( VerifierStore && o ) noexcept;
+            
+            size_t size() const;
+            
+            std::optional< Record > find( std::string_view identity ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::unique_ptr< IMPL > impl;
+    };
+}
+
+#endif /* SRPXX_VERIFIER_STORE_HPP */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_WIRE_HPP
+#define SRPXX_WIRE_HPP
+
+#include <SRPXX/Base.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/Client.hpp>
+#include <SRPXX/HashAlgorithm.hpp>
+#include <SRPXX/Server.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace SRP
+{
+    /*
+     * Versioned binary encoding of the four handshake messages.
+     * Each message starts with an 8-byte header: version, type, hash algorithm,
+     * group, and the 32-bit little-endian length of the body.
+     * Identities and salts are prefixed by an 8-bit length, A and B are left-padded
+     * to the size of the group, and M1 and M2 have the size of the digest.
+     */
+    namespace Wire
+    {
+        enum class Type: uint8_t
+        {
+            Hello       = 1,
+            Challenge   = 2,
+            ClientProof = 3,
+            ServerProof = 4
+        };
+        
+        struct Bytes
+        {
+            const uint8_t * data;
+            size_t          length;
+        };
+        
+        /* Parsed fields point into the input - Only the fields of the message's type are set */
+        struct Message
+        {
+            Type             type;
+            HashAlgorithm    hashAlgorithm;
+            Base::GroupType  groupType;
+            std::string_view identity;
+            Bytes            salt;
+            BigNumView       A;
+            BigNumView       B;
+            Bytes            M1;
+            Bytes            M2;
+        };
+        
+        constexpr uint8_t version      = 1;
+        constexpr size_t  headerLength = 8;
+        constexpr size_t  maxLength    = headerLength + 1 + 255 + 1024;
+        
+        size_t valueLength( Base::GroupType groupType );
+        size_t proofLength( HashAlgorithm hashAlgorithm );
+        
+        /* Writes the message to the output - Returns its length, or 0 if the buffer is too small */
+        size_t encodeHello(       const Client & client, uint8_t * output, size_t capacity );
+        size_t encodeChallenge(   const Server & server, uint8_t * output, size_t capacity );
+        size_t encodeClientProof( const Client & client, uint8_t * output, size_t capacity );
+        size_t encodeServerProof( const Server & server, const std::vector< uint8_t > & M2, uint8_t * output, size_t capacity );
+        
+        /*
+         * Parses the message at the start of the input, without copying.
+         * Returns its length, or 0 if more input is needed - Throws for a malformed message.
+         */
+        size_t parse( const uint8_t * input, size_t length, Message & message );
+    }
+}
+
+#endif /* SRPXX_WIRE_HPP */
@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "AEAD.hpp"
+#include <climits>
+#include <stdexcept>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/evp.h>
+#ifdef OPENSSL_IS_BORINGSSL
+#include <openssl/aead.h>
+#endif
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    namespace AEAD
+    {
+        #ifdef OPENSSL_IS_BORINGSSL
+        
+        class Context::IMPL
+        {
+            public:
+                
+                IMPL( Cipher cipher, const uint8_t * key );
+                ~IMPL();
+                
+                EVP_AEAD_CTX _context;
+        };
+        
+        #else
+        
+        class Context::IMPL
+        {
+            public:
+                
+                using CipherContext = std::unique_ptr< EVP_CIPHER_CTX, decltype( &EVP_CIPHER_CTX_free ) >;
+                
+                IMPL( Cipher cipher, const uint8_t * key );
+                ~IMPL();
+                
+                /* Keyed once - Each record only sets its nonce */
+                static CipherContext init( Cipher cipher, const uint8_t * key, bool encrypt );
+                
+                bool crypt( EVP_CIPHER_CTX * context, bool encrypt, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag );
+                
+                CipherContext _encrypt;
+                CipherContext _decrypt;
+        };
+        
+        #endif
+        
+        Context::Context( Cipher cipher, const uint8_t * key ):
+            impl( std::make_unique< IMPL >( cipher, key ) )
+        {}
+        
+        Context::~Context()
+        {}
+        
+        Context::Context( Context && o ) noexcept = default;
+        
+        Context & Context::operator =( Context && o ) noexcept = default;
+        
+        #ifdef OPENSSL_IS_BORINGSSL
+        
+        bool Context::seal( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag )
+        {
+            size_t tagSize = 0;
+            
+            return EVP_AEAD_CTX_seal_scatter( &( this->impl->_context ), data, tag, &tagSize, tagLength, nonce, nonceLength, data, length, nullptr, 0, aad, aadLength ) == 1;
+        }
+        
+        bool Context::open( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, const uint8_t * tag )
+        {
+            return EVP_AEAD_CTX_open_gather( &( this->impl->_context ), data, nonce, nonceLength, data, length, tag, tagLength, aad, aadLength ) == 1;
+        }
+        
+        Context::IMPL::IMPL( Cipher cipher, const uint8_t * key )
+        {
+            const EVP_AEAD * aead = ( cipher == Cipher::AES256GCM ) ? EVP_aead_aes_256_gcm() : EVP_aead_chacha20_poly1305();
+            
+            if( EVP_AEAD_CTX_init( &( this->_context ), aead, key, keyLength, tagLength, nullptr ) != 1 )
+            {
+                throw std::runtime_error( "Cannot initialize AEAD context" );
+            }
+        }
+        
+        Context::IMPL::~IMPL()
+        {
+            EVP_AEAD_CTX_cleanup( &( this->_context ) );
+        }
+        
+        #else
+        
+        bool Context::seal( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag )
+        {
+            return this->impl->crypt( this->impl->_encrypt.get(), true, nonce, aad, aadLength, data, length, tag );
+        }
+        
+        bool Context::open( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, const uint8_t * tag )
+        {
+            return this->impl->crypt( this->impl->_decrypt.get(), false, nonce, aad, aadLength, data, length, const_cast< uint8_t * >( tag ) );
+        }
+        
+        Context::IMPL::IMPL( Cipher cipher, const uint8_t * key ):
+            _encrypt( init( cipher, key, true ) ),
+            _decrypt( init( cipher, key, false ) )
+        {}
+        
+        Context::IMPL::~IMPL()
+        {}
+        
+        Context::IMPL::CipherContext Context::IMPL::init( Cipher cipher, const uint8_t * key, bool encrypt )
+        {
+            CipherContext context( EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free );
+            
+            if( context == nullptr )
+            {
+                throw std::bad_alloc();
+            }
+            
+            const EVP_CIPHER * evp = ( cipher == Cipher::AES256GCM ) ? EVP_aes_256_gcm() : EVP_chacha20_poly1305();
+            
+            if( EVP_CipherInit_ex( context.get(), evp, nullptr, nullptr, nullptr, encrypt ? 1 : 0 ) != 1
+            ||  EVP_CIPHER_CTX_ctrl( context.get(), EVP_CTRL_AEAD_SET_IVLEN, static_cast< int >( nonceLength ), nullptr ) != 1
+            ||  EVP_CipherInit_ex( context.get(), nullptr, nullptr, key, nullptr, -1 ) != 1 )
+            {
+                throw std::runtime_error( "Cannot initialize AEAD context" );
+            }
+            
+            return context;
+        }
+        
+        bool Context::IMPL::crypt( EVP_CIPHER_CTX * context, bool encrypt, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag )
+        {
+            int outLength = 0;
+            
+            if( aadLength > INT_MAX || length > INT_MAX )
+            {
+                return false;
+            }
+            
+            if( EVP_CipherInit_ex( context, nullptr, nullptr, nullptr, nonce, -1 ) != 1 )
+            {
+                return false;
+            }
+            
+            if( aadLength > 0 && EVP_CipherUpdate( context, nullptr, &outLength, aad, static_cast< int >( aadLength ) ) != 1 )
+            {
+                return false;
+            }
+            
+            /* Both ciphers are stream modes, so the output can overwrite the input */
+            if( length > 0 && EVP_CipherUpdate( context, data, &outLength, data, static_cast< int >( length ) ) != 1 )
+            {
+                return false;
+            }
+            
+            if( encrypt == false && EVP_CIPHER_CTX_ctrl( context, EVP_CTRL_AEAD_SET_TAG, static_cast< int >( tagLength ), tag ) != 1 )
+            {
+                return false;
+            }
+            
+            if( EVP_CipherFinal_ex( context, data + length, &outLength ) != 1 )
+            {
+                return false;
+            }
+            
+            return encrypt == false || EVP_CIPHER_CTX_ctrl( context, EVP_CTRL_AEAD_GET_TAG, static_cast< int >( tagLength ), tag ) == 1;
+        }
+        
+        #endif
+        
+        bool seal( const uint8_t * key, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag )
+        {
+            return Context( Cipher::AES256GCM, key ).seal( nonce, aad, aadLength, data, length, tag );
+        }
+        
+        bool open( const uint8_t * key, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, const uint8_t * tag )
+        {
+            return Context( Cipher::AES256GCM, key ).open( nonce, aad, aadLength, data, length, tag );
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_AEAD_HPP
+#define SRPXX_AEAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace SRP
+{
+    /* AEAD ciphers through the linked SSL library, in place on caller buffers */
+    namespace AEAD
+    {
+        constexpr size_t keyLength   = 32;
+        constexpr size_t nonceLength = 12;
+        constexpr size_t tagLength   = 16;
+        
+        enum class Cipher
+        {
+            AES256GCM,
+            ChaCha20Poly1305
+        };
+        
+        /* A key set up once, for many records - Not thread-safe */
+        class Context
+        {
+            public:
+                
+                /* Throws if the cipher is not available */
+                Context( Cipher cipher, const uint8_t * key );
+                ~Context();
+                
+                Context( const Context & o )              = delete;
+                Context & operator =( const Context & o ) = delete;
+                
+                Context( Context && o ) noexcept;
+                Context & operator =( Context && o ) noexcept;
+                
+                bool seal( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag );
+                
+                /* False if the tag does not match, in which case the data is garbage */
+                bool open( const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, const uint8_t * tag );
+                
+            private:
+                
+                class IMPL;
+                
+                std::unique_ptr< IMPL > impl;
+        };
+        
+        /* AES-256-GCM with a one-time context */
+        bool seal( const uint8_t * key, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, uint8_t * tag );
+        bool open( const uint8_t * key, const uint8_t * nonce, const uint8_t * aad, size_t aadLength, uint8_t * data, size_t length, const uint8_t * tag );
+    }
+}
+
+#endif /* SRPXX_AEAD_HPP */
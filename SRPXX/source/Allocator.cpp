@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/Allocator.hpp>
+#include <atomic>
+#include <cstdlib>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/crypto.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    namespace
+    {
+        class MallocAllocator: public Allocator
+        {
+            public:
+                
+                void * allocate( size_t size ) override
+                {
+                    return malloc( size );
+                }
+                
+                void * reallocate( void * p, size_t size ) override
+                {
+                    return realloc( p, size );
+                }
+                
+                void deallocate( void * p ) override
+                {
+                    free( p );
+                }
+        };
+        
+        std::atomic< Allocator * > & currentAllocator()
+        {
+            static std::atomic< Allocator * > allocator( &( Allocator::defaultAllocator() ) );
+            
+            return allocator;
+        }
+        
+        #ifndef OPENSSL_IS_BORINGSSL
+        
+        std::atomic< Allocator * > openSSLAllocator( nullptr );
+        
+        void * openSSLMalloc( size_t size, const char * file, int line )
+        {
+            ( void )file;
+            ( void )line;
+            
+            return openSSLAllocator.load( std::memory_order_relaxed )->allocate( size );
+        }
+        
+        void * openSSLRealloc( void * p, size_t size, const char * file, int line )
+        {
+            ( void )file;
+            ( void )line;
+            
+            Allocator * allocator = openSSLAllocator.load( std::memory_order_relaxed );
+            
+            if( p == nullptr )
+            {
+                return allocator->allocate( size );
+            }
+            
+            if( size == 0 )
+            {
+                allocator->deallocate( p );
+                
+                return nullptr;
+            }
+            
+            return allocator->reallocate( p, size );
+        }
+        
+        void openSSLFree( void * p, const char * file, int line )
+        {
+            ( void )file;
+            ( void )line;
+            
+            if( p != nullptr )
+            {
+                openSSLAllocator.load( std::memory_order_relaxed )->deallocate( p );
+            }
+        }
+        
+        #endif
+    }
+    
+    Allocator & Allocator::defaultAllocator()
+    {
+        /* Never destroyed, as memory may still be released during static destruction */
+        static Allocator * allocator = new MallocAllocator();
+        
+        return *( allocator );
+    }
+    
+    Allocator & Allocator::current()
+    {
+        return *( currentAllocator().load( std::memory_order_acquire ) );
+    }
+    
+    void Allocator::setCurrent( Allocator & allocator )
+    {
+        currentAllocator().store( &allocator, std::memory_order_release );
+    }
+    
+    bool Allocator::useForOpenSSL( Allocator & allocator )
+    {
+        #ifdef OPENSSL_IS_BORINGSSL
+        
+        ( void )allocator;
+        
+        return false;
+        
+        #else
+        
+        Allocator * expected = nullptr;
+        
+        if( openSSLAllocator.compare_exchange_strong( expected, &allocator ) == false )
+        {
+            return false;
+        }
+        
+        if( CRYPTO_set_mem_functions( openSSLMalloc, openSSLRealloc, openSSLFree ) != 1 )
+        {
+            openSSLAllocator.store( nullptr );
+            
+            return false;
+        }
+        
+        return true;
+        
+        #endif
+    }
+}
@@ -22,10 +22,10 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
-/* For memset_s */
-#define __STDC_WANT_LIB_EXT1__ 1
-
 #include <SRPXX/Base.hpp>
+#include <SRPXX/GroupTables.hpp>
+#include <SRPXX/HMAC.hpp>
+#include <SRPXX/SecureArena.hpp>
 #include <SRPXX/SHA1.hpp>
 #include <SRPXX/SHA224.hpp>
 #include <SRPXX/SHA256.hpp>
@@ -33,15 +33,75 @@
 #include <SRPXX/SHA512.hpp>
 #include <string>
 #include <cctype>
+#include <mutex>
 #include <stdexcept>
 #include <string.h>
 
-#ifdef _WIN32
-#include <Windows.h>
-#endif
-
 namespace SRP
 {
+    namespace
+    {
+        /* PRK = HMAC( 0, K ) */
+        template< typename Hash >
+        void extract( const std::vector< uint8_t > & K, SecureBytes & prk )
+        {
+            HMAC< Hash > hmac( nullptr, 0 );
+            
+            prk.resize( Hash::digestSize );
+            hmac.mac( K.data(), K.size(), prk.data() );
+        }
+        
+        /* T( i ) = HMAC( PRK, T( i - 1 ) || label || i ), keyed once for all labels */
+        template< typename Hash, typename Keys >
+        void expand( const SecureBytes & prk, const Keys & keys )
+        {
+            HMAC< Hash > hmac( prk.data(), prk.size() );
+            uint8_t      t[ Hash::digestSize ];
+            
+            for( const auto & key: keys )
+            {
+                if( key.length > 255 * Hash::digestSize )
+                {
+                    throw std::runtime_error( "Derived key is too long" );
+                }
+                
+                for( size_t offset = 0, i = 1; offset < key.length; offset += Hash::digestSize, i++ )
+                {
+                    uint8_t counter = static_cast< uint8_t >( i );
+                    
+                    hmac.begin();
+                    
+                    if( i > 1 )
+                    {
+                        hmac.update( t, sizeof( t ) );
+                    }
+                    
+                    hmac.update( reinterpret_cast< const uint8_t * >( key.label.data() ), key.label.size() );
+                    hmac.update( &counter, 1 );
+                    hmac.finalize( t );
+                    
+                    memcpy( key.key + offset, t, std::min( sizeof( t ), key.length - offset ) );
+                }
+            }
+            
+            SecureArena::wipe( t, sizeof( t ) );
+        }
+        
+        template< typename Hash, typename Keys >
+        void derive( const Base & session, SecureBytes & prk, const Keys & keys )
+        {
+            if( prk.empty() )
+            {
+                std::vector< uint8_t > K = session.K();
+                
+                extract< Hash >( K, prk );
+                SecureArena::wipe( K.data(), K.size() );
+            }
+            
+            expand< Hash >( prk, keys );
+        }
+    }
+    
     class Base::IMPL
     {
         public:
@@ -54,12 +114,22 @@ namespace SRP
             BigNum                 _N;
             BigNum                 _g;
             std::string            _identity;
-            std::vector< uint8_t > _salt;
+            SecureBytes            _salt;
+            mutable SecureBytes    _prk;
+            mutable std::mutex     _prkMutex;
             
-            void clearSalt();
+            /* Only if they contain the group */
+            std::shared_ptr< const GroupTables > _tables;
             
-            static BigNum getN( GroupType groupType );
-            static BigNum getG( GroupType groupType );
+            struct Group
+            {
+                BigNum N;
+                BigNum g;
+            };
+            
+            static const Group & getGroup( GroupType groupType );
+            static BigNum        getN( GroupType groupType );
+            static BigNum        getG( GroupType groupType );
             
             static std::pair< std::string, std::string > getNG( GroupType groupType );
             
@@ -79,21 +149,58 @@ namespace SRP
     Base::~Base()
     {}
     
+    Base::Base( Base && o ) noexcept = default;
+    
+    Base & Base::operator =( Base && o ) noexcept = default;
+    
+    void Base::clear()
+    {
+        SecureArena::wipe( this->impl->_salt.data(), this->impl->_salt.size() );
+        
+        this->impl->_identity.clear();
+        this->impl->_salt.clear();
+        this->invalidateKeys();
+    }
+    
+    void Base::reset( const std::string & identity )
+    {
+        this->Base::clear();
+        
+        this->impl->_identity = identity;
+    }
+    
     std::string Base::identity() const
     {
         return this->impl->_identity;
     }
     
+    HashAlgorithm Base::hashAlgorithm() const
+    {
+        return this->impl->_hashAlgorithm;
+    }
+    
+    Base::GroupType Base::groupType() const
+    {
+        return this->impl->_groupType;
+    }
+    
     std::vector< uint8_t > Base::salt() const
     {
-        return this->impl->_salt;
+        return { this->impl->_salt.begin(), this->impl->_salt.end() };
     }
     
     void Base::setSalt( const std::vector< uint8_t > & value )
     {
-        this->impl->clearSalt();
+        this->setSalt( value.data(), value.size() );
+    }
+    
+    void Base::setSalt( const uint8_t * data, size_t length )
+    {
+        SecureArena::wipe( this->impl->_salt.data(), this->impl->_salt.size() );
         
-        this->impl->_salt = value;
+        /* Re-uses the existing capacity */
+        this->impl->_salt.assign( data, data + length );
+        this->invalidateKeys();
     }
     
     BigNum Base::N() const
@@ -109,6 +216,11 @@ namespace SRP
     /* H( N | PAD( g ) ) */
     BigNum Base::k() const
     {
+        if( this->impl->_tables != nullptr )
+        {
+            return BigNum( this->impl->_tables->k( this->impl->_groupType, this->impl->_hashAlgorithm ) );
+        }
+        
         return BigNum
         (
             this->hash
@@ -138,48 +250,150 @@ namespace SRP
         );
     }
     
+    /* A % N != 0 / B % N != 0 */
+    bool Base::isValidPublicValue( const BigNumView & value ) const
+    {
+        return value.isValidModulo( this->impl->_N );
+    }
+    
     /* H( S ) */
     std::vector< uint8_t > Base::K() const
     {
-        return this->hash( this->S().bytes( BigNum::Endianness::BigEndian ) );
+        return this->K( this->S() );
+    }
+    
+    std::vector< uint8_t > Base::K( const BigNum & S ) const
+    {
+        std::vector< uint8_t > bytes = S.bytes( BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > K     = this->hash( bytes );
+        
+        SecureArena::wipe( bytes.data(), bytes.size() );
+        
+        return K;
+    }
+    
+    void Base::deriveKeys( std::initializer_list< DerivedKey > keys ) const
+    {
+        /* The PRK is cached by a const method, so concurrent calls must not race on it */
+        std::lock_guard< std::mutex > l( this->impl->_prkMutex );
+        
+        switch( this->impl->_hashAlgorithm )
+        {
+            case HashAlgorithm::SHA1:   derive< SHA1   >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA224: derive< SHA224 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA256: derive< SHA256 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA384: derive< SHA384 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA512: derive< SHA512 >( *( this ), this->impl->_prk, keys ); break;
+        }
+    }
+    
+    void Base::deriveKeys( const std::vector< DerivedKey > & keys ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_prkMutex );
+        
+        switch( this->impl->_hashAlgorithm )
+        {
+            case HashAlgorithm::SHA1:   derive< SHA1   >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA224: derive< SHA224 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA256: derive< SHA256 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA384: derive< SHA384 >( *( this ), this->impl->_prk, keys ); break;
+            case HashAlgorithm::SHA512: derive< SHA512 >( *( this ), this->impl->_prk, keys ); break;
+        }
     }
     
     /* H( H( N ) xor H( g ), H( I ), s, A, B, K ) */
     std::vector< uint8_t > Base::M1() const
     {
-        std::vector< uint8_t > hn = this->hash( this->N().bytes( BigNum::Endianness::BigEndian ) );
-        std::vector< uint8_t > hg = this->hash( this->pad( this->g().bytes( BigNum::Endianness::BigEndian ) ) );
+        std::vector< uint8_t > K  = this->K();
+        std::vector< uint8_t > M1 = this->M1( K );
+        
+        SecureArena::wipe( K.data(), K.size() );
+        
+        return M1;
+    }
+    
+    std::vector< uint8_t > Base::M1( const std::vector< uint8_t > & K ) const
+    {
         std::vector< uint8_t > ng;
         
-        for( size_t i = 0; i < hn.size(); i++ )
+        if( this->impl->_tables != nullptr )
         {
-            ng.push_back( hn[ i ] ^ hg[ i ] );
+            ng = this->impl->_tables->hashNG( this->impl->_groupType, this->impl->_hashAlgorithm );
         }
-        
-        return this->hash
-        (
+        else
+        {
+            std::vector< uint8_t > hn = this->hash( this->N().bytes( BigNum::Endianness::BigEndian ) );
+            std::vector< uint8_t > hg = this->hash( this->pad( this->g().bytes( BigNum::Endianness::BigEndian ) ) );
+            
+            for( size_t i = 0; i < hn.size(); i++ )
             {
-                ng,
-                this->hash( String::toBytes( this->identity() ) ),
-                this->salt(),
-                this->A().bytes( BigNum::Endianness::BigEndian ),
-                this->B().bytes( BigNum::Endianness::BigEndian ),
-                this->K()
+                ng.push_back( hn[ i ] ^ hg[ i ] );
             }
-        );
+        }
+        
+        /* K is hashed in place rather than copied into a list of inputs */
+        std::unique_ptr< Hasher > hasher = this->makeHasher();
+        
+        hasher->update( ng );
+        hasher->update( this->hash( String::toBytes( this->identity() ) ) );
+        hasher->update( this->impl->_salt.data(), this->impl->_salt.size() );
+        hasher->update( this->A().bytes( BigNum::Endianness::BigEndian ) );
+        hasher->update( this->B().bytes( BigNum::Endianness::BigEndian ) );
+        hasher->update( K );
+        hasher->finalize();
+        
+        return hasher->bytes();
     }
     
     /* H( A | M | K ) */
     std::vector< uint8_t > Base::M2() const
     {
-        return this->hash
-        (
-            {
-                this->A().bytes( BigNum::Endianness::BigEndian ),
-                this->M1(),
-                this->K()
-            }
-        );
+        std::vector< uint8_t > K  = this->K();
+        std::vector< uint8_t > M1 = this->M1( K );
+        std::vector< uint8_t > M2 = this->M2( M1, K );
+        
+        SecureArena::wipe( K.data(),  K.size() );
+        SecureArena::wipe( M1.data(), M1.size() );
+        
+        return M2;
+    }
+    
+    std::vector< uint8_t > Base::M2( const std::vector< uint8_t > & M1, const std::vector< uint8_t > & K ) const
+    {
+        std::unique_ptr< Hasher > hasher = this->makeHasher();
+        
+        hasher->update( this->A().bytes( BigNum::Endianness::BigEndian ) );
+        hasher->update( M1 );
+        hasher->update( K );
+        hasher->finalize();
+        
+        return hasher->bytes();
+    }
+    
+    BigNum Base::gExp( const BigNum & exponent ) const
+    {
+        const FixedBase * table = ( this->impl->_tables != nullptr ) ? this->impl->_tables->g( this->impl->_groupType ) : nullptr;
+        
+        if( table != nullptr && table->covers( exponent ) )
+        {
+            return table->modExp( exponent );
+        }
+        
+        return this->impl->_g.modExp( exponent, this->impl->_N );
+    }
+    
+    bool Base::hasGroupTables() const
+    {
+        return this->impl->_tables != nullptr;
+    }
+    
+    void Base::invalidateKeys()
+    {
+        std::lock_guard< std::mutex > l( this->impl->_prkMutex );
+        
+        SecureArena::wipe( this->impl->_prk.data(), this->impl->_prk.size() );
+        
+        this->impl->_prk.clear();
     }
     
     std::unique_ptr< Hasher > Base::makeHasher() const
@@ -236,28 +450,39 @@ namespace SRP
     Base::IMPL::IMPL( const std::string & identity, HashAlgorithm hashAlgorithm, GroupType groupType ):
         _hashAlgorithm( hashAlgorithm ),
         _groupType( groupType ),
-        _N( IMPL::getN( groupType ) ),
-        _g( IMPL::getG( groupType ) ),
-        _identity( identity )
-    {}
-    
-    Base::IMPL::~IMPL()
+        _N( IMPL::getGroup( groupType ).N ),
+        _g( IMPL::getGroup( groupType ).g ),
+        _identity( identity ),
+        _salt( SecureArena::shared() ),
+        _prk( SecureArena::shared() ),
+        _tables( GroupTables::installed() )
     {
-        this->clearSalt();
+        if( this->_tables != nullptr && this->_tables->contains( groupType ) == false )
+        {
+            this->_tables = nullptr;
+        }
     }
     
-    void Base::IMPL::clearSalt()
+    Base::IMPL::~IMPL()
+    {}
+            
+    const Base::IMPL::Group & Base::IMPL::getGroup( GroupType groupType )
     {
-        if( this->_salt.size() > 0 )
+        /* Parsed once, as every session for a group shares the same values */
+        static const std::vector< Group > groups =
         {
-            #ifdef _WIN32
-            SecureZeroMemory( this->_salt.data(), this->_salt.size() );
-            #else
-            memset_s( this->_salt.data(), this->_salt.size(), 0, this->_salt.size() );
-            #endif
-        }
+            { IMPL::getN( GroupType::NG1024 ), IMPL::getG( GroupType::NG1024 ) },
+            { IMPL::getN( GroupType::NG1536 ), IMPL::getG( GroupType::NG1536 ) },
+            { IMPL::getN( GroupType::NG2048 ), IMPL::getG( GroupType::NG2048 ) },
+            { IMPL::getN( GroupType::NG3072 ), IMPL::getG( GroupType::NG3072 ) },
+            { IMPL::getN( GroupType::NG4096 ), IMPL::getG( GroupType::NG4096 ) },
+            { IMPL::getN( GroupType::NG6144 ), IMPL::getG( GroupType::NG6144 ) },
+            { IMPL::getN( GroupType::NG8192 ), IMPL::getG( GroupType::NG8192 ) }
+        };
+        
+        return groups[ static_cast< size_t >( groupType ) ];
     }
-            
+    
     BigNum Base::IMPL::getN( GroupType groupType )
     {
         std::unique_ptr< BigNum > N = BigNum::fromString( IMPL::getNG( groupType ).first, BigNum::StringFormat::Hexadecimal );
@@ -23,53 +23,18 @@
  ******************************************************************************/
 
 #include <SRPXX/BigNum.hpp>
+#include <SRPXX/Allocator.hpp>
+#include <SRPXX/BigNumView.hpp>
 #include <SRPXX/Platform.hpp>
 #include <SRPXX/String.hpp>
 #include <algorithm>
+#include <cstddef>
 #include <exception>
-
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wold-style-cast"
-#endif
-#include <openssl/ssl.h>
-#include <openssl/bn.h>
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
+#include <stdexcept>
+#include "BigNumIMPL.hpp"
 
 namespace SRP
 {
-    class BigNum::IMPL
-    {
-        public:
-            
-            IMPL( BIGNUM * bn );
-            IMPL( const std::vector< uint8_t > & bytes, Endianness endianness );
-            IMPL( int64_t value );
-            IMPL( const BigNum & o );
-            ~IMPL();
-            
-            BIGNUM * _bn;
-    };
-    
-    class BigNum::Context
-    {
-        public:
-            
-            Context();
-            ~Context();
-            
-            Context( const Context & o ) = delete;
-            Context & operator =( const Context & o ) = delete;
-            
-            operator BN_CTX * () const;
-            
-        private:
-            
-            BN_CTX * _ctx;
-    };
-    
     std::unique_ptr< BigNum > BigNum::fromString( const std::string & value, StringFormat format )
     {
         BigNum n;
@@ -94,7 +59,56 @@ namespace SRP
     {
         BigNum n;
         
-        BN_rand( n.impl->_bn, static_cast< int >( bits ), BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ANY );
+        if( BN_rand( n.impl->_bn, static_cast< int >( bits ), BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ANY ) != 1 )
+        {
+            throw std::runtime_error( "Cannot generate random BigNum value" );
+        }
+        
+        return n;
+    }
+    
+    BigNum BigNum::modSubMulExp( const BigNum & a, const BigNum & k, const BigNum & g, const BigNum & x, const BigNum & modulus )
+    {
+        Context ctx;
+        BigNum  n;
+        
+        BN_CTX_start( ctx );
+        
+        BIGNUM * t = BN_CTX_get( ctx );
+        bool     r = t != nullptr
+                  && BN_mod_exp( t, g.impl->_bn, x.impl->_bn, modulus.impl->_bn, ctx )
+                  && BN_mod_mul( t, t, k.impl->_bn, modulus.impl->_bn, ctx )
+                  && BN_mod_sub( n.impl->_bn, a.impl->_bn, t, modulus.impl->_bn, ctx );
+        
+        BN_CTX_end( ctx );
+        
+        if( r == false )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
+        
+        return n;
+    }
+    
+    BigNum BigNum::modMulAddExp( const BigNum & k, const BigNum & v, const BigNum & g, const BigNum & b, const BigNum & modulus )
+    {
+        Context ctx;
+        BigNum  n;
+        
+        BN_CTX_start( ctx );
+        
+        BIGNUM * t = BN_CTX_get( ctx );
+        bool     r = t != nullptr
+                  && BN_mod_exp( t, g.impl->_bn, b.impl->_bn, modulus.impl->_bn, ctx )
+                  && BN_mod_mul( n.impl->_bn, k.impl->_bn, v.impl->_bn, modulus.impl->_bn, ctx )
+                  && BN_mod_add( n.impl->_bn, n.impl->_bn, t, modulus.impl->_bn, ctx );
+        
+        BN_CTX_end( ctx );
+        
+        if( r == false )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
         
         return n;
     }
@@ -111,6 +125,10 @@ namespace SRP
         impl( std::make_unique< IMPL >( value ) )
     {}
     
+    BigNum::BigNum( const BigNumView & view ):
+        impl( std::make_unique< IMPL >( BN_bin2bn( view.data(), view.size(), nullptr ) ) )
+    {}
+    
     BigNum::BigNum( const BigNum & o ):
         impl( std::make_unique< IMPL >( o ) )
     {}
@@ -129,6 +147,45 @@ namespace SRP
         return *( this );
     }
     
+    BigNum & BigNum::assign( const BigNumView & view )
+    {
+        /* BN_bin2bn re-uses the existing limbs when they are large enough */
+        if( BN_bin2bn( view.data(), view.size(), this->impl->_bn ) == nullptr )
+        {
+            throw std::runtime_error( "Cannot assign BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    BigNum & BigNum::assign( const BigNum & o )
+    {
+        if( BN_copy( this->impl->_bn, o.impl->_bn ) == nullptr )
+        {
+            throw std::runtime_error( "Cannot assign BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    BigNum & BigNum::randomize( unsigned int bits )
+    {
+        if( BN_rand( this->impl->_bn, static_cast< int >( bits ), BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ANY ) != 1 )
+        {
+            throw std::runtime_error( "Cannot generate random BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    /* Wipes the current value */
+    BigNum & BigNum::clear()
+    {
+        BN_clear( this->impl->_bn );
+        
+        return *( this );
+    }
+    
     bool BigNum::operator ==( const BigNum & o ) const
     {
         return BN_cmp( this->impl->_bn, o.impl->_bn ) == 0;
@@ -181,39 +238,48 @@ namespace SRP
             
     bool BigNum::operator >=( const BigNum & o ) const
     {
-        return *( this ) > o || *( this ) == o;
+        return this->compare( o ) >= 0;
     }
     
     bool BigNum::operator <=( const BigNum & o ) const
     {
-        return *( this ) < o || *( this ) == o;
+        return this->compare( o ) <= 0;
     }
     
     bool BigNum::operator >( const BigNum & o ) const
     {
-        return BN_cmp( this->impl->_bn, o.impl->_bn ) == 1;
+        return this->compare( o ) > 0;
     }
     
     bool BigNum::operator <( const BigNum & o ) const
     {
-        return BN_cmp( this->impl->_bn, o.impl->_bn ) == -1;
+        return this->compare( o ) < 0;
+    }
+    
+    int BigNum::compare( const BigNum & o ) const
+    {
+        return BN_cmp( this->impl->_bn, o.impl->_bn );
     }
     
     BigNum & BigNum::operator ++()
     {
-        return *( this ) += 1;
+        BN_add_word( this->impl->_bn, 1 );
+        
+        return *( this );
     }
     
     BigNum & BigNum::operator --()
     {
-        return *( this ) -= 1;
+        BN_sub_word( this->impl->_bn, 1 );
+        
+        return *( this );
     }
     
     BigNum BigNum::operator ++( int )
     {
         BigNum n( *( this ) );
         
-        *( this ) += 1;
+        ++( *( this ) );
         
         return n;
     }
@@ -222,7 +288,7 @@ namespace SRP
     {
         BigNum n( *( this ) );
         
-        *( this ) -= 1;
+        --( *( this ) );
         
         return n;
     }
@@ -277,7 +343,7 @@ namespace SRP
         return *( this );
     }
     
-    BigNum BigNum::operator +( const BigNum & value ) const
+    BigNum BigNum::operator +( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -286,7 +352,7 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::operator -( const BigNum & value ) const
+    BigNum BigNum::operator -( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -295,7 +361,7 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::operator *( const BigNum & value ) const
+    BigNum BigNum::operator *( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -304,7 +370,7 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::operator /( const BigNum & value ) const
+    BigNum BigNum::operator /( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -313,7 +379,7 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::operator %( const BigNum & value ) const
+    BigNum BigNum::operator %( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -322,7 +388,7 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::operator ^( const BigNum & value ) const
+    BigNum BigNum::operator ^( const BigNum & value ) const &
     {
         BigNum n( *( this ) );
         
@@ -331,36 +397,160 @@ namespace SRP
         return n;
     }
     
-    BigNum BigNum::modExp( const BigNum & exponent, const BigNum & modulus ) const
+    BigNum BigNum::operator +( const BigNum & value ) &&
     {
-        Context ctx;
-        BigNum  n( *( this ) );
+        *( this ) += value;
         
-        BN_mod_exp( n.impl->_bn, n.impl->_bn, exponent.impl->_bn, modulus.impl->_bn, ctx );
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::operator -( const BigNum & value ) &&
+    {
+        *( this ) -= value;
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::operator *( const BigNum & value ) &&
+    {
+        *( this ) *= value;
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::operator /( const BigNum & value ) &&
+    {
+        *( this ) /= value;
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::operator %( const BigNum & value ) &&
+    {
+        *( this ) %= value;
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::operator ^( const BigNum & value ) &&
+    {
+        *( this ) ^= value;
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::modExp( const BigNum & exponent, const BigNum & modulus ) const &
+    {
+        BigNum n( *( this ) );
+        
+        n.modExpInPlace( exponent, modulus );
         
         return n;
     }
     
-    BigNum BigNum::modAdd( const BigNum & add, const BigNum & modulus ) const
+    BigNum BigNum::modAdd( const BigNum & add, const BigNum & modulus ) const &
     {
-        Context ctx;
-        BigNum  n( *( this ) );
+        BigNum n( *( this ) );
         
-        BN_mod_add( n.impl->_bn, n.impl->_bn, add.impl->_bn, modulus.impl->_bn, ctx );
+        n.modAddInPlace( add, modulus );
         
         return n;
     }
     
-    BigNum BigNum::modMul( const BigNum & multiplier, const BigNum & modulus ) const
+    BigNum BigNum::modSub( const BigNum & sub, const BigNum & modulus ) const &
     {
-        Context ctx;
-        BigNum  n( *( this ) );
+        BigNum n( *( this ) );
         
-        BN_mod_mul( n.impl->_bn, n.impl->_bn, multiplier.impl->_bn, modulus.impl->_bn, ctx );
+        n.modSubInPlace( sub, modulus );
         
         return n;
     }
     
+    BigNum BigNum::modMul( const BigNum & multiplier, const BigNum & modulus ) const &
+    {
+        BigNum n( *( this ) );
+        
+        n.modMulInPlace( multiplier, modulus );
+        
+        return n;
+    }
+    
+    BigNum BigNum::modExp( const BigNum & exponent, const BigNum & modulus ) &&
+    {
+        this->modExpInPlace( exponent, modulus );
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::modAdd( const BigNum & add, const BigNum & modulus ) &&
+    {
+        this->modAddInPlace( add, modulus );
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::modSub( const BigNum & sub, const BigNum & modulus ) &&
+    {
+        this->modSubInPlace( sub, modulus );
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum BigNum::modMul( const BigNum & multiplier, const BigNum & modulus ) &&
+    {
+        this->modMulInPlace( multiplier, modulus );
+        
+        return std::move( *( this ) );
+    }
+    
+    BigNum & BigNum::modExpInPlace( const BigNum & exponent, const BigNum & modulus )
+    {
+        Context ctx;
+        
+        if( BN_mod_exp( this->impl->_bn, this->impl->_bn, exponent.impl->_bn, modulus.impl->_bn, ctx ) != 1 )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    BigNum & BigNum::modAddInPlace( const BigNum & add, const BigNum & modulus )
+    {
+        Context ctx;
+        
+        if( BN_mod_add( this->impl->_bn, this->impl->_bn, add.impl->_bn, modulus.impl->_bn, ctx ) != 1 )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    BigNum & BigNum::modSubInPlace( const BigNum & sub, const BigNum & modulus )
+    {
+        Context ctx;
+        
+        if( BN_mod_sub( this->impl->_bn, this->impl->_bn, sub.impl->_bn, modulus.impl->_bn, ctx ) != 1 )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
+    BigNum & BigNum::modMulInPlace( const BigNum & multiplier, const BigNum & modulus )
+    {
+        Context ctx;
+        
+        if( BN_mod_mul( this->impl->_bn, this->impl->_bn, multiplier.impl->_bn, modulus.impl->_bn, ctx ) != 1 )
+        {
+            throw std::runtime_error( "Cannot compute BigNum value" );
+        }
+        
+        return *( this );
+    }
+    
     std::string BigNum::string( StringFormat format ) const
     {
         BigNum abs = this->positive();
@@ -421,6 +611,11 @@ namespace SRP
         return bytes;
     }
     
+    bool BigNum::bytes( uint8_t * output, size_t length ) const
+    {
+        return BN_bn2bin_padded( output, length, this->impl->_bn ) == 1;
+    }
+    
     BigNum BigNum::negative() const
     {
         BigNum n = *( this );
@@ -445,6 +640,18 @@ namespace SRP
         return n;
     }
             
+    BigNum & BigNum::makeSecret()
+    {
+        this->impl->_secret = true;
+        
+        return *( this );
+    }
+    
+    bool BigNum::isSecret() const
+    {
+        return this->impl->_secret;
+    }
+    
     bool BigNum::isNegative() const
     {
         return BN_is_negative( this->impl->_bn ) == 1;
@@ -473,8 +680,14 @@ namespace SRP
     }
     
     BigNum::IMPL::IMPL( BIGNUM * bn ):
-        _bn( bn )
-    {}
+        _bn( bn ),
+        _secret( false )
+    {
+        if( bn == nullptr )
+        {
+            throw std::runtime_error( "Cannot create BigNum value" );
+        }
+    }
     
     BigNum::IMPL::IMPL( const std::vector< uint8_t > & bytes, Endianness endianness ):
         IMPL( BN_new() )
@@ -485,11 +698,14 @@ namespace SRP
         }
         else if( endianness == Endianness::BigEndian || ( endianness == Endianness::Auto && Platform::isBigEndian() ) )
         {
-            BN_bin2bn( bytes.data(), bytes.size(), this->_bn );
+            if( BN_bin2bn( bytes.data(), bytes.size(), this->_bn ) == nullptr )
+            {
+                throw std::runtime_error( "Cannot create BigNum value" );
+            }
         }
-        else
+        else if( BN_lebin2bn( bytes.data(), bytes.size(), this->_bn ) == nullptr )
         {
-            BN_lebin2bn( bytes.data(), bytes.size(), this->_bn );
+            throw std::runtime_error( "Cannot create BigNum value" );
         }
     }
     
@@ -516,11 +732,48 @@ namespace SRP
     
     BigNum::IMPL::IMPL( const BigNum & o ):
         IMPL( BN_dup( o.impl->_bn ) )
-    {}
+    {
+        this->_secret = o.impl->_secret;
+    }
     
     BigNum::IMPL::~IMPL()
     {
-        BN_free( this->_bn );
+        if( this->_secret )
+        {
+            BN_clear_free( this->_bn );
+        }
+        else
+        {
+            BN_free( this->_bn );
+        }
+    }
+    
+    void * BigNum::IMPL::operator new( size_t size )
+    {
+        /* Remembers the allocator, as the current one may change before the value is released */
+        Allocator & allocator = Allocator::current();
+        void      * p         = allocator.allocate( size + alignof( std::max_align_t ) );
+        
+        if( p == nullptr )
+        {
+            throw std::bad_alloc();
+        }
+        
+        *( static_cast< Allocator ** >( p ) ) = &allocator;
+        
+        return static_cast< uint8_t * >( p ) + alignof( std::max_align_t );
+    }
+    
+    void BigNum::IMPL::operator delete( void * p )
+    {
+        if( p == nullptr )
+        {
+            return;
+        }
+        
+        void * block = static_cast< uint8_t * >( p ) - alignof( std::max_align_t );
+        
+        ( *( static_cast< Allocator ** >( block ) ) )->deallocate( block );
     }
     
     BigNum::Context::Context():
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_BIG_NUM_IMPL_HPP
+#define SRPXX_BIG_NUM_IMPL_HPP
+
+#include <SRPXX/BigNum.hpp>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/ssl.h>
+#include <openssl/bn.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    class BigNum::IMPL
+    {
+        public:
+            
+            IMPL( BIGNUM * bn );
+            IMPL( const std::vector< uint8_t > & bytes, Endianness endianness );
+            IMPL( int64_t value );
+            IMPL( const BigNum & o );
+            ~IMPL();
+            
+            /* Allocated through SRP::Allocator */
+            static void * operator new( size_t size );
+            static void   operator delete( void * p );
+            
+            BIGNUM * _bn;
+            bool     _secret;
+    };
+    
+    class BigNum::Context
+    {
+        public:
+            
+            Context();
+            ~Context();
+            
+            Context( const Context & o ) = delete;
+            Context & operator =( const Context & o ) = delete;
+            
+            operator BN_CTX * () const;
+            
+        private:
+            
+            BN_CTX * _ctx;
+    };
+}
+
+#endif /* SRPXX_BIG_NUM_IMPL_HPP */
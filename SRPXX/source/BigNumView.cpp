@@ -0,0 +1,181 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/Allocator.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include "BigNumIMPL.hpp"
+
+namespace SRP
+{
+    BigNumView::BigNumView():
+        BigNumView( nullptr, 0 )
+    {}
+    
+    BigNumView::BigNumView( const uint8_t * data, size_t length ):
+        _data( data ),
+        _size( ( data == nullptr ) ? 0 : length )
+    {
+        /* Leading zeroes do not change the value - skip them once, so comparisons can work on the significant bytes only */
+        while( this->_size > 0 && this->_data[ 0 ] == 0 )
+        {
+            this->_data++;
+            this->_size--;
+        }
+    }
+    
+    BigNumView::BigNumView( const std::vector< uint8_t > & data ):
+        BigNumView( data.data(), data.size() )
+    {}
+    
+    const uint8_t * BigNumView::data() const
+    {
+        return this->_data;
+    }
+    
+    size_t BigNumView::size() const
+    {
+        return this->_size;
+    }
+    
+    bool BigNumView::isZero() const
+    {
+        return this->_size == 0;
+    }
+    
+    int BigNumView::compare( const BigNum & o ) const
+    {
+        if( BN_is_negative( o.impl->_bn ) )
+        {
+            return 1;
+        }
+        
+        size_t size = static_cast< size_t >( BN_num_bytes( o.impl->_bn ) );
+        
+        if( this->_size != size )
+        {
+            return ( this->_size < size ) ? -1 : 1;
+        }
+        
+        if( size == 0 )
+        {
+            return 0;
+        }
+        
+        /* Large enough for the 8192-bit group - larger values fall back to the heap */
+        std::array< uint8_t, 1024 > stack;
+        Vector< uint8_t >           heap;
+        uint8_t                   * bytes = stack.data();
+        
+        if( size > stack.size() )
+        {
+            heap.resize( size );
+            
+            bytes = heap.data();
+        }
+        
+        BN_bn2bin( o.impl->_bn, bytes );
+        
+        int r = memcmp( this->_data, bytes, size );
+        
+        return ( r < 0 ) ? -1 : ( ( r > 0 ) ? 1 : 0 );
+    }
+    
+    bool BigNumView::isValidModulo( const BigNum & modulus ) const
+    {
+        if( BN_is_zero( modulus.impl->_bn ) || BN_is_negative( modulus.impl->_bn ) )
+        {
+            return false;
+        }
+        
+        /* Common case: wire values are already reduced, so the check is a plain comparison */
+        if( this->compare( modulus ) < 0 )
+        {
+            return this->isZero() == false;
+        }
+        
+        BigNum::Context ctx;
+        
+        BN_CTX_start( ctx );
+        
+        BIGNUM * value = BN_CTX_get( ctx );
+        BIGNUM * rem   = BN_CTX_get( ctx );
+        bool     valid = false;
+        
+        if
+        (
+               rem != nullptr
+            && BN_bin2bn( this->_data, this->_size, value ) != nullptr
+            && BN_nnmod( rem, value, modulus.impl->_bn, ctx ) == 1
+        )
+        {
+            valid = BN_is_zero( rem ) == 0;
+        }
+        
+        BN_CTX_end( ctx );
+        
+        return valid;
+    }
+    
+    BigNum BigNumView::modExp( const BigNum & exponent, const BigNum & modulus ) const
+    {
+        BigNum::Context ctx;
+        BigNum          n;
+        
+        BN_CTX_start( ctx );
+        
+        BIGNUM * base = BN_CTX_get( ctx );
+        int      r    = 0;
+        
+        if( base != nullptr && BN_bin2bn( this->_data, this->_size, base ) != nullptr )
+        {
+            if( BN_is_odd( modulus.impl->_bn ) )
+            {
+                /* The base is converted straight into Montgomery form by BN_mod_exp_mont */
+                r = BN_mod_exp_mont( n.impl->_bn, base, exponent.impl->_bn, modulus.impl->_bn, ctx, nullptr );
+            }
+            else
+            {
+                r = BN_mod_exp( n.impl->_bn, base, exponent.impl->_bn, modulus.impl->_bn, ctx );
+            }
+        }
+        
+        BN_CTX_end( ctx );
+        
+        if( r != 1 )
+        {
+            throw std::runtime_error( "Cannot compute modular exponentiation" );
+        }
+        
+        return n;
+    }
+    
+    std::vector< uint8_t > BigNumView::bytes() const
+    {
+        return { this->_data, this->_data + this->_size };
+    }
+}
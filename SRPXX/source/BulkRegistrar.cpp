@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/BulkRegistrar.hpp>
+#include <SRPXX/Client.hpp>
+#include <SRPXX/FixedBase.hpp>
+#include <SRPXX/Random.hpp>
+#include <algorithm>
+#include <future>
+
+namespace SRP
+{
+    class BulkRegistrar::IMPL
+    {
+        public:
+            
+            IMPL( HashAlgorithm hashAlgorithm, Base::GroupType groupType, size_t saltLength, uint64_t options );
+            ~IMPL();
+            
+            Client makeClient() const;
+            
+            void generate( Client & client, const Credentials & credentials, const uint8_t * salt, Registration & registration ) const;
+            
+            HashAlgorithm                _hashAlgorithm;
+            Base::GroupType              _groupType;
+            size_t                       _saltLength;
+            uint64_t                     _options;
+            std::unique_ptr< FixedBase > _g;
+    };
+    
+    BulkRegistrar::BulkRegistrar( HashAlgorithm hashAlgorithm, Base::GroupType groupType, size_t saltLength, uint64_t options ):
+        impl( std::make_unique< IMPL >( hashAlgorithm, groupType, saltLength, options ) )
+    {}
+    
+    BulkRegistrar::~BulkRegistrar()
+    {}
+    
+    HashAlgorithm BulkRegistrar::hashAlgorithm() const
+    {
+        return this->impl->_hashAlgorithm;
+    }
+    
+    Base::GroupType BulkRegistrar::groupType() const
+    {
+        return this->impl->_groupType;
+    }
+    
+    size_t BulkRegistrar::saltLength() const
+    {
+        return this->impl->_saltLength;
+    }
+    
+    BulkRegistrar::Registration BulkRegistrar::generate( const Credentials & credentials ) const
+    {
+        Client                 client = this->impl->makeClient();
+        std::vector< uint8_t > salt   = Random::bytes( this->impl->_saltLength );
+        Registration           registration;
+        
+        this->impl->generate( client, credentials, salt.data(), registration );
+        
+        return registration;
+    }
+    
+    std::vector< BulkRegistrar::Registration > BulkRegistrar::generate( const std::vector< Credentials > & credentials, Engine & engine ) const
+    {
+        std::vector< Registration >        registrations( credentials.size() );
+        std::vector< uint8_t >             salts = Random::bytes( credentials.size() * this->impl->_saltLength );
+        std::vector< std::future< void > > futures;
+        
+        /* A few chunks per thread, so stealing evens out uneven passwords */
+        size_t chunks = std::min( credentials.size(), engine.threads() * 4 );
+        size_t length = ( chunks == 0 ) ? 0 : ( credentials.size() + chunks - 1 ) / chunks;
+        
+        for( size_t begin = 0; begin < credentials.size(); begin += length )
+        {
+            size_t end = std::min( begin + length, credentials.size() );
+            
+            futures.push_back
+            (
+                engine.submit
+                (
+                    [ this, &credentials, &registrations, &salts, begin, end ]
+                    {
+                        Client client = this->impl->makeClient();
+                        
+                        for( size_t i = begin; i < end; i++ )
+                        {
+                            this->impl->generate( client, credentials[ i ], salts.data() + ( i * this->impl->_saltLength ), registrations[ i ] );
+                        }
+                    }
+                )
+            );
+        }
+        
+        /* Every chunk must be done before returning, as they reference the local buffers */
+        for( auto & future: futures )
+        {
+            future.wait();
+        }
+        
+        for( auto & future: futures )
+        {
+            future.get();
+        }
+        
+        return registrations;
+    }
+    
+    BulkRegistrar::IMPL::IMPL( HashAlgorithm hashAlgorithm, Base::GroupType groupType, size_t saltLength, uint64_t options ):
+        _hashAlgorithm( hashAlgorithm ),
+        _groupType( groupType ),
+        _saltLength( saltLength ),
+        _options( options )
+    {
+        Client client = this->makeClient();
+        
+        /* x is a single hash output */
+        unsigned int bits = static_cast< unsigned int >( client.hash( std::vector< uint8_t >() ).size() * 8 );
+        
+        this->_g = std::make_unique< FixedBase >( client.g(), client.N(), bits );
+    }
+    
+    BulkRegistrar::IMPL::~IMPL()
+    {}
+    
+    Client BulkRegistrar::IMPL::makeClient() const
+    {
+        /* a is never used, so it does not need to be random */
+        Client client( "", this->_hashAlgorithm, this->_groupType, BigNum( 1 ) );
+        
+        client.setOptions( this->_options );
+        
+        return client;
+    }
+    
+    void BulkRegistrar::IMPL::generate( Client & client, const Credentials & credentials, const uint8_t * salt, Registration & registration ) const
+    {
+        client.reset( credentials.identity, BigNum( 1 ) );
+        client.setPassword( credentials.password );
+        client.setSalt( salt, this->_saltLength );
+        
+        registration.identity = credentials.identity;
+        registration.salt     = std::vector< uint8_t >( salt, salt + this->_saltLength );
+        registration.verifier = this->_g->modExp( client.x() ).bytes( BigNum::Endianness::BigEndian );
+        
+        client.clear();
+    }
+}
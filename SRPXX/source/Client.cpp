@@ -22,15 +22,8 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
-/* For memset_s */
-#define __STDC_WANT_LIB_EXT1__ 1
-
 #include <SRPXX/Client.hpp>
-#include <string.h>
-
-#ifdef _WIN32
-#include <Windows.h>
-#endif
+#include <SRPXX/SecureArena.hpp>
 
 namespace SRP
 {
@@ -41,12 +34,10 @@ namespace SRP
             IMPL( const BigNum & a );
             ~IMPL();
             
-            void clearPassword();
-            
-            BigNum                 _a;
-            BigNum                 _B;
-            std::vector< uint8_t > _password;
-            uint64_t               _options;
+            BigNum      _a;
+            BigNum      _B;
+            SecureBytes _password;
+            uint64_t    _options;
     };
     
     Client::Client( const std::string & identity, HashAlgorithm hashAlgorithm, GroupType groupType ):
@@ -61,6 +52,37 @@ namespace SRP
     Client::~Client()
     {}
     
+    Client::Client( Client && o ) noexcept = default;
+    
+    Client & Client::operator =( Client && o ) noexcept = default;
+    
+    void Client::reset( const std::string & identity )
+    {
+        this->clear();
+        this->Base::reset( identity );
+        
+        this->impl->_a.randomize( 256 );
+    }
+    
+    void Client::reset( const std::string & identity, const BigNum & a )
+    {
+        this->clear();
+        this->Base::reset( identity );
+        
+        this->impl->_a.assign( a );
+    }
+    
+    void Client::clear()
+    {
+        this->Base::clear();
+        
+        SecureArena::wipe( this->impl->_password.data(), this->impl->_password.size() );
+        
+        this->impl->_password.clear();
+        this->impl->_a.clear();
+        this->impl->_B.clear();
+    }
+    
     void Client::setPassword( const std::string & value )
     {
         this->setPassword( SRP::String::toBytes( value ) );
@@ -68,29 +90,41 @@ namespace SRP
     
     void Client::setPassword( const std::vector< uint8_t > & value )
     {
-        this->impl->clearPassword();
+        SecureArena::wipe( this->impl->_password.data(), this->impl->_password.size() );
         
-        this->impl->_password = value;
+        /* Re-uses the existing capacity - the arena wipes it when released */
+        this->impl->_password.assign( value.begin(), value.end() );
+        this->invalidateKeys();
     }
     
     void Client::setB( const BigNum & value )
     {
         this->impl->_B = value;
+        this->invalidateKeys();
+    }
+    
+    void Client::setB( const BigNumView & value )
+    {
+        this->impl->_B.assign( value );
+        this->invalidateKeys();
     }
     
     void Client::setOptions( uint64_t options )
     {
         this->impl->_options = options;
+        this->invalidateKeys();
     }
     
     void Client::addOption( Options option )
     {
         this->impl->_options |= static_cast< uint64_t >( option );
+        this->invalidateKeys();
     }
     
     void Client::removeOption( Options option )
     {
         this->impl->_options &= ~static_cast< uint64_t >( option );
+        this->invalidateKeys();
     }
     
     bool Client::hasOption( Options option ) const
@@ -101,7 +135,7 @@ namespace SRP
     /* ( g ^ a % N ) */
     BigNum Client::A() const
     {
-        return this->g().modExp( this->impl->_a, this->N() );
+        return this->gExp( this->impl->_a );
     }
     
     /* From server */
@@ -118,63 +152,79 @@ namespace SRP
     /* ( SHA( s | SHA( I | `:` | P ) ) ) */
     BigNum Client::x() const
     {
-        std::vector< std::vector< uint8_t > > data =
-        {
-            String::toBytes( this->identity() ),
-            String::toBytes( ":" ),
-            this->impl->_password
-        };
+        /* Hashed in place, so the password is never copied out of the secure arena */
+        std::unique_ptr< Hasher > hasher = this->makeHasher();
         
-        if( this->hasOption( Options::NoUsernameInX ) )
+        if( this->hasOption( Options::NoUsernameInX ) == false )
         {
-            data.erase( data.begin() );
+            hasher->update( this->identity() );
         }
         
-        std::vector< uint8_t > hash = this->hash
-        (
-            {
-                this->salt(),
-                this->hash( data )
-            }
-        );
+        hasher->update( ":" );
+        hasher->update( this->impl->_password.data(), this->impl->_password.size() );
+        hasher->finalize();
+        
+        /* H( I:P ) and x are as good as the password, so both are wiped */
+        std::vector< uint8_t >    inner = hasher->bytes();
+        std::unique_ptr< Hasher > outer = this->makeHasher();
+        
+        outer->update( this->salt() );
+        outer->update( inner );
+        outer->finalize();
         
-        return { hash, BigNum::Endianness::BigEndian };
+        std::vector< uint8_t > hash = outer->bytes();
+        BigNum                 x( hash, BigNum::Endianness::BigEndian );
+        
+        SecureArena::wipe( inner.data(), inner.size() );
+        SecureArena::wipe( hash.data(),  hash.size() );
+        
+        return x.makeSecret();
     }
     
     /* g ^ x % N */
     BigNum Client::v() const
     {
-        return this->g().modExp( this->x(), this->N() );
+        return this->gExp( this->x() );
     }
     
     /* ( ( B - ( k * g ^ x ) ) ^ ( a + ( u * x ) ) % N ) */
     BigNum Client::S() const
     {
-        BigNum left  = this->B() - ( this->k() * this->g().modExp( this->x(), this->N() ) );
-        BigNum right = this->a() + ( this->u() * this->x() );
-
-        return left.modExp( right, this->N() );
+        BigNum N     = this->N();
+        BigNum x     = this->x();
+        BigNum left  = BigNum::modSubMulExp( this->B(), this->k(), this->g(), x, N );
+        BigNum right = this->u();
+        
+        right *= x;
+        right += this->a();
+        
+        left.makeSecret().modExpInPlace( right, N );
+        
+        return left;
     }
     
-    Client::IMPL::IMPL( const BigNum & a ):
-        _a( a ),
-        _options( 0 )
-    {}
+    #ifdef SRPXX_COROUTINES
     
-    Client::IMPL::~IMPL()
+    Awaitable< BigNum > Client::computeA( Executor & executor ) const
     {
-        this->clearPassword();
+        return { [ this ] { return this->A(); }, executor };
     }
     
-    void Client::IMPL::clearPassword()
+    Awaitable< std::vector< uint8_t > > Client::computeM1( Executor & executor ) const
     {
-        if( this->_password.size() > 0 )
-        {
-            #ifdef _WIN32
-            SecureZeroMemory( this->_password.data(), this->_password.size() );
-            #else
-            memset_s( this->_password.data(), this->_password.size(), 0, this->_password.size() );
-            #endif
-        }
+        return { [ this ] { return this->M1( this->K( this->S() ) ); }, executor };
     }
+    
+    #endif
+    
+    Client::IMPL::IMPL( const BigNum & a ):
+        _a( a ),
+        _password( SecureArena::shared() ),
+        _options( 0 )
+    {
+        this->_a.makeSecret();
+    }
+    
+    Client::IMPL::~IMPL()
+    {}
 }
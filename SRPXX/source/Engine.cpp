@@ -0,0 +1,448 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/Engine.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace SRP
+{
+    namespace
+    {
+        /* Bounded multi-producer / multi-consumer queue - D. Vyukov */
+        class SubmissionQueue
+        {
+            public:
+                
+                SubmissionQueue( size_t capacity ):
+                    _cells( std::make_unique< Cell[] >( capacity ) ),
+                    _mask( capacity - 1 ),
+                    _enqueue( 0 ),
+                    _dequeue( 0 )
+                {
+                    for( size_t i = 0; i < capacity; i++ )
+                    {
+                        this->_cells[ i ].sequence.store( i, std::memory_order_relaxed );
+                    }
+                }
+                
+                bool push( Engine::Task & task )
+                {
+                    Cell * cell = nullptr;
+                    size_t pos  = this->_enqueue.load( std::memory_order_relaxed );
+                    
+                    while( true )
+                    {
+                        cell = &( this->_cells[ pos & this->_mask ] );
+                        
+                        size_t   seq = cell->sequence.load( std::memory_order_acquire );
+                        intptr_t dif = static_cast< intptr_t >( seq ) - static_cast< intptr_t >( pos );
+                        
+                        if( dif == 0 )
+                        {
+                            if( this->_enqueue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                            {
+                                break;
+                            }
+                        }
+                        else if( dif < 0 )
+                        {
+                            return false;
+                        }
+                        else
+                        {
+                            pos = this->_enqueue.load( std::memory_order_relaxed );
+                        }
+                    }
+                    
+                    cell->task = std::move( task );
+                    
+                    cell->sequence.store( pos + 1, std::memory_order_release );
+                    
+                    return true;
+                }
+                
+                bool pop( Engine::Task & task )
+                {
+                    Cell * cell = nullptr;
+                    size_t pos  = this->_dequeue.load( std::memory_order_relaxed );
+                    
+                    while( true )
+                    {
+                        cell = &( this->_cells[ pos & this->_mask ] );
+                        
+                        size_t   seq = cell->sequence.load( std::memory_order_acquire );
+                        intptr_t dif = static_cast< intptr_t >( seq ) - static_cast< intptr_t >( pos + 1 );
+                        
+                        if( dif == 0 )
+                        {
+                            if( this->_dequeue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                            {
+                                break;
+                            }
+                        }
+                        else if( dif < 0 )
+                        {
+                            return false;
+                        }
+                        else
+                        {
+                            pos = this->_dequeue.load( std::memory_order_relaxed );
+                        }
+                    }
+                    
+                    task       = std::move( cell->task );
+                    cell->task = nullptr;
+                    
+                    cell->sequence.store( pos + this->_mask + 1, std::memory_order_release );
+                    
+                    return true;
+                }
+                
+            private:
+                
+                struct Cell
+                {
+                    std::atomic< size_t > sequence;
+                    Engine::Task          task;
+                };
+                
+                std::unique_ptr< Cell[] > _cells;
+                size_t                    _mask;
+                
+                alignas( 64 ) std::atomic< size_t > _enqueue;
+                alignas( 64 ) std::atomic< size_t > _dequeue;
+        };
+        
+        struct Worker
+        {
+            std::mutex                 mutex;
+            std::deque< Engine::Task > tasks;
+            std::thread                thread;
+        };
+        
+        template< typename T, typename F >
+        Engine::Task makeTask( F f, Engine::Completion< T > completion )
+        {
+            return [ f = std::move( f ), completion = std::move( completion ) ]
+            {
+                T result;
+                
+                try
+                {
+                    result = f();
+                }
+                catch( ... )
+                {
+                    completion( T(), std::current_exception() );
+                    
+                    return;
+                }
+                
+                completion( std::move( result ), nullptr );
+            };
+        }
+        
+        Engine::Keys computeKeys( Base & session )
+        {
+            Engine::Keys keys;
+            
+            keys.S  = session.S();
+            keys.K  = session.K( keys.S );
+            keys.M1 = session.M1( keys.K );
+            
+            return keys;
+        }
+    }
+    
+    class Engine::IMPL
+    {
+        public:
+            
+            IMPL( size_t threads, bool pinThreads );
+            ~IMPL();
+            
+            void run( size_t index );
+            bool take( size_t index, Task & task );
+            void push( Task task );
+            void pin( std::thread & thread, size_t index );
+            
+            static thread_local IMPL * currentEngine;
+            static thread_local size_t currentWorker;
+            
+            std::vector< std::unique_ptr< Worker > > _workers;
+            SubmissionQueue                          _queue;
+            std::atomic< size_t >                    _next;
+            std::atomic< size_t >                    _pending;
+            std::atomic< size_t >                    _sleeping;
+            std::atomic< bool >                      _stop;
+            std::mutex                               _mutex;
+            std::condition_variable                  _condition;
+    };
+    
+    thread_local Engine::IMPL * Engine::IMPL::currentEngine = nullptr;
+    thread_local size_t         Engine::IMPL::currentWorker = 0;
+    
+    Engine::Engine( size_t threads, bool pinThreads ):
+        impl( std::make_unique< IMPL >( threads, pinThreads ) )
+    {}
+    
+    Engine::~Engine()
+    {}
+    
+    size_t Engine::threads() const
+    {
+        return this->impl->_workers.size();
+    }
+    
+    void Engine::post( Task task )
+    {
+        this->impl->push( std::move( task ) );
+    }
+    
+    std::future< BigNum > Engine::B( Server & server )
+    {
+        return this->submit( [ &server ] { return server.B(); } );
+    }
+    
+    void Engine::B( Server & server, Completion< BigNum > completion )
+    {
+        this->post( makeTask< BigNum >( [ &server ] { return server.B(); }, std::move( completion ) ) );
+    }
+    
+    std::future< Engine::Keys > Engine::keys( Base & session )
+    {
+        return this->submit( [ &session ] { return computeKeys( session ); } );
+    }
+    
+    void Engine::keys( Base & session, Completion< Keys > completion )
+    {
+        this->post( makeTask< Keys >( [ &session ] { return computeKeys( session ); }, std::move( completion ) ) );
+    }
+    
+    std::future< std::vector< uint8_t > > Engine::verify( Server & server, const std::vector< uint8_t > & M1 )
+    {
+        return this->submit( [ &server, M1 ] { return server.verifyM1( M1 ); } );
+    }
+    
+    void Engine::verify( Server & server, const std::vector< uint8_t > & M1, Completion< std::vector< uint8_t > > completion )
+    {
+        this->post( makeTask< std::vector< uint8_t > >( [ &server, M1 ] { return server.verifyM1( M1 ); }, std::move( completion ) ) );
+    }
+    
+    Engine::IMPL::IMPL( size_t threads, bool pinThreads ):
+        _queue( 4096 ),
+        _next( 0 ),
+        _pending( 0 ),
+        _sleeping( 0 ),
+        _stop( false )
+    {
+        if( threads == 0 )
+        {
+            threads = std::max< size_t >( std::thread::hardware_concurrency(), 1 );
+        }
+        
+        for( size_t i = 0; i < threads; i++ )
+        {
+            this->_workers.push_back( std::make_unique< Worker >() );
+        }
+        
+        /* Only started once every deque exists, as workers steal from each other */
+        for( size_t i = 0; i < threads; i++ )
+        {
+            this->_workers[ i ]->thread = std::thread( [ this, i ] { this->run( i ); } );
+            
+            if( pinThreads )
+            {
+                this->pin( this->_workers[ i ]->thread, i );
+            }
+        }
+    }
+    
+    Engine::IMPL::~IMPL()
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_mutex );
+            
+            this->_stop = true;
+        }
+        
+        this->_condition.notify_all();
+        
+        for( const auto & worker: this->_workers )
+        {
+            worker->thread.join();
+        }
+    }
+    
+    void Engine::IMPL::run( size_t index )
+    {
+        currentEngine = this;
+        currentWorker = index;
+        
+        while( true )
+        {
+            Task task;
+            
+            if( this->take( index, task ) )
+            {
+                this->_pending--;
+                
+                try
+                {
+                    task();
+                }
+                catch( ... )
+                {}
+                
+                continue;
+            }
+            
+            std::unique_lock< std::mutex > l( this->_mutex );
+            
+            /* Remaining tasks are completed before stopping */
+            if( this->_stop && this->_pending == 0 )
+            {
+                break;
+            }
+            
+            this->_sleeping++;
+            this->_condition.wait( l, [ this ] { return this->_stop || this->_pending > 0; } );
+            this->_sleeping--;
+            
+            if( this->_pending > 0 )
+            {
+                /* Submitted but not visible yet */
+                l.unlock();
+                std::this_thread::yield();
+            }
+        }
+        
+        currentEngine = nullptr;
+    }
+    
+    bool Engine::IMPL::take( size_t index, Task & task )
+    {
+        {
+            Worker                      & worker = *( this->_workers[ index ] );
+            std::lock_guard< std::mutex > l( worker.mutex );
+            
+            if( worker.tasks.empty() == false )
+            {
+                task = std::move( worker.tasks.back() );
+                
+                worker.tasks.pop_back();
+                
+                return true;
+            }
+        }
+        
+        if( this->_queue.pop( task ) )
+        {
+            return true;
+        }
+        
+        for( size_t i = 1; i < this->_workers.size(); i++ )
+        {
+            Worker                      & victim = *( this->_workers[ ( index + i ) % this->_workers.size() ] );
+            std::lock_guard< std::mutex > l( victim.mutex );
+            
+            if( victim.tasks.empty() == false )
+            {
+                task = std::move( victim.tasks.front() );
+                
+                victim.tasks.pop_front();
+                
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    void Engine::IMPL::push( Task task )
+    {
+        /* Counted first, so a worker never sees a task it cannot account for */
+        this->_pending++;
+        
+        if( currentEngine == this )
+        {
+            Worker                      & worker = *( this->_workers[ currentWorker ] );
+            std::lock_guard< std::mutex > l( worker.mutex );
+            
+            worker.tasks.push_back( std::move( task ) );
+        }
+        else if( this->_queue.push( task ) == false )
+        {
+            Worker                      & worker = *( this->_workers[ this->_next++ % this->_workers.size() ] );
+            std::lock_guard< std::mutex > l( worker.mutex );
+            
+            worker.tasks.push_back( std::move( task ) );
+        }
+        
+        if( this->_sleeping > 0 )
+        {
+            std::lock_guard< std::mutex > l( this->_mutex );
+            
+            this->_condition.notify_one();
+        }
+    }
+    
+    void Engine::IMPL::pin( std::thread & thread, size_t index )
+    {
+        size_t cpus = std::max< size_t >( std::thread::hardware_concurrency(), 1 );
+        
+        #ifdef _WIN32
+        
+        SetThreadAffinityMask( thread.native_handle(), static_cast< DWORD_PTR >( 1 ) << ( index % std::min< size_t >( cpus, sizeof( DWORD_PTR ) * 8 ) ) );
+        
+        #elif defined( __linux__ )
+        
+        cpu_set_t set;
+        
+        CPU_ZERO( &set );
+        CPU_SET( index % cpus, &set );
+        pthread_setaffinity_np( thread.native_handle(), sizeof( set ), &set );
+        
+        #else
+        
+        /* No hard affinity on this platform */
+        ( void )thread;
+        ( void )index;
+        ( void )cpus;
+        
+        #endif
+    }
+}
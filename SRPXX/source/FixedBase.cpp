@@ -0,0 +1,306 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/FixedBase.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include "BigNumIMPL.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace SRP
+{
+    class FixedBase::IMPL
+    {
+        public:
+            
+            IMPL( const BigNum & modulus, unsigned int exponentBits, unsigned int window );
+            ~IMPL();
+            
+            void build( const BigNum & base, const BigNum & modulus );
+            void attach( const BigNum & base, const BigNum & modulus, const uint8_t * table, size_t length );
+            void release();
+            
+            size_t digit( const BIGNUM * exponent, size_t row ) const;
+            
+            /* Copies an entry of the table, reading every entry of the row */
+            void select( size_t row, size_t digit, uint8_t * entry ) const;
+            
+            BigNum modExp( const BIGNUM * exponent ) const;
+            
+            unsigned int           _exponentBits;
+            unsigned int           _window;
+            size_t                 _rows;
+            size_t                 _entries;
+            size_t                 _width;
+            BN_MONT_CTX          * _mont;
+            std::vector< uint8_t > _built;
+            const uint8_t        * _table;
+    };
+    
+    FixedBase::FixedBase( const BigNum & base, const BigNum & modulus, unsigned int exponentBits, unsigned int window ):
+        impl( std::make_unique< IMPL >( modulus, exponentBits, window ) )
+    {
+        this->impl->build( base, modulus );
+    }
+    
+    FixedBase::FixedBase( const BigNum & base, const BigNum & modulus, unsigned int exponentBits, unsigned int window, const uint8_t * table, size_t length ):
+        impl( std::make_unique< IMPL >( modulus, exponentBits, window ) )
+    {
+        this->impl->attach( base, modulus, table, length );
+    }
+    
+    FixedBase::~FixedBase()
+    {}
+    
+    unsigned int FixedBase::exponentBits() const
+    {
+        return this->impl->_exponentBits;
+    }
+    
+    bool FixedBase::covers( const BigNum & exponent ) const
+    {
+        const BIGNUM * e = exponent.impl->_bn;
+        
+        return BN_is_negative( e ) == 0 && static_cast< unsigned int >( BN_num_bits( e ) ) <= this->impl->_exponentBits;
+    }
+    
+    size_t FixedBase::memory() const
+    {
+        return this->impl->_rows * this->impl->_entries * this->impl->_width;
+    }
+    
+    BigNum FixedBase::modExp( const BigNum & exponent ) const
+    {
+        const BIGNUM * e = exponent.impl->_bn;
+        
+        if( this->covers( exponent ) == false )
+        {
+            throw std::runtime_error( "Exponent is out of range for the fixed-base table" );
+        }
+        
+        return this->impl->modExp( e );
+    }
+    
+    std::vector< uint8_t > FixedBase::table() const
+    {
+        return std::vector< uint8_t >( this->impl->_table, this->impl->_table + this->memory() );
+    }
+    
+    FixedBase::IMPL::IMPL( const BigNum & modulus, unsigned int exponentBits, unsigned int window ):
+        _exponentBits( exponentBits ),
+        _window( window ),
+        _rows( ( exponentBits + window - 1 ) / ( ( window == 0 ) ? 1 : window ) ),
+        _entries( static_cast< size_t >( 1 ) << window ),
+        _width( static_cast< size_t >( BN_num_bytes( modulus.impl->_bn ) ) ),
+        _mont( nullptr ),
+        _table( nullptr )
+    {
+        if( window == 0 || window > 8 || exponentBits == 0 )
+        {
+            throw std::runtime_error( "Invalid fixed-base table parameters" );
+        }
+        
+        if( BN_is_odd( modulus.impl->_bn ) == 0 )
+        {
+            throw std::runtime_error( "Fixed-base tables require an odd modulus" );
+        }
+        
+        BigNum::Context ctx;
+        
+        this->_mont = BN_MONT_CTX_new();
+        
+        if( this->_mont == nullptr || BN_MONT_CTX_set( this->_mont, modulus.impl->_bn, ctx ) != 1 )
+        {
+            this->release();
+            
+            throw std::runtime_error( "Cannot compute fixed-base table" );
+        }
+    }
+    
+    void FixedBase::IMPL::build( const BigNum & base, const BigNum & modulus )
+    {
+        BigNum::Context ctx;
+        
+        BN_CTX_start( ctx );
+        
+        /* base ^ ( 2 ^ ( window * row ) ), in Montgomery form */
+        BIGNUM * power = BN_CTX_get( ctx );
+        BIGNUM * entry = BN_CTX_get( ctx );
+        bool     r     = entry != nullptr
+                      && BN_nnmod( power, base.impl->_bn, modulus.impl->_bn, ctx ) == 1
+                      && BN_to_montgomery( power, power, this->_mont, ctx ) == 1;
+        
+        /* Stored in the exported layout, so entries are selected the same way as in a mapped table */
+        this->_built.resize( this->_rows * this->_entries * this->_width );
+        
+        uint8_t * p = this->_built.data();
+        
+        for( size_t row = 0; r && row < this->_rows; row++ )
+        {
+            for( size_t i = 0; r && i < this->_entries; i++, p += this->_width )
+            {
+                if( i == 0 )
+                {
+                    r = BN_to_montgomery( entry, BN_value_one(), this->_mont, ctx ) == 1;
+                }
+                else
+                {
+                    r = BN_mod_mul_montgomery( entry, entry, power, this->_mont, ctx ) == 1;
+                }
+                
+                r = r && BN_bn2le_padded( p, this->_width, entry ) == 1;
+            }
+            
+            r = r && BN_mod_mul_montgomery( power, entry, power, this->_mont, ctx ) == 1;
+        }
+        
+        BN_CTX_end( ctx );
+        
+        if( r == false )
+        {
+            this->release();
+            
+            throw std::runtime_error( "Cannot compute fixed-base table" );
+        }
+        
+        this->_table = this->_built.data();
+    }
+    
+    void FixedBase::IMPL::attach( const BigNum & base, const BigNum & modulus, const uint8_t * table, size_t length )
+    {
+        if( table == nullptr || length != this->_rows * this->_entries * this->_width )
+        {
+            this->release();
+            
+            throw std::runtime_error( "Invalid fixed-base table size" );
+        }
+        
+        BigNum::Context        ctx;
+        std::vector< uint8_t > expected( this->_width * 2 );
+        
+        BN_CTX_start( ctx );
+        
+        /* The first entries are 1 and the base - Checks the Montgomery constant R as well */
+        BIGNUM * one   = BN_CTX_get( ctx );
+        BIGNUM * power = BN_CTX_get( ctx );
+        bool     r     = power != nullptr
+                      && BN_to_montgomery( one, BN_value_one(), this->_mont, ctx ) == 1
+                      && BN_nnmod( power, base.impl->_bn, modulus.impl->_bn, ctx ) == 1
+                      && BN_to_montgomery( power, power, this->_mont, ctx ) == 1
+                      && BN_bn2le_padded( expected.data(), this->_width, one ) == 1
+                      && BN_bn2le_padded( expected.data() + this->_width, this->_width, power ) == 1;
+        
+        BN_CTX_end( ctx );
+        
+        if( r == false || memcmp( expected.data(), table, expected.size() ) != 0 )
+        {
+            this->release();
+            
+            throw std::runtime_error( "Fixed-base table does not match its base and modulus" );
+        }
+        
+        this->_table = table;
+    }
+    
+    FixedBase::IMPL::~IMPL()
+    {
+        this->release();
+    }
+    
+    void FixedBase::IMPL::release()
+    {
+        BN_MONT_CTX_free( this->_mont );
+        
+        this->_built.clear();
+        
+        this->_mont  = nullptr;
+        this->_table = nullptr;
+    }
+    
+    size_t FixedBase::IMPL::digit( const BIGNUM * exponent, size_t row ) const
+    {
+        size_t digit = 0;
+        
+        for( unsigned int i = 0; i < this->_window; i++ )
+        {
+            digit |= static_cast< size_t >( BN_is_bit_set( exponent, static_cast< int >( ( row * this->_window ) + i ) ) ) << i;
+        }
+        
+        return digit;
+    }
+    
+    void FixedBase::IMPL::select( size_t row, size_t digit, uint8_t * entry ) const
+    {
+        const uint8_t * p = this->_table + ( row * this->_entries * this->_width );
+        
+        memset( entry, 0, this->_width );
+        
+        for( size_t i = 0; i < this->_entries; i++, p += this->_width )
+        {
+            /* 0xFF for the selected entry, 0 otherwise, without branching on the digit */
+            uint8_t mask = static_cast< uint8_t >( ( ( ( i ^ digit ) | ( 0 - ( i ^ digit ) ) ) >> ( ( sizeof( size_t ) * 8 ) - 1 ) ) - 1 );
+            
+            for( size_t j = 0; j < this->_width; j++ )
+            {
+                entry[ j ] |= p[ j ] & mask;
+            }
+        }
+    }
+    
+    BigNum FixedBase::IMPL::modExp( const BIGNUM * exponent ) const
+    {
+        BigNum::Context        ctx;
+        BigNum                 n;
+        std::vector< uint8_t > entry( this->_width );
+        
+        BN_CTX_start( ctx );
+        
+        BIGNUM * acc  = BN_CTX_get( ctx );
+        BIGNUM * next = BN_CTX_get( ctx );
+        bool     r    = next != nullptr;
+        
+        for( size_t row = 0; r && row < this->_rows; row++ )
+        {
+            this->select( row, this->digit( exponent, row ), entry.data() );
+            
+            r = BN_lebin2bn( entry.data(), this->_width, ( row == 0 ) ? acc : next ) != nullptr;
+            r = r && ( row == 0 || BN_mod_mul_montgomery( acc, acc, next, this->_mont, ctx ) == 1 );
+        }
+        
+        r = r && BN_from_montgomery( n.impl->_bn, acc, this->_mont, ctx ) == 1;
+        
+        BN_CTX_end( ctx );
+        
+        /* Entries reveal digits of the exponent */
+        SecureArena::wipe( entry.data(), entry.size() );
+        
+        if( r == false )
+        {
+            throw std::runtime_error( "Cannot compute modular exponentiation" );
+        }
+        
+        return n;
+    }
+}
@@ -0,0 +1,510 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/GroupTables.hpp>
+#include <SRPXX/Client.hpp>
+#include <SRPXX/SHA1.hpp>
+#include <SRPXX/SHA224.hpp>
+#include <SRPXX/SHA256.hpp>
+#include <SRPXX/SHA384.hpp>
+#include <SRPXX/SHA512.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * File layout, all integers little-endian:
+ * 
+ *   Header (64 bytes):         magic[ 8 ], version u32, group count u32, exponent bits u32, window u32,
+ *                              file size u64, SHA-256 of everything after the header[ 32 ]
+ *   Directory (16 bytes each): group type u32, N length u32, record offset u64
+ *   Records (64 aligned):      N, g padded to N - Both big-endian
+ *                              k, H( N ) xor H( g ) - For each hash algorithm, in enum order
+ *                              g table, 64 aligned - See FixedBase::table()
+ */
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr uint8_t magic[ 8 ]     = { 'S', 'R', 'P', 'X', 'X', 'G', 'R', 'T' };
+        constexpr size_t  headerSize     = 64;
+        constexpr size_t  directorySize  = 16;
+        constexpr size_t  groupCount     = static_cast< size_t >( Base::GroupType::NG8192 ) + 1;
+        constexpr size_t  hashCount      = static_cast< size_t >( HashAlgorithm::SHA512 ) + 1;
+        
+        std::mutex                           installedLock;
+        std::shared_ptr< const GroupTables > installedTables;
+        
+        uint64_t loadLE( const uint8_t * p, size_t size )
+        {
+            uint64_t value = 0;
+            
+            for( size_t i = 0; i < size; i++ )
+            {
+                value |= static_cast< uint64_t >( p[ i ] ) << ( i * 8 );
+            }
+            
+            return value;
+        }
+        
+        void storeLE( uint8_t * p, uint64_t value, size_t size )
+        {
+            for( size_t i = 0; i < size; i++ )
+            {
+                p[ i ] = static_cast< uint8_t >( value >> ( i * 8 ) );
+            }
+        }
+        
+        size_t align( size_t value )
+        {
+            return ( value + 63 ) & ~static_cast< size_t >( 63 );
+        }
+        
+        size_t digestSize( HashAlgorithm hashAlgorithm )
+        {
+            switch( hashAlgorithm )
+            {
+                case HashAlgorithm::SHA1:   return SHA1::digestSize;
+                case HashAlgorithm::SHA224: return SHA224::digestSize;
+                case HashAlgorithm::SHA256: return SHA256::digestSize;
+                case HashAlgorithm::SHA384: return SHA384::digestSize;
+                case HashAlgorithm::SHA512: return SHA512::digestSize;
+            }
+            
+            throw std::runtime_error( "Unknown hash algorithm" );
+        }
+        
+        /* N, g, k and H( N ) xor H( g ) */
+        size_t valuesSize( size_t width )
+        {
+            size_t size = 2 * width;
+            
+            for( size_t i = 0; i < hashCount; i++ )
+            {
+                size += 2 * digestSize( static_cast< HashAlgorithm >( i ) );
+            }
+            
+            return size;
+        }
+        
+        size_t tableSize( size_t width, unsigned int exponentBits, unsigned int window )
+        {
+            return ( ( exponentBits + window - 1 ) / window ) * ( static_cast< size_t >( 1 ) << window ) * width;
+        }
+        
+        /* N, padded g, then k and H( N ) xor H( g ) for each hash algorithm - Computed from the built-in group */
+        std::vector< uint8_t > groupValues( Base::GroupType groupType )
+        {
+            std::vector< uint8_t > values;
+            
+            for( size_t i = 0; i < hashCount; i++ )
+            {
+                /* a is never used */
+                Client                 client( "", static_cast< HashAlgorithm >( i ), groupType, BigNum( 1 ) );
+                std::vector< uint8_t > N  = client.N().bytes( BigNum::Endianness::BigEndian );
+                std::vector< uint8_t > g  = client.pad( client.g().bytes( BigNum::Endianness::BigEndian ) );
+                std::vector< uint8_t > k  = client.hash( { N, g } );
+                std::vector< uint8_t > hn = client.hash( N );
+                std::vector< uint8_t > hg = client.hash( g );
+                
+                if( i == 0 )
+                {
+                    values.insert( values.end(), N.begin(), N.end() );
+                    values.insert( values.end(), g.begin(), g.end() );
+                }
+                
+                for( size_t j = 0; j < hn.size(); j++ )
+                {
+                    hn[ j ] ^= hg[ j ];
+                }
+                
+                values.insert( values.end(), k.begin(),  k.end() );
+                values.insert( values.end(), hn.begin(), hn.end() );
+            }
+            
+            return values;
+        }
+    }
+    
+    class GroupTables::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            ~IMPL();
+            
+            void map( const std::string & path );
+            void unmap();
+            void validate();
+            
+            /* Fixed-width k, followed by H( N ) xor H( g ) - Null if the group is not in the file */
+            const uint8_t * digests( Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const;
+            
+            const uint8_t * _data;
+            size_t          _size;
+            
+            std::array< std::unique_ptr< FixedBase >, groupCount > _g;
+            std::array< const uint8_t *, groupCount >              _values;
+            
+            #ifdef _WIN32
+            HANDLE          _file;
+            HANDLE          _mapping;
+            #endif
+    };
+    
+    void GroupTables::write( const std::string & path, const std::vector< Base::GroupType > & groups, unsigned int exponentBits, unsigned int window )
+    {
+        std::vector< Base::GroupType > types( groups );
+        
+        std::sort( types.begin(), types.end() );
+        types.erase( std::unique( types.begin(), types.end() ), types.end() );
+        
+        std::vector< uint8_t > data( align( headerSize + types.size() * directorySize ), 0 );
+        
+        for( size_t i = 0; i < types.size(); i++ )
+        {
+            /* a is never used */
+            Client                 client( "", HashAlgorithm::SHA1, types[ i ], BigNum( 1 ) );
+            BigNum                 N      = client.N();
+            FixedBase              g( client.g(), N, exponentBits, window );
+            std::vector< uint8_t > values = groupValues( types[ i ] );
+            std::vector< uint8_t > table  = g.table();
+            size_t                 width  = N.bytes( BigNum::Endianness::BigEndian ).size();
+            size_t                 offset = data.size();
+            
+            storeLE( data.data() + headerSize + i * directorySize,     static_cast< uint64_t >( types[ i ] ), 4 );
+            storeLE( data.data() + headerSize + i * directorySize + 4, width,                                 4 );
+            storeLE( data.data() + headerSize + i * directorySize + 8, offset,                                8 );
+            
+            data.insert( data.end(), values.begin(), values.end() );
+            data.resize( offset + align( valuesSize( width ) ), 0 );
+            data.insert( data.end(), table.begin(), table.end() );
+            data.resize( align( data.size() ), 0 );
+        }
+        
+        memcpy( data.data(), magic, sizeof( magic ) );
+        storeLE( data.data() +  8, version,      4 );
+        storeLE( data.data() + 12, types.size(), 4 );
+        storeLE( data.data() + 16, exponentBits, 4 );
+        storeLE( data.data() + 20, window,       4 );
+        storeLE( data.data() + 24, data.size(),  8 );
+        
+        std::vector< uint8_t > checksum = SHA256::bytes( data.data() + headerSize, data.size() - headerSize );
+        
+        memcpy( data.data() + 32, checksum.data(), checksum.size() );
+        
+        std::string tmp = path + ".tmp";
+        
+        {
+            std::ofstream stream( tmp, std::ios::binary | std::ios::trunc );
+            
+            stream.write( reinterpret_cast< const char * >( data.data() ), static_cast< std::streamsize >( data.size() ) );
+            stream.flush();
+            
+            if( stream.good() == false )
+            {
+                std::remove( tmp.c_str() );
+                
+                throw std::runtime_error( "Cannot write group tables" );
+            }
+        }
+        
+        #ifdef _WIN32
+        bool renamed = MoveFileExA( tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+        #else
+        bool renamed = std::rename( tmp.c_str(), path.c_str() ) == 0;
+        #endif
+        
+        if( renamed == false )
+        {
+            std::remove( tmp.c_str() );
+            
+            throw std::runtime_error( "Cannot write group tables" );
+        }
+    }
+    
+    GroupTables::GroupTables( const std::string & path ):
+        impl( std::make_unique< IMPL >( path ) )
+    {}
+    
+    GroupTables::~GroupTables()
+    {}
+    
+    bool GroupTables::contains( Base::GroupType groupType ) const
+    {
+        return this->impl->_g[ static_cast< size_t >( groupType ) ] != nullptr;
+    }
+    
+    const FixedBase * GroupTables::g( Base::GroupType groupType ) const
+    {
+        return this->impl->_g[ static_cast< size_t >( groupType ) ].get();
+    }
+    
+    BigNumView GroupTables::k( Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const
+    {
+        return { this->impl->digests( groupType, hashAlgorithm ), digestSize( hashAlgorithm ) };
+    }
+    
+    std::vector< uint8_t > GroupTables::hashNG( Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const
+    {
+        const uint8_t * p    = this->impl->digests( groupType, hashAlgorithm );
+        size_t          size = digestSize( hashAlgorithm );
+        
+        /* Offset by the digest size, as k's view skips its leading zeros */
+        return ( p == nullptr ) ? std::vector< uint8_t >() : std::vector< uint8_t >( p + size, p + 2 * size );
+    }
+    
+    void GroupTables::install( std::shared_ptr< const GroupTables > tables )
+    {
+        std::lock_guard< std::mutex > lock( installedLock );
+        
+        installedTables = std::move( tables );
+    }
+    
+    std::shared_ptr< const GroupTables > GroupTables::installed()
+    {
+        std::lock_guard< std::mutex > lock( installedLock );
+        
+        return installedTables;
+    }
+    
+    GroupTables::IMPL::IMPL( const std::string & path ):
+        _data( nullptr ),
+        _size( 0 ),
+        _values {}
+    {
+        this->map( path );
+        
+        try
+        {
+            this->validate();
+        }
+        catch( ... )
+        {
+            for( auto & g: this->_g )
+            {
+                g.reset();
+            }
+            
+            this->unmap();
+            
+            throw;
+        }
+    }
+    
+    GroupTables::IMPL::~IMPL()
+    {
+        for( auto & g: this->_g )
+        {
+            g.reset();
+        }
+        
+        this->unmap();
+    }
+    
+    void GroupTables::IMPL::map( const std::string & path )
+    {
+        #ifdef _WIN32
+        
+        LARGE_INTEGER size;
+        
+        this->_file    = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        this->_mapping = nullptr;
+        
+        if( this->_file == INVALID_HANDLE_VALUE || GetFileSizeEx( this->_file, &size ) == FALSE )
+        {
+            if( this->_file != INVALID_HANDLE_VALUE )
+            {
+                CloseHandle( this->_file );
+            }
+            
+            throw std::runtime_error( "Cannot open group tables" );
+        }
+        
+        this->_size    = static_cast< size_t >( size.QuadPart );
+        this->_mapping = ( this->_size < headerSize ) ? nullptr : CreateFileMappingA( this->_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        this->_data    = ( this->_mapping == nullptr ) ? nullptr : static_cast< const uint8_t * >( MapViewOfFile( this->_mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        
+        if( this->_data == nullptr )
+        {
+            if( this->_mapping != nullptr )
+            {
+                CloseHandle( this->_mapping );
+            }
+            
+            CloseHandle( this->_file );
+            
+            throw std::runtime_error( "Cannot map group tables" );
+        }
+        
+        #else
+        
+        struct stat st;
+        int         fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+        
+        if( fd == -1 || fstat( fd, &st ) != 0 )
+        {
+            if( fd != -1 )
+            {
+                close( fd );
+            }
+            
+            throw std::runtime_error( "Cannot open group tables" );
+        }
+        
+        this->_size = static_cast< size_t >( st.st_size );
+        
+        void * p = ( this->_size < headerSize ) ? MAP_FAILED : mmap( nullptr, this->_size, PROT_READ, MAP_SHARED, fd, 0 );
+        
+        /* The mapping keeps its own reference to the file */
+        close( fd );
+        
+        if( p == MAP_FAILED )
+        {
+            throw std::runtime_error( "Cannot map group tables" );
+        }
+        
+        this->_data = static_cast< const uint8_t * >( p );
+        
+        #endif
+    }
+    
+    void GroupTables::IMPL::unmap()
+    {
+        if( this->_data == nullptr )
+        {
+            return;
+        }
+        
+        #ifdef _WIN32
+        UnmapViewOfFile( this->_data );
+        CloseHandle( this->_mapping );
+        CloseHandle( this->_file );
+        #else
+        munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        #endif
+        
+        this->_data = nullptr;
+    }
+    
+    void GroupTables::IMPL::validate()
+    {
+        uint64_t     count        = loadLE( this->_data + 12, 4 );
+        unsigned int exponentBits = static_cast< unsigned int >( loadLE( this->_data + 16, 4 ) );
+        unsigned int window       = static_cast< unsigned int >( loadLE( this->_data + 20, 4 ) );
+        
+        bool valid = memcmp( this->_data, magic, sizeof( magic ) ) == 0
+                  && loadLE( this->_data + 8, 4 ) == version
+                  && loadLE( this->_data + 24, 8 ) == this->_size
+                  && count <= groupCount
+                  && exponentBits > 0 && exponentBits <= 8192
+                  && window > 0 && window <= 8
+                  && this->_size >= headerSize + count * directorySize;
+        
+        if( valid == false )
+        {
+            throw std::runtime_error( "Invalid group tables" );
+        }
+        
+        /* Every byte is covered, so a corrupted table cannot silently produce wrong values */
+        if( memcmp( SHA256::bytes( this->_data + headerSize, this->_size - headerSize ).data(), this->_data + 32, SHA256::digestSize ) != 0 )
+        {
+            throw std::runtime_error( "Invalid group tables checksum" );
+        }
+        
+        for( uint64_t i = 0; i < count; i++ )
+        {
+            const uint8_t * entry     = this->_data + headerSize + i * directorySize;
+            uint64_t        groupType = loadLE( entry,     4 );
+            size_t          width     = static_cast< size_t >( loadLE( entry + 4, 4 ) );
+            size_t          offset    = static_cast< size_t >( loadLE( entry + 8, 8 ) );
+            
+            if
+            (
+                   groupType >= groupCount
+                || this->_g[ groupType ] != nullptr
+                || width == 0
+                || width > 1024
+                || offset < headerSize + count * directorySize
+                || offset % 64 != 0
+            )
+            {
+                throw std::runtime_error( "Invalid group tables" );
+            }
+            
+            size_t table = align( valuesSize( width ) );
+            size_t size  = tableSize( width, exponentBits, window );
+            
+            if( offset > this->_size || table + size > this->_size - offset )
+            {
+                throw std::runtime_error( "Invalid group tables" );
+            }
+            
+            /* Checked against the built-in group, so a file can only speed things up */
+            std::vector< uint8_t > values = groupValues( static_cast< Base::GroupType >( groupType ) );
+            
+            if( values.size() != valuesSize( width ) || memcmp( values.data(), this->_data + offset, values.size() ) != 0 )
+            {
+                throw std::runtime_error( "Group tables do not match the built-in groups" );
+            }
+            
+            BigNum N( std::vector< uint8_t >( this->_data + offset, this->_data + offset + width ), BigNum::Endianness::BigEndian );
+            BigNum g( std::vector< uint8_t >( this->_data + offset + width, this->_data + offset + 2 * width ), BigNum::Endianness::BigEndian );
+            
+            this->_values[ groupType ] = this->_data + offset + 2 * width;
+            this->_g[ groupType ]      = std::make_unique< FixedBase >( g, N, exponentBits, window, this->_data + offset + table, size );
+        }
+    }
+    
+    const uint8_t * GroupTables::IMPL::digests( Base::GroupType groupType, HashAlgorithm hashAlgorithm ) const
+    {
+        const uint8_t * p = this->_values[ static_cast< size_t >( groupType ) ];
+        
+        if( p == nullptr )
+        {
+            return nullptr;
+        }
+        
+        for( size_t i = 0; i < static_cast< size_t >( hashAlgorithm ); i++ )
+        {
+            p += 2 * digestSize( static_cast< HashAlgorithm >( i ) );
+        }
+        
+        return p;
+    }
+}
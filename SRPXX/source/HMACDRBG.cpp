@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/HMACDRBG.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    class HMACDRBG::IMPL
+    {
+        public:
+            
+            IMPL( HashAlgorithm hashAlgorithm );
+            ~IMPL();
+            
+            /* K = HMAC( K, V || 0x00 || data ), V = HMAC( K, V ), then again with 0x01 if there is data */
+            void update( const std::vector< const std::vector< uint8_t > * > & data );
+            void hmac( const SecureBytes & data, uint8_t * out ) const;
+            
+            const EVP_MD * _digest;
+            size_t         _length;
+            SecureBytes    _K;
+            SecureBytes    _V;
+            SecureBytes    _buffer;
+    };
+    
+    HMACDRBG::HMACDRBG( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & entropy, const std::vector< uint8_t > & nonce, const std::vector< uint8_t > & personalization ):
+        impl( std::make_unique< IMPL >( hashAlgorithm ) )
+    {
+        this->impl->update( { &entropy, &nonce, &personalization } );
+    }
+    
+    HMACDRBG::~HMACDRBG()
+    {}
+    
+    void HMACDRBG::reseed( const std::vector< uint8_t > & entropy, const std::vector< uint8_t > & additional )
+    {
+        this->impl->update( { &entropy, &additional } );
+    }
+    
+    void HMACDRBG::generate( uint8_t * buffer, size_t length )
+    {
+        for( size_t offset = 0; offset < length; offset += this->impl->_length )
+        {
+            this->impl->hmac( this->impl->_V, this->impl->_V.data() );
+            
+            std::copy_n( this->impl->_V.begin(), std::min( this->impl->_length, length - offset ), buffer + offset );
+        }
+        
+        this->impl->update( {} );
+    }
+    
+    std::vector< uint8_t > HMACDRBG::generate( size_t length )
+    {
+        std::vector< uint8_t > bytes( length );
+        
+        this->generate( bytes.data(), bytes.size() );
+        
+        return bytes;
+    }
+    
+    HMACDRBG::IMPL::IMPL( HashAlgorithm hashAlgorithm ):
+        _digest( nullptr ),
+        _length( 0 ),
+        _K( SecureArena::shared() ),
+        _V( SecureArena::shared() ),
+        _buffer( SecureArena::shared() )
+    {
+        switch( hashAlgorithm )
+        {
+            case HashAlgorithm::SHA1:   this->_digest = EVP_sha1();   break;
+            case HashAlgorithm::SHA224: this->_digest = EVP_sha224(); break;
+            case HashAlgorithm::SHA256: this->_digest = EVP_sha256(); break;
+            case HashAlgorithm::SHA384: this->_digest = EVP_sha384(); break;
+            case HashAlgorithm::SHA512: this->_digest = EVP_sha512(); break;
+        }
+        
+        if( this->_digest == nullptr )
+        {
+            throw std::runtime_error( "Unsupported hash algorithm" );
+        }
+        
+        this->_length = static_cast< size_t >( EVP_MD_size( this->_digest ) );
+        
+        this->_K.assign( this->_length, 0x00 );
+        this->_V.assign( this->_length, 0x01 );
+    }
+    
+    HMACDRBG::IMPL::~IMPL()
+    {}
+    
+    void HMACDRBG::IMPL::update( const std::vector< const std::vector< uint8_t > * > & data )
+    {
+        bool empty = std::all_of( data.begin(), data.end(), []( const std::vector< uint8_t > * d ) { return d->empty(); } );
+        
+        for( uint8_t round = 0; round < ( empty ? 1 : 2 ); round++ )
+        {
+            this->_buffer.assign( this->_V.begin(), this->_V.end() );
+            this->_buffer.push_back( round );
+            
+            for( const auto * d: data )
+            {
+                this->_buffer.insert( this->_buffer.end(), d->begin(), d->end() );
+            }
+            
+            this->hmac( this->_buffer, this->_K.data() );
+            this->hmac( this->_V,      this->_V.data() );
+        }
+        
+        SecureArena::wipe( this->_buffer.data(), this->_buffer.size() );
+    }
+    
+    void HMACDRBG::IMPL::hmac( const SecureBytes & data, uint8_t * out ) const
+    {
+        unsigned int length = 0;
+        
+        if( ::HMAC( this->_digest, this->_K.data(), static_cast< int >( this->_K.size() ), data.data(), data.size(), out, &length ) == nullptr )
+        {
+            throw std::runtime_error( "Cannot compute HMAC" );
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/KeyRing.hpp>
+#include <SRPXX/Random.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+
+namespace SRP
+{
+    class KeyRing::IMPL
+    {
+        public:
+            
+            struct Key
+            {
+                uint32_t    id;
+                SecureBytes bytes;
+            };
+            
+            IMPL( size_t capacity );
+            ~IMPL();
+            
+            void insert( uint32_t id, const uint8_t * key );
+            
+            mutable std::shared_mutex _mutex;
+            size_t                    _capacity;
+            std::deque< Key >         _keys;
+    };
+    
+    KeyRing::KeyRing( size_t capacity ):
+        impl( std::make_unique< IMPL >( capacity ) )
+    {}
+    
+    KeyRing::~KeyRing()
+    {}
+    
+    uint32_t KeyRing::rotate()
+    {
+        std::vector< uint8_t >                key = Random::bytes( KeyRing::keyLength );
+        std::unique_lock< std::shared_mutex > l( this->impl->_mutex );
+        uint32_t                              id  = this->impl->_keys.empty() ? 1 : this->impl->_keys.back().id + 1;
+        
+        while( id == 0 || std::any_of( this->impl->_keys.begin(), this->impl->_keys.end(), [ & ]( const IMPL::Key & k ) { return k.id == id; } ) )
+        {
+            id++;
+        }
+        
+        this->impl->insert( id, key.data() );
+        
+        SecureArena::wipe( key.data(), key.size() );
+        
+        return id;
+    }
+    
+    void KeyRing::add( uint32_t id, const std::vector< uint8_t > & key )
+    {
+        if( key.size() != KeyRing::keyLength )
+        {
+            throw std::runtime_error( "Invalid key length" );
+        }
+        
+        std::unique_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        if( std::any_of( this->impl->_keys.begin(), this->impl->_keys.end(), [ & ]( const IMPL::Key & k ) { return k.id == id; } ) )
+        {
+            throw std::runtime_error( "Duplicate key id" );
+        }
+        
+        this->impl->insert( id, key.data() );
+    }
+    
+    void KeyRing::remove( uint32_t id )
+    {
+        std::unique_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        auto it = std::find_if( this->impl->_keys.begin(), this->impl->_keys.end(), [ & ]( const IMPL::Key & k ) { return k.id == id; } );
+        
+        if( it != this->impl->_keys.end() )
+        {
+            this->impl->_keys.erase( it );
+        }
+    }
+    
+    bool KeyRing::empty() const
+    {
+        std::shared_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        return this->impl->_keys.empty();
+    }
+    
+    size_t KeyRing::size() const
+    {
+        std::shared_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        return this->impl->_keys.size();
+    }
+    
+    uint32_t KeyRing::current() const
+    {
+        std::shared_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        if( this->impl->_keys.empty() )
+        {
+            throw std::runtime_error( "Key ring is empty" );
+        }
+        
+        return this->impl->_keys.back().id;
+    }
+    
+    bool KeyRing::key( uint32_t id, uint8_t * buffer ) const
+    {
+        std::shared_lock< std::shared_mutex > l( this->impl->_mutex );
+        
+        /* Newest first, as most lookups are for the current key */
+        for( auto it = this->impl->_keys.rbegin(); it != this->impl->_keys.rend(); ++it )
+        {
+            if( it->id == id )
+            {
+                memcpy( buffer, it->bytes.data(), KeyRing::keyLength );
+                
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    KeyRing::IMPL::IMPL( size_t capacity ):
+        _capacity( std::max< size_t >( capacity, 1 ) )
+    {}
+    
+    KeyRing::IMPL::~IMPL()
+    {}
+    
+    void KeyRing::IMPL::insert( uint32_t id, const uint8_t * key )
+    {
+        this->_keys.push_back( { id, SecureBytes( key, key + KeyRing::keyLength, SecureArena::shared() ) } );
+        
+        while( this->_keys.size() > this->_capacity )
+        {
+            this->_keys.pop_front();
+        }
+    }
+}
@@ -0,0 +1,281 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/OffloadClient.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include "OffloadSegment.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace SRP
+{
+    class OffloadClient::IMPL
+    {
+        public:
+            
+            using Clock = std::chrono::steady_clock;
+            
+            IMPL( const std::string & name, std::chrono::milliseconds timeout );
+            
+            /* Returns the index of a slot holding the result, and its state word - It must then be released */
+            uint32_t submit( OffloadSegment::Operation operation, const Server & server, const std::vector< uint8_t > * M1, uint32_t & word );
+            uint32_t claim( Clock::time_point deadline, uint32_t & word );
+            void     release( uint32_t index, uint32_t word );
+            
+            std::chrono::milliseconds wait( Clock::time_point deadline ) const;
+            
+            OffloadSegment::Mapping   _segment;
+            std::chrono::milliseconds _timeout;
+            std::atomic< uint32_t >   _next;
+    };
+    
+    OffloadClient::OffloadClient( const std::string & name, std::chrono::milliseconds timeout ):
+        impl( std::make_unique< IMPL >( name, timeout ) )
+    {}
+    
+    OffloadClient::~OffloadClient()
+    {}
+    
+    BigNum OffloadClient::B( const Server & server )
+    {
+        uint32_t               word   = 0;
+        uint32_t               index  = this->impl->submit( OffloadSegment::Operation::B, server, nullptr, word );
+        OffloadSegment::Slot & slot   = this->impl->_segment.slot( index );
+        size_t                 offset = 0;
+        const uint8_t        * data   = nullptr;
+        size_t                 length = 0;
+        
+        if( OffloadSegment::read( slot, offset, data, length ) == false )
+        {
+            this->impl->release( index, word );
+            
+            throw std::runtime_error( "Malformed offload result" );
+        }
+        
+        BigNum value( BigNumView( data, length ) );
+        
+        this->impl->release( index, word );
+        
+        return value;
+    }
+    
+    OffloadClient::Verification OffloadClient::verify( const Server & server, const std::vector< uint8_t > & M1 )
+    {
+        uint32_t               word   = 0;
+        uint32_t               index  = this->impl->submit( OffloadSegment::Operation::Verify, server, &M1, word );
+        OffloadSegment::Slot & slot   = this->impl->_segment.slot( index );
+        size_t                 offset = 0;
+        const uint8_t        * M2     = nullptr;
+        const uint8_t        * K      = nullptr;
+        size_t                 m2     = 0;
+        size_t                 k      = 0;
+        Verification           result;
+        
+        if( slot.status == static_cast< uint8_t >( OffloadSegment::Status::OK ) )
+        {
+            if( OffloadSegment::read( slot, offset, M2, m2 ) == false || OffloadSegment::read( slot, offset, K, k ) == false )
+            {
+                this->impl->release( index, word );
+                
+                throw std::runtime_error( "Malformed offload result" );
+            }
+            
+            result.M2.assign( M2, M2 + m2 );
+            result.K.assign( K, K + k );
+        }
+        
+        this->impl->release( index, word );
+        
+        return result;
+    }
+    
+    OffloadClient::IMPL::IMPL( const std::string & name, std::chrono::milliseconds timeout ):
+        _segment( name, false ),
+        _timeout( timeout ),
+        _next( 0 )
+    {}
+    
+    uint32_t OffloadClient::IMPL::submit( OffloadSegment::Operation operation, const Server & server, const std::vector< uint8_t > * M1, uint32_t & word )
+    {
+        OffloadSegment::Header & header   = this->_segment.header();
+        Clock::time_point        deadline = Clock::now() + this->_timeout;
+        uint32_t                 claimed  = 0;
+        uint32_t                 index    = this->claim( deadline, claimed );
+        OffloadSegment::Slot   & slot     = this->_segment.slot( index );
+        std::string              identity = server.identity();
+        std::vector< uint8_t >   salt     = server.salt();
+        std::vector< uint8_t >   v        = server.v().bytes( BigNum::Endianness::BigEndian );
+        std::vector< uint8_t >   b        = server.b().bytes( BigNum::Endianness::BigEndian );
+        bool                     written  = true;
+        
+        slot.operation     = static_cast< uint8_t >( operation );
+        slot.hashAlgorithm = static_cast< uint8_t >( server.hashAlgorithm() );
+        slot.groupType     = static_cast< uint8_t >( server.groupType() );
+        slot.status        = 0;
+        slot.length        = 0;
+        
+        written = written && OffloadSegment::append( slot, reinterpret_cast< const uint8_t * >( identity.data() ), identity.size() );
+        written = written && OffloadSegment::append( slot, salt.data(), salt.size() );
+        written = written && OffloadSegment::append( slot, v.data(), v.size() );
+        written = written && OffloadSegment::append( slot, b.data(), b.size() );
+        
+        SecureArena::wipe( b.data(), b.size() );
+        
+        if( M1 != nullptr )
+        {
+            std::vector< uint8_t > A = server.A().bytes( BigNum::Endianness::BigEndian );
+            
+            written = written && OffloadSegment::append( slot, A.data(), A.size() );
+            written = written && OffloadSegment::append( slot, M1->data(), M1->size() );
+        }
+        
+        if( written == false )
+        {
+            this->release( index, claimed );
+            
+            throw std::runtime_error( "Offload request is too large" );
+        }
+        
+        uint32_t expected  = claimed;
+        uint32_t submitted = OffloadSegment::withState( claimed, OffloadSegment::State::Submitted );
+        
+        /* Only fails if the service reclaimed the slot after this client stalled for too long, even if it was claimed again since */
+        if( slot.state.compare_exchange_strong( expected, submitted ) == false )
+        {
+            throw std::runtime_error( "Offload slot was reclaimed" );
+        }
+        
+        word = OffloadSegment::withState( claimed, OffloadSegment::State::Done );
+        
+        /* The ring holds one cell per slot, so it cannot be full */
+        OffloadSegment::push( header, this->_segment.cells(), this->_segment.slots(), index );
+        
+        header.submitted.fetch_add( 1 );
+        
+        if( header.sleeping.load() != 0 )
+        {
+            OffloadSegment::wake( header.submitted );
+        }
+        
+        while( slot.state.load( std::memory_order_acquire ) != word )
+        {
+            if( header.ready.load( std::memory_order_acquire ) == 0 || Clock::now() >= deadline )
+            {
+                expected = submitted;
+                
+                /* The service releases an abandoned slot once it is done with it */
+                if( slot.state.compare_exchange_strong( expected, OffloadSegment::withState( claimed, OffloadSegment::State::Abandoned ) ) )
+                {
+                    throw std::runtime_error( header.ready.load() == 0 ? "Offload service stopped" : "Offload request timed out" );
+                }
+                
+                break;
+            }
+            
+            OffloadSegment::wait( slot.state, submitted, this->wait( deadline ) );
+        }
+        
+        if( slot.status == static_cast< uint8_t >( OffloadSegment::Status::Failed ) )
+        {
+            size_t          offset = 0;
+            const uint8_t * data   = nullptr;
+            size_t          length = 0;
+            std::string     message( "Offload request failed" );
+            
+            if( OffloadSegment::read( slot, offset, data, length ) )
+            {
+                message += ": " + std::string( reinterpret_cast< const char * >( data ), length );
+            }
+            
+            this->release( index, word );
+            
+            throw std::runtime_error( message );
+        }
+        
+        return index;
+    }
+    
+    uint32_t OffloadClient::IMPL::claim( Clock::time_point deadline, uint32_t & word )
+    {
+        OffloadSegment::Header & header = this->_segment.header();
+        uint32_t                 slots  = this->_segment.slots();
+        
+        while( true )
+        {
+            uint32_t seen  = header.released.load( std::memory_order_acquire );
+            uint32_t start = this->_next.fetch_add( 1, std::memory_order_relaxed );
+            
+            for( uint32_t i = 0; i < slots; i++ )
+            {
+                uint32_t               index    = ( start + i ) & ( slots - 1 );
+                OffloadSegment::Slot & slot     = this->_segment.slot( index );
+                uint32_t               expected = slot.state.load( std::memory_order_acquire );
+                
+                if( OffloadSegment::stateOf( expected ) != OffloadSegment::State::Free )
+                {
+                    continue;
+                }
+                
+                word = OffloadSegment::withState( expected, OffloadSegment::State::Claimed );
+                
+                if( slot.state.compare_exchange_strong( expected, word ) )
+                {
+                    OffloadSegment::own( slot );
+                    
+                    return index;
+                }
+            }
+            
+            if( header.ready.load( std::memory_order_acquire ) == 0 )
+            {
+                throw std::runtime_error( "Offload service stopped" );
+            }
+            
+            if( Clock::now() >= deadline )
+            {
+                throw std::runtime_error( "Offload request timed out" );
+            }
+            
+            header.waiting.fetch_add( 1 );
+            OffloadSegment::wait( header.released, seen, this->wait( deadline ) );
+            header.waiting.fetch_sub( 1 );
+        }
+    }
+    
+    void OffloadClient::IMPL::release( uint32_t index, uint32_t word )
+    {
+        /* Does nothing if the service reclaimed the slot in the meantime */
+        OffloadSegment::release( this->_segment.header(), this->_segment.slot( index ), word );
+    }
+    
+    /* Waits are bounded, so a stopped service is noticed */
+    std::chrono::milliseconds OffloadClient::IMPL::wait( Clock::time_point deadline ) const
+    {
+        auto remaining = std::chrono::duration_cast< std::chrono::milliseconds >( deadline - Clock::now() ) + std::chrono::milliseconds( 1 );
+        
+        return std::max( std::chrono::milliseconds( 1 ), std::min( remaining, std::chrono::milliseconds( 100 ) ) );
+    }
+}
@@ -0,0 +1,443 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "OffloadSegment.hpp"
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+namespace SRP
+{
+    namespace OffloadSegment
+    {
+        #ifdef _WIN32
+        
+        Mapping::Mapping( const std::string & name, bool create, uint32_t slots ):
+            _name( name ),
+            _owner( false ),
+            _address( nullptr ),
+            _size( 0 ),
+            _slots( 0 )
+        {
+            ( void )create;
+            ( void )slots;
+            
+            throw std::runtime_error( "The offload service is not supported on Windows" );
+        }
+        
+        Mapping::~Mapping()
+        {}
+        
+        #else
+        
+        namespace
+        {
+            size_t segmentSize( uint32_t slots )
+            {
+                return sizeof( Header ) + ( sizeof( Cell ) * slots ) + ( sizeof( Slot ) * slots );
+            }
+            
+            std::string segmentName( const std::string & name )
+            {
+                return ( name.empty() == false && name[ 0 ] == '/' ) ? name : "/" + name;
+            }
+        }
+        
+        Mapping::Mapping( const std::string & name, bool create, uint32_t slots ):
+            _name( segmentName( name ) ),
+            _owner( create ),
+            _address( nullptr ),
+            _size( 0 ),
+            _slots( 0 )
+        {
+            int fd = -1;
+            
+            if( create )
+            {
+                if( slots == 0 || ( slots & ( slots - 1 ) ) != 0 )
+                {
+                    throw std::runtime_error( "The number of offload slots must be a power of two" );
+                }
+                
+                /* A stale segment from a previous service */
+                shm_unlink( this->_name.c_str() );
+                
+                this->_size = segmentSize( slots );
+                fd          = shm_open( this->_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR );
+                
+                if( fd >= 0 && ftruncate( fd, static_cast< off_t >( this->_size ) ) != 0 )
+                {
+                    int error = errno;
+                    
+                    close( fd );
+                    shm_unlink( this->_name.c_str() );
+                    
+                    throw std::system_error( error, std::generic_category(), "Cannot size offload segment " + this->_name );
+                }
+            }
+            else
+            {
+                struct stat info;
+                
+                fd = shm_open( this->_name.c_str(), O_RDWR, 0 );
+                
+                if( fd >= 0 )
+                {
+                    if( fstat( fd, &info ) != 0 || static_cast< size_t >( info.st_size ) < sizeof( Header ) )
+                    {
+                        close( fd );
+                        
+                        throw std::runtime_error( "Invalid offload segment " + this->_name );
+                    }
+                    
+                    this->_size = static_cast< size_t >( info.st_size );
+                }
+            }
+            
+            if( fd < 0 )
+            {
+                throw std::system_error( errno, std::generic_category(), "Cannot open offload segment " + this->_name );
+            }
+            
+            this->_address = mmap( nullptr, this->_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+            
+            close( fd );
+            
+            if( this->_address == MAP_FAILED )
+            {
+                this->_address = nullptr;
+                
+                if( this->_owner )
+                {
+                    shm_unlink( this->_name.c_str() );
+                }
+                
+                throw std::system_error( errno, std::generic_category(), "Cannot map offload segment " + this->_name );
+            }
+            
+            Header & header = this->header();
+            
+            if( create )
+            {
+                /* A new segment is zero-filled, so every slot starts free */
+                header.magic    = magic;
+                header.version  = version;
+                header.slots    = slots;
+                header.slotSize = sizeof( Slot );
+                
+                for( uint32_t i = 0; i < slots; i++ )
+                {
+                    this->cells()[ i ].sequence.store( i, std::memory_order_relaxed );
+                }
+                
+                header.ready.store( 1, std::memory_order_release );
+            }
+            else if
+            (
+                   header.ready.load( std::memory_order_acquire ) != 1
+                || header.magic    != magic
+                || header.version  != version
+                || header.slotSize != sizeof( Slot )
+                || header.slots    == 0
+                || segmentSize( header.slots ) != this->_size
+            )
+            {
+                munmap( this->_address, this->_size );
+                
+                throw std::runtime_error( "Incompatible or stopped offload segment " + this->_name );
+            }
+            
+            this->_slots = header.slots;
+        }
+        
+        Mapping::~Mapping()
+        {
+            if( this->_address == nullptr )
+            {
+                return;
+            }
+            
+            if( this->_owner )
+            {
+                /* Clients still attached fail their next request */
+                this->header().ready.store( 0, std::memory_order_release );
+                shm_unlink( this->_name.c_str() );
+            }
+            
+            munmap( this->_address, this->_size );
+        }
+        
+        #endif
+        
+        Header & Mapping::header() const
+        {
+            return *( static_cast< Header * >( this->_address ) );
+        }
+        
+        Cell * Mapping::cells() const
+        {
+            return reinterpret_cast< Cell * >( static_cast< uint8_t * >( this->_address ) + sizeof( Header ) );
+        }
+        
+        Slot & Mapping::slot( uint32_t index ) const
+        {
+            uint8_t * slots = static_cast< uint8_t * >( this->_address ) + sizeof( Header ) + ( sizeof( Cell ) * this->_slots );
+            
+            return reinterpret_cast< Slot * >( slots )[ index ];
+        }
+        
+        uint32_t Mapping::slots() const
+        {
+            return this->_slots;
+        }
+        
+        void wait( std::atomic< uint32_t > & word, uint32_t expected, std::chrono::milliseconds timeout )
+        {
+            if( word.load( std::memory_order_acquire ) != expected )
+            {
+                return;
+            }
+            
+            #ifdef __linux__
+            
+            struct timespec ts;
+            
+            ts.tv_sec  = static_cast< time_t >( timeout.count() / 1000 );
+            ts.tv_nsec = static_cast< long >( ( timeout.count() % 1000 ) * 1000000 );
+            
+            /* Not FUTEX_PRIVATE_FLAG, as the word is shared between processes */
+            syscall( SYS_futex, reinterpret_cast< uint32_t * >( &word ), FUTEX_WAIT, expected, &ts, nullptr, 0 );
+            
+            #else
+            
+            /* No cross-process address wait - Polls with short sleeps */
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            
+            while( word.load( std::memory_order_acquire ) == expected && std::chrono::steady_clock::now() < deadline )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+            }
+            
+            #endif
+        }
+        
+        void wake( std::atomic< uint32_t > & word )
+        {
+            #ifdef __linux__
+            syscall( SYS_futex, reinterpret_cast< uint32_t * >( &word ), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0 );
+            #else
+            ( void )word;
+            #endif
+        }
+        
+        bool push( Header & header, Cell * cells, uint32_t slots, uint32_t slot )
+        {
+            Cell   * cell = nullptr;
+            uint64_t mask = slots - 1;
+            uint64_t pos  = header.enqueue.load( std::memory_order_relaxed );
+            
+            while( true )
+            {
+                cell = &( cells[ pos & mask ] );
+                
+                uint64_t seq = cell->sequence.load( std::memory_order_acquire );
+                int64_t  dif = static_cast< int64_t >( seq ) - static_cast< int64_t >( pos );
+                
+                if( dif == 0 )
+                {
+                    if( header.enqueue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                    {
+                        break;
+                    }
+                }
+                else if( dif < 0 )
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = header.enqueue.load( std::memory_order_relaxed );
+                }
+            }
+            
+            cell->slot = slot;
+            
+            cell->sequence.store( pos + 1, std::memory_order_release );
+            
+            return true;
+        }
+        
+        bool pop( Header & header, Cell * cells, uint32_t slots, uint32_t & slot )
+        {
+            uint64_t mask = slots - 1;
+            uint64_t pos  = header.dequeue.load( std::memory_order_relaxed );
+            Cell   * cell = &( cells[ pos & mask ] );
+            
+            /* Single consumer - No need to compete for the position */
+            if( cell->sequence.load( std::memory_order_acquire ) != pos + 1 )
+            {
+                return false;
+            }
+            
+            slot = cell->slot;
+            
+            header.dequeue.store( pos + 1, std::memory_order_relaxed );
+            cell->sequence.store( pos + mask + 1, std::memory_order_release );
+            
+            return true;
+        }
+        
+        State stateOf( uint32_t word )
+        {
+            return static_cast< State >( word & 0xFF );
+        }
+        
+        uint32_t withState( uint32_t word, State state )
+        {
+            return ( word & ~static_cast< uint32_t >( 0xFF ) ) | static_cast< uint32_t >( state );
+        }
+        
+        void own( Slot & slot )
+        {
+            uint64_t now = static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+            
+            slot.claimed.store( std::max< uint64_t >( now, 1 ) );
+            
+            #ifdef _WIN32
+            slot.owner.store( 1 );
+            #else
+            slot.owner.store( static_cast< uint32_t >( getpid() ) );
+            #endif
+        }
+        
+        bool release( Header & header, Slot & slot, uint32_t word )
+        {
+            /* Abandoned first, so nobody else moves the slot on while it is wiped */
+            if( slot.state.compare_exchange_strong( word, withState( word, State::Abandoned ) ) == false )
+            {
+                return false;
+            }
+            
+            /* Requests hold b, and results K */
+            SecureArena::wipe( slot.data, dataLength );
+            slot.owner.store( 0 );
+            slot.claimed.store( 0 );
+            slot.state.store( withState( word + 0x100, State::Free ) );
+            header.released.fetch_add( 1 );
+            
+            if( header.waiting.load() > 0 )
+            {
+                wake( header.released );
+            }
+            
+            return true;
+        }
+        
+        bool reclaim( Header & header, Slot & slot, std::chrono::milliseconds timeout )
+        {
+            uint32_t word    = slot.state.load( std::memory_order_acquire );
+            uint32_t owner   = slot.owner.load();
+            uint64_t claimed = slot.claimed.load();
+            uint64_t now     = static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+            
+            /* Submitted slots belong to the service, and abandoned ones are freed once processed */
+            if( ( stateOf( word ) != State::Claimed && stateOf( word ) != State::Done ) || owner == 0 || claimed == 0 )
+            {
+                return false;
+            }
+            
+            bool exited = false;
+            
+            #ifndef _WIN32
+            exited = kill( static_cast< pid_t >( owner ), 0 ) != 0 && errno == ESRCH;
+            #endif
+            
+            if( exited == false && ( now < claimed || now - claimed < static_cast< uint64_t >( timeout.count() ) ) )
+            {
+                return false;
+            }
+            
+            /* Freeing bumps the generation, so a hung client that wakes up can no longer submit or release the slot */
+            return release( header, slot, word );
+        }
+        
+        bool append( Slot & slot, const uint8_t * data, size_t length )
+        {
+            if( length > 0xFFFF || slot.length + 2 + length > dataLength )
+            {
+                return false;
+            }
+            
+            slot.data[ slot.length     ] = static_cast< uint8_t >( length );
+            slot.data[ slot.length + 1 ] = static_cast< uint8_t >( length >> 8 );
+            
+            if( length > 0 )
+            {
+                memcpy( slot.data + slot.length + 2, data, length );
+            }
+            
+            slot.length += static_cast< uint32_t >( 2 + length );
+            
+            return true;
+        }
+        
+        bool read( const Slot & slot, size_t & offset, const uint8_t * & data, size_t & length )
+        {
+            if( slot.length > dataLength || offset + 2 > slot.length )
+            {
+                return false;
+            }
+            
+            length = static_cast< size_t >( slot.data[ offset ] ) | ( static_cast< size_t >( slot.data[ offset + 1 ] ) << 8 );
+            
+            if( offset + 2 + length > slot.length )
+            {
+                return false;
+            }
+            
+            data    = slot.data + offset + 2;
+            offset += 2 + length;
+            
+            return true;
+        }
+    }
+}
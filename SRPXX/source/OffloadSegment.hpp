@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#ifndef SRPXX_OFFLOAD_SEGMENT_HPP
+#define SRPXX_OFFLOAD_SEGMENT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Shared-memory segment of the offload service, all integers in host order:
+ * 
+ *   header, cells[ slots ], slots[ slots ]
+ * 
+ * Clients claim a free slot, write their request into it and push its index
+ * into the ring of cells, which only the service pops.
+ * The service writes the result into the same slot and marks it as done.
+ * Claimed slots record their owner's process ID and the time of the claim,
+ * so the service can free the slots of clients that exited or hung.
+ * Slot state words hold a State in their low byte and a generation above it,
+ * bumped each time the slot is freed, so a client that stalled past a reclaim
+ * cannot move on a slot claimed again since.
+ * Slot fields are each a u16 length followed by the bytes:
+ * 
+ *   B request:      identity, salt, v, b          - result: B
+ *   Verify request: identity, salt, v, b, A, M1  - result: M2, K
+ *   Failures:       message
+ */
+namespace SRP
+{
+    namespace OffloadSegment
+    {
+        constexpr uint32_t magic      = 0x53525058;
+        constexpr uint32_t version    = 3;
+        constexpr size_t   dataLength = 4096;
+        
+        static_assert( std::atomic< uint32_t >::is_always_lock_free && std::atomic< uint64_t >::is_always_lock_free, "Shared atomics need to be lock-free" );
+        static_assert( sizeof( std::atomic< uint32_t > ) == sizeof( uint32_t ), "Futex words need to be plain 32-bit integers" );
+        
+        enum class State: uint32_t
+        {
+            Free      = 0,
+            Claimed   = 1,
+            Submitted = 2,
+            Done      = 3,
+            Abandoned = 4
+        };
+        
+        enum class Operation: uint8_t
+        {
+            B      = 1,
+            Verify = 2
+        };
+        
+        enum class Status: uint8_t
+        {
+            OK       = 0,
+            Rejected = 1,
+            Failed   = 2
+        };
+        
+        struct Header
+        {
+            uint32_t                magic;
+            uint32_t                version;
+            uint32_t                slots;
+            uint32_t                slotSize;
+            std::atomic< uint32_t > ready;
+            
+            /* Ring positions, on their own cache lines */
+            alignas( 64 ) std::atomic< uint64_t > enqueue;
+            alignas( 64 ) std::atomic< uint64_t > dequeue;
+            
+            /* Bumped for each request, the service waits on it while sleeping */
+            alignas( 64 ) std::atomic< uint32_t > submitted;
+            std::atomic< uint32_t >              sleeping;
+            
+            /* Bumped for each released slot, clients wait on it while waiting is non-zero */
+            alignas( 64 ) std::atomic< uint32_t > released;
+            std::atomic< uint32_t >              waiting;
+        };
+        
+        struct Cell
+        {
+            std::atomic< uint64_t > sequence;
+            uint32_t                slot;
+        };
+        
+        struct alignas( 64 ) Slot
+        {
+            std::atomic< uint32_t > state;
+            
+            /* Zero while the slot is free or being claimed - The claim time is in milliseconds of the steady clock */
+            std::atomic< uint32_t > owner;
+            std::atomic< uint64_t > claimed;
+            
+            uint8_t                 operation;
+            uint8_t                 hashAlgorithm;
+            uint8_t                 groupType;
+            uint8_t                 status;
+            uint32_t                length;
+            uint8_t                 data[ dataLength ];
+        };
+        
+        /* Maps a segment - Clients open an existing one, the service replaces any stale one */
+        class Mapping
+        {
+            public:
+                
+                Mapping( const std::string & name, bool create, uint32_t slots = 0 );
+                ~Mapping();
+                
+                Mapping( const Mapping & o )              = delete;
+                Mapping & operator =( const Mapping & o ) = delete;
+                
+                Header & header() const;
+                Cell   * cells()  const;
+                Slot   & slot( uint32_t index ) const;
+                
+                /* As mapped - The header's copy can be written by any client */
+                uint32_t slots() const;
+                
+            private:
+                
+                std::string _name;
+                bool        _owner;
+                void      * _address;
+                size_t      _size;
+                uint32_t    _slots;
+        };
+        
+        /* Returns once the word no longer holds expected, after a wake, or after the timeout */
+        void wait( std::atomic< uint32_t > & word, uint32_t expected, std::chrono::milliseconds timeout );
+        void wake( std::atomic< uint32_t > & word );
+        
+        /* Bounded MPSC ring of slot indices - D. Vyukov */
+        bool push( Header & header, Cell * cells, uint32_t slots, uint32_t slot );
+        bool pop(  Header & header, Cell * cells, uint32_t slots, uint32_t & slot );
+        
+        /* Parts of a slot state word */
+        State    stateOf( uint32_t word );
+        uint32_t withState( uint32_t word, State state );
+        
+        /* Records the calling process as the owner of a slot it just claimed */
+        void own( Slot & slot );
+        
+        /* Wipes a slot and frees it, if its state word still holds word - Returns whether it did */
+        bool release( Header & header, Slot & slot, uint32_t word );
+        
+        /* Frees a slot left claimed or done by a process that exited, or for longer than timeout - Returns whether it did */
+        bool reclaim( Header & header, Slot & slot, std::chrono::milliseconds timeout );
+        
+        /* Fields of a slot's data */
+        bool append( Slot & slot, const uint8_t * data, size_t length );
+        bool read( const Slot & slot, size_t & offset, const uint8_t * & data, size_t & length );
+    }
+}
+
+#endif /* SRPXX_OFFLOAD_SEGMENT_HPP */
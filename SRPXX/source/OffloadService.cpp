@@ -0,0 +1,289 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/OffloadService.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <SRPXX/Engine.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <SRPXX/Server.hpp>
+#include "OffloadSegment.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/crypto.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    class OffloadService::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & name, const Options & options );
+            
+            /* On a worker thread */
+            void process( uint32_t index );
+            void compute( OffloadSegment::Slot & slot );
+            
+            Options                  _options;
+            OffloadSegment::Mapping  _segment;
+            VerifierCache            _cache;
+            std::atomic< bool >      _stopped;
+            std::atomic< uint64_t >  _requests;
+            std::atomic< uint64_t >  _batches;
+            std::atomic< uint64_t >  _reclaimed;
+            
+            /* Last, so workers are joined before anything they use is destroyed */
+            Engine _engine;
+    };
+    
+    OffloadService::Options::Options():
+        slots( 256 ),
+        threads( 0 ),
+        cacheBudget( 64 * 1024 * 1024 ),
+        reclaimTimeout( std::chrono::seconds( 60 ) )
+    {}
+    
+    OffloadService::OffloadService( const std::string & name ):
+        OffloadService( name, Options() )
+    {}
+    
+    OffloadService::OffloadService( const std::string & name, const Options & options ):
+        impl( std::make_unique< IMPL >( name, options ) )
+    {}
+    
+    OffloadService::~OffloadService()
+    {}
+    
+    void OffloadService::run()
+    {
+        OffloadSegment::Header & header = this->impl->_segment.header();
+        OffloadSegment::Cell   * cells  = this->impl->_segment.cells();
+        
+        auto swept = std::chrono::steady_clock::now();
+        
+        while( this->impl->_stopped == false )
+        {
+            uint32_t seen  = header.submitted.load( std::memory_order_acquire );
+            uint32_t slot  = 0;
+            uint64_t count = 0;
+            
+            /* Slots held by clients that exited or hung would otherwise never be free again */
+            if( std::chrono::steady_clock::now() - swept >= std::chrono::seconds( 1 ) )
+            {
+                for( uint32_t i = 0; i < this->impl->_options.slots; i++ )
+                {
+                    if( OffloadSegment::reclaim( header, this->impl->_segment.slot( i ), this->impl->_options.reclaimTimeout ) )
+                    {
+                        this->impl->_reclaimed++;
+                    }
+                }
+                
+                swept = std::chrono::steady_clock::now();
+            }
+            
+            /* Everything submitted since the last wake-up goes to the engine at once - Indices come from clients, so they are checked */
+            while( OffloadSegment::pop( header, cells, this->impl->_options.slots, slot ) )
+            {
+                if( slot < this->impl->_options.slots )
+                {
+                    this->impl->_engine.post( [ this, slot ] { this->impl->process( slot ); } );
+                    
+                    count++;
+                }
+            }
+            
+            if( count > 0 )
+            {
+                this->impl->_requests += count;
+                this->impl->_batches++;
+                
+                continue;
+            }
+            
+            /* Clients bump the counter after pushing, so a request arriving now ends the wait */
+            header.sleeping.store( 1 );
+            OffloadSegment::wait( header.submitted, seen, std::chrono::milliseconds( 100 ) );
+            header.sleeping.store( 0 );
+        }
+    }
+    
+    void OffloadService::stop()
+    {
+        OffloadSegment::Header & header = this->impl->_segment.header();
+        
+        this->impl->_stopped = true;
+        
+        header.submitted.fetch_add( 1 );
+        OffloadSegment::wake( header.submitted );
+    }
+    
+    OffloadService::Stats OffloadService::stats() const
+    {
+        return { this->impl->_requests, this->impl->_batches, this->impl->_reclaimed, this->impl->_cache.stats() };
+    }
+    
+    OffloadService::IMPL::IMPL( const std::string & name, const Options & options ):
+        _options( options ),
+        _segment( name, true, options.slots ),
+        _cache( options.cacheBudget ),
+        _stopped( false ),
+        _requests( 0 ),
+        _batches( 0 ),
+        _reclaimed( 0 ),
+        _engine( options.threads )
+    {}
+    
+    void OffloadService::IMPL::process( uint32_t index )
+    {
+        OffloadSegment::Slot   & slot   = this->_segment.slot( index );
+        OffloadSegment::Header & header = this->_segment.header();
+        
+        try
+        {
+            this->compute( slot );
+        }
+        catch( const std::exception & e )
+        {
+            std::string message = e.what();
+            
+            slot.status = static_cast< uint8_t >( OffloadSegment::Status::Failed );
+            slot.length = 0;
+            
+            OffloadSegment::append( slot, reinterpret_cast< const uint8_t * >( message.data() ), std::min< size_t >( message.size(), 256 ) );
+        }
+        
+        uint32_t word = slot.state.load( std::memory_order_acquire );
+        
+        if( OffloadSegment::stateOf( word ) == OffloadSegment::State::Submitted && slot.state.compare_exchange_strong( word, OffloadSegment::withState( word, OffloadSegment::State::Done ) ) )
+        {
+            OffloadSegment::wake( slot.state );
+            
+            return;
+        }
+        
+        /* The client gave up waiting - The slot is released here instead */
+        if( OffloadSegment::stateOf( word ) == OffloadSegment::State::Abandoned )
+        {
+            OffloadSegment::release( header, slot, word );
+        }
+    }
+    
+    void OffloadService::IMPL::compute( OffloadSegment::Slot & slot )
+    {
+        const uint8_t * fields[ 6 ]  = {};
+        size_t          lengths[ 6 ] = {};
+        size_t          offset       = 0;
+        size_t          count        = ( slot.operation == static_cast< uint8_t >( OffloadSegment::Operation::Verify ) ) ? 6 : 4;
+        
+        if( slot.operation != static_cast< uint8_t >( OffloadSegment::Operation::B ) && slot.operation != static_cast< uint8_t >( OffloadSegment::Operation::Verify ) )
+        {
+            throw std::runtime_error( "Invalid offload operation" );
+        }
+        
+        if( slot.hashAlgorithm > static_cast< uint8_t >( HashAlgorithm::SHA512 ) || slot.groupType > static_cast< uint8_t >( Base::GroupType::NG8192 ) )
+        {
+            throw std::runtime_error( "Invalid offload group or hash algorithm" );
+        }
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            if( OffloadSegment::read( slot, offset, fields[ i ], lengths[ i ] ) == false )
+            {
+                throw std::runtime_error( "Malformed offload request" );
+            }
+        }
+        
+        /* identity, salt, v, b [ , A, M1 ] - All copied before the slot is overwritten with the result */
+        Server server
+        (
+            std::string( reinterpret_cast< const char * >( fields[ 0 ] ), lengths[ 0 ] ),
+            static_cast< HashAlgorithm >( slot.hashAlgorithm ),
+            static_cast< Base::GroupType >( slot.groupType ),
+            BigNum( BigNumView( fields[ 3 ], lengths[ 3 ] ) )
+        );
+        
+        server.setSalt( fields[ 1 ], lengths[ 1 ] );
+        server.setV( BigNumView( fields[ 2 ], lengths[ 2 ] ) );
+        
+        if( this->_options.cacheBudget > 0 )
+        {
+            server.setPrecomputed( this->_cache.get( server ) );
+        }
+        
+        slot.status = static_cast< uint8_t >( OffloadSegment::Status::OK );
+        
+        if( slot.operation == static_cast< uint8_t >( OffloadSegment::Operation::B ) )
+        {
+            std::vector< uint8_t > B = server.B().bytes( BigNum::Endianness::BigEndian );
+            
+            slot.length = 0;
+            
+            OffloadSegment::append( slot, B.data(), B.size() );
+            
+            return;
+        }
+        
+        if( server.isValidPublicValue( BigNumView( fields[ 4 ], lengths[ 4 ] ) ) == false )
+        {
+            slot.status = static_cast< uint8_t >( OffloadSegment::Status::Rejected );
+            slot.length = 0;
+            
+            return;
+        }
+        
+        server.setA( BigNumView( fields[ 4 ], lengths[ 4 ] ) );
+        
+        BigNum                 S        = server.S();
+        std::vector< uint8_t > K        = server.K( S );
+        std::vector< uint8_t > expected = server.M1( K );
+        
+        if( expected.size() != lengths[ 5 ] || CRYPTO_memcmp( expected.data(), fields[ 5 ], expected.size() ) != 0 )
+        {
+            slot.status = static_cast< uint8_t >( OffloadSegment::Status::Rejected );
+            slot.length = 0;
+        }
+        else
+        {
+            std::vector< uint8_t > M2 = server.M2( expected, K );
+            
+            slot.length = 0;
+            
+            OffloadSegment::append( slot, M2.data(), M2.size() );
+            OffloadSegment::append( slot, K.data(),  K.size() );
+        }
+        
+        SecureArena::wipe( K.data(), K.size() );
+        server.clear();
+    }
+}
@@ -0,0 +1,572 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/PoolAllocator.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr size_t   headerSize   = 16;
+        constexpr size_t   minClassSize = 32;
+        constexpr size_t   classCount   = 10;
+        constexpr size_t   slabSize     = 64 * 1024;
+        constexpr uint32_t largeClass   = 0xFFFFFFFF;
+        constexpr uint32_t headerMagic  = 0x53525050;
+        
+        struct Header
+        {
+            uint32_t sizeClass;
+            uint32_t magic;
+            uint64_t size;
+        };
+        
+        static_assert( sizeof( Header ) == headerSize, "Header must keep payloads aligned" );
+        static_assert( ( minClassSize << ( classCount - 1 ) ) == PoolAllocator::maxPooledSize, "Invalid size classes" );
+        
+        struct Block
+        {
+            Block * next;
+        };
+        
+        struct FreeList
+        {
+            Block * head  = nullptr;
+            size_t  count = 0;
+            
+            void push( Block * block )
+            {
+                block->next = this->head;
+                this->head  = block;
+                
+                this->count++;
+            }
+            
+            Block * pop()
+            {
+                Block * block = this->head;
+                
+                if( block != nullptr )
+                {
+                    this->head = block->next;
+                    
+                    this->count--;
+                }
+                
+                return block;
+            }
+        };
+        
+        size_t classSize( size_t sizeClass )
+        {
+            return minClassSize << sizeClass;
+        }
+        
+        uint32_t classFor( size_t size )
+        {
+            uint32_t sizeClass = 0;
+            
+            while( classSize( sizeClass ) < size )
+            {
+                sizeClass++;
+            }
+            
+            return sizeClass;
+        }
+        
+        /* Number of blocks moved between a thread cache and the shared lists at once */
+        size_t batchSize( size_t sizeClass )
+        {
+            return std::clamp< size_t >( ( slabSize / ( classSize( sizeClass ) + headerSize ) ) / 2, 2, 64 );
+        }
+        
+        Header * headerOf( void * p )
+        {
+            return reinterpret_cast< Header * >( static_cast< uint8_t * >( p ) - headerSize );
+        }
+        
+        void * payloadOf( void * block, uint32_t sizeClass, size_t size )
+        {
+            Header * header = static_cast< Header * >( block );
+            
+            header->sizeClass = sizeClass;
+            header->magic     = headerMagic;
+            header->size      = size;
+            
+            return static_cast< uint8_t * >( block ) + headerSize;
+        }
+        
+        /* Only ever written by the owning thread, so no read-modify-write is needed */
+        void increment( std::atomic< uint64_t > & counter )
+        {
+            counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        }
+    }
+    
+    class PoolAllocator::IMPL: public std::enable_shared_from_this< PoolAllocator::IMPL >
+    {
+        public:
+            
+            class ThreadCache
+            {
+                public:
+                    
+                    ThreadCache( std::shared_ptr< IMPL > pool );
+                    ~ThreadCache();
+                    
+                    ThreadCache( const ThreadCache & o )              = delete;
+                    ThreadCache & operator =( const ThreadCache & o ) = delete;
+                    
+                    std::shared_ptr< IMPL > _pool;
+                    FreeList                _lists[ classCount ];
+                    std::atomic< uint64_t > _allocations;
+                    std::atomic< uint64_t > _deallocations;
+                    std::atomic< uint64_t > _cacheHits;
+                    std::atomic< uint64_t > _cacheMisses;
+                    std::atomic< uint64_t > _largeAllocations;
+            };
+            
+            class ThreadCaches
+            {
+                public:
+                    
+                    ~ThreadCaches();
+                    
+                    std::vector< std::unique_ptr< ThreadCache > > _caches;
+                    ThreadCache                                 * _last = nullptr;
+            };
+            
+            IMPL();
+            ~IMPL();
+            
+            ThreadCache * cache();
+            
+            void releaseSlabs();
+            
+            bool grow( size_t sizeClass );
+            void refill( size_t sizeClass, FreeList & list );
+            void release( size_t sizeClass, FreeList & list, size_t count );
+            
+            void * allocateShared( uint32_t sizeClass, size_t size );
+            void   deallocateShared( void * p );
+            
+            static thread_local bool         threadCachesDestroyed;
+            static thread_local ThreadCaches threadCaches;
+            
+            std::mutex                   _mutex;
+            std::atomic< bool >          _destroyed;
+            FreeList                     _lists[ classCount ];
+            std::vector< void * >        _slabs;
+            std::vector< ThreadCache * > _caches;
+            Stats                        _retired;
+    };
+    
+    thread_local bool                              PoolAllocator::IMPL::threadCachesDestroyed = false;
+    thread_local PoolAllocator::IMPL::ThreadCaches PoolAllocator::IMPL::threadCaches;
+    
+    PoolAllocator::PoolAllocator():
+        impl( std::make_shared< IMPL >() )
+    {}
+    
+    PoolAllocator::~PoolAllocator()
+    {
+        this->impl->releaseSlabs();
+    }
+    
+    void * PoolAllocator::allocate( size_t size )
+    {
+        IMPL::ThreadCache * cache = this->impl->cache();
+        
+        if( size > maxPooledSize )
+        {
+            void * block = malloc( size + headerSize );
+            
+            if( block == nullptr )
+            {
+                return nullptr;
+            }
+            
+            if( cache == nullptr )
+            {
+                std::lock_guard< std::mutex > l( this->impl->_mutex );
+                
+                this->impl->_retired.allocations++;
+                this->impl->_retired.largeAllocations++;
+            }
+            else
+            {
+                increment( cache->_allocations );
+                increment( cache->_largeAllocations );
+            }
+            
+            return payloadOf( block, largeClass, size );
+        }
+        
+        uint32_t sizeClass = classFor( size );
+        
+        if( cache == nullptr )
+        {
+            return this->impl->allocateShared( sizeClass, size );
+        }
+        
+        FreeList & list = cache->_lists[ sizeClass ];
+        
+        if( list.head == nullptr )
+        {
+            increment( cache->_cacheMisses );
+            this->impl->refill( sizeClass, list );
+        }
+        else
+        {
+            increment( cache->_cacheHits );
+        }
+        
+        Block * block = list.pop();
+        
+        if( block == nullptr )
+        {
+            return nullptr;
+        }
+        
+        increment( cache->_allocations );
+        
+        return payloadOf( block, sizeClass, size );
+    }
+    
+    void * PoolAllocator::reallocate( void * p, size_t size )
+    {
+        if( p == nullptr )
+        {
+            return this->allocate( size );
+        }
+        
+        Header * header = headerOf( p );
+        
+        if( header->sizeClass == largeClass && size > maxPooledSize )
+        {
+            void * block = realloc( header, size + headerSize );
+            
+            return ( block == nullptr ) ? nullptr : payloadOf( block, largeClass, size );
+        }
+        
+        size_t capacity = ( header->sizeClass == largeClass ) ? header->size : classSize( header->sizeClass );
+        
+        if( size <= capacity && header->sizeClass != largeClass )
+        {
+            header->size = size;
+            
+            return p;
+        }
+        
+        void * n = this->allocate( size );
+        
+        if( n == nullptr )
+        {
+            return nullptr;
+        }
+        
+        memcpy( n, p, std::min< size_t >( size, header->size ) );
+        this->deallocate( p );
+        
+        return n;
+    }
+    
+    void PoolAllocator::deallocate( void * p )
+    {
+        if( p == nullptr )
+        {
+            return;
+        }
+        
+        Header            * header = headerOf( p );
+        IMPL::ThreadCache * cache  = this->impl->cache();
+        
+        if( header->sizeClass == largeClass )
+        {
+            free( header );
+        }
+        else if( cache != nullptr )
+        {
+            FreeList & list      = cache->_lists[ header->sizeClass ];
+            size_t     sizeClass = header->sizeClass;
+            
+            list.push( reinterpret_cast< Block * >( header ) );
+            
+            if( list.count > batchSize( sizeClass ) * 2 )
+            {
+                this->impl->release( sizeClass, list, batchSize( sizeClass ) );
+            }
+        }
+        else
+        {
+            this->impl->deallocateShared( p );
+            
+            return;
+        }
+        
+        if( cache == nullptr )
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mutex );
+            
+            this->impl->_retired.deallocations++;
+        }
+        else
+        {
+            increment( cache->_deallocations );
+        }
+    }
+    
+    PoolAllocator::Stats PoolAllocator::stats() const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        Stats stats = this->impl->_retired;
+        
+        for( const IMPL::ThreadCache * cache: this->impl->_caches )
+        {
+            stats.allocations      += cache->_allocations.load( std::memory_order_relaxed );
+            stats.deallocations    += cache->_deallocations.load( std::memory_order_relaxed );
+            stats.cacheHits        += cache->_cacheHits.load( std::memory_order_relaxed );
+            stats.cacheMisses      += cache->_cacheMisses.load( std::memory_order_relaxed );
+            stats.largeAllocations += cache->_largeAllocations.load( std::memory_order_relaxed );
+        }
+        
+        stats.threads = this->impl->_caches.size();
+        
+        return stats;
+    }
+    
+    PoolAllocator::IMPL::IMPL():
+        _destroyed( false ),
+        _retired{}
+    {}
+    
+    PoolAllocator::IMPL::~IMPL()
+    {
+        this->releaseSlabs();
+    }
+    
+    /*
+     * Called when the allocator is destroyed.
+     * Caches of threads that are still running only keep this object alive, not the slabs, and are dropped on their next lookup.
+     */
+    void PoolAllocator::IMPL::releaseSlabs()
+    {
+        std::lock_guard< std::mutex > l( this->_mutex );
+        
+        for( ThreadCache * cache: this->_caches )
+        {
+            for( size_t i = 0; i < classCount; i++ )
+            {
+                cache->_lists[ i ] = {};
+            }
+        }
+        
+        for( size_t i = 0; i < classCount; i++ )
+        {
+            this->_lists[ i ] = {};
+        }
+        
+        for( void * slab: this->_slabs )
+        {
+            free( slab );
+        }
+        
+        this->_slabs.clear();
+        this->_destroyed.store( true, std::memory_order_release );
+    }
+    
+    PoolAllocator::IMPL::ThreadCache * PoolAllocator::IMPL::cache()
+    {
+        /* Memory may still be released by other thread-local destructors */
+        if( threadCachesDestroyed )
+        {
+            return nullptr;
+        }
+        
+        ThreadCaches & caches = threadCaches;
+        
+        /* A cache keeps its pool alive, so the address cannot be re-used while it is registered */
+        if( caches._last != nullptr && caches._last->_pool.get() == this )
+        {
+            return caches._last;
+        }
+        
+        caches._caches.erase
+        (
+            std::remove_if
+            (
+                caches._caches.begin(),
+                caches._caches.end(),
+                [ & ]( const std::unique_ptr< ThreadCache > & cache )
+                {
+                    return cache->_pool->_destroyed.load( std::memory_order_acquire );
+                }
+            ),
+            caches._caches.end()
+        );
+        
+        caches._last = nullptr;
+        
+        for( const auto & cache: caches._caches )
+        {
+            if( cache->_pool.get() == this )
+            {
+                caches._last = cache.get();
+                
+                return caches._last;
+            }
+        }
+        
+        caches._caches.push_back( std::make_unique< ThreadCache >( this->shared_from_this() ) );
+        
+        caches._last = caches._caches.back().get();
+        
+        return caches._last;
+    }
+    
+    bool PoolAllocator::IMPL::grow( size_t sizeClass )
+    {
+        size_t    blockSize = classSize( sizeClass ) + headerSize;
+        size_t    count     = std::max< size_t >( slabSize / blockSize, 1 );
+        uint8_t * slab      = static_cast< uint8_t * >( malloc( count * blockSize ) );
+        
+        if( slab == nullptr )
+        {
+            return false;
+        }
+        
+        this->_slabs.push_back( slab );
+        
+        this->_retired.bytesReserved += count * blockSize;
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            this->_lists[ sizeClass ].push( reinterpret_cast< Block * >( slab + ( i * blockSize ) ) );
+        }
+        
+        return true;
+    }
+    
+    void PoolAllocator::IMPL::refill( size_t sizeClass, FreeList & list )
+    {
+        std::lock_guard< std::mutex > l( this->_mutex );
+        
+        for( size_t i = 0; i < batchSize( sizeClass ); i++ )
+        {
+            if( this->_lists[ sizeClass ].head == nullptr && this->grow( sizeClass ) == false )
+            {
+                break;
+            }
+            
+            list.push( this->_lists[ sizeClass ].pop() );
+        }
+    }
+    
+    void PoolAllocator::IMPL::release( size_t sizeClass, FreeList & list, size_t count )
+    {
+        std::lock_guard< std::mutex > l( this->_mutex );
+        
+        for( size_t i = 0; i < count && list.head != nullptr; i++ )
+        {
+            this->_lists[ sizeClass ].push( list.pop() );
+        }
+    }
+    
+    void * PoolAllocator::IMPL::allocateShared( uint32_t sizeClass, size_t size )
+    {
+        std::lock_guard< std::mutex > l( this->_mutex );
+        
+        if( this->_lists[ sizeClass ].head == nullptr && this->grow( sizeClass ) == false )
+        {
+            return nullptr;
+        }
+        
+        this->_retired.allocations++;
+        this->_retired.cacheMisses++;
+        
+        return payloadOf( this->_lists[ sizeClass ].pop(), sizeClass, size );
+    }
+    
+    void PoolAllocator::IMPL::deallocateShared( void * p )
+    {
+        std::lock_guard< std::mutex > l( this->_mutex );
+        
+        Header * header = headerOf( p );
+        
+        this->_lists[ header->sizeClass ].push( reinterpret_cast< Block * >( header ) );
+        
+        this->_retired.deallocations++;
+    }
+    
+    PoolAllocator::IMPL::ThreadCache::ThreadCache( std::shared_ptr< IMPL > pool ):
+        _pool( pool ),
+        _allocations( 0 ),
+        _deallocations( 0 ),
+        _cacheHits( 0 ),
+        _cacheMisses( 0 ),
+        _largeAllocations( 0 )
+    {
+        std::lock_guard< std::mutex > l( this->_pool->_mutex );
+        
+        this->_pool->_caches.push_back( this );
+    }
+    
+    PoolAllocator::IMPL::ThreadCache::~ThreadCache()
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_pool->_mutex );
+            
+            for( size_t i = 0; i < classCount; i++ )
+            {
+                while( this->_lists[ i ].head != nullptr )
+                {
+                    this->_pool->_lists[ i ].push( this->_lists[ i ].pop() );
+                }
+            }
+            
+            this->_pool->_retired.allocations      += this->_allocations.load( std::memory_order_relaxed );
+            this->_pool->_retired.deallocations    += this->_deallocations.load( std::memory_order_relaxed );
+            this->_pool->_retired.cacheHits        += this->_cacheHits.load( std::memory_order_relaxed );
+            this->_pool->_retired.cacheMisses      += this->_cacheMisses.load( std::memory_order_relaxed );
+            this->_pool->_retired.largeAllocations += this->_largeAllocations.load( std::memory_order_relaxed );
+            
+            this->_pool->_caches.erase( std::find( this->_pool->_caches.begin(), this->_pool->_caches.end(), this ) );
+        }
+        
+        /* May destroy the pool, so only once the lock is released */
+        this->_pool.reset();
+    }
+    
+    PoolAllocator::IMPL::ThreadCaches::~ThreadCaches()
+    {
+        threadCachesDestroyed = true;
+    }
+}
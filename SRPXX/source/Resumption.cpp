@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/Resumption.hpp>
+#include <SRPXX/HMAC.hpp>
+#include <SRPXX/SHA1.hpp>
+#include <SRPXX/SHA224.hpp>
+#include <SRPXX/SHA256.hpp>
+#include <SRPXX/SHA384.hpp>
+#include <SRPXX/SHA512.hpp>
+#include <SRPXX/Random.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <stdexcept>
+#include <string>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/crypto.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    namespace
+    {
+        /* HMAC( key, label || clientNonce || serverNonce ) */
+        template< typename Hash >
+        SecureBytes mac( const uint8_t * key, size_t keyLength, const std::string & label, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce )
+        {
+            HMAC< Hash > context( key, keyLength );
+            SecureBytes  out( Hash::digestSize, 0, SecureArena::shared() );
+            
+            context.begin();
+            context.update( reinterpret_cast< const uint8_t * >( label.data() ), label.size() );
+            context.update( clientNonce.data(), clientNonce.size() );
+            context.update( serverNonce.data(), serverNonce.size() );
+            context.finalize( out.data() );
+            
+            return out;
+        }
+        
+        SecureBytes hmac( HashAlgorithm hashAlgorithm, const uint8_t * key, size_t keyLength, const std::string & label, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce )
+        {
+            switch( hashAlgorithm )
+            {
+                case HashAlgorithm::SHA1:   return mac< SHA1   >( key, keyLength, label, clientNonce, serverNonce );
+                case HashAlgorithm::SHA224: return mac< SHA224 >( key, keyLength, label, clientNonce, serverNonce );
+                case HashAlgorithm::SHA256: return mac< SHA256 >( key, keyLength, label, clientNonce, serverNonce );
+                case HashAlgorithm::SHA384: return mac< SHA384 >( key, keyLength, label, clientNonce, serverNonce );
+                case HashAlgorithm::SHA512: return mac< SHA512 >( key, keyLength, label, clientNonce, serverNonce );
+            }
+            
+            throw std::runtime_error( "Unsupported hash algorithm" );
+        }
+        
+        bool equals( const SecureBytes & expected, const std::vector< uint8_t > & value )
+        {
+            return expected.size() == value.size() && CRYPTO_memcmp( expected.data(), value.data(), value.size() ) == 0;
+        }
+    }
+    
+    class Resumption::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce );
+            ~IMPL();
+            
+            std::string _identity;
+            SecureBytes _clientProof;
+            SecureBytes _serverProof;
+            SecureBytes _K;
+    };
+    
+    std::vector< uint8_t > Resumption::secret( const Base & session )
+    {
+        std::vector< uint8_t > K = session.K();
+        
+        if( K.empty() )
+        {
+            return {};
+        }
+        
+        std::vector< uint8_t > secret = Resumption::secret( session.hashAlgorithm(), K );
+        
+        SecureArena::wipe( K.data(), K.size() );
+        
+        return secret;
+    }
+    
+    std::vector< uint8_t > Resumption::secret( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K )
+    {
+        SecureBytes secret = hmac( hashAlgorithm, K.data(), K.size(), "SRPXX resumption", {}, {} );
+        
+        return { secret.begin(), secret.end() };
+    }
+    
+    std::vector< uint8_t > Resumption::nonce()
+    {
+        return Random::bytes( Resumption::nonceLength );
+    }
+    
+    Resumption::Resumption( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce ):
+        Resumption( {}, hashAlgorithm, secret, clientNonce, serverNonce )
+    {}
+    
+    Resumption::Resumption( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce ):
+        impl( std::make_unique< IMPL >( identity, hashAlgorithm, secret, clientNonce, serverNonce ) )
+    {}
+    
+    Resumption::~Resumption()
+    {}
+    
+    Resumption::Resumption( Resumption && o ) noexcept = default;
+    
+    Resumption & Resumption::operator =( Resumption && o ) noexcept = default;
+    
+    std::vector< uint8_t > Resumption::clientProof() const
+    {
+        return { this->impl->_clientProof.begin(), this->impl->_clientProof.end() };
+    }
+    
+    std::vector< uint8_t > Resumption::serverProof() const
+    {
+        return { this->impl->_serverProof.begin(), this->impl->_serverProof.end() };
+    }
+    
+    bool Resumption::verifyClientProof( const std::vector< uint8_t > & proof ) const
+    {
+        return equals( this->impl->_clientProof, proof );
+    }
+    
+    bool Resumption::verifyServerProof( const std::vector< uint8_t > & proof ) const
+    {
+        return equals( this->impl->_serverProof, proof );
+    }
+    
+    std::vector< uint8_t > Resumption::K() const
+    {
+        return { this->impl->_K.begin(), this->impl->_K.end() };
+    }
+    
+    std::string Resumption::identity() const
+    {
+        return this->impl->_identity;
+    }
+    
+    Resumption::IMPL::IMPL( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & secret, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce ):
+        _identity( identity ),
+        _clientProof( SecureArena::shared() ),
+        _serverProof( SecureArena::shared() ),
+        _K( SecureArena::shared() )
+    {
+        if( clientNonce.size() != Resumption::nonceLength || serverNonce.size() != Resumption::nonceLength )
+        {
+            throw std::runtime_error( "Invalid resumption nonce" );
+        }
+        
+        this->_clientProof = hmac( hashAlgorithm, secret.data(), secret.size(), "SRPXX client", clientNonce, serverNonce );
+        this->_serverProof = hmac( hashAlgorithm, secret.data(), secret.size(), "SRPXX server", clientNonce, serverNonce );
+        this->_K           = hmac( hashAlgorithm, secret.data(), secret.size(), "SRPXX key",    clientNonce, serverNonce );
+    }
+    
+    Resumption::IMPL::~IMPL()
+    {}
+}
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/ResumptionStore.hpp>
+#include <SRPXX/Random.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace SRP
+{
+    class ResumptionStore::IMPL
+    {
+        public:
+            
+            struct Ticket
+            {
+                std::string       identity;
+                HashAlgorithm     hashAlgorithm;
+                SecureBytes       secret;
+                Clock::time_point expiry;
+                uint32_t          uses;
+            };
+            
+            IMPL( Clock::duration ttl, uint32_t maxUses );
+            ~IMPL();
+            
+            Clock::duration                          _ttl;
+            uint32_t                                 _maxUses;
+            mutable std::mutex                       _mutex;
+            std::unordered_map< uint64_t, Ticket >   _tickets;
+    };
+    
+    ResumptionStore::ResumptionStore( Clock::duration ttl, uint32_t maxUses ):
+        impl( std::make_unique< IMPL >( ttl, maxUses ) )
+    {}
+    
+    ResumptionStore::~ResumptionStore()
+    {}
+    
+    uint64_t ResumptionStore::issue( const Base & session )
+    {
+        std::vector< uint8_t > K = session.K();
+        
+        if( K.empty() )
+        {
+            throw std::runtime_error( "Session has no key" );
+        }
+        
+        uint64_t id = this->issue( session.identity(), session.hashAlgorithm(), K );
+        
+        SecureArena::wipe( K.data(), K.size() );
+        
+        return id;
+    }
+    
+    uint64_t ResumptionStore::issue( HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K )
+    {
+        return this->issue( {}, hashAlgorithm, K );
+    }
+    
+    uint64_t ResumptionStore::issue( const std::string & identity, HashAlgorithm hashAlgorithm, const std::vector< uint8_t > & K )
+    {
+        std::vector< uint8_t > secret = Resumption::secret( hashAlgorithm, K );
+        IMPL::Ticket           ticket { identity, hashAlgorithm, SecureBytes( secret.begin(), secret.end(), SecureArena::shared() ), Clock::now() + this->impl->_ttl, this->impl->_maxUses };
+        uint64_t               id     = 0;
+        
+        SecureArena::wipe( secret.data(), secret.size() );
+        
+        std::lock_guard< std::mutex > lock( this->impl->_mutex );
+        
+        while( id == 0 || this->impl->_tickets.count( id ) != 0 )
+        {
+            std::vector< uint8_t > bytes = Random::bytes( sizeof( id ) );
+            
+            memcpy( &id, bytes.data(), sizeof( id ) );
+        }
+        
+        this->impl->_tickets.emplace( id, std::move( ticket ) );
+        
+        return id;
+    }
+    
+    std::optional< Resumption > ResumptionStore::redeem( uint64_t id, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce, const std::vector< uint8_t > & clientProof )
+    {
+        return this->redeem( id, clientNonce, serverNonce, clientProof, Clock::now() );
+    }
+    
+    std::optional< Resumption > ResumptionStore::redeem( uint64_t id, const std::vector< uint8_t > & clientNonce, const std::vector< uint8_t > & serverNonce, const std::vector< uint8_t > & clientProof, Clock::time_point now )
+    {
+        std::lock_guard< std::mutex > lock( this->impl->_mutex );
+        
+        auto it = this->impl->_tickets.find( id );
+        
+        if( it == this->impl->_tickets.end() )
+        {
+            return {};
+        }
+        
+        if( it->second.expiry <= now )
+        {
+            this->impl->_tickets.erase( it );
+            
+            return {};
+        }
+        
+        std::vector< uint8_t > secret( it->second.secret.begin(), it->second.secret.end() );
+        Resumption             resumption( it->second.identity, it->second.hashAlgorithm, secret, clientNonce, serverNonce );
+        
+        SecureArena::wipe( secret.data(), secret.size() );
+        
+        /* Checked first, so a wrong proof does not use up the ticket */
+        if( resumption.verifyClientProof( clientProof ) == false )
+        {
+            return {};
+        }
+        
+        if( --( it->second.uses ) == 0 )
+        {
+            this->impl->_tickets.erase( it );
+        }
+        
+        return resumption;
+    }
+    
+    bool ResumptionStore::revoke( uint64_t id )
+    {
+        std::lock_guard< std::mutex > lock( this->impl->_mutex );
+        
+        return this->impl->_tickets.erase( id ) != 0;
+    }
+    
+    size_t ResumptionStore::size() const
+    {
+        std::lock_guard< std::mutex > lock( this->impl->_mutex );
+        
+        return this->impl->_tickets.size();
+    }
+    
+    size_t ResumptionStore::expire()
+    {
+        return this->expire( Clock::now() );
+    }
+    
+    size_t ResumptionStore::expire( Clock::time_point now )
+    {
+        std::lock_guard< std::mutex > lock( this->impl->_mutex );
+        
+        size_t expired = 0;
+        
+        for( auto it = this->impl->_tickets.begin(); it != this->impl->_tickets.end(); )
+        {
+            if( it->second.expiry <= now )
+            {
+                it = this->impl->_tickets.erase( it );
+                
+                expired++;
+            }
+            else
+            {
+                it++;
+            }
+        }
+        
+        return expired;
+    }
+    
+    ResumptionStore::IMPL::IMPL( Clock::duration ttl, uint32_t maxUses ):
+        _ttl( ttl ),
+        _maxUses( maxUses )
+    {
+        if( maxUses == 0 )
+        {
+            throw std::runtime_error( "Resumption tickets need at least one use" );
+        }
+    }
+    
+    ResumptionStore::IMPL::~IMPL()
+    {}
+}
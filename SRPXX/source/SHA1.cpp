@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include <SRPXX/SHA1.hpp>
+#include <SRPXX/SecureArena.hpp>
 #include <openssl/sha.h>
 
 namespace SRP
@@ -81,6 +82,17 @@ namespace SRP
     SHA1::~SHA1()
     {}
     
+    SHA1::SHA1( const SHA1 & o ):
+        impl( std::make_unique< IMPL >( *( o.impl ) ) )
+    {}
+    
+    SHA1 & SHA1::operator =( const SHA1 & o )
+    {
+        *( this->impl ) = *( o.impl );
+        
+        return *this;
+    }
+    
     bool SHA1::update( const std::vector< uint8_t > & data )
     {
         return this->update( data.data(), data.size() );
@@ -118,6 +130,18 @@ namespace SRP
         return false;
     }
     
+    bool SHA1::finalize( uint8_t * hash )
+    {
+        if( this->finalize() == false )
+        {
+            return false;
+        }
+        
+        memcpy( hash, this->impl->_hash, sizeof( this->impl->_hash ) );
+        
+        return true;
+    }
+    
     std::vector< uint8_t > SHA1::bytes() const
     {
         if( this->impl->_finalized == false )
@@ -145,5 +169,8 @@ namespace SRP
     }
     
     SHA1::IMPL::~IMPL()
-    {}
+    {
+        SecureArena::wipe( &( this->_context ), sizeof( this->_context ) );
+        SecureArena::wipe( this->_hash,         sizeof( this->_hash ) );
+    }
 }
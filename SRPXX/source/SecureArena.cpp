@@ -0,0 +1,461 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/crypto.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr size_t   headerSize   = 16;
+        constexpr size_t   minClassSize = 16;
+        constexpr size_t   classCount   = 9;
+        constexpr uint32_t largeClass   = 0xFFFFFFFF;
+        constexpr uint32_t headerMagic  = 0x53525053;
+        
+        struct Header
+        {
+            uint32_t sizeClass;
+            uint32_t magic;
+            uint64_t size;
+        };
+        
+        static_assert( sizeof( Header ) == headerSize, "Header must keep payloads aligned" );
+        
+        struct Block
+        {
+            Block * next;
+        };
+        
+        struct Region
+        {
+            uint8_t * base;
+            size_t    size;
+            uint8_t * begin;
+            size_t    usable;
+            bool      locked;
+        };
+        
+        size_t classSize( size_t sizeClass )
+        {
+            return minClassSize << sizeClass;
+        }
+        
+        uint32_t classFor( size_t size )
+        {
+            uint32_t sizeClass = 0;
+            
+            while( classSize( sizeClass ) < size )
+            {
+                sizeClass++;
+            }
+            
+            return sizeClass;
+        }
+        
+        size_t pageSize()
+        {
+            #ifdef _WIN32
+            SYSTEM_INFO info;
+            
+            GetSystemInfo( &info );
+            
+            return static_cast< size_t >( info.dwPageSize );
+            #else
+            return static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+            #endif
+        }
+        
+        Header * headerOf( const void * p )
+        {
+            return reinterpret_cast< Header * >( const_cast< uint8_t * >( static_cast< const uint8_t * >( p ) ) - headerSize );
+        }
+        
+        /* Usable pages are locked when possible, with a guard page on each side */
+        bool mapRegion( size_t size, Region & region )
+        {
+            size_t page   = pageSize();
+            size_t usable = ( ( size + page - 1 ) / page ) * page;
+            size_t total  = usable + ( page * 2 );
+            
+            #ifdef _WIN32
+            
+            void * base = VirtualAlloc( nullptr, total, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+            DWORD  old  = 0;
+            
+            if( base == nullptr )
+            {
+                return false;
+            }
+            
+            region.base   = static_cast< uint8_t * >( base );
+            region.begin  = region.base + page;
+            region.locked = VirtualLock( region.begin, usable ) != 0;
+            
+            VirtualProtect( region.base,           page, PAGE_NOACCESS, &old );
+            VirtualProtect( region.begin + usable, page, PAGE_NOACCESS, &old );
+            
+            #else
+            
+            void * base = mmap( nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 );
+            
+            if( base == MAP_FAILED )
+            {
+                return false;
+            }
+            
+            region.base   = static_cast< uint8_t * >( base );
+            region.begin  = region.base + page;
+            region.locked = mlock( region.begin, usable ) == 0;
+            
+            mprotect( region.base,           page, PROT_NONE );
+            mprotect( region.begin + usable, page, PROT_NONE );
+            
+            #ifdef MADV_DONTDUMP
+            madvise( region.begin, usable, MADV_DONTDUMP );
+            #endif
+            
+            #endif
+            
+            region.size   = total;
+            region.usable = usable;
+            
+            return true;
+        }
+        
+        void unmapRegion( const Region & region )
+        {
+            OPENSSL_cleanse( region.begin, region.usable );
+            
+            #ifdef _WIN32
+            
+            if( region.locked )
+            {
+                VirtualUnlock( region.begin, region.usable );
+            }
+            
+            VirtualFree( region.base, 0, MEM_RELEASE );
+            
+            #else
+            
+            if( region.locked )
+            {
+                munlock( region.begin, region.usable );
+            }
+            
+            munmap( region.base, region.size );
+            
+            #endif
+        }
+    }
+    
+    class SecureArena::IMPL
+    {
+        public:
+            
+            IMPL( size_t regionSize );
+            ~IMPL();
+            
+            void * allocateBlock( size_t size );
+            void * allocateLarge( size_t size );
+            void   track( const Region & region );
+            
+            size_t                      _regionSize;
+            mutable std::mutex          _mutex;
+            std::vector< Region >       _regions;
+            std::map< void *, Region >  _large;
+            uint8_t                   * _cursor;
+            uint8_t                   * _end;
+            Block                     * _lists[ classCount ];
+            Stats                       _stats;
+    };
+    
+    SecureArena & SecureArena::shared()
+    {
+        /* Never destroyed, as secrets may still be released during static destruction */
+        static SecureArena * arena = new SecureArena();
+        
+        return *( arena );
+    }
+    
+    void SecureArena::wipe( void * p, size_t size )
+    {
+        if( p != nullptr && size > 0 )
+        {
+            OPENSSL_cleanse( p, size );
+        }
+    }
+    
+    SecureArena::SecureArena( size_t regionSize ):
+        impl( std::make_unique< IMPL >( regionSize ) )
+    {}
+    
+    SecureArena::~SecureArena()
+    {}
+    
+    void * SecureArena::allocate( size_t size )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        void * p = ( size > classSize( classCount - 1 ) ) ? this->impl->allocateLarge( size ) : this->impl->allocateBlock( size );
+        
+        if( p != nullptr )
+        {
+            this->impl->_stats.allocations++;
+            
+            this->impl->_stats.bytesInUse += size;
+        }
+        
+        return p;
+    }
+    
+    void * SecureArena::reallocate( void * p, size_t size )
+    {
+        if( p == nullptr )
+        {
+            return this->allocate( size );
+        }
+        
+        Header * header = headerOf( p );
+        
+        if( header->sizeClass != largeClass && size <= classSize( header->sizeClass ) )
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mutex );
+            
+            if( size < header->size )
+            {
+                OPENSSL_cleanse( static_cast< uint8_t * >( p ) + size, header->size - size );
+            }
+            
+            this->impl->_stats.bytesInUse -= header->size;
+            this->impl->_stats.bytesInUse += size;
+            
+            header->size = size;
+            
+            return p;
+        }
+        
+        void * n = this->allocate( size );
+        
+        if( n == nullptr )
+        {
+            return nullptr;
+        }
+        
+        memcpy( n, p, std::min< size_t >( size, header->size ) );
+        this->deallocate( p );
+        
+        return n;
+    }
+    
+    void SecureArena::deallocate( void * p )
+    {
+        if( p == nullptr )
+        {
+            return;
+        }
+        
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        Header * header = headerOf( p );
+        
+        this->impl->_stats.deallocations++;
+        
+        this->impl->_stats.bytesInUse -= header->size;
+        
+        if( header->sizeClass == largeClass )
+        {
+            auto it = this->impl->_large.find( header );
+            
+            if( it != this->impl->_large.end() )
+            {
+                this->impl->_stats.bytesReserved -= it->second.usable;
+                this->impl->_stats.bytesLocked   -= ( it->second.locked ) ? it->second.usable : 0;
+                this->impl->_stats.regions--;
+                
+                /* Wipes the whole region */
+                unmapRegion( it->second );
+                this->impl->_large.erase( it );
+            }
+            
+            return;
+        }
+        
+        /* Only the bytes actually handed out can hold secrets */
+        OPENSSL_cleanse( p, header->size );
+        
+        uint32_t sizeClass = header->sizeClass;
+        Block  * block     = reinterpret_cast< Block * >( header );
+        
+        block->next                     = this->impl->_lists[ sizeClass ];
+        this->impl->_lists[ sizeClass ] = block;
+    }
+    
+    bool SecureArena::owns( const void * p ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        const uint8_t * u = static_cast< const uint8_t * >( p );
+        
+        for( const Region & region: this->impl->_regions )
+        {
+            if( u >= region.begin && u < region.begin + region.usable )
+            {
+                return true;
+            }
+        }
+        
+        for( const auto & large: this->impl->_large )
+        {
+            if( u >= large.second.begin && u < large.second.begin + large.second.usable )
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    SecureArena::Stats SecureArena::stats() const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        return this->impl->_stats;
+    }
+    
+    SecureArena::IMPL::IMPL( size_t regionSize ):
+        _regionSize( std::max< size_t >( regionSize, classSize( classCount - 1 ) + headerSize ) ),
+        _cursor( nullptr ),
+        _end( nullptr ),
+        _lists{},
+        _stats{}
+    {}
+    
+    SecureArena::IMPL::~IMPL()
+    {
+        /* Bulk wipe - released blocks were already wiped individually */
+        for( const Region & region: this->_regions )
+        {
+            unmapRegion( region );
+        }
+        
+        for( const auto & large: this->_large )
+        {
+            unmapRegion( large.second );
+        }
+    }
+    
+    void * SecureArena::IMPL::allocateBlock( size_t size )
+    {
+        uint32_t sizeClass = classFor( size );
+        size_t   blockSize = classSize( sizeClass ) + headerSize;
+        void   * block     = this->_lists[ sizeClass ];
+        
+        if( block != nullptr )
+        {
+            this->_lists[ sizeClass ] = this->_lists[ sizeClass ]->next;
+        }
+        else
+        {
+            if( this->_cursor == nullptr || this->_cursor + blockSize > this->_end )
+            {
+                Region region;
+                
+                if( mapRegion( this->_regionSize, region ) == false )
+                {
+                    return nullptr;
+                }
+                
+                this->track( region );
+                this->_regions.push_back( region );
+                
+                this->_cursor = region.begin;
+                this->_end    = region.begin + region.usable;
+            }
+            
+            block          = this->_cursor;
+            this->_cursor += blockSize;
+        }
+        
+        Header * header = static_cast< Header * >( block );
+        
+        header->sizeClass = sizeClass;
+        header->magic     = headerMagic;
+        header->size      = size;
+        
+        return static_cast< uint8_t * >( block ) + headerSize;
+    }
+    
+    void * SecureArena::IMPL::allocateLarge( size_t size )
+    {
+        Region region;
+        
+        if( mapRegion( size + headerSize, region ) == false )
+        {
+            return nullptr;
+        }
+        
+        this->track( region );
+        
+        this->_large[ region.begin ] = region;
+        
+        Header * header = reinterpret_cast< Header * >( region.begin );
+        
+        header->sizeClass = largeClass;
+        header->magic     = headerMagic;
+        header->size      = size;
+        
+        return region.begin + headerSize;
+    }
+    
+    void SecureArena::IMPL::track( const Region & region )
+    {
+        this->_stats.regions++;
+        
+        this->_stats.bytesReserved += region.usable;
+        this->_stats.bytesLocked   += ( region.locked ) ? region.usable : 0;
+    }
+}
@@ -0,0 +1,281 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/SecureChannel.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include "AEAD.hpp"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace SRP
+{
+    namespace
+    {
+        void storeLE( uint8_t * p, uint32_t value )
+        {
+            for( size_t i = 0; i < 4; i++ )
+            {
+                p[ i ] = static_cast< uint8_t >( value >> ( 8 * i ) );
+            }
+        }
+        
+        uint32_t loadLE( const uint8_t * p )
+        {
+            uint32_t value = 0;
+            
+            for( size_t i = 0; i < 4; i++ )
+            {
+                value |= static_cast< uint32_t >( p[ i ] ) << ( 8 * i );
+            }
+            
+            return value;
+        }
+    }
+    
+    class SecureChannel::IMPL
+    {
+        public:
+            
+            IMPL( AEAD::Cipher cipher, const uint8_t * sendKey, const uint8_t * receiveKey, const uint8_t * sendNonce, const uint8_t * receiveNonce );
+            ~IMPL();
+            
+            /* Direction nonce xor the big-endian record number */
+            static void nonce( const uint8_t * base, uint64_t record, uint8_t * nonce );
+            
+            AEAD::Context _send;
+            AEAD::Context _receive;
+            uint8_t       _sendNonce[ AEAD::nonceLength ];
+            uint8_t       _receiveNonce[ AEAD::nonceLength ];
+            uint64_t      _sent;
+            uint64_t      _received;
+    };
+    
+    SecureChannel::SecureChannel( const Client & session, Cipher cipher ):
+        SecureChannel( session, true, 0, cipher )
+    {}
+    
+    SecureChannel::SecureChannel( const Server & session, Cipher cipher ):
+        SecureChannel( session, false, 0, cipher )
+    {}
+    
+    SecureChannel::SecureChannel( const Client & session, uint64_t channel, Cipher cipher ):
+        SecureChannel( session, true, channel, cipher )
+    {}
+    
+    SecureChannel::SecureChannel( const Server & session, uint64_t channel, Cipher cipher ):
+        SecureChannel( session, false, channel, cipher )
+    {}
+    
+    SecureChannel::SecureChannel( const Base & session, bool client, uint64_t channel, Cipher cipher )
+    {
+        uint8_t      keys[ 2 * ( AEAD::keyLength + AEAD::nonceLength ) ];
+        uint8_t    * clientKey   = keys;
+        uint8_t    * serverKey   = clientKey + AEAD::keyLength;
+        uint8_t    * clientNonce = serverKey + AEAD::keyLength;
+        uint8_t    * serverNonce = clientNonce + AEAD::nonceLength;
+        AEAD::Cipher aead        = ( cipher == Cipher::AES256GCM ) ? AEAD::Cipher::AES256GCM : AEAD::Cipher::ChaCha20Poly1305;
+        
+        /* Channel 0 keeps the original labels */
+        std::string suffix = ( channel == 0 ) ? std::string() : " " + std::to_string( channel );
+        
+        session.deriveKeys
+        (
+            {
+                { "SRPXX client key"   + suffix, clientKey,   AEAD::keyLength },
+                { "SRPXX server key"   + suffix, serverKey,   AEAD::keyLength },
+                { "SRPXX client nonce" + suffix, clientNonce, AEAD::nonceLength },
+                { "SRPXX server nonce" + suffix, serverNonce, AEAD::nonceLength }
+            }
+        );
+        
+        try
+        {
+            if( client )
+            {
+                this->impl = std::make_unique< IMPL >( aead, clientKey, serverKey, clientNonce, serverNonce );
+            }
+            else
+            {
+                this->impl = std::make_unique< IMPL >( aead, serverKey, clientKey, serverNonce, clientNonce );
+            }
+        }
+        catch( ... )
+        {
+            SecureArena::wipe( keys, sizeof( keys ) );
+            
+            throw;
+        }
+        
+        SecureArena::wipe( keys, sizeof( keys ) );
+    }
+    
+    SecureChannel::~SecureChannel()
+    {}
+    
+    SecureChannel::SecureChannel( SecureChannel && o ) noexcept = default;
+    
+    SecureChannel & SecureChannel::operator =( SecureChannel && o ) noexcept = default;
+    
+    void SecureChannel::seal( uint8_t * data, size_t length, uint8_t * tag )
+    {
+        uint8_t nonce[ AEAD::nonceLength ];
+        
+        if( this->impl->_sent == std::numeric_limits< uint64_t >::max() )
+        {
+            throw std::runtime_error( "Record numbers exhausted" );
+        }
+        
+        IMPL::nonce( this->impl->_sendNonce, this->impl->_sent, nonce );
+        
+        if( this->impl->_send.seal( nonce, nullptr, 0, data, length, tag ) == false )
+        {
+            throw std::runtime_error( "Cannot seal record" );
+        }
+        
+        this->impl->_sent++;
+    }
+    
+    bool SecureChannel::open( uint8_t * data, size_t length, const uint8_t * tag )
+    {
+        uint8_t nonce[ AEAD::nonceLength ];
+        
+        IMPL::nonce( this->impl->_receiveNonce, this->impl->_received, nonce );
+        
+        if( this->impl->_receive.open( nonce, nullptr, 0, data, length, tag ) == false )
+        {
+            return false;
+        }
+        
+        this->impl->_received++;
+        
+        return true;
+    }
+    
+    size_t SecureChannel::batchLength( const std::vector< Message > & messages )
+    {
+        size_t length = tagLength;
+        
+        for( const auto & message: messages )
+        {
+            length += frameLength + message.length;
+        }
+        
+        return length;
+    }
+    
+    size_t SecureChannel::seal( const std::vector< Message > & messages, uint8_t * record, size_t capacity )
+    {
+        size_t    length = SecureChannel::batchLength( messages );
+        uint8_t * p      = record;
+        
+        if( length > capacity )
+        {
+            return 0;
+        }
+        
+        for( const auto & message: messages )
+        {
+            if( message.length > std::numeric_limits< uint32_t >::max() )
+            {
+                throw std::runtime_error( "Message is too long" );
+            }
+            
+            storeLE( p, static_cast< uint32_t >( message.length ) );
+            memcpy( p + frameLength, message.data, message.length );
+            
+            p += frameLength + message.length;
+        }
+        
+        this->seal( record, length - tagLength, p );
+        
+        return length;
+    }
+    
+    bool SecureChannel::open( uint8_t * record, size_t length, std::vector< Message > & messages )
+    {
+        messages.clear();
+        
+        if( length < tagLength || this->open( record, length - tagLength, record + length - tagLength ) == false )
+        {
+            return false;
+        }
+        
+        const uint8_t * p   = record;
+        const uint8_t * end = record + length - tagLength;
+        
+        while( p != end )
+        {
+            if( static_cast< size_t >( end - p ) < frameLength || static_cast< size_t >( end - p ) - frameLength < loadLE( p ) )
+            {
+                messages.clear();
+                
+                return false;
+            }
+            
+            messages.push_back( { p + frameLength, loadLE( p ) } );
+            
+            p += frameLength + messages.back().length;
+        }
+        
+        return true;
+    }
+    
+    uint64_t SecureChannel::sent() const
+    {
+        return this->impl->_sent;
+    }
+    
+    uint64_t SecureChannel::received() const
+    {
+        return this->impl->_received;
+    }
+    
+    SecureChannel::IMPL::IMPL( AEAD::Cipher cipher, const uint8_t * sendKey, const uint8_t * receiveKey, const uint8_t * sendNonce, const uint8_t * receiveNonce ):
+        _send( cipher, sendKey ),
+        _receive( cipher, receiveKey ),
+        _sent( 0 ),
+        _received( 0 )
+    {
+        memcpy( this->_sendNonce,    sendNonce,    sizeof( this->_sendNonce ) );
+        memcpy( this->_receiveNonce, receiveNonce, sizeof( this->_receiveNonce ) );
+    }
+    
+    SecureChannel::IMPL::~IMPL()
+    {
+        SecureArena::wipe( this->_sendNonce,    sizeof( this->_sendNonce ) );
+        SecureArena::wipe( this->_receiveNonce, sizeof( this->_receiveNonce ) );
+    }
+    
+    void SecureChannel::IMPL::nonce( const uint8_t * base, uint64_t record, uint8_t * nonce )
+    {
+        memcpy( nonce, base, AEAD::nonceLength );
+        
+        for( size_t i = 0; i < 8; i++ )
+        {
+            nonce[ AEAD::nonceLength - 1 - i ] = static_cast< uint8_t >( nonce[ AEAD::nonceLength - 1 - i ] ^ ( record >> ( 8 * i ) ) );
+        }
+    }
+}
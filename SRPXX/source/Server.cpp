@@ -23,9 +23,80 @@
  ******************************************************************************/
 
 #include <SRPXX/Server.hpp>
+#include <SRPXX/HMACDRBG.hpp>
+#include <SRPXX/Random.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <SRPXX/VerifierCache.hpp>
+#include "AEAD.hpp"
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include <openssl/crypto.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+/*
+ * Tickets, all integers little-endian:
+ * 
+ *   version u8, key id u32, nonce[ 12 ], sealed fields, tag[ 16 ]
+ * 
+ * Sealed fields, with the version and key id as associated data:
+ * 
+ *   expiry u64 (seconds since the epoch), ticket id[ 16 ], hash algorithm u8,
+ *   group type u8, then identity, salt, b, A and v, each as a u16 length
+ *   followed by the bytes
+ */
 
 namespace SRP
 {
+    namespace
+    {
+        constexpr uint8_t ticketVersion  = 2;
+        constexpr size_t  ticketHeader   = 5;
+        constexpr size_t  ticketIDLength = 16;
+        constexpr size_t  ticketFixed    = 36;
+        
+        uint64_t loadLE( const uint8_t * p, size_t size )
+        {
+            uint64_t value = 0;
+            
+            for( size_t i = 0; i < size; i++ )
+            {
+                value |= static_cast< uint64_t >( p[ i ] ) << ( i * 8 );
+            }
+            
+            return value;
+        }
+        
+        void appendLE( std::vector< uint8_t > & data, uint64_t value, size_t size )
+        {
+            for( size_t i = 0; i < size; i++ )
+            {
+                data.push_back( static_cast< uint8_t >( value >> ( i * 8 ) ) );
+            }
+        }
+        
+        void appendField( std::vector< uint8_t > & data, const uint8_t * field, size_t size )
+        {
+            if( size > 0xFFFF )
+            {
+                throw std::runtime_error( "Ticket field is too long" );
+            }
+            
+            appendLE( data, size, 2 );
+            data.insert( data.end(), field, field + size );
+        }
+    }
+    
     class Server::IMPL
     {
         public:
@@ -33,11 +104,65 @@ namespace SRP
             IMPL( const BigNum & b );
             ~IMPL();
             
-            BigNum _v;
-            BigNum _b;
-            BigNum _A;
+            BigNum                                       _v;
+            BigNum                                       _b;
+            BigNum                                       _A;
+            std::shared_ptr< const PrecomputedVerifier > _precomputed;
     };
     
+    class Server::TicketCache::IMPL
+    {
+        public:
+            
+            IMPL( size_t capacity );
+            ~IMPL();
+            
+            using Expiry = std::pair< int64_t, std::string >;
+            
+            mutable std::mutex                                                           _mutex;
+            size_t                                                                       _capacity;
+            std::unordered_set< std::string >                                            _ids;
+            std::priority_queue< Expiry, std::vector< Expiry >, std::greater< Expiry > > _expiries;
+    };
+    
+    Server::TicketCache::TicketCache( size_t capacity ):
+        impl( std::make_unique< IMPL >( capacity ) )
+    {}
+    
+    Server::TicketCache::~TicketCache()
+    {}
+    
+    size_t Server::TicketCache::size() const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        return this->impl->_ids.size();
+    }
+    
+    bool Server::TicketCache::redeem( const uint8_t * id, int64_t expiry )
+    {
+        std::string                   key( reinterpret_cast< const char * >( id ), ticketIDLength );
+        int64_t                       now = std::chrono::duration_cast< std::chrono::seconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        /* Expired tickets are refused anyway, so their IDs are no longer needed */
+        while( this->impl->_expiries.empty() == false && this->impl->_expiries.top().first < now )
+        {
+            this->impl->_ids.erase( this->impl->_expiries.top().second );
+            this->impl->_expiries.pop();
+        }
+        
+        if( this->impl->_ids.count( key ) > 0 || this->impl->_ids.size() >= this->impl->_capacity )
+        {
+            return false;
+        }
+        
+        this->impl->_ids.insert( key );
+        this->impl->_expiries.push( { expiry, key } );
+        
+        return true;
+    }
+    
     Server::Server( const std::string & identity, HashAlgorithm hashAlgorithm, GroupType groupType ):
         Server( identity, hashAlgorithm, groupType, BigNum::random( 256 ) )
     {}
@@ -49,15 +174,90 @@ namespace SRP
     
     Server::~Server()
     {}
+    
+    Server::Server( Server && o ) noexcept = default;
+    
+    Server & Server::operator =( Server && o ) noexcept = default;
+    
+    void Server::reset( const std::string & identity, const std::vector< uint8_t > & salt, const BigNum & verifier )
+    {
+        this->Base::reset( identity );
+        this->setSalt( salt );
+        
+        this->impl->_v.assign( verifier );
+        this->impl->_b.randomize( 256 );
+        this->impl->_A.clear();
+        this->impl->_precomputed.reset();
+    }
+    
+    void Server::reset( const std::string & identity, const std::vector< uint8_t > & salt, const BigNum & verifier, const BigNum & b )
+    {
+        this->Base::reset( identity );
+        this->setSalt( salt );
+        
+        this->impl->_v.assign( verifier );
+        this->impl->_b.assign( b );
+        this->impl->_A.clear();
+        this->impl->_precomputed.reset();
+    }
+    
+    void Server::clear()
+    {
+        this->Base::clear();
+        
+        this->impl->_v.clear();
+        this->impl->_b.clear();
+        this->impl->_A.clear();
+        this->impl->_precomputed.reset();
+    }
             
     void Server::setV( const BigNum & value )
     {
         this->impl->_v = value;
+        
+        this->impl->_precomputed.reset();
+        this->invalidateKeys();
+    }
+    
+    void Server::setV( const BigNumView & value )
+    {
+        this->impl->_v.assign( value );
+        
+        this->impl->_precomputed.reset();
+        this->invalidateKeys();
     }
     
     void Server::setA( const BigNum & value )
     {
         this->impl->_A = value;
+        this->invalidateKeys();
+    }
+    
+    void Server::setA( const BigNumView & value )
+    {
+        this->impl->_A.assign( value );
+        this->invalidateKeys();
+    }
+    
+    void Server::setPrecomputed( std::shared_ptr< const PrecomputedVerifier > value )
+    {
+        if( value != nullptr )
+        {
+            if( value->hashAlgorithm() != this->hashAlgorithm() || value->groupType() != this->groupType() )
+            {
+                throw std::runtime_error( "Precomputed verifier does not match the server's group or hash algorithm" );
+            }
+            
+            this->impl->_v.assign( value->v() );
+        }
+        
+        this->impl->_precomputed = std::move( value );
+        this->invalidateKeys();
+    }
+    
+    std::shared_ptr< const PrecomputedVerifier > Server::precomputed() const
+    {
+        return this->impl->_precomputed;
     }
             
     BigNum Server::A() const
@@ -68,19 +268,32 @@ namespace SRP
     /* k * v + g ^ b % N */
     BigNum Server::B() const
     {
-        BigNum left  = this->k().modMul( this->v(), this->N() );
-        BigNum right = this->g().modExp( this->b(), this->N() );
+        if( this->impl->_precomputed != nullptr )
+        {
+            return this->gExp( this->impl->_b ).modAdd( this->impl->_precomputed->kv(), this->N() );
+        }
         
-        return left.modAdd( right, this->N() );
+        if( this->hasGroupTables() )
+        {
+            BigNum N = this->N();
+            
+            return this->gExp( this->impl->_b ).modAdd( this->k().modMul( this->v(), N ), N );
+        }
+        
+        return BigNum::modMulAddExp( this->k(), this->v(), this->g(), this->b(), this->N() );
     }
     
     /* ( ( A * v ^ u ) ^ b % N ) */
     BigNum Server::S() const
     {
-        BigNum tmp1 = this->v().modExp( this->u(), this->N() );
-        BigNum tmp2 = this->A() * tmp1;
+        BigNum N   = this->N();
+        BigNum tmp = ( this->impl->_precomputed != nullptr ) ? this->impl->_precomputed->powers().modExp( this->u() ) : this->v().modExp( this->u(), N );
+        
+        tmp.modMulInPlace( this->impl->_A, N );
         
-        return tmp2.modExp( this->b(), this->N() );
+        tmp.makeSecret().modExpInPlace( this->impl->_b, N );
+        
+        return tmp;
     }
     
     BigNum Server::v() const
@@ -93,10 +306,239 @@ namespace SRP
         return this->impl->_b;
     }
     
+    std::vector< uint8_t > Server::verifyM1( const std::vector< uint8_t > & M1 ) const
+    {
+        return this->verifyM1( M1.data(), M1.size() );
+    }
+    
+    std::vector< uint8_t > Server::verifyM1( const uint8_t * M1, size_t length ) const
+    {
+        std::vector< uint8_t > A = this->impl->_A.bytes( BigNum::Endianness::BigEndian );
+        
+        /* A % N == 0 gives S == 0, so a valid M1 could be computed without the password */
+        if( this->isValidPublicValue( BigNumView( A ) ) == false )
+        {
+            return {};
+        }
+        
+        BigNum                 S        = this->S();
+        std::vector< uint8_t > K        = this->K( S );
+        std::vector< uint8_t > expected = this->M1( K );
+        std::vector< uint8_t > M2;
+        
+        if( expected.size() == length && CRYPTO_memcmp( expected.data(), M1, length ) == 0 )
+        {
+            M2 = this->M2( expected, K );
+        }
+        
+        SecureArena::wipe( K.data(),        K.size() );
+        SecureArena::wipe( expected.data(), expected.size() );
+        
+        return M2;
+    }
+    
+    std::vector< uint8_t > Server::exportTicket( const KeyRing & keys, std::chrono::seconds lifetime ) const
+    {
+        uint8_t                key[ KeyRing::keyLength ];
+        uint32_t               id       = keys.current();
+        std::string            identity = this->identity();
+        std::vector< uint8_t > salt     = this->salt();
+        std::vector< uint8_t > b        = this->impl->_b.bytes( BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > A        = this->impl->_A.bytes( BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > v        = this->impl->_v.bytes( BigNum::Endianness::BigEndian );
+        std::vector< uint8_t > nonce    = Random::bytes( AEAD::nonceLength );
+        std::vector< uint8_t > ticketID = Random::bytes( ticketIDLength );
+        std::vector< uint8_t > ticket;
+        
+        if( keys.key( id, key ) == false )
+        {
+            throw std::runtime_error( "Unknown ticket key" );
+        }
+        
+        int64_t expiry = std::chrono::duration_cast< std::chrono::seconds >( std::chrono::system_clock::now().time_since_epoch() + lifetime ).count();
+        
+        /* Reserved upfront, so b is never left behind by a reallocation */
+        ticket.reserve( ticketHeader + AEAD::nonceLength + ticketFixed + identity.size() + salt.size() + b.size() + A.size() + v.size() + AEAD::tagLength );
+        
+        appendLE( ticket, ticketVersion, 1 );
+        appendLE( ticket, id,            4 );
+        ticket.insert( ticket.end(), nonce.begin(), nonce.end() );
+        
+        size_t start = ticket.size();
+        
+        appendLE( ticket, static_cast< uint64_t >( expiry ),                8 );
+        ticket.insert( ticket.end(), ticketID.begin(), ticketID.end() );
+        appendLE( ticket, static_cast< uint64_t >( this->hashAlgorithm() ), 1 );
+        appendLE( ticket, static_cast< uint64_t >( this->groupType() ),     1 );
+        appendField( ticket, reinterpret_cast< const uint8_t * >( identity.data() ), identity.size() );
+        appendField( ticket, salt.data(), salt.size() );
+        appendField( ticket, b.data(),    b.size() );
+        appendField( ticket, A.data(),    A.size() );
+        appendField( ticket, v.data(),    v.size() );
+        
+        size_t length = ticket.size() - start;
+        
+        ticket.resize( ticket.size() + AEAD::tagLength );
+        
+        bool sealed = AEAD::seal( key, ticket.data() + ticketHeader, ticket.data(), ticketHeader, ticket.data() + start, length, ticket.data() + start + length );
+        
+        SecureArena::wipe( key,      sizeof( key ) );
+        SecureArena::wipe( b.data(), b.size() );
+        
+        if( sealed == false )
+        {
+            throw std::runtime_error( "Cannot seal ticket" );
+        }
+        
+        return ticket;
+    }
+    
+    std::optional< Server > Server::fromTicket( const std::vector< uint8_t > & ticket, const KeyRing & keys )
+    {
+        return restore( ticket, keys, nullptr );
+    }
+    
+    std::optional< Server > Server::fromTicket( const std::vector< uint8_t > & ticket, const KeyRing & keys, TicketCache & redeemed )
+    {
+        return restore( ticket, keys, &redeemed );
+    }
+    
+    std::optional< Server > Server::restore( const std::vector< uint8_t > & ticket, const KeyRing & keys, TicketCache * redeemed )
+    {
+        uint8_t key[ KeyRing::keyLength ];
+        
+        if( ticket.size() < ticketHeader + AEAD::nonceLength + ticketFixed + AEAD::tagLength || ticket[ 0 ] != ticketVersion )
+        {
+            return {};
+        }
+        
+        if( keys.key( static_cast< uint32_t >( loadLE( ticket.data() + 1, 4 ) ), key ) == false )
+        {
+            return {};
+        }
+        
+        const uint8_t * tag    = ticket.data() + ticket.size() - AEAD::tagLength;
+        size_t          start  = ticketHeader + AEAD::nonceLength;
+        SecureBytes     plain( ticket.data() + start, tag, SecureArena::shared() );
+        bool            opened = AEAD::open( key, ticket.data() + ticketHeader, ticket.data(), ticketHeader, plain.data(), plain.size(), tag );
+        
+        SecureArena::wipe( key, sizeof( key ) );
+        
+        if( opened == false )
+        {
+            return {};
+        }
+        
+        /* Authenticated, so only sealed by exportTicket(), but still bounds-checked */
+        const uint8_t * p   = plain.data();
+        const uint8_t * end = p + plain.size();
+        int64_t         now = std::chrono::duration_cast< std::chrono::seconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+        
+        int64_t         expiry = static_cast< int64_t >( loadLE( p, 8 ) );
+        const uint8_t * id     = p + 8;
+        
+        p += 8 + ticketIDLength;
+        
+        if( expiry < now || p[ 0 ] > static_cast< uint8_t >( HashAlgorithm::SHA512 ) || p[ 1 ] > static_cast< uint8_t >( GroupType::NG8192 ) )
+        {
+            return {};
+        }
+        
+        HashAlgorithm   hashAlgorithm = static_cast< HashAlgorithm >( p[ 0 ] );
+        GroupType       groupType     = static_cast< GroupType >( p[ 1 ] );
+        const uint8_t * fields[ 5 ]   = {};
+        size_t          lengths[ 5 ]  = {};
+        
+        p += 2;
+        
+        /* Raw bytes - The salt and identity can start with zeros, which BigNumView would strip */
+        for( size_t i = 0; i < 5; i++ )
+        {
+            if( end - p < 2 || static_cast< size_t >( end - p - 2 ) < loadLE( p, 2 ) )
+            {
+                return {};
+            }
+            
+            fields[ i ]  = p + 2;
+            lengths[ i ] = static_cast< size_t >( loadLE( p, 2 ) );
+            p           += 2 + lengths[ i ];
+        }
+        
+        /* Last, so a malformed ticket does not use up its ID */
+        if( redeemed != nullptr && redeemed->redeem( id, expiry ) == false )
+        {
+            return {};
+        }
+        
+        Server server
+        (
+            std::string( reinterpret_cast< const char * >( fields[ 0 ] ), lengths[ 0 ] ),
+            hashAlgorithm,
+            groupType,
+            BigNum( BigNumView( fields[ 2 ], lengths[ 2 ] ) ).makeSecret()
+        );
+        
+        server.setSalt( fields[ 1 ], lengths[ 1 ] );
+        server.setA( BigNumView( fields[ 3 ], lengths[ 3 ] ) );
+        server.setV( BigNumView( fields[ 4 ], lengths[ 4 ] ) );
+        
+        return server;
+    }
+    
+    BigNum Server::deriveB( const KeyRing & keys, uint32_t keyID, const std::vector< uint8_t > & nonce, const std::string & identity )
+    {
+        std::vector< uint8_t > key( KeyRing::keyLength );
+        SecureBytes            b( 32, 0, SecureArena::shared() );
+        
+        if( keys.key( keyID, key.data() ) == false )
+        {
+            throw std::runtime_error( "Unknown server key" );
+        }
+        
+        std::vector< uint8_t > framedNonce;
+        std::vector< uint8_t > framedIdentity;
+        
+        /* The DRBG concatenates its inputs - Length-prefixed, so no two nonce and identity pairs share a seed */
+        appendLE( framedNonce,    nonce.size(),    8 );
+        appendLE( framedIdentity, identity.size(), 8 );
+        framedNonce.insert( framedNonce.end(), nonce.begin(), nonce.end() );
+        framedIdentity.insert( framedIdentity.end(), identity.begin(), identity.end() );
+        
+        HMACDRBG drbg( HashAlgorithm::SHA256, key, framedNonce, framedIdentity );
+        
+        SecureArena::wipe( key.data(), key.size() );
+        drbg.generate( b.data(), b.size() );
+        
+        return BigNum( BigNumView( b.data(), b.size() ) ).makeSecret();
+    }
+    
+    #ifdef SRPXX_COROUTINES
+    
+    Awaitable< BigNum > Server::computeB( Executor & executor ) const
+    {
+        return { [ this ] { return this->B(); }, executor };
+    }
+    
+    Awaitable< std::vector< uint8_t > > Server::verify( const std::vector< uint8_t > & M1, Executor & executor ) const
+    {
+        return { [ this, M1 ] { return this->verifyM1( M1 ); }, executor };
+    }
+    
+    #endif
+    
     Server::IMPL::IMPL( const BigNum & b ):
         _b( b )
-    {}
+    {
+        this->_b.makeSecret();
+    }
     
     Server::IMPL::~IMPL()
     {}
+    
+    Server::TicketCache::IMPL::IMPL( size_t capacity ):
+        _capacity( capacity )
+    {}
+    
+    Server::TicketCache::IMPL::~IMPL()
+    {}
 }
@@ -0,0 +1,578 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/SessionTable.hpp>
+#include <SRPXX/SecureArena.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr size_t   slotBits = 6;
+        constexpr size_t   slots    = static_cast< size_t >( 1 ) << slotBits;
+        constexpr size_t   levels   = 4;
+        constexpr uint64_t maxDelay = ( static_cast< uint64_t >( 1 ) << ( slotBits * levels ) ) - 1;
+        
+        /*
+         * A session without the per-group state a Server carries.
+         * Identity, salt, b, A and v share a single buffer, wiped on release.
+         * v is not kept when the session has a precomputed verifier, which holds it.
+         */
+        struct Entry
+        {
+            enum Field: size_t
+            {
+                Identity,
+                Salt,
+                B,
+                A,
+                V,
+                FieldCount
+            };
+            
+            Entry( uint64_t entryID, const Server & server );
+            ~Entry();
+            
+            Entry( const Entry & o )              = delete;
+            Entry & operator =( const Entry & o ) = delete;
+            
+            const uint8_t * field( Field f ) const;
+            Server          server()         const;
+            
+            uint64_t                                     id;
+            uint64_t                                     deadline;
+            size_t                                       slot;
+            Entry                                      * prev;
+            Entry                                      * next;
+            HashAlgorithm                                hashAlgorithm;
+            Base::GroupType                              groupType;
+            uint32_t                                     lengths[ FieldCount ];
+            std::shared_ptr< const PrecomputedVerifier > precomputed;
+            std::unique_ptr< uint8_t[] >                 data;
+        };
+        
+        Entry::Entry( uint64_t entryID, const Server & server ):
+            id( entryID ),
+            deadline( 0 ),
+            slot( 0 ),
+            prev( nullptr ),
+            next( nullptr ),
+            hashAlgorithm( server.hashAlgorithm() ),
+            groupType( server.groupType() ),
+            lengths{},
+            precomputed( server.precomputed() )
+        {
+            std::string            identity = server.identity();
+            std::vector< uint8_t > salt     = server.salt();
+            std::vector< uint8_t > b        = server.b().bytes( BigNum::Endianness::BigEndian );
+            std::vector< uint8_t > A        = server.A().bytes( BigNum::Endianness::BigEndian );
+            std::vector< uint8_t > v;
+            
+            if( this->precomputed == nullptr )
+            {
+                v = server.v().bytes( BigNum::Endianness::BigEndian );
+            }
+            
+            const uint8_t * fields[ FieldCount ] = { reinterpret_cast< const uint8_t * >( identity.data() ), salt.data(), b.data(), A.data(), v.data() };
+            size_t          sizes[ FieldCount ]  = { identity.size(), salt.size(), b.size(), A.size(), v.size() };
+            size_t          total                = 0;
+            
+            for( size_t i = 0; i < FieldCount; i++ )
+            {
+                this->lengths[ i ] = static_cast< uint32_t >( sizes[ i ] );
+                total             += sizes[ i ];
+            }
+            
+            this->data = std::make_unique< uint8_t[] >( total );
+            
+            for( size_t i = 0, offset = 0; i < FieldCount; offset += sizes[ i ], i++ )
+            {
+                if( sizes[ i ] > 0 )
+                {
+                    memcpy( this->data.get() + offset, fields[ i ], sizes[ i ] );
+                }
+            }
+            
+            SecureArena::wipe( salt.data(), salt.size() );
+            SecureArena::wipe( b.data(),    b.size() );
+        }
+        
+        Entry::~Entry()
+        {
+            size_t total = 0;
+            
+            for( uint32_t length: this->lengths )
+            {
+                total += length;
+            }
+            
+            SecureArena::wipe( this->data.get(), total );
+        }
+        
+        const uint8_t * Entry::field( Field f ) const
+        {
+            size_t offset = 0;
+            
+            for( size_t i = 0; i < f; i++ )
+            {
+                offset += this->lengths[ i ];
+            }
+            
+            return this->data.get() + offset;
+        }
+        
+        Server Entry::server() const
+        {
+            std::string identity( reinterpret_cast< const char * >( this->field( Identity ) ), this->lengths[ Identity ] );
+            BigNum      b( BigNumView( this->field( B ), this->lengths[ B ] ) );
+            Server      server( identity, this->hashAlgorithm, this->groupType, b.makeSecret() );
+            
+            server.setSalt( this->field( Salt ), this->lengths[ Salt ] );
+            
+            if( this->precomputed != nullptr )
+            {
+                server.setPrecomputed( this->precomputed );
+            }
+            else
+            {
+                server.setV( BigNumView( this->field( V ), this->lengths[ V ] ) );
+            }
+            
+            server.setA( BigNumView( this->field( A ), this->lengths[ A ] ) );
+            
+            return server;
+        }
+        
+        struct Shard
+        {
+            Shard( size_t shardCapacity, uint64_t now ):
+                capacity( shardCapacity ),
+                tick( now ),
+                wheel{},
+                occupied{},
+                inserted( 0 ),
+                taken( 0 ),
+                removed( 0 ),
+                expired( 0 ),
+                rejected( 0 )
+            {
+                this->entries.reserve( shardCapacity );
+            }
+            
+            mutable std::mutex                    mutex;
+            size_t                                capacity;
+            uint64_t                              tick;
+            std::unordered_map< uint64_t, Entry > entries;
+            std::array< Entry *, slots * levels > wheel;
+            std::array< uint64_t, levels >        occupied;
+            uint64_t                              inserted;
+            uint64_t                              taken;
+            uint64_t                              removed;
+            uint64_t                              expired;
+            uint64_t                              rejected;
+        };
+    }
+    
+    class SessionTable::IMPL
+    {
+        public:
+            
+            IMPL( size_t capacity, Clock::duration timeout, Clock::duration resolution, size_t shards );
+            ~IMPL();
+            
+            uint64_t ticks( Clock::time_point time )   const;
+            uint64_t ticks( Clock::duration duration ) const;
+            Shard  & shard( uint64_t id )              const;
+            
+            static void     schedule( Shard & shard, Entry & entry );
+            static void     unlink( Shard & shard, Entry & entry );
+            static uint64_t nextTick( const Shard & shard );
+            static size_t   advance( Shard & shard, uint64_t tick );
+            static void   erase( Shard & shard, Entry & entry );
+            
+            std::vector< std::unique_ptr< Shard > > _shards;
+            size_t                                  _capacity;
+            Clock::duration                         _timeout;
+            Clock::duration                         _resolution;
+    };
+    
+    SessionTable::SessionTable( size_t capacity, Clock::duration timeout, Clock::duration resolution, size_t shards ):
+        impl( std::make_unique< IMPL >( capacity, timeout, resolution, shards ) )
+    {}
+    
+    SessionTable::~SessionTable()
+    {}
+    
+    bool SessionTable::insert( uint64_t id, Server && server )
+    {
+        return this->insert( id, std::move( server ), this->impl->_timeout );
+    }
+    
+    bool SessionTable::insert( uint64_t id, Server && server, Clock::duration timeout )
+    {
+        Shard                       & shard = this->impl->shard( id );
+        uint64_t                      now   = this->impl->ticks( Clock::now() );
+        std::lock_guard< std::mutex > l( shard.mutex );
+        
+        IMPL::advance( shard, now );
+        
+        if( shard.entries.size() >= shard.capacity || shard.entries.find( id ) != shard.entries.end() )
+        {
+            shard.rejected++;
+            
+            return false;
+        }
+        
+        Entry & entry = shard.entries.try_emplace( id, id, server ).first->second;
+        
+        server.clear();
+        
+        entry.deadline = shard.tick + std::clamp< uint64_t >( this->impl->ticks( timeout ), 1, maxDelay );
+        
+        IMPL::schedule( shard, entry );
+        
+        shard.inserted++;
+        
+        return true;
+    }
+    
+    std::optional< Server > SessionTable::take( uint64_t id )
+    {
+        Shard                       & shard = this->impl->shard( id );
+        uint64_t                      now   = this->impl->ticks( Clock::now() );
+        std::lock_guard< std::mutex > l( shard.mutex );
+        
+        IMPL::advance( shard, now );
+        
+        auto it = shard.entries.find( id );
+        
+        if( it == shard.entries.end() )
+        {
+            return {};
+        }
+        
+        std::optional< Server > server( it->second.server() );
+        
+        IMPL::unlink( shard, it->second );
+        shard.entries.erase( it );
+        
+        shard.taken++;
+        
+        return server;
+    }
+    
+    bool SessionTable::remove( uint64_t id )
+    {
+        Shard                       & shard = this->impl->shard( id );
+        std::lock_guard< std::mutex > l( shard.mutex );
+        auto                          it    = shard.entries.find( id );
+        
+        if( it == shard.entries.end() )
+        {
+            return false;
+        }
+        
+        IMPL::erase( shard, it->second );
+        
+        shard.removed++;
+        
+        return true;
+    }
+    
+    bool SessionTable::contains( uint64_t id ) const
+    {
+        Shard                       & shard = this->impl->shard( id );
+        uint64_t                      now   = this->impl->ticks( Clock::now() );
+        std::lock_guard< std::mutex > l( shard.mutex );
+        auto                          it    = shard.entries.find( id );
+        
+        /* Not advancing the wheel here, so expiry is checked directly */
+        return it != shard.entries.end() && it->second.deadline > now;
+    }
+    
+    size_t SessionTable::size() const
+    {
+        size_t size = 0;
+        
+        for( const auto & shard: this->impl->_shards )
+        {
+            std::lock_guard< std::mutex > l( shard->mutex );
+            
+            size += shard->entries.size();
+        }
+        
+        return size;
+    }
+    
+    size_t SessionTable::capacity() const
+    {
+        return this->impl->_capacity;
+    }
+    
+    size_t SessionTable::expire()
+    {
+        return this->expire( Clock::now() );
+    }
+    
+    size_t SessionTable::expire( Clock::time_point now )
+    {
+        uint64_t tick    = this->impl->ticks( now );
+        size_t   expired = 0;
+        
+        for( const auto & shard: this->impl->_shards )
+        {
+            std::lock_guard< std::mutex > l( shard->mutex );
+            
+            expired += IMPL::advance( *( shard ), tick );
+        }
+        
+        return expired;
+    }
+    
+    SessionTable::Stats SessionTable::stats() const
+    {
+        Stats stats {};
+        
+        stats.capacity = this->impl->_capacity;
+        
+        for( const auto & shard: this->impl->_shards )
+        {
+            std::lock_guard< std::mutex > l( shard->mutex );
+            
+            stats.sessions += shard->entries.size();
+            stats.inserted += shard->inserted;
+            stats.taken    += shard->taken;
+            stats.removed  += shard->removed;
+            stats.expired  += shard->expired;
+            stats.rejected += shard->rejected;
+        }
+        
+        return stats;
+    }
+    
+    SessionTable::IMPL::IMPL( size_t capacity, Clock::duration timeout, Clock::duration resolution, size_t shards ):
+        _timeout( timeout ),
+        _resolution( std::max< Clock::duration >( resolution, Clock::duration( 1 ) ) )
+    {
+        size_t count = 1;
+        
+        while( count < std::max< size_t >( shards, 1 ) )
+        {
+            count <<= 1;
+        }
+        
+        size_t   perShard = ( capacity + count - 1 ) / count;
+        uint64_t now      = this->ticks( Clock::now() );
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            this->_shards.push_back( std::make_unique< Shard >( perShard, now ) );
+        }
+        
+        this->_capacity = perShard * count;
+    }
+    
+    SessionTable::IMPL::~IMPL()
+    {}
+    
+    uint64_t SessionTable::IMPL::ticks( Clock::time_point time ) const
+    {
+        return this->ticks( time.time_since_epoch() );
+    }
+    
+    uint64_t SessionTable::IMPL::ticks( Clock::duration duration ) const
+    {
+        return static_cast< uint64_t >( std::max< Clock::duration::rep >( duration / this->_resolution, 0 ) );
+    }
+    
+    Shard & SessionTable::IMPL::shard( uint64_t id ) const
+    {
+        /* Session IDs may be sequential, so they are mixed first - Fibonacci hashing */
+        uint64_t hash = id * 0x9E3779B97F4A7C15ULL;
+        
+        return *( this->_shards[ static_cast< size_t >( hash >> 32 ) & ( this->_shards.size() - 1 ) ] );
+    }
+    
+    void SessionTable::IMPL::schedule( Shard & shard, Entry & entry )
+    {
+        uint64_t delta = ( entry.deadline > shard.tick ) ? entry.deadline - shard.tick : 0;
+        size_t   level = 0;
+        
+        while( level < levels - 1 && delta >= ( static_cast< uint64_t >( 1 ) << ( slotBits * ( level + 1 ) ) ) )
+        {
+            level++;
+        }
+        
+        /* Already due entries go in the slot for the current tick */
+        uint64_t at = std::max( entry.deadline, shard.tick );
+        
+        entry.slot = level * slots + ( ( at >> ( slotBits * level ) ) & ( slots - 1 ) );
+        
+        Entry * & head = shard.wheel[ entry.slot ];
+        
+        shard.occupied[ level ] |= static_cast< uint64_t >( 1 ) << ( entry.slot & ( slots - 1 ) );
+        
+        entry.prev = nullptr;
+        entry.next = head;
+        
+        if( head != nullptr )
+        {
+            head->prev = &entry;
+        }
+        
+        head = &entry;
+    }
+    
+    void SessionTable::IMPL::unlink( Shard & shard, Entry & entry )
+    {
+        if( entry.prev != nullptr )
+        {
+            entry.prev->next = entry.next;
+        }
+        else if( shard.wheel[ entry.slot ] == &entry )
+        {
+            shard.wheel[ entry.slot ] = entry.next;
+            
+            if( entry.next == nullptr )
+            {
+                shard.occupied[ entry.slot / slots ] &= ~( static_cast< uint64_t >( 1 ) << ( entry.slot & ( slots - 1 ) ) );
+            }
+        }
+        
+        if( entry.next != nullptr )
+        {
+            entry.next->prev = entry.prev;
+        }
+        
+        entry.prev = nullptr;
+        entry.next = nullptr;
+    }
+    
+    /* First tick after the current one with a slot to cascade or expire */
+    uint64_t SessionTable::IMPL::nextTick( const Shard & shard )
+    {
+        uint64_t next = UINT64_MAX;
+        
+        for( size_t level = 0; level < levels; level++ )
+        {
+            if( shard.occupied[ level ] == 0 )
+            {
+                continue;
+            }
+            
+            /* Slots are scanned for one full turn, starting after the current one */
+            uint64_t position = shard.tick >> ( slotBits * level );
+            int      start    = static_cast< int >( ( position + 1 ) & ( slots - 1 ) );
+            uint64_t distance = static_cast< uint64_t >( std::countr_zero( std::rotr( shard.occupied[ level ], start ) ) ) + 1;
+            
+            next = std::min( next, ( position + distance ) << ( slotBits * level ) );
+        }
+        
+        return next;
+    }
+    
+    size_t SessionTable::IMPL::advance( Shard & shard, uint64_t tick )
+    {
+        size_t expired = 0;
+        
+        if( shard.entries.empty() )
+        {
+            shard.tick = std::max( shard.tick, tick );
+            
+            return 0;
+        }
+        
+        while( shard.tick < tick )
+        {
+            /* Ticks with nothing to cascade or expire are skipped */
+            shard.tick = std::min( nextTick( shard ), tick );
+            
+            /* Higher levels first, as they may move entries down to a slot cascaded next */
+            for( size_t level = levels - 1; level > 0; level-- )
+            {
+                if( ( shard.tick & ( ( static_cast< uint64_t >( 1 ) << ( slotBits * level ) ) - 1 ) ) != 0 )
+                {
+                    continue;
+                }
+                
+                size_t    index = ( shard.tick >> ( slotBits * level ) ) & ( slots - 1 );
+                Entry * & head  = shard.wheel[ level * slots + index ];
+                Entry   * entry = head;
+                
+                head                    = nullptr;
+                shard.occupied[ level ] &= ~( static_cast< uint64_t >( 1 ) << index );
+                
+                while( entry != nullptr )
+                {
+                    Entry * next = entry->next;
+                    
+                    schedule( shard, *( entry ) );
+                    
+                    entry = next;
+                }
+            }
+            
+            Entry * & head  = shard.wheel[ shard.tick & ( slots - 1 ) ];
+            Entry   * entry = head;
+            
+            head                = nullptr;
+            shard.occupied[ 0 ] &= ~( static_cast< uint64_t >( 1 ) << ( shard.tick & ( slots - 1 ) ) );
+            
+            while( entry != nullptr )
+            {
+                Entry * next = entry->next;
+                
+                entry->prev = nullptr;
+                entry->next = nullptr;
+                
+                erase( shard, *( entry ) );
+                
+                shard.expired++;
+                expired++;
+                
+                entry = next;
+            }
+            
+            if( shard.entries.empty() )
+            {
+                shard.tick = tick;
+            }
+        }
+        
+        return expired;
+    }
+    
+    void SessionTable::IMPL::erase( Shard & shard, Entry & entry )
+    {
+        unlink( shard, entry );
+        shard.entries.erase( entry.id );
+    }
+}
@@ -0,0 +1,302 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/ShardRing.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace SRP
+{
+    class ShardRing::IMPL
+    {
+        public:
+            
+            struct Point
+            {
+                uint64_t hash;
+                size_t   shard;
+            };
+            
+            IMPL( size_t virtualNodes );
+            IMPL( const IMPL & o );
+            ~IMPL();
+            
+            void build();
+            
+            const std::string * owner( uint64_t hash ) const;
+            size_t              successor( uint64_t hash ) const;
+            
+            size_t               _virtualNodes;
+            std::vector< Shard > _shards;
+            std::vector< Point > _points;
+    };
+    
+    uint64_t ShardRing::hash( std::string_view identity )
+    {
+        /* FNV-1a, then the SplitMix64 finalizer, as FNV alone clusters similar names on the ring */
+        uint64_t h = 0xCBF29CE484222325ULL;
+        
+        for( char c: identity )
+        {
+            h ^= static_cast< uint8_t >( c );
+            h *= 0x100000001B3ULL;
+        }
+        
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        
+        return h;
+    }
+    
+    ShardRing::ShardRing( size_t virtualNodes ):
+        impl( std::make_unique< IMPL >( virtualNodes ) )
+    {}
+    
+    ShardRing::ShardRing( const ShardRing & o ):
+        impl( std::make_unique< IMPL >( *( o.impl ) ) )
+    {}
+    
+    ShardRing::~ShardRing()
+    {}
+    
+    ShardRing & ShardRing::operator =( ShardRing o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    void swap( ShardRing & o1, ShardRing & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    void ShardRing::add( const std::string & name, uint32_t weight )
+    {
+        if( weight == 0 )
+        {
+            throw std::runtime_error( "Invalid shard weight" );
+        }
+        
+        if( this->contains( name ) )
+        {
+            throw std::runtime_error( "Shard already exists: " + name );
+        }
+        
+        this->impl->_shards.push_back( { name, weight } );
+        this->impl->build();
+    }
+    
+    void ShardRing::remove( const std::string & name )
+    {
+        auto it = std::find_if( this->impl->_shards.begin(), this->impl->_shards.end(), [ & ]( const Shard & shard ) { return shard.name == name; } );
+        
+        if( it != this->impl->_shards.end() )
+        {
+            this->impl->_shards.erase( it );
+            this->impl->build();
+        }
+    }
+    
+    bool ShardRing::contains( const std::string & name ) const
+    {
+        return std::any_of( this->impl->_shards.begin(), this->impl->_shards.end(), [ & ]( const Shard & shard ) { return shard.name == name; } );
+    }
+    
+    size_t ShardRing::size() const
+    {
+        return this->impl->_shards.size();
+    }
+    
+    std::vector< ShardRing::Shard > ShardRing::shards() const
+    {
+        return this->impl->_shards;
+    }
+    
+    const std::string & ShardRing::route( std::string_view identity ) const
+    {
+        const std::string * owner = this->impl->owner( ShardRing::hash( identity ) );
+        
+        if( owner == nullptr )
+        {
+            throw std::runtime_error( "No shard to route to" );
+        }
+        
+        return *( owner );
+    }
+    
+    std::vector< std::string > ShardRing::route( std::string_view identity, size_t count ) const
+    {
+        std::vector< std::string > shards;
+        std::vector< bool >        seen( this->impl->_shards.size(), false );
+        
+        if( this->impl->_points.empty() )
+        {
+            return shards;
+        }
+        
+        size_t start = this->impl->successor( ShardRing::hash( identity ) );
+        
+        for( size_t i = 0; i < this->impl->_points.size() && shards.size() < count; i++ )
+        {
+            size_t shard = this->impl->_points[ ( start + i ) % this->impl->_points.size() ].shard;
+            
+            if( seen[ shard ] == false )
+            {
+                seen[ shard ] = true;
+                
+                shards.push_back( this->impl->_shards[ shard ].name );
+            }
+        }
+        
+        return shards;
+    }
+    
+    std::vector< ShardRing::Move > ShardRing::rebalance( const ShardRing & target ) const
+    {
+        std::vector< Move >     moves;
+        std::vector< uint64_t > bounds;
+        
+        /* Owners in both rings are constant between two consecutive virtual nodes of either ring */
+        for( const auto & point: this->impl->_points )
+        {
+            bounds.push_back( point.hash );
+        }
+        
+        for( const auto & point: target.impl->_points )
+        {
+            bounds.push_back( point.hash );
+        }
+        
+        std::sort( bounds.begin(), bounds.end() );
+        
+        bounds.erase( std::unique( bounds.begin(), bounds.end() ), bounds.end() );
+        
+        auto add = [ & ]( uint64_t first, uint64_t last )
+        {
+            const std::string * from = this->impl->owner( last );
+            const std::string * to   = target.impl->owner( last );
+            std::string         f    = ( from == nullptr ) ? std::string() : *( from );
+            std::string         t    = ( to   == nullptr ) ? std::string() : *( to );
+            
+            if( f == t )
+            {
+                return;
+            }
+            
+            if( moves.empty() == false && moves.back().last + 1 == first && moves.back().from == f && moves.back().to == t )
+            {
+                moves.back().last = last;
+            }
+            else
+            {
+                moves.push_back( { first, last, f, t } );
+            }
+        };
+        
+        for( size_t i = 0; i < bounds.size(); i++ )
+        {
+            add( ( i == 0 ) ? 0 : bounds[ i - 1 ] + 1, bounds[ i ] );
+        }
+        
+        if( bounds.empty() == false && bounds.back() != std::numeric_limits< uint64_t >::max() )
+        {
+            add( bounds.back() + 1, std::numeric_limits< uint64_t >::max() );
+        }
+        
+        return moves;
+    }
+    
+    ShardRing::IMPL::IMPL( size_t virtualNodes ):
+        _virtualNodes( std::max< size_t >( virtualNodes, 1 ) )
+    {}
+    
+    ShardRing::IMPL::IMPL( const IMPL & o ):
+        _virtualNodes( o._virtualNodes ),
+        _shards(       o._shards ),
+        _points(       o._points )
+    {}
+    
+    ShardRing::IMPL::~IMPL()
+    {}
+    
+    void ShardRing::IMPL::build()
+    {
+        this->_points.clear();
+        
+        for( size_t i = 0; i < this->_shards.size(); i++ )
+        {
+            size_t count = this->_virtualNodes * this->_shards[ i ].weight;
+            
+            for( size_t j = 0; j < count; j++ )
+            {
+                this->_points.push_back( { ShardRing::hash( this->_shards[ i ].name + "#" + std::to_string( j ) ), i } );
+            }
+        }
+        
+        /* Collisions are ordered by name, so the order shards were added in does not matter */
+        std::sort
+        (
+            this->_points.begin(),
+            this->_points.end(),
+            [ this ]( const Point & p1, const Point & p2 )
+            {
+                if( p1.hash != p2.hash )
+                {
+                    return p1.hash < p2.hash;
+                }
+                
+                return this->_shards[ p1.shard ].name < this->_shards[ p2.shard ].name;
+            }
+        );
+    }
+    
+    const std::string * ShardRing::IMPL::owner( uint64_t hash ) const
+    {
+        if( this->_points.empty() )
+        {
+            return nullptr;
+        }
+        
+        return &( this->_shards[ this->_points[ this->successor( hash ) ].shard ].name );
+    }
+    
+    size_t ShardRing::IMPL::successor( uint64_t hash ) const
+    {
+        auto it = std::lower_bound( this->_points.begin(), this->_points.end(), hash, []( const Point & point, uint64_t h ) { return point.hash < h; } );
+        
+        if( it == this->_points.end() )
+        {
+            return 0;
+        }
+        
+        return static_cast< size_t >( it - this->_points.begin() );
+    }
+}
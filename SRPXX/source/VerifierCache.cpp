@@ -0,0 +1,357 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/VerifierCache.hpp>
+#include <SRPXX/Server.hpp>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace SRP
+{
+    class PrecomputedVerifier::IMPL
+    {
+        public:
+            
+            IMPL( const Server & server, unsigned int window );
+            ~IMPL();
+            
+            HashAlgorithm                _hashAlgorithm;
+            Base::GroupType              _groupType;
+            BigNum                       _v;
+            BigNum                       _kv;
+            std::unique_ptr< FixedBase > _powers;
+            size_t                       _memory;
+    };
+    
+    class VerifierCache::IMPL
+    {
+        public:
+            
+            struct Slot
+            {
+                std::string                                  identity;
+                std::shared_ptr< const PrecomputedVerifier > entry;
+                bool                                         referenced;
+            };
+            
+            IMPL( size_t budget, unsigned int window );
+            ~IMPL();
+            
+            /* Hashes of the identities that missed once, oldest first */
+            static constexpr size_t admissionCount = 16384;
+            
+            bool admit( const std::string & identity );
+            void insert( const std::string & identity, const std::shared_ptr< const PrecomputedVerifier > & entry );
+            void release( size_t slot );
+            bool evict();
+            
+            mutable std::mutex                        _mutex;
+            size_t                                    _budget;
+            unsigned int                              _window;
+            std::vector< Slot >                       _slots;
+            std::vector< size_t >                     _free;
+            std::unordered_map< std::string, size_t > _index;
+            std::unordered_set< size_t >              _seen;
+            std::deque< size_t >                      _seenOrder;
+            size_t                                    _hand;
+            size_t                                    _memory;
+            uint64_t                                  _hits;
+            uint64_t                                  _misses;
+            uint64_t                                  _evictions;
+    };
+    
+    PrecomputedVerifier::PrecomputedVerifier( const Server & server, unsigned int window ):
+        impl( std::make_unique< IMPL >( server, window ) )
+    {}
+    
+    PrecomputedVerifier::~PrecomputedVerifier()
+    {}
+    
+    HashAlgorithm PrecomputedVerifier::hashAlgorithm() const
+    {
+        return this->impl->_hashAlgorithm;
+    }
+    
+    Base::GroupType PrecomputedVerifier::groupType() const
+    {
+        return this->impl->_groupType;
+    }
+    
+    const BigNum & PrecomputedVerifier::v() const
+    {
+        return this->impl->_v;
+    }
+    
+    const BigNum & PrecomputedVerifier::kv() const
+    {
+        return this->impl->_kv;
+    }
+    
+    const FixedBase & PrecomputedVerifier::powers() const
+    {
+        return *( this->impl->_powers );
+    }
+    
+    size_t PrecomputedVerifier::memory() const
+    {
+        return this->impl->_memory;
+    }
+    
+    VerifierCache::VerifierCache( size_t budget, unsigned int window ):
+        impl( std::make_unique< IMPL >( budget, window ) )
+    {}
+    
+    VerifierCache::~VerifierCache()
+    {}
+    
+    std::shared_ptr< const PrecomputedVerifier > VerifierCache::get( const Server & server )
+    {
+        std::string identity = server.identity();
+        BigNum      v        = server.v();
+        
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mutex );
+            
+            auto it = this->impl->_index.find( identity );
+            
+            if
+            (
+                   it != this->impl->_index.end()
+                && this->impl->_slots[ it->second ].entry->hashAlgorithm() == server.hashAlgorithm()
+                && this->impl->_slots[ it->second ].entry->groupType()     == server.groupType()
+                && this->impl->_slots[ it->second ].entry->v()             == v
+            )
+            {
+                this->impl->_hits++;
+                
+                this->impl->_slots[ it->second ].referenced = true;
+                
+                return this->impl->_slots[ it->second ].entry;
+            }
+            
+            this->impl->_misses++;
+            
+            if( this->impl->admit( identity ) == false )
+            {
+                return nullptr;
+            }
+        }
+        
+        /* Computed without the lock, so other identities are still served meanwhile */
+        auto entry = std::make_shared< const PrecomputedVerifier >( server, this->impl->_window );
+        
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        this->impl->insert( identity, entry );
+        
+        return entry;
+    }
+    
+    void VerifierCache::remove( const std::string & identity )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        auto it = this->impl->_index.find( identity );
+        
+        if( it != this->impl->_index.end() )
+        {
+            this->impl->release( it->second );
+        }
+    }
+    
+    void VerifierCache::clear()
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        this->impl->_slots.clear();
+        this->impl->_free.clear();
+        this->impl->_index.clear();
+        this->impl->_seen.clear();
+        this->impl->_seenOrder.clear();
+        
+        this->impl->_hand   = 0;
+        this->impl->_memory = 0;
+    }
+    
+    VerifierCache::Stats VerifierCache::stats() const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        return
+        {
+            this->impl->_hits,
+            this->impl->_misses,
+            this->impl->_evictions,
+            this->impl->_index.size(),
+            this->impl->_memory,
+            this->impl->_budget
+        };
+    }
+    
+    PrecomputedVerifier::IMPL::IMPL( const Server & server, unsigned int window ):
+        _hashAlgorithm( server.hashAlgorithm() ),
+        _groupType( server.groupType() ),
+        _v( server.v() ),
+        _kv( server.k().modMul( server.v(), server.N() ) )
+    {
+        BigNum N = server.N();
+        
+        /* u is a single hash output */
+        unsigned int bits = static_cast< unsigned int >( server.hash( std::vector< uint8_t >() ).size() * 8 );
+        
+        this->_powers = std::make_unique< FixedBase >( this->_v, N, bits, window );
+        this->_memory = this->_powers->memory() + ( 2 * N.bytes( BigNum::Endianness::BigEndian ).size() );
+    }
+    
+    PrecomputedVerifier::IMPL::~IMPL()
+    {}
+    
+    VerifierCache::IMPL::IMPL( size_t budget, unsigned int window ):
+        _budget( budget ),
+        _window( window ),
+        _hand( 0 ),
+        _memory( 0 ),
+        _hits( 0 ),
+        _misses( 0 ),
+        _evictions( 0 )
+    {}
+    
+    VerifierCache::IMPL::~IMPL()
+    {}
+    
+    bool VerifierCache::IMPL::admit( const std::string & identity )
+    {
+        /* A stale entry is replaced right away */
+        if( this->_index.count( identity ) > 0 )
+        {
+            return true;
+        }
+        
+        size_t hash = std::hash< std::string >()( identity );
+        
+        /* Left in the order, which only bounds the count */
+        if( this->_seen.erase( hash ) > 0 )
+        {
+            return true;
+        }
+        
+        if( this->_seenOrder.size() == admissionCount )
+        {
+            this->_seen.erase( this->_seenOrder.front() );
+            this->_seenOrder.pop_front();
+        }
+        
+        this->_seen.insert( hash );
+        this->_seenOrder.push_back( hash );
+        
+        return false;
+    }
+    
+    void VerifierCache::IMPL::insert( const std::string & identity, const std::shared_ptr< const PrecomputedVerifier > & entry )
+    {
+        auto it = this->_index.find( identity );
+        
+        /* Stale verifier, or computed concurrently by another thread */
+        if( it != this->_index.end() )
+        {
+            this->release( it->second );
+        }
+        
+        if( entry->memory() > this->_budget )
+        {
+            return;
+        }
+        
+        while( this->_memory + entry->memory() > this->_budget && this->evict() )
+        {}
+        
+        size_t slot = this->_slots.size();
+        
+        if( this->_free.empty() )
+        {
+            this->_slots.push_back( {} );
+        }
+        else
+        {
+            slot = this->_free.back();
+            
+            this->_free.pop_back();
+        }
+        
+        this->_slots[ slot ]     = { identity, entry, false };
+        this->_index[ identity ] = slot;
+        this->_memory           += entry->memory();
+    }
+    
+    void VerifierCache::IMPL::release( size_t slot )
+    {
+        this->_index.erase( this->_slots[ slot ].identity );
+        
+        this->_memory -= this->_slots[ slot ].entry->memory();
+        
+        this->_slots[ slot ] = {};
+        
+        this->_free.push_back( slot );
+    }
+    
+    bool VerifierCache::IMPL::evict()
+    {
+        if( this->_index.empty() )
+        {
+            return false;
+        }
+        
+        /* Two turns at most, as the first one clears every reference bit */
+        for( size_t i = 0; i < this->_slots.size() * 2; i++ )
+        {
+            size_t slot = this->_hand;
+            
+            this->_hand = ( this->_hand + 1 ) % this->_slots.size();
+            
+            if( this->_slots[ slot ].entry == nullptr )
+            {
+                continue;
+            }
+            
+            if( this->_slots[ slot ].referenced )
+            {
+                this->_slots[ slot ].referenced = false;
+                
+                continue;
+            }
+            
+            this->release( slot );
+            
+            this->_evictions++;
+            
+            return true;
+        }
+        
+        return false;
+    }
+}
@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/VerifierDirectory.hpp>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace SRP
+{
+    namespace
+    {
+        /* One per thread, never freed, and re-used once its thread exits */
+        struct ThreadRecord
+        {
+            std::atomic< uint64_t > epoch { 0 };
+            std::atomic< bool >     used  { false };
+            ThreadRecord          * next  = nullptr;
+            size_t                  depth = 0;
+        };
+        
+        std::atomic< uint64_t >       globalEpoch( 1 );
+        std::atomic< ThreadRecord * > threadRecords( nullptr );
+        
+        ThreadRecord * acquireThreadRecord()
+        {
+            for( ThreadRecord * record = threadRecords.load(); record != nullptr; record = record->next )
+            {
+                bool used = false;
+                
+                if( record->used.load( std::memory_order_relaxed ) == false && record->used.compare_exchange_strong( used, true ) )
+                {
+                    return record;
+                }
+            }
+            
+            ThreadRecord * record = new ThreadRecord();
+            
+            record->used = true;
+            record->next = threadRecords.load();
+            
+            while( threadRecords.compare_exchange_weak( record->next, record ) == false )
+            {}
+            
+            return record;
+        }
+        
+        struct ThreadHandle
+        {
+            ThreadHandle():
+                record( acquireThreadRecord() )
+            {}
+            
+            ~ThreadHandle()
+            {
+                this->record->epoch = 0;
+                this->record->used  = false;
+            }
+            
+            ThreadRecord * record;
+        };
+        
+        ThreadRecord & currentThreadRecord()
+        {
+            static thread_local ThreadHandle handle;
+            
+            return *( handle.record );
+        }
+        
+        /* Oldest epoch announced by an active reader */
+        uint64_t oldestEpoch()
+        {
+            uint64_t oldest = std::numeric_limits< uint64_t >::max();
+            
+            for( ThreadRecord * record = threadRecords.load(); record != nullptr; record = record->next )
+            {
+                uint64_t epoch = record->epoch.load();
+                
+                if( epoch != 0 && epoch < oldest )
+                {
+                    oldest = epoch;
+                }
+            }
+            
+            return oldest;
+        }
+    }
+    
+    class VerifierDirectory::IMPL
+    {
+        public:
+            
+            struct Retired
+            {
+                uint64_t                         epoch;
+                std::unique_ptr< VerifierStore > store;
+            };
+            
+            IMPL();
+            ~IMPL();
+            
+            size_t reclaim();
+            
+            std::atomic< VerifierStore * > _current;
+            std::atomic< uint64_t >        _version;
+            std::atomic< size_t >          _retiredCount;
+            std::mutex                     _mutex;
+            std::vector< Retired >         _retired;
+    };
+    
+    VerifierDirectory::VerifierDirectory():
+        impl( std::make_unique< IMPL >() )
+    {}
+    
+    VerifierDirectory::~VerifierDirectory()
+    {}
+    
+    void VerifierDirectory::publish( std::unique_ptr< VerifierStore > store )
+    {
+        VerifierStore * previous = this->impl->_current.exchange( store.release() );
+        
+        this->impl->_version++;
+        
+        if( previous != nullptr )
+        {
+            /* Readers announcing a later epoch can only see the new snapshot */
+            uint64_t epoch = globalEpoch.fetch_add( 1 );
+            
+            std::lock_guard< std::mutex > l( this->impl->_mutex );
+            
+            this->impl->_retired.push_back( { epoch, std::unique_ptr< VerifierStore >( previous ) } );
+            this->impl->_retiredCount++;
+        }
+        
+        this->reclaim();
+    }
+    
+    void VerifierDirectory::publish( const std::string & path )
+    {
+        this->publish( std::make_unique< VerifierStore >( path ) );
+    }
+    
+    VerifierDirectory::Reader VerifierDirectory::read() const
+    {
+        return Reader( *( this ) );
+    }
+    
+    uint64_t VerifierDirectory::version() const
+    {
+        return this->impl->_version;
+    }
+    
+    size_t VerifierDirectory::retired() const
+    {
+        return this->impl->_retiredCount;
+    }
+    
+    size_t VerifierDirectory::reclaim()
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mutex );
+        
+        return this->impl->reclaim();
+    }
+    
+    VerifierDirectory::Reader::Reader( const VerifierDirectory & directory ):
+        _directory( &directory ),
+        _store( nullptr )
+    {
+        ThreadRecord & record = currentThreadRecord();
+        
+        if( record.depth++ == 0 )
+        {
+            record.epoch = globalEpoch.load();
+        }
+        
+        /* Loaded after announcing the epoch, so a snapshot retired meanwhile is kept alive */
+        this->_store = directory.impl->_current.load();
+    }
+    
+    VerifierDirectory::Reader::~Reader()
+    {
+        ThreadRecord & record = currentThreadRecord();
+        
+        if( --record.depth > 0 )
+        {
+            return;
+        }
+        
+        record.epoch = 0;
+        
+        if( this->_directory->impl->_retiredCount > 0 )
+        {
+            /* Never waits, as another thread is already reclaiming otherwise */
+            std::unique_lock< std::mutex > l( this->_directory->impl->_mutex, std::try_to_lock );
+            
+            if( l.owns_lock() )
+            {
+                this->_directory->impl->reclaim();
+            }
+        }
+    }
+    
+    const VerifierStore * VerifierDirectory::Reader::store() const
+    {
+        return this->_store;
+    }
+    
+    std::optional< VerifierStore::Record > VerifierDirectory::Reader::find( std::string_view identity ) const
+    {
+        if( this->_store == nullptr )
+        {
+            return {};
+        }
+        
+        return this->_store->find( identity );
+    }
+    
+    VerifierDirectory::IMPL::IMPL():
+        _current( nullptr ),
+        _version( 0 ),
+        _retiredCount( 0 )
+    {}
+    
+    VerifierDirectory::IMPL::~IMPL()
+    {
+        delete this->_current.load();
+    }
+    
+    size_t VerifierDirectory::IMPL::reclaim()
+    {
+        uint64_t oldest = oldestEpoch();
+        
+        for( auto it = this->_retired.begin(); it != this->_retired.end(); )
+        {
+            if( it->epoch < oldest )
+            {
+                it = this->_retired.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        
+        this->_retiredCount = this->_retired.size();
+        
+        return this->_retired.size();
+    }
+}
@@ -0,0 +1,1205 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/VerifierLog.hpp>
+#include <SRPXX/BigNumView.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Segment records, all integers little-endian:
+ * 
+ *   length u32 (of everything after the checksum), CRC-32 u32 (of the same bytes),
+ *   sequence u64, type u8, hash algorithm u8, group type u8, reserved u8,
+ *   identity length u16, salt length u16, verifier length u16,
+ *   identity, salt, big-endian verifier
+ */
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr size_t  headerSize = 8;
+        constexpr size_t  fixedSize  = 18;
+        constexpr uint8_t typePut    = 1;
+        constexpr uint8_t typeRemove = 2;
+        
+        uint32_t crc32( const uint8_t * data, size_t length )
+        {
+            static const std::array< uint32_t, 256 > table = []
+            {
+                std::array< uint32_t, 256 > t {};
+                
+                for( uint32_t i = 0; i < 256; i++ )
+                {
+                    uint32_t c = i;
+                    
+                    for( int j = 0; j < 8; j++ )
+                    {
+                        c = ( c & 1 ) ? 0xEDB88320U ^ ( c >> 1 ) : c >> 1;
+                    }
+                    
+                    t[ i ] = c;
+                }
+                
+                return t;
+            }
+            ();
+            
+            uint32_t crc = 0xFFFFFFFFU;
+            
+            for( size_t i = 0; i < length; i++ )
+            {
+                crc = table[ ( crc ^ data[ i ] ) & 0xFF ] ^ ( crc >> 8 );
+            }
+            
+            return crc ^ 0xFFFFFFFFU;
+        }
+        
+        uint64_t loadLE( const uint8_t * p, size_t size )
+        {
+            uint64_t value = 0;
+            
+            for( size_t i = 0; i < size; i++ )
+            {
+                value |= static_cast< uint64_t >( p[ i ] ) << ( i * 8 );
+            }
+            
+            return value;
+        }
+        
+        void appendLE( std::vector< uint8_t > & data, uint64_t value, size_t size )
+        {
+            for( size_t i = 0; i < size; i++ )
+            {
+                data.push_back( static_cast< uint8_t >( value >> ( i * 8 ) ) );
+            }
+        }
+        
+        struct Decoded
+        {
+            uint64_t         sequence;
+            uint8_t          type;
+            HashAlgorithm    hashAlgorithm;
+            Base::GroupType  groupType;
+            std::string_view identity;
+            const uint8_t  * salt;
+            size_t           saltLength;
+            const uint8_t  * verifier;
+            size_t           verifierLength;
+            size_t           size;
+        };
+        
+        bool decode( const uint8_t * p, size_t available, Decoded & record )
+        {
+            if( available < headerSize + fixedSize )
+            {
+                return false;
+            }
+            
+            size_t length = static_cast< size_t >( loadLE( p, 4 ) );
+            
+            if( length < fixedSize || length > available - headerSize || crc32( p + headerSize, length ) != loadLE( p + 4, 4 ) )
+            {
+                return false;
+            }
+            
+            const uint8_t * body           = p + headerSize;
+            uint64_t        hashAlgorithm  = body[ 9 ];
+            uint64_t        groupType      = body[ 10 ];
+            size_t          identityLength = static_cast< size_t >( loadLE( body + 12, 2 ) );
+            size_t          saltLength     = static_cast< size_t >( loadLE( body + 14, 2 ) );
+            size_t          verifierLength = static_cast< size_t >( loadLE( body + 16, 2 ) );
+            
+            if
+            (
+                   identityLength + saltLength + verifierLength != length - fixedSize
+                || ( body[ 8 ] != typePut && body[ 8 ] != typeRemove )
+                || hashAlgorithm > static_cast< uint64_t >( HashAlgorithm::SHA512 )
+                || groupType     > static_cast< uint64_t >( Base::GroupType::NG8192 )
+            )
+            {
+                return false;
+            }
+            
+            body += fixedSize;
+            
+            record.sequence       = loadLE( p + headerSize, 8 );
+            record.type           = p[ headerSize + 8 ];
+            record.hashAlgorithm  = static_cast< HashAlgorithm >( hashAlgorithm );
+            record.groupType      = static_cast< Base::GroupType >( groupType );
+            record.identity       = std::string_view( reinterpret_cast< const char * >( body ), identityLength );
+            record.salt           = body + identityLength;
+            record.saltLength     = saltLength;
+            record.verifier       = body + identityLength + saltLength;
+            record.verifierLength = verifierLength;
+            record.size           = headerSize + length;
+            
+            return true;
+        }
+        
+        class File
+        {
+            public:
+                
+                File( const std::string & path, bool create );
+                ~File();
+                
+                File( const File & o )              = delete;
+                File & operator =( const File & o ) = delete;
+                
+                uint64_t size() const;
+                bool     readAt( uint64_t offset, uint8_t * data, size_t length ) const;
+                bool     append( const uint8_t * data, size_t length );
+                bool     sync();
+                bool     truncate( uint64_t length );
+                
+            private:
+                
+                #ifdef _WIN32
+                HANDLE                  _handle;
+                #else
+                int                     _fd;
+                #endif
+                std::atomic< uint64_t > _size;
+        };
+        
+        struct Segment
+        {
+            Segment( uint64_t segmentID, const std::string & segmentPath, bool create ):
+                id( segmentID ),
+                path( segmentPath ),
+                file( segmentPath, create ),
+                liveBytes( 0 )
+            {}
+            
+            uint64_t    id;
+            std::string path;
+            File        file;
+            uint64_t    liveBytes;
+        };
+        
+        struct Location
+        {
+            std::shared_ptr< Segment > segment;
+            uint64_t                   offset;
+            uint32_t                   size;
+            uint64_t                   sequence;
+        };
+        
+        struct Update
+        {
+            uint8_t                type;
+            std::string            identity;
+            HashAlgorithm          hashAlgorithm;
+            Base::GroupType        groupType;
+            std::vector< uint8_t > salt;
+            std::vector< uint8_t > verifier;
+            std::promise< void >   promise;
+        };
+        
+        void encode( std::vector< uint8_t > & data, uint64_t sequence, const Update & update )
+        {
+            size_t start  = data.size();
+            size_t length = fixedSize + update.identity.size() + update.salt.size() + update.verifier.size();
+            
+            appendLE( data, length,                                          4 );
+            appendLE( data, 0,                                               4 );
+            appendLE( data, sequence,                                        8 );
+            appendLE( data, update.type,                                     1 );
+            appendLE( data, static_cast< uint64_t >( update.hashAlgorithm ), 1 );
+            appendLE( data, static_cast< uint64_t >( update.groupType ),     1 );
+            appendLE( data, 0,                                               1 );
+            appendLE( data, update.identity.size(),                          2 );
+            appendLE( data, update.salt.size(),                              2 );
+            appendLE( data, update.verifier.size(),                          2 );
+            
+            data.insert( data.end(), update.identity.begin(), update.identity.end() );
+            data.insert( data.end(), update.salt.begin(),     update.salt.end() );
+            data.insert( data.end(), update.verifier.begin(), update.verifier.end() );
+            
+            uint32_t crc = crc32( data.data() + start + headerSize, length );
+            
+            for( size_t i = 0; i < 4; i++ )
+            {
+                data[ start + 4 + i ] = static_cast< uint8_t >( crc >> ( i * 8 ) );
+            }
+        }
+    }
+    
+    class VerifierLog::IMPL
+    {
+        public:
+            
+            struct Scan
+            {
+                std::string identity;
+                uint64_t    sequence;
+                uint64_t    offset;
+                uint32_t    size;
+                bool        put;
+            };
+            
+            IMPL( const std::string & directory, const Options & options );
+            ~IMPL();
+            
+            std::string segmentPath( uint64_t id, bool compacted ) const;
+            
+            void                load();
+            std::vector< Scan > scan( Segment & segment, bool truncate ) const;
+            void                write();
+            void                commit( std::vector< Update > & updates );
+            void                apply( const Update & update, const Location & location );
+            bool                needsCompaction() const;
+            void                compactInBackground();
+            void                compact();
+            
+            std::future< void > push( Update update );
+            
+            std::string                                      _directory;
+            Options                                          _options;
+            mutable std::shared_mutex                        _indexMutex;
+            std::unordered_map< std::string, Location >      _index;
+            std::map< uint64_t, std::shared_ptr< Segment > > _segments;
+            std::shared_ptr< Segment >                       _active;
+            std::atomic< uint64_t >                          _nextSegment;
+            uint64_t                                         _nextSequence;
+            std::mutex                                       _queueMutex;
+            std::condition_variable                          _queueCondition;
+            std::vector< Update >                            _queue;
+            bool                                             _stop;
+            std::mutex                                       _compactionMutex;
+            std::condition_variable                          _compactionCondition;
+            bool                                             _compactionRequested;
+            std::mutex                                       _compacting;
+            std::atomic< uint64_t >                          _commits;
+            std::atomic< uint64_t >                          _records;
+            std::atomic< uint64_t >                          _bytesWritten;
+            std::atomic< uint64_t >                          _compactions;
+            std::thread                                      _writer;
+            std::thread                                      _compactor;
+    };
+    
+    VerifierLog::Options::Options():
+        segmentSize( 64 * 1024 * 1024 ),
+        compactionThreshold( 0.5 )
+    {}
+    
+    VerifierLog::VerifierLog( const std::string & directory ):
+        VerifierLog( directory, Options() )
+    {}
+    
+    VerifierLog::VerifierLog( const std::string & directory, const Options & options ):
+        impl( std::make_unique< IMPL >( directory, options ) )
+    {}
+    
+    VerifierLog::~VerifierLog()
+    {}
+    
+    std::future< void > VerifierLog::put( const std::string & identity, HashAlgorithm hashAlgorithm, Base::GroupType groupType, const std::vector< uint8_t > & salt, const BigNum & verifier )
+    {
+        std::vector< uint8_t > bytes = verifier.bytes( BigNum::Endianness::BigEndian );
+        
+        if( identity.size() > 0xFFFF || salt.size() > 0xFFFF || bytes.size() > 0xFFFF )
+        {
+            throw std::runtime_error( "Verifier log record is too large" );
+        }
+        
+        return this->impl->push( { typePut, identity, hashAlgorithm, groupType, salt, std::move( bytes ), {} } );
+    }
+    
+    std::future< void > VerifierLog::remove( const std::string & identity )
+    {
+        if( identity.size() > 0xFFFF )
+        {
+            throw std::runtime_error( "Verifier log record is too large" );
+        }
+        
+        return this->impl->push( { typeRemove, identity, HashAlgorithm::SHA1, Base::GroupType::NG1024, {}, {}, {} } );
+    }
+    
+    std::optional< VerifierLog::Record > VerifierLog::find( const std::string & identity ) const
+    {
+        Location location;
+        
+        {
+            std::shared_lock< std::shared_mutex > l( this->impl->_indexMutex );
+            auto                                  it = this->impl->_index.find( identity );
+            
+            if( it == this->impl->_index.end() )
+            {
+                return {};
+            }
+            
+            location = it->second;
+        }
+        
+        std::vector< uint8_t > data( location.size );
+        Decoded                record;
+        
+        if
+        (
+               location.segment->file.readAt( location.offset, data.data(), data.size() ) == false
+            || decode( data.data(), data.size(), record ) == false
+            || record.type != typePut
+        )
+        {
+            throw std::runtime_error( "Cannot read verifier log record" );
+        }
+        
+        return Record
+        {
+            record.hashAlgorithm,
+            record.groupType,
+            std::vector< uint8_t >( record.salt, record.salt + record.saltLength ),
+            BigNum( BigNumView( record.verifier, record.verifierLength ) )
+        };
+    }
+    
+    size_t VerifierLog::size() const
+    {
+        std::shared_lock< std::shared_mutex > l( this->impl->_indexMutex );
+        
+        return this->impl->_index.size();
+    }
+    
+    void VerifierLog::compact()
+    {
+        this->impl->compact();
+    }
+    
+    VerifierLog::Stats VerifierLog::stats() const
+    {
+        Stats                                 stats {};
+        std::shared_lock< std::shared_mutex > l( this->impl->_indexMutex );
+        
+        stats.identities   = this->impl->_index.size();
+        stats.segments     = this->impl->_segments.size();
+        stats.records      = this->impl->_records;
+        stats.commits      = this->impl->_commits;
+        stats.bytesWritten = this->impl->_bytesWritten;
+        stats.compactions  = this->impl->_compactions;
+        
+        for( const auto & p: this->impl->_segments )
+        {
+            stats.liveBytes  += p.second->liveBytes;
+            stats.totalBytes += p.second->file.size();
+        }
+        
+        return stats;
+    }
+    
+    VerifierLog::IMPL::IMPL( const std::string & directory, const Options & options ):
+        _directory( directory ),
+        _options( options ),
+        _nextSegment( 1 ),
+        _nextSequence( 1 ),
+        _stop( false ),
+        _compactionRequested( false ),
+        _commits( 0 ),
+        _records( 0 ),
+        _bytesWritten( 0 ),
+        _compactions( 0 )
+    {
+        std::error_code error;
+        
+        std::filesystem::create_directories( directory, error );
+        
+        if( std::filesystem::is_directory( directory, error ) == false )
+        {
+            throw std::runtime_error( "Cannot create verifier log directory" );
+        }
+        
+        this->load();
+        
+        this->_writer    = std::thread( [ this ] { this->write(); } );
+        this->_compactor = std::thread( [ this ] { this->compactInBackground(); } );
+    }
+    
+    VerifierLog::IMPL::~IMPL()
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_queueMutex );
+            
+            this->_stop = true;
+        }
+        
+        this->_queueCondition.notify_all();
+        this->_writer.join();
+        
+        {
+            std::lock_guard< std::mutex > l( this->_compactionMutex );
+            
+            this->_compactionRequested = true;
+        }
+        
+        this->_compactionCondition.notify_all();
+        this->_compactor.join();
+    }
+    
+    std::string VerifierLog::IMPL::segmentPath( uint64_t id, bool compacted ) const
+    {
+        std::string name = std::to_string( id );
+        
+        /* Compacted segments are told apart, as they are never appended to */
+        return ( std::filesystem::path( this->_directory ) / ( std::string( 16 - std::min< size_t >( name.size(), 16 ), '0' ) + name + ( compacted ? ".compact" : ".log" ) ) ).string();
+    }
+    
+    void VerifierLog::IMPL::load()
+    {
+        std::vector< std::pair< uint64_t, bool > > ids;
+        
+        for( const auto & entry: std::filesystem::directory_iterator( this->_directory ) )
+        {
+            std::string name = entry.path().filename().string();
+            
+            if( entry.path().extension() == ".tmp" )
+            {
+                /* Left over by an interrupted compaction */
+                std::error_code error;
+                
+                std::filesystem::remove( entry.path(), error );
+            }
+            else if
+            (
+                   ( ( entry.path().extension() == ".log" && name.size() == 20 ) || ( entry.path().extension() == ".compact" && name.size() == 24 ) )
+                && std::all_of( name.begin(), name.begin() + 16, [] ( char c ) { return c >= '0' && c <= '9'; } )
+            )
+            {
+                ids.push_back( { std::stoull( name.substr( 0, 16 ) ), entry.path().extension() == ".compact" } );
+            }
+        }
+        
+        std::sort( ids.begin(), ids.end() );
+        
+        std::vector< std::shared_ptr< Segment > > segments;
+        std::vector< std::vector< Scan > >        scans( ids.size() );
+        std::vector< std::thread >                threads;
+        std::atomic< size_t >                     next( 0 );
+        size_t                                    active = ids.size();
+        
+        for( const auto & id: ids )
+        {
+            if( id.second == false )
+            {
+                active = segments.size();
+            }
+            
+            segments.push_back( std::make_shared< Segment >( id.first, this->segmentPath( id.first, id.second ), false ) );
+        }
+        
+        /* Segments are independent, so they are scanned in parallel */
+        size_t count = std::min< size_t >( std::max< size_t >( std::thread::hardware_concurrency(), 1 ), segments.size() );
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            threads.emplace_back
+            (
+                [ & ]
+                {
+                    for( size_t n = next++; n < segments.size(); n = next++ )
+                    {
+                        /* Only the active segment may have a torn write, which is discarded */
+                        scans[ n ] = this->scan( *( segments[ n ] ), n == active );
+                    }
+                }
+            );
+        }
+        
+        for( auto & thread: threads )
+        {
+            thread.join();
+        }
+        
+        /* The most recent record for each identity wins, whatever segment it is in */
+        std::unordered_map< std::string, std::pair< Scan *, Segment * > > latest;
+        
+        for( size_t i = 0; i < segments.size(); i++ )
+        {
+            for( auto & scan: scans[ i ] )
+            {
+                auto & p = latest[ scan.identity ];
+                
+                if( p.first == nullptr || p.first->sequence < scan.sequence )
+                {
+                    p = { &scan, segments[ i ].get() };
+                }
+                
+                this->_nextSequence = std::max( this->_nextSequence, scan.sequence + 1 );
+            }
+            
+            this->_segments[ segments[ i ]->id ] = segments[ i ];
+        }
+        
+        for( const auto & p: latest )
+        {
+            if( p.second.first->put == false )
+            {
+                continue;
+            }
+            
+            Segment & segment = *( p.second.second );
+            
+            segment.liveBytes += p.second.first->size;
+            
+            this->_index[ p.first ] = { this->_segments[ segment.id ], p.second.first->offset, p.second.first->size, p.second.first->sequence };
+        }
+        
+        /* Compacted segments may have a higher ID than the active one, which is the last appended segment */
+        if( active == segments.size() )
+        {
+            uint64_t id = ( segments.empty() ) ? 1 : segments.back()->id + 1;
+            
+            this->_active = std::make_shared< Segment >( id, this->segmentPath( id, false ), true );
+            
+            this->_segments[ id ] = this->_active;
+        }
+        else
+        {
+            this->_active = segments[ active ];
+        }
+        
+        this->_nextSegment = std::max( this->_active->id, ( segments.empty() ) ? 0 : segments.back()->id ) + 1;
+    }
+    
+    std::vector< VerifierLog::IMPL::Scan > VerifierLog::IMPL::scan( Segment & segment, bool truncate ) const
+    {
+        std::vector< uint8_t > data( static_cast< size_t >( segment.file.size() ) );
+        std::vector< Scan >    scans;
+        size_t                 offset = 0;
+        Decoded                record;
+        
+        if( segment.file.readAt( 0, data.data(), data.size() ) == false )
+        {
+            throw std::runtime_error( "Cannot read verifier log segment" );
+        }
+        
+        while( offset < data.size() && decode( data.data() + offset, data.size() - offset, record ) )
+        {
+            scans.push_back( { std::string( record.identity ), record.sequence, offset, static_cast< uint32_t >( record.size ), record.type == typePut } );
+            
+            offset += record.size;
+        }
+        
+        if( truncate && offset < data.size() )
+        {
+            segment.file.truncate( offset );
+        }
+        
+        return scans;
+    }
+    
+    void VerifierLog::IMPL::write()
+    {
+        std::vector< Update > updates;
+        
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( this->_queueMutex );
+                
+                this->_queueCondition.wait( l, [ this ] { return this->_stop || this->_queue.empty() == false; } );
+                
+                if( this->_queue.empty() )
+                {
+                    break;
+                }
+                
+                /* Everything queued so far goes in the same batch, with a single sync */
+                updates.swap( this->_queue );
+            }
+            
+            this->commit( updates );
+            updates.clear();
+            
+            if( this->needsCompaction() )
+            {
+                {
+                    std::lock_guard< std::mutex > l( this->_compactionMutex );
+                    
+                    this->_compactionRequested = true;
+                }
+                
+                this->_compactionCondition.notify_one();
+            }
+        }
+    }
+    
+    void VerifierLog::IMPL::commit( std::vector< Update > & updates )
+    {
+        if( this->_active->file.size() >= this->_options.segmentSize )
+        {
+            uint64_t id      = this->_nextSegment++;
+            auto     segment = std::make_shared< Segment >( id, this->segmentPath( id, false ), true );
+            
+            std::unique_lock< std::shared_mutex > l( this->_indexMutex );
+            
+            this->_segments[ segment->id ] = segment;
+            this->_active                  = segment;
+        }
+        
+        std::vector< uint8_t >  data;
+        std::vector< Location > locations;
+        uint64_t                base = this->_active->file.size();
+        
+        for( const auto & update: updates )
+        {
+            size_t offset = data.size();
+            
+            encode( data, this->_nextSequence, update );
+            locations.push_back( { this->_active, base + offset, static_cast< uint32_t >( data.size() - offset ), this->_nextSequence++ } );
+        }
+        
+        if( this->_active->file.append( data.data(), data.size() ) == false || this->_active->file.sync() == false )
+        {
+            this->_active->file.truncate( base );
+            
+            for( auto & update: updates )
+            {
+                update.promise.set_exception( std::make_exception_ptr( std::runtime_error( "Cannot write verifier log" ) ) );
+            }
+            
+            return;
+        }
+        
+        {
+            std::unique_lock< std::shared_mutex > l( this->_indexMutex );
+            
+            for( size_t i = 0; i < updates.size(); i++ )
+            {
+                this->apply( updates[ i ], locations[ i ] );
+            }
+        }
+        
+        this->_commits++;
+        this->_records      += updates.size();
+        this->_bytesWritten += data.size();
+        
+        for( auto & update: updates )
+        {
+            update.promise.set_value();
+        }
+    }
+    
+    void VerifierLog::IMPL::apply( const Update & update, const Location & location )
+    {
+        auto it = this->_index.find( update.identity );
+        
+        if( it != this->_index.end() )
+        {
+            it->second.segment->liveBytes -= it->second.size;
+        }
+        
+        if( update.type == typePut )
+        {
+            location.segment->liveBytes += location.size;
+            
+            if( it != this->_index.end() )
+            {
+                it->second = location;
+            }
+            else
+            {
+                this->_index.emplace( update.identity, location );
+            }
+        }
+        else if( it != this->_index.end() )
+        {
+            this->_index.erase( it );
+        }
+    }
+    
+    bool VerifierLog::IMPL::needsCompaction() const
+    {
+        std::shared_lock< std::shared_mutex > l( this->_indexMutex );
+        
+        uint64_t live  = 0;
+        uint64_t total = 0;
+        
+        for( const auto & p: this->_segments )
+        {
+            if( p.second != this->_active )
+            {
+                live  += p.second->liveBytes;
+                total += p.second->file.size();
+            }
+        }
+        
+        return total > 0 && static_cast< double >( total - live ) >= static_cast< double >( total ) * this->_options.compactionThreshold;
+    }
+    
+    void VerifierLog::IMPL::compactInBackground()
+    {
+        while( true )
+        {
+            {
+                std::unique_lock< std::mutex > l( this->_compactionMutex );
+                
+                this->_compactionCondition.wait( l, [ this ] { return this->_compactionRequested; } );
+                
+                this->_compactionRequested = false;
+            }
+            
+            {
+                std::lock_guard< std::mutex > l( this->_queueMutex );
+                
+                if( this->_stop )
+                {
+                    break;
+                }
+            }
+            
+            try
+            {
+                this->compact();
+            }
+            catch( ... )
+            {
+                /* Compaction is retried on the next request, and the log stays valid meanwhile */
+            }
+        }
+    }
+    
+    void VerifierLog::IMPL::compact()
+    {
+        std::lock_guard< std::mutex > compacting( this->_compacting );
+        
+        struct Moved
+        {
+            std::string identity;
+            Segment   * from;
+            uint64_t    fromOffset;
+            uint64_t    offset;
+            uint32_t    size;
+        };
+        
+        struct Tombstone
+        {
+            uint64_t               sequence;
+            std::vector< uint8_t > record;
+        };
+        
+        std::vector< std::shared_ptr< Segment > >    sealed;
+        std::vector< Moved >                         moved;
+        std::unordered_set< std::string >            puts;
+        std::unordered_map< std::string, Tombstone > tombstones;
+        
+        {
+            std::shared_lock< std::shared_mutex > l( this->_indexMutex );
+            
+            for( const auto & p: this->_segments )
+            {
+                if( p.second != this->_active )
+                {
+                    sealed.push_back( p.second );
+                }
+            }
+        }
+        
+        if( sealed.empty() )
+        {
+            return;
+        }
+        
+        /* Written one sealed segment at a time, and only visible once complete */
+        uint64_t    id             = this->_nextSegment++;
+        std::string path           = this->segmentPath( id, true );
+        uint64_t    size           = 0;
+        uint64_t    tombstoneBytes = 0;
+        
+        {
+            File file( path + ".tmp", true );
+            
+            auto append = [ & ]( const std::vector< uint8_t > & output )
+            {
+                if( output.empty() == false && file.append( output.data(), output.size() ) == false )
+                {
+                    throw std::runtime_error( "Cannot write verifier log segment" );
+                }
+                
+                size += output.size();
+            };
+            
+            for( const auto & segment: sealed )
+            {
+                std::vector< uint8_t > data( static_cast< size_t >( segment->file.size() ) );
+                std::vector< uint8_t > output;
+                size_t                 offset = 0;
+                Decoded                record;
+                
+                if( segment->file.readAt( 0, data.data(), data.size() ) == false )
+                {
+                    throw std::runtime_error( "Cannot read verifier log segment" );
+                }
+                
+                while( offset < data.size() && decode( data.data() + offset, data.size() - offset, record ) )
+                {
+                    std::string identity( record.identity );
+                    bool        live = false;
+                    
+                    {
+                        std::shared_lock< std::shared_mutex > l( this->_indexMutex );
+                        auto                                  it = this->_index.find( identity );
+                        
+                        if( record.type == typePut )
+                        {
+                            live = it != this->_index.end() && it->second.segment == segment && it->second.offset == offset;
+                        }
+                        else
+                        {
+                            live = it == this->_index.end();
+                        }
+                    }
+                    
+                    auto begin = data.begin() + static_cast< std::ptrdiff_t >( offset );
+                    auto end   = begin + static_cast< std::ptrdiff_t >( record.size );
+                    
+                    if( record.type == typePut )
+                    {
+                        puts.insert( identity );
+                        
+                        if( live )
+                        {
+                            moved.push_back( { identity, segment.get(), offset, size + output.size(), static_cast< uint32_t >( record.size ) } );
+                            output.insert( output.end(), begin, end );
+                        }
+                    }
+                    else if( live && ( tombstones.count( identity ) == 0 || tombstones[ identity ].sequence < record.sequence ) )
+                    {
+                        tombstones[ identity ] = { record.sequence, std::vector< uint8_t >( begin, end ) };
+                    }
+                    
+                    offset += record.size;
+                }
+                
+                append( output );
+            }
+            
+            std::vector< uint8_t > output;
+            
+            for( const auto & p: tombstones )
+            {
+                /*
+                 * Only kept while an older put of the identity is in a sealed segment,
+                 * which may outlive this one after a crash.
+                 * Otherwise, nothing is left for the tombstone to hide.
+                 */
+                if( puts.count( p.first ) > 0 )
+                {
+                    output.insert( output.end(), p.second.record.begin(), p.second.record.end() );
+                }
+            }
+            
+            tombstoneBytes = output.size();
+            
+            append( output );
+            
+            if( file.sync() == false )
+            {
+                throw std::runtime_error( "Cannot write verifier log segment" );
+            }
+        }
+        
+        std::shared_ptr< Segment > compacted;
+        
+        if( size > 0 )
+        {
+            std::filesystem::rename( path + ".tmp", path );
+            
+            compacted = std::make_shared< Segment >( id, path, false );
+            
+            /* Tombstones are counted as live, so they do not trigger another compaction right away */
+            compacted->liveBytes = tombstoneBytes;
+        }
+        else
+        {
+            std::error_code error;
+            
+            std::filesystem::remove( path + ".tmp", error );
+        }
+        
+        std::vector< std::string > paths;
+        
+        {
+            std::unique_lock< std::shared_mutex > l( this->_indexMutex );
+            
+            for( const auto & m: moved )
+            {
+                auto it = this->_index.find( m.identity );
+                
+                /* Unless updated in the meantime */
+                if( it != this->_index.end() && it->second.segment.get() == m.from && it->second.offset == m.fromOffset )
+                {
+                    it->second.segment    = compacted;
+                    it->second.offset     = m.offset;
+                    compacted->liveBytes += m.size;
+                }
+            }
+            
+            if( compacted != nullptr )
+            {
+                this->_segments[ compacted->id ] = compacted;
+            }
+            
+            for( const auto & segment: sealed )
+            {
+                this->_segments.erase( segment->id );
+                paths.push_back( segment->path );
+            }
+        }
+        
+        sealed.clear();
+        
+        for( const auto & path: paths )
+        {
+            std::error_code error;
+            
+            std::filesystem::remove( path, error );
+        }
+        
+        this->_compactions++;
+    }
+    
+    std::future< void > VerifierLog::IMPL::push( Update update )
+    {
+        std::future< void > future = update.promise.get_future();
+        
+        {
+            std::lock_guard< std::mutex > l( this->_queueMutex );
+            
+            this->_queue.push_back( std::move( update ) );
+        }
+        
+        this->_queueCondition.notify_one();
+        
+        return future;
+    }
+    
+    #ifdef _WIN32
+    
+    File::File( const std::string & path, bool create ):
+        _handle( CreateFileA( path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr ) ),
+        _size( 0 )
+    {
+        LARGE_INTEGER size;
+        
+        if( this->_handle == INVALID_HANDLE_VALUE || GetFileSizeEx( this->_handle, &size ) == FALSE )
+        {
+            if( this->_handle != INVALID_HANDLE_VALUE )
+            {
+                CloseHandle( this->_handle );
+            }
+            
+            throw std::runtime_error( "Cannot open verifier log segment" );
+        }
+        
+        this->_size = static_cast< uint64_t >( size.QuadPart );
+    }
+    
+    File::~File()
+    {
+        CloseHandle( this->_handle );
+    }
+    
+    bool File::readAt( uint64_t offset, uint8_t * data, size_t length ) const
+    {
+        while( length > 0 )
+        {
+            OVERLAPPED overlapped {};
+            DWORD      read = 0;
+            DWORD      size = static_cast< DWORD >( std::min< size_t >( length, 0x40000000 ) );
+            
+            overlapped.Offset     = static_cast< DWORD >( offset );
+            overlapped.OffsetHigh = static_cast< DWORD >( offset >> 32 );
+            
+            if( ReadFile( this->_handle, data, size, &read, &overlapped ) == FALSE || read == 0 )
+            {
+                return false;
+            }
+            
+            data   += read;
+            offset += read;
+            length -= read;
+        }
+        
+        return true;
+    }
+    
+    bool File::append( const uint8_t * data, size_t length )
+    {
+        while( length > 0 )
+        {
+            OVERLAPPED overlapped {};
+            DWORD      written = 0;
+            DWORD      size    = static_cast< DWORD >( std::min< size_t >( length, 0x40000000 ) );
+            uint64_t   offset  = this->_size;
+            
+            overlapped.Offset     = static_cast< DWORD >( offset );
+            overlapped.OffsetHigh = static_cast< DWORD >( offset >> 32 );
+            
+            if( WriteFile( this->_handle, data, size, &written, &overlapped ) == FALSE )
+            {
+                return false;
+            }
+            
+            data        += written;
+            length      -= written;
+            this->_size += written;
+        }
+        
+        return true;
+    }
+    
+    bool File::sync()
+    {
+        return FlushFileBuffers( this->_handle ) != FALSE;
+    }
+    
+    bool File::truncate( uint64_t length )
+    {
+        LARGE_INTEGER offset;
+        
+        offset.QuadPart = static_cast< LONGLONG >( length );
+        
+        if( SetFilePointerEx( this->_handle, offset, nullptr, FILE_BEGIN ) == FALSE || SetEndOfFile( this->_handle ) == FALSE )
+        {
+            return false;
+        }
+        
+        this->_size = length;
+        
+        return true;
+    }
+    
+    #else
+    
+    File::File( const std::string & path, bool create ):
+        _fd( open( path.c_str(), O_RDWR | O_CLOEXEC | ( create ? O_CREAT : 0 ), 0600 ) ),
+        _size( 0 )
+    {
+        struct stat st;
+        
+        if( this->_fd == -1 || fstat( this->_fd, &st ) != 0 )
+        {
+            if( this->_fd != -1 )
+            {
+                close( this->_fd );
+            }
+            
+            throw std::runtime_error( "Cannot open verifier log segment" );
+        }
+        
+        this->_size = static_cast< uint64_t >( st.st_size );
+    }
+    
+    File::~File()
+    {
+        close( this->_fd );
+    }
+    
+    bool File::readAt( uint64_t offset, uint8_t * data, size_t length ) const
+    {
+        while( length > 0 )
+        {
+            ssize_t n = pread( this->_fd, data, length, static_cast< off_t >( offset ) );
+            
+            if( n <= 0 )
+            {
+                return false;
+            }
+            
+            data   += n;
+            offset += static_cast< uint64_t >( n );
+            length -= static_cast< size_t >( n );
+        }
+        
+        return true;
+    }
+    
+    bool File::append( const uint8_t * data, size_t length )
+    {
+        while( length > 0 )
+        {
+            ssize_t n = pwrite( this->_fd, data, length, static_cast< off_t >( this->_size.load() ) );
+            
+            if( n <= 0 )
+            {
+                return false;
+            }
+            
+            data        += n;
+            length      -= static_cast< size_t >( n );
+            this->_size += static_cast< uint64_t >( n );
+        }
+        
+        return true;
+    }
+    
+    bool File::sync()
+    {
+        #ifdef __APPLE__
+        return fcntl( this->_fd, F_FULLFSYNC ) == 0 || fsync( this->_fd ) == 0;
+        #else
+        return fsync( this->_fd ) == 0;
+        #endif
+    }
+    
+    bool File::truncate( uint64_t length )
+    {
+        if( ftruncate( this->_fd, static_cast< off_t >( length ) ) != 0 )
+        {
+            return false;
+        }
+        
+        this->_size = length;
+        
+        return true;
+    }
+    
+    #endif
+    
+    uint64_t File::size() const
+    {
+        return this->_size;
+    }
+}
@@ -0,0 +1,549 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/VerifierStore.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * File layout, all integers little-endian:
+ * 
+ *   Header (64 bytes):     magic[ 8 ], version u32, reserved u32, count u64, bucket count u64,
+ *                          index offset u64, data offset u64, file size u64, reserved u64
+ *   Index (16 bytes each): identity hash u64, record offset u64 (0 for an empty bucket)
+ *   Records (8 aligned):   identity length u16, hash algorithm u8, group type u8, salt length u16,
+ *                          verifier length u16, identity, salt, big-endian verifier
+ */
+
+namespace SRP
+{
+    namespace
+    {
+        constexpr uint8_t magic[ 8 ]   = { 'S', 'R', 'P', 'X', 'X', 'V', 'S', 'T' };
+        constexpr size_t  headerSize   = 64;
+        constexpr size_t  bucketSize   = 16;
+        constexpr size_t  recordHeader = 8;
+        
+        /* FNV-1a */
+        uint64_t hashIdentity( std::string_view identity )
+        {
+            uint64_t hash = 0xCBF29CE484222325ULL;
+            
+            for( char c: identity )
+            {
+                hash ^= static_cast< uint8_t >( c );
+                hash *= 0x100000001B3ULL;
+            }
+            
+            return hash;
+        }
+        
+        uint64_t loadLE( const uint8_t * p, size_t size )
+        {
+            uint64_t value = 0;
+            
+            for( size_t i = 0; i < size; i++ )
+            {
+                value |= static_cast< uint64_t >( p[ i ] ) << ( i * 8 );
+            }
+            
+            return value;
+        }
+        
+        void storeLE( uint8_t * p, uint64_t value, size_t size )
+        {
+            for( size_t i = 0; i < size; i++ )
+            {
+                p[ i ] = static_cast< uint8_t >( value >> ( i * 8 ) );
+            }
+        }
+        
+        void appendLE( std::vector< uint8_t > & data, uint64_t value, size_t size )
+        {
+            data.resize( data.size() + size );
+            storeLE( data.data() + data.size() - size, value, size );
+        }
+        
+        /* Written and synced before it is renamed over the store, so a crash never leaves the new name on a partial file */
+        bool writeSynced( const std::string & path, const std::vector< uint8_t > & data )
+        {
+            const uint8_t * p      = data.data();
+            size_t          length = data.size();
+            
+            #ifdef _WIN32
+            
+            HANDLE file = CreateFileA( path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+            bool   ok   = file != INVALID_HANDLE_VALUE;
+            
+            while( ok && length > 0 )
+            {
+                DWORD written = 0;
+                
+                ok      = WriteFile( file, p, static_cast< DWORD >( std::min< size_t >( length, 0x40000000 ) ), &written, nullptr ) != FALSE;
+                p      += written;
+                length -= written;
+            }
+            
+            ok = ok && FlushFileBuffers( file ) != FALSE;
+            
+            if( file != INVALID_HANDLE_VALUE )
+            {
+                ok = CloseHandle( file ) != FALSE && ok;
+            }
+            
+            return ok;
+            
+            #else
+            
+            int  fd = open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+            bool ok = fd >= 0;
+            
+            while( ok && length > 0 )
+            {
+                ssize_t n = write( fd, p, length );
+                
+                if( n < 0 && errno == EINTR )
+                {
+                    continue;
+                }
+                
+                ok      = n > 0;
+                p      += ( n > 0 ) ? n : 0;
+                length -= ( n > 0 ) ? static_cast< size_t >( n ) : 0;
+            }
+            
+            #ifdef __APPLE__
+            ok = ok && ( fcntl( fd, F_FULLFSYNC ) == 0 || fsync( fd ) == 0 );
+            #else
+            ok = ok && fsync( fd ) == 0;
+            #endif
+            
+            if( fd >= 0 )
+            {
+                ok = close( fd ) == 0 && ok;
+            }
+            
+            return ok;
+            
+            #endif
+        }
+        
+        /* Makes the rename itself durable - Windows has no equivalent, MOVEFILE_WRITE_THROUGH covers it */
+        bool syncDirectory( const std::string & path )
+        {
+            #ifdef _WIN32
+            
+            ( void )path;
+            
+            return true;
+            
+            #else
+            
+            std::string directory = std::filesystem::path( path ).parent_path().string();
+            int         fd        = open( directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC );
+            
+            if( fd < 0 )
+            {
+                return false;
+            }
+            
+            /* Some file systems cannot sync a directory, which is not an error */
+            bool ok = fsync( fd ) == 0 || errno == EINVAL;
+            
+            close( fd );
+            
+            return ok;
+            
+            #endif
+        }
+    }
+    
+    class VerifierStore::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path );
+            ~IMPL();
+            
+            void   unmap();
+            Record record( uint64_t offset ) const;
+            
+            const uint8_t * _data;
+            size_t          _size;
+            uint64_t        _count;
+            uint64_t        _buckets;
+            uint64_t        _indexOffset;
+            uint64_t        _dataOffset;
+            
+            #ifdef _WIN32
+            HANDLE          _file;
+            HANDLE          _mapping;
+            #endif
+    };
+    
+    class VerifierStore::Builder::IMPL
+    {
+        public:
+            
+            struct Entry
+            {
+                std::string            identity;
+                HashAlgorithm          hashAlgorithm;
+                Base::GroupType        groupType;
+                std::vector< uint8_t > salt;
+                std::vector< uint8_t > verifier;
+            };
+            
+            std::vector< Entry >                      _entries;
+            std::unordered_map< std::string, size_t > _indices;
+    };
+    
+    VerifierStore::VerifierStore( const std::string & path ):
+        impl( std::make_unique< IMPL >( path ) )
+    {}
+    
+    VerifierStore::~VerifierStore()
+    {}
+    
+    VerifierStore::VerifierStore( VerifierStore && o ) noexcept = default;
+    
+    VerifierStore & VerifierStore::operator =( VerifierStore && o ) noexcept = default;
+    
+    size_t VerifierStore::size() const
+    {
+        return static_cast< size_t >( this->impl->_count );
+    }
+    
+    std::optional< VerifierStore::Record > VerifierStore::find( std::string_view identity ) const
+    {
+        uint64_t        hash  = hashIdentity( identity );
+        uint64_t        mask  = this->impl->_buckets - 1;
+        const uint8_t * index = this->impl->_data + this->impl->_indexOffset;
+        
+        for( uint64_t i = 0, bucket = hash & mask; i < this->impl->_buckets; i++, bucket = ( bucket + 1 ) & mask )
+        {
+            const uint8_t * p      = index + bucket * bucketSize;
+            uint64_t        offset = loadLE( p + 8, 8 );
+            
+            if( offset == 0 )
+            {
+                break;
+            }
+            
+            if( loadLE( p, 8 ) != hash )
+            {
+                continue;
+            }
+            
+            Record record = this->impl->record( offset );
+            
+            if( record.identity == identity )
+            {
+                return record;
+            }
+        }
+        
+        return {};
+    }
+    
+    VerifierStore::Builder::Builder():
+        impl( std::make_unique< IMPL >() )
+    {}
+    
+    VerifierStore::Builder::~Builder()
+    {}
+    
+    void VerifierStore::Builder::add( const std::string & identity, HashAlgorithm hashAlgorithm, Base::GroupType groupType, const std::vector< uint8_t > & salt, const BigNum & verifier )
+    {
+        std::vector< uint8_t > bytes = verifier.bytes( BigNum::Endianness::BigEndian );
+        
+        if( identity.size() > 0xFFFF || salt.size() > 0xFFFF || bytes.size() > 0xFFFF )
+        {
+            throw std::runtime_error( "Verifier store record is too large" );
+        }
+        
+        IMPL::Entry entry { identity, hashAlgorithm, groupType, salt, std::move( bytes ) };
+        auto        it    = this->impl->_indices.find( identity );
+        
+        if( it != this->impl->_indices.end() )
+        {
+            this->impl->_entries[ it->second ] = std::move( entry );
+        }
+        else
+        {
+            this->impl->_indices[ identity ] = this->impl->_entries.size();
+            
+            this->impl->_entries.push_back( std::move( entry ) );
+        }
+    }
+    
+    size_t VerifierStore::Builder::size() const
+    {
+        return this->impl->_entries.size();
+    }
+    
+    void VerifierStore::Builder::write( const std::string & path ) const
+    {
+        /* At most half full, so probe sequences stay short */
+        uint64_t buckets = 16;
+        
+        while( buckets < this->impl->_entries.size() * 2 )
+        {
+            buckets <<= 1;
+        }
+        
+        uint64_t               dataOffset = headerSize + buckets * bucketSize;
+        std::vector< uint8_t > data( static_cast< size_t >( dataOffset ), 0 );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            uint64_t offset = data.size();
+            uint64_t hash   = hashIdentity( entry.identity );
+            uint64_t bucket = hash & ( buckets - 1 );
+            
+            appendLE( data, entry.identity.size(),                          2 );
+            appendLE( data, static_cast< uint64_t >( entry.hashAlgorithm ), 1 );
+            appendLE( data, static_cast< uint64_t >( entry.groupType ),     1 );
+            appendLE( data, entry.salt.size(),                              2 );
+            appendLE( data, entry.verifier.size(),                          2 );
+            
+            data.insert( data.end(), entry.identity.begin(), entry.identity.end() );
+            data.insert( data.end(), entry.salt.begin(),     entry.salt.end() );
+            data.insert( data.end(), entry.verifier.begin(), entry.verifier.end() );
+            data.resize( ( data.size() + 7 ) & ~static_cast< size_t >( 7 ), 0 );
+            
+            while( loadLE( data.data() + headerSize + bucket * bucketSize + 8, 8 ) != 0 )
+            {
+                bucket = ( bucket + 1 ) & ( buckets - 1 );
+            }
+            
+            storeLE( data.data() + headerSize + bucket * bucketSize,     hash,   8 );
+            storeLE( data.data() + headerSize + bucket * bucketSize + 8, offset, 8 );
+        }
+        
+        memcpy( data.data(), magic, sizeof( magic ) );
+        storeLE( data.data() +  8, version,                     4 );
+        storeLE( data.data() + 16, this->impl->_entries.size(), 8 );
+        storeLE( data.data() + 24, buckets,                     8 );
+        storeLE( data.data() + 32, headerSize,                  8 );
+        storeLE( data.data() + 40, dataOffset,                  8 );
+        storeLE( data.data() + 48, data.size(),                 8 );
+        
+        std::string tmp = path + ".tmp";
+        
+        if( writeSynced( tmp, data ) == false )
+        {
+            std::remove( tmp.c_str() );
+            
+            throw std::runtime_error( "Cannot write verifier store" );
+        }
+        
+        #ifdef _WIN32
+        bool renamed = MoveFileExA( tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+        #else
+        bool renamed = std::rename( tmp.c_str(), path.c_str() ) == 0;
+        #endif
+        
+        if( renamed == false )
+        {
+            std::remove( tmp.c_str() );
+            
+            throw std::runtime_error( "Cannot write verifier store" );
+        }
+        
+        if( syncDirectory( path ) == false )
+        {
+            throw std::runtime_error( "Cannot sync verifier store directory" );
+        }
+    }
+    
+    VerifierStore::IMPL::IMPL( const std::string & path ):
+        _data( nullptr ),
+        _size( 0 )
+    {
+        #ifdef _WIN32
+        
+        LARGE_INTEGER size;
+        
+        this->_file    = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        this->_mapping = nullptr;
+        
+        if( this->_file == INVALID_HANDLE_VALUE || GetFileSizeEx( this->_file, &size ) == FALSE )
+        {
+            if( this->_file != INVALID_HANDLE_VALUE )
+            {
+                CloseHandle( this->_file );
+            }
+            
+            throw std::runtime_error( "Cannot open verifier store" );
+        }
+        
+        this->_size    = static_cast< size_t >( size.QuadPart );
+        this->_mapping = ( this->_size < headerSize ) ? nullptr : CreateFileMappingA( this->_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        this->_data    = ( this->_mapping == nullptr ) ? nullptr : static_cast< const uint8_t * >( MapViewOfFile( this->_mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        
+        if( this->_data == nullptr )
+        {
+            if( this->_mapping != nullptr )
+            {
+                CloseHandle( this->_mapping );
+            }
+            
+            CloseHandle( this->_file );
+            
+            throw std::runtime_error( "Cannot map verifier store" );
+        }
+        
+        #else
+        
+        struct stat st;
+        int         fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+        
+        if( fd == -1 || fstat( fd, &st ) != 0 )
+        {
+            if( fd != -1 )
+            {
+                close( fd );
+            }
+            
+            throw std::runtime_error( "Cannot open verifier store" );
+        }
+        
+        this->_size = static_cast< size_t >( st.st_size );
+        
+        void * p = ( this->_size < headerSize ) ? MAP_FAILED : mmap( nullptr, this->_size, PROT_READ, MAP_SHARED, fd, 0 );
+        
+        /* The mapping keeps its own reference to the file */
+        close( fd );
+        
+        if( p == MAP_FAILED )
+        {
+            throw std::runtime_error( "Cannot map verifier store" );
+        }
+        
+        this->_data = static_cast< const uint8_t * >( p );
+        
+        #ifdef MADV_RANDOM
+        madvise( p, this->_size, MADV_RANDOM );
+        #endif
+        
+        #endif
+        
+        this->_count       = loadLE( this->_data + 16, 8 );
+        this->_buckets     = loadLE( this->_data + 24, 8 );
+        this->_indexOffset = loadLE( this->_data + 32, 8 );
+        this->_dataOffset  = loadLE( this->_data + 40, 8 );
+        
+        bool valid = memcmp( this->_data, magic, sizeof( magic ) ) == 0
+                  && loadLE( this->_data + 8, 4 ) == version
+                  && loadLE( this->_data + 48, 8 ) == this->_size
+                  && this->_indexOffset == headerSize
+                  && this->_buckets != 0
+                  && ( this->_buckets & ( this->_buckets - 1 ) ) == 0
+                  && this->_count < this->_buckets
+                  && this->_buckets <= ( this->_size - headerSize ) / bucketSize
+                  && this->_dataOffset == headerSize + this->_buckets * bucketSize;
+        
+        if( valid == false )
+        {
+            this->unmap();
+            
+            throw std::runtime_error( "Invalid verifier store" );
+        }
+    }
+    
+    VerifierStore::IMPL::~IMPL()
+    {
+        this->unmap();
+    }
+    
+    void VerifierStore::IMPL::unmap()
+    {
+        if( this->_data == nullptr )
+        {
+            return;
+        }
+        
+        #ifdef _WIN32
+        UnmapViewOfFile( this->_data );
+        CloseHandle( this->_mapping );
+        CloseHandle( this->_file );
+        #else
+        munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        #endif
+        
+        this->_data = nullptr;
+    }
+    
+    VerifierStore::Record VerifierStore::IMPL::record( uint64_t offset ) const
+    {
+        if( offset < this->_dataOffset || offset > this->_size - recordHeader )
+        {
+            throw std::runtime_error( "Invalid verifier store record" );
+        }
+        
+        const uint8_t * p              = this->_data + offset;
+        size_t          identityLength = static_cast< size_t >( loadLE( p,     2 ) );
+        uint64_t        hashAlgorithm  = loadLE( p + 2, 1 );
+        uint64_t        groupType      = loadLE( p + 3, 1 );
+        size_t          saltLength     = static_cast< size_t >( loadLE( p + 4, 2 ) );
+        size_t          verifierLength = static_cast< size_t >( loadLE( p + 6, 2 ) );
+        
+        if
+        (
+               hashAlgorithm > static_cast< uint64_t >( HashAlgorithm::SHA512 )
+            || groupType     > static_cast< uint64_t >( Base::GroupType::NG8192 )
+            || identityLength + saltLength + verifierLength > this->_size - offset - recordHeader
+        )
+        {
+            throw std::runtime_error( "Invalid verifier store record" );
+        }
+        
+        p += recordHeader;
+        
+        return
+        {
+            std::string_view( reinterpret_cast< const char * >( p ), identityLength ),
+            static_cast< HashAlgorithm >( hashAlgorithm ),
+            static_cast< Base::GroupType >( groupType ),
+            p + identityLength,
+            saltLength,
+            BigNumView( p + identityLength + saltLength, verifierLength )
+        };
+    }
+}
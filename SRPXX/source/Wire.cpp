@@ -0,0 +1,330 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2024 Jean-David Gadina - www.xs-labs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include <SRPXX/Wire.hpp>
+#include <SRPXX/SHA1.hpp>
+#include <SRPXX/SHA224.hpp>
+#include <SRPXX/SHA256.hpp>
+#include <SRPXX/SHA384.hpp>
+#include <SRPXX/SHA512.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    void storeLE32( uint8_t * p, uint32_t value )
+    {
+        p[ 0 ] = static_cast< uint8_t >( value );
+        p[ 1 ] = static_cast< uint8_t >( value >> 8 );
+        p[ 2 ] = static_cast< uint8_t >( value >> 16 );
+        p[ 3 ] = static_cast< uint8_t >( value >> 24 );
+    }
+    
+    uint32_t loadLE32( const uint8_t * p )
+    {
+        return static_cast< uint32_t >( p[ 0 ] )
+            | ( static_cast< uint32_t >( p[ 1 ] ) << 8 )
+            | ( static_cast< uint32_t >( p[ 2 ] ) << 16 )
+            | ( static_cast< uint32_t >( p[ 3 ] ) << 24 );
+    }
+    
+    /* Explicit codes, so the format does not depend on the order of the enums */
+    uint8_t hashCode( SRP::HashAlgorithm hashAlgorithm )
+    {
+        switch( hashAlgorithm )
+        {
+            case SRP::HashAlgorithm::SHA1:   return 1;
+            case SRP::HashAlgorithm::SHA224: return 2;
+            case SRP::HashAlgorithm::SHA256: return 3;
+            case SRP::HashAlgorithm::SHA384: return 4;
+            case SRP::HashAlgorithm::SHA512: return 5;
+        }
+        
+        throw std::runtime_error( "Unknown hash algorithm" );
+    }
+    
+    uint8_t groupCode( SRP::Base::GroupType groupType )
+    {
+        switch( groupType )
+        {
+            case SRP::Base::GroupType::NG1024: return 1;
+            case SRP::Base::GroupType::NG1536: return 2;
+            case SRP::Base::GroupType::NG2048: return 3;
+            case SRP::Base::GroupType::NG3072: return 4;
+            case SRP::Base::GroupType::NG4096: return 5;
+            case SRP::Base::GroupType::NG6144: return 6;
+            case SRP::Base::GroupType::NG8192: return 7;
+        }
+        
+        throw std::runtime_error( "Unknown group type" );
+    }
+    
+    SRP::HashAlgorithm hashFromCode( uint8_t code )
+    {
+        switch( code )
+        {
+            case 1: return SRP::HashAlgorithm::SHA1;
+            case 2: return SRP::HashAlgorithm::SHA224;
+            case 3: return SRP::HashAlgorithm::SHA256;
+            case 4: return SRP::HashAlgorithm::SHA384;
+            case 5: return SRP::HashAlgorithm::SHA512;
+                
+            default: throw std::runtime_error( "Invalid message hash algorithm" );
+        }
+    }
+    
+    SRP::Base::GroupType groupFromCode( uint8_t code )
+    {
+        switch( code )
+        {
+            case 1: return SRP::Base::GroupType::NG1024;
+            case 2: return SRP::Base::GroupType::NG1536;
+            case 3: return SRP::Base::GroupType::NG2048;
+            case 4: return SRP::Base::GroupType::NG3072;
+            case 5: return SRP::Base::GroupType::NG4096;
+            case 6: return SRP::Base::GroupType::NG6144;
+            case 7: return SRP::Base::GroupType::NG8192;
+                
+            default: throw std::runtime_error( "Invalid message group" );
+        }
+    }
+    
+    uint8_t * writeHeader( uint8_t * output, SRP::Wire::Type type, SRP::HashAlgorithm hashAlgorithm, SRP::Base::GroupType groupType, size_t bodyLength )
+    {
+        output[ 0 ] = SRP::Wire::version;
+        output[ 1 ] = static_cast< uint8_t >( type );
+        output[ 2 ] = hashCode( hashAlgorithm );
+        output[ 3 ] = groupCode( groupType );
+        
+        storeLE32( output + 4, static_cast< uint32_t >( bodyLength ) );
+        
+        return output + SRP::Wire::headerLength;
+    }
+    
+    uint8_t * writeField( uint8_t * output, const uint8_t * data, size_t length )
+    {
+        output[ 0 ] = static_cast< uint8_t >( length );
+        
+        if( length > 0 )
+        {
+            memcpy( output + 1, data, length );
+        }
+        
+        return output + 1 + length;
+    }
+    
+    size_t encodeField( SRP::Wire::Type type, const SRP::Base & session, const uint8_t * field, size_t fieldLength, const SRP::BigNum & value, uint8_t * output, size_t capacity )
+    {
+        size_t valueLength = SRP::Wire::valueLength( session.groupType() );
+        size_t length      = SRP::Wire::headerLength + 1 + fieldLength + valueLength;
+        
+        if( fieldLength > 0xFF )
+        {
+            throw std::runtime_error( type == SRP::Wire::Type::Hello ? "Identity is too long" : "Salt is too long" );
+        }
+        
+        if( length > capacity )
+        {
+            return 0;
+        }
+        
+        uint8_t * p = writeHeader( output, type, session.hashAlgorithm(), session.groupType(), length - SRP::Wire::headerLength );
+        
+        p = writeField( p, field, fieldLength );
+        
+        if( value.bytes( p, valueLength ) == false )
+        {
+            throw std::runtime_error( "Value is larger than the group" );
+        }
+        
+        return length;
+    }
+    
+    size_t encodeProof( SRP::Wire::Type type, const SRP::Base & session, const std::vector< uint8_t > & proof, uint8_t * output, size_t capacity )
+    {
+        size_t length = SRP::Wire::headerLength + proof.size();
+        
+        if( proof.size() != SRP::Wire::proofLength( session.hashAlgorithm() ) )
+        {
+            throw std::runtime_error( "Invalid proof length" );
+        }
+        
+        if( length > capacity )
+        {
+            return 0;
+        }
+        
+        memcpy( writeHeader( output, type, session.hashAlgorithm(), session.groupType(), proof.size() ), proof.data(), proof.size() );
+        
+        return length;
+    }
+}
+
+namespace SRP
+{
+    namespace Wire
+    {
+        size_t valueLength( Base::GroupType groupType )
+        {
+            switch( groupType )
+            {
+                case Base::GroupType::NG1024: return 128;
+                case Base::GroupType::NG1536: return 192;
+                case Base::GroupType::NG2048: return 256;
+                case Base::GroupType::NG3072: return 384;
+                case Base::GroupType::NG4096: return 512;
+                case Base::GroupType::NG6144: return 768;
+                case Base::GroupType::NG8192: return 1024;
+            }
+            
+            throw std::runtime_error( "Unknown group type" );
+        }
+        
+        size_t proofLength( HashAlgorithm hashAlgorithm )
+        {
+            switch( hashAlgorithm )
+            {
+                case HashAlgorithm::SHA1:   return SHA1::digestSize;
+                case HashAlgorithm::SHA224: return SHA224::digestSize;
+                case HashAlgorithm::SHA256: return SHA256::digestSize;
+                case HashAlgorithm::SHA384: return SHA384::digestSize;
+                case HashAlgorithm::SHA512: return SHA512::digestSize;
+            }
+            
+            throw std::runtime_error( "Unknown hash algorithm" );
+        }
+        
+        size_t encodeHello( const Client & client, uint8_t * output, size_t capacity )
+        {
+            std::string identity = client.identity();
+            
+            return encodeField( Type::Hello, client, reinterpret_cast< const uint8_t * >( identity.data() ), identity.size(), client.A(), output, capacity );
+        }
+        
+        size_t encodeChallenge( const Server & server, uint8_t * output, size_t capacity )
+        {
+            std::vector< uint8_t > salt = server.salt();
+            
+            return encodeField( Type::Challenge, server, salt.data(), salt.size(), server.B(), output, capacity );
+        }
+        
+        size_t encodeClientProof( const Client & client, uint8_t * output, size_t capacity )
+        {
+            return encodeProof( Type::ClientProof, client, client.M1(), output, capacity );
+        }
+        
+        size_t encodeServerProof( const Server & server, const std::vector< uint8_t > & M2, uint8_t * output, size_t capacity )
+        {
+            return encodeProof( Type::ServerProof, server, M2, output, capacity );
+        }
+        
+        size_t parse( const uint8_t * input, size_t length, Message & message )
+        {
+            if( length < headerLength )
+            {
+                return 0;
+            }
+            
+            if( input[ 0 ] != version )
+            {
+                throw std::runtime_error( "Unsupported message version: " + std::to_string( input[ 0 ] ) );
+            }
+            
+            size_t bodyLength = loadLE32( input + 4 );
+            
+            /* Checked before waiting for the body, so a bad length cannot stall a reader */
+            if( bodyLength > maxLength - headerLength )
+            {
+                throw std::runtime_error( "Invalid message length" );
+            }
+            
+            message               = {};
+            message.type          = static_cast< Type >( input[ 1 ] );
+            message.hashAlgorithm = hashFromCode( input[ 2 ] );
+            message.groupType     = groupFromCode( input[ 3 ] );
+            
+            if( length - headerLength < bodyLength )
+            {
+                return 0;
+            }
+            
+            const uint8_t * body = input + headerLength;
+            
+            switch( message.type )
+            {
+                case Type::Hello:
+                case Type::Challenge:
+                {
+                    size_t fieldLength = ( bodyLength > 0 ) ? body[ 0 ] : 0;
+                    size_t valueLength = Wire::valueLength( message.groupType );
+                    
+                    if( bodyLength == 0 || bodyLength != 1 + fieldLength + valueLength )
+                    {
+                        throw std::runtime_error( "Invalid message length" );
+                    }
+                    
+                    if( message.type == Type::Hello )
+                    {
+                        message.identity = { reinterpret_cast< const char * >( body + 1 ), fieldLength };
+                        message.A        = { body + 1 + fieldLength, valueLength };
+                    }
+                    else
+                    {
+                        message.salt = { body + 1, fieldLength };
+                        message.B    = { body + 1 + fieldLength, valueLength };
+                    }
+                    
+                    break;
+                }
+                
+                case Type::ClientProof:
+                case Type::ServerProof:
+                {
+                    if( bodyLength != proofLength( message.hashAlgorithm ) )
+                    {
+                        throw std::runtime_error( "Invalid message length" );
+                    }
+                    
+                    if( message.type == Type::ClientProof )
+                    {
+                        message.M1 = { body, bodyLength };
+                    }
+                    else
+                    {
+                        message.M2 = { body, bodyLength };
+                    }
+                    
+                    break;
+                }
+                
+                default:
+                    
+                    throw std::runtime_error( "Invalid message type" );
+            }
+            
+            return headerLength + bodyLength;
+        }
+    }
+}